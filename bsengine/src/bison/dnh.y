@@ -4,7 +4,7 @@
 %define api.namespace {bstorm}
 %define parser_class_name {DnhParser}
 %locations
-%define api.location.type {bstorm::SourceLoc}
+%define api.location.type {bstorm::NodeLoc}
 %define parse.error verbose
 
 %parse-param { bstorm::DnhParseContext* ctx }
@@ -15,25 +15,30 @@
 #include <bstorm/source_map.hpp>
 #include <bstorm/node.hpp>
 #include <bstorm/env.hpp>
+#include <bstorm/node_arena.hpp>
 
 namespace bstorm
 {
 class DnhLexer;
 struct DnhParseContext
 {
-    DnhParseContext(DnhLexer* lexer, bool expandInclude) :
+    DnhParseContext(DnhLexer* lexer, NodeArena* arena, bool expandInclude) :
         env(std::make_shared<Env>()),
+        expandInclude(expandInclude),
         lexer(lexer),
-        expandInclude(expandInclude){}
-    DnhParseContext(const std::shared_ptr<Env>& globalEnv, DnhLexer* lexer, bool expandInclude) :
+        arena(arena){}
+    DnhParseContext(const std::shared_ptr<Env>& globalEnv, DnhLexer* lexer, NodeArena* arena, bool expandInclude) :
         env(globalEnv ? globalEnv : std::make_shared<Env>()),
+        expandInclude(expandInclude),
         lexer(lexer),
-        expandInclude(expandInclude){}
+        arena(arena){}
     std::shared_ptr<Env> env;
     std::shared_ptr<NodeBlock> result;
     std::vector<NodeHeader> headers;
     const bool expandInclude;
     DnhLexer* lexer;
+    NodeArena* arena; // nodes are allocated here
+    const NodePos* lastSrcPos = nullptr; // shared by nodes at the same position
 };
 }
 }
@@ -52,13 +57,15 @@ using namespace bstorm;
 static int yylex(DnhParser::semantic_type *yylval, DnhParser::location_type* yylloc, DnhParseContext* ctx)
 {
     auto lexer = ctx->lexer;
-    auto tk = lexer->dnhlex();
+    auto tk = lexer->Lex();
     switch(tk)
     {
         case DnhParser::token_type::TK_NUM:
-        case DnhParser::token_type::TK_IDENT:
             yylval->str = new std::string(lexer->GetString());
             break;
+        case DnhParser::token_type::TK_IDENT:
+            yylval->ident = lexer->GetIdent().GetEntry();
+            break;
         case DnhParser::token_type::TK_HEADER:
         case DnhParser::token_type::TK_STR:
             yylval->wstr = new std::wstring(lexer->GetWString());
@@ -75,20 +82,37 @@ void DnhParser::error(const DnhParser::location_type& yylloc, const std::string&
 {
     throw Log(LogLevel::LV_ERROR)
       .Msg(msg)
-      .AddSourcePos(std::make_shared<SourcePos>(yylloc.begin));
+      .AddSourcePos(&yylloc.begin);
 }
 
-static std::shared_ptr<NodeExp> exp(NodeExp* exp) { return std::shared_ptr<NodeExp>(exp); }
-static std::shared_ptr<NodeStmt> stmt(NodeStmt* stmt) { return std::shared_ptr<NodeStmt>(stmt); }
-static std::shared_ptr<NodeLeftVal> leftval(NodeLeftVal* leftval) { return std::shared_ptr<NodeLeftVal>(leftval); }
-static std::shared_ptr<NodeBlock> block(NodeBlock* block) { return std::shared_ptr<NodeBlock>(block); }
+// AST nodes are allocated from the per-compilation arena
+template <class T, class... Args>
+static T* New(DnhParseContext* ctx, Args&&... args) { return ctx->arena->New<T>(std::forward<Args>(args)...); }
+template <class T>
+static std::shared_ptr<T> own(DnhParseContext* ctx, T* node) { return ctx->arena->Own(node); }
+static std::shared_ptr<NodeExp> exp(DnhParseContext* ctx, NodeExp* exp) { return own(ctx, exp); }
+static std::shared_ptr<NodeStmt> stmt(DnhParseContext* ctx, NodeStmt* stmt) { return own(ctx, stmt); }
+static std::shared_ptr<NodeLeftVal> leftval(DnhParseContext* ctx, NodeLeftVal* leftval) { return own(ctx, leftval); }
+static std::shared_ptr<NodeBlock> block(DnhParseContext* ctx, NodeBlock* block) { return own(ctx, block); }
+
+// positions are trivially destructible, so they are not counted as live objects
+static const NodePos* NewPos(DnhParseContext* ctx, const NodePos& pos)
+{
+    return new (ctx->arena->Allocate(sizeof(NodePos), alignof(NodePos))) NodePos(pos);
+}
 
-static void FixPos(Node *node, const DnhParser::location_type& yylloc)
+static void FixPos(DnhParseContext* ctx, Node *node, const DnhParser::location_type& yylloc)
 {
-    node->srcPos = std::make_shared<SourcePos>(yylloc.begin);
+    const auto& pos = yylloc.begin;
+    const auto& last = ctx->lastSrcPos;
+    if (!last || last->line != pos.line || last->column != pos.column || last->filename != pos.filename)
+    {
+        ctx->lastSrcPos = NewPos(ctx, pos);
+    }
+    node->srcPos = ctx->lastSrcPos;
 }
 
-static void CheckDupDef(DnhParseContext* ctx, const DnhParser::location_type& yylloc, const std::string& name)
+static void CheckDupDef(DnhParseContext* ctx, const DnhParser::location_type& yylloc, const Ident& name)
 {
     if (ctx->env->GetCurrentBlockNameTable()->count(name) != 0)
     {
@@ -98,13 +122,13 @@ static void CheckDupDef(DnhParseContext* ctx, const DnhParser::location_type& yy
         auto msg = "found a duplicate definition of '" + prevDef->name + "' (previous definition was at line " + prevDefLine + " in " + prevDefPath + ").";
         throw Log(LogLevel::LV_ERROR)
           .Msg(msg)
-          .AddSourcePos(std::make_shared<SourcePos>(yylloc.begin));
+          .AddSourcePos(&yylloc.begin);
     }
 }
 
 static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
 {
-    auto def = std::shared_ptr<NodeDef>(ptr);
+    auto def = own(ctx, ptr);
     ctx->env->AddDef(def->name, def);
 }
 }
@@ -116,7 +140,7 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
     std::vector<std::shared_ptr<NodeElseIf>> *elsifs;
     std::vector<std::shared_ptr<NodeCase>> *cases;
     std::vector<std::wstring> *wstrs;
-    std::vector<std::string> *strs;
+    std::vector<Ident> *idents;
     NodeRange *range;
     NodeBlock *block;
     NodeElseIf *elsif;
@@ -126,6 +150,7 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
     NodeExp *exp;
     std::wstring *wstr;
     std::string *str;
+    const Ident::Entry *ident; // wrap in Ident to use
     wchar_t wchar;
 }
 
@@ -134,14 +159,14 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
 %destructor { delete $$; } <elsifs>
 %destructor { delete $$; } <cases>
 %destructor { delete $$; } <wstrs>
-%destructor { delete $$; } <strs>
-%destructor { delete $$; } <range>
-%destructor { delete $$; } <block>
-%destructor { delete $$; } <elsif>
-%destructor { delete $$; } <case_>
-%destructor { delete $$; } <leftval>
-%destructor { delete $$; } <stmt>
-%destructor { delete $$; } <exp>
+%destructor { delete $$; } <idents>
+%destructor { ctx->arena->Destroy($$); } <range>
+%destructor { ctx->arena->Destroy($$); } <block>
+%destructor { ctx->arena->Destroy($$); } <elsif>
+%destructor { ctx->arena->Destroy($$); } <case_>
+%destructor { ctx->arena->Destroy($$); } <leftval>
+%destructor { ctx->arena->Destroy($$); } <stmt>
+%destructor { ctx->arena->Destroy($$); } <exp>
 %destructor { delete $$; } <wstr>
 %destructor { delete $$; } <str>
 
@@ -215,7 +240,7 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
 %token TK_RABSPAREN "|)"
 /* literal */
 %token <str> TK_NUM "<number>"
-%token <str> TK_IDENT "<identifier>"
+%token <ident> TK_IDENT "<identifier>"
 %token <wchar> TK_CHAR "<char>"
 %token <wstr> TK_STR "<string>"
 
@@ -250,8 +275,8 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
 %type <exps> exps exps1 indices indices1
 %type <exp> cond
 %type <exp> exp primary monoop binop call-exp lit array array-access
-%type <strs> params params1 opt-params
-%type <str> param loop-param
+%type <idents> params params1 opt-params
+%type <ident> param loop-param
 %type <wstr> header-param
 %type <wstrs> header-params
 
@@ -260,8 +285,8 @@ static void AddDef(DnhParseContext* ctx, NodeDef* ptr)
 %%
 program            : stmts TK_EOF
                       {
-                          ctx->result = std::make_shared<NodeBlock>(ctx->env->GetCurrentBlockNameTable(), std::move(*$1));
-                          ctx->result->srcPos = std::make_shared<SourcePos>(SourcePos({1, 1, ctx->lexer->GetCurrentFilePath()}));
+                          ctx->result = ctx->arena->Make<NodeBlock>(ctx->env->GetCurrentBlockNameTable(), std::move(*$1));
+                          ctx->result->srcPos = NewPos(ctx, NodePos(1, 1, ctx->lexer->GetCurrentFilePath()));
                           delete($1);
                       }
 
@@ -269,12 +294,12 @@ stmts              : single-stmt
                        {
                          if ($1)
                          {
-                             $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt($1)};
+                             $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt(ctx, $1)};
                          } else {
                              $$ = new std::vector<std::shared_ptr<NodeStmt>>();
                          }
                        }
-                   | stmts1 single-stmt { $$ = $1; if ($2) { $1->push_back(stmt($2)); } }
+                   | stmts1 single-stmt { $$ = $1; if ($2) { $1->push_back(stmt(ctx, $2)); } }
 
 stmts1             : term-by-single TK_SEMI { $$ = $1; }
                    | term-by-compound
@@ -283,23 +308,23 @@ term-by-single     : single-stmt
                        {
                          if ($1)
                          {
-                             $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt($1)};
+                             $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt(ctx, $1)};
                          } else
                          {
                              $$ = new std::vector<std::shared_ptr<NodeStmt>>();
                          }
                        }
-                   | stmts1 single-stmt { $$ = $1; if ($2) { $1->push_back(stmt($2)); } }
+                   | stmts1 single-stmt { $$ = $1; if ($2) { $1->push_back(stmt(ctx, $2)); } }
 
 term-by-compound   : compound-stmt
                        {
                          if ($1) {
-                           $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt($1)};
+                           $$ = new std::vector<std::shared_ptr<NodeStmt>>{stmt(ctx, $1)};
                          } else {
                            $$ = new std::vector<std::shared_ptr<NodeStmt>>();
                          }
                        }
-                   | stmts1 compound-stmt { $$ = $1; if ($2) { $1->push_back(stmt($2)); } }
+                   | stmts1 compound-stmt { $$ = $1; if ($2) { $1->push_back(stmt(ctx, $2)); } }
 
 single-stmt        : none             { $$ = NULL; }
                    | var-decl         { $$ = NULL; }
@@ -309,21 +334,21 @@ single-stmt        : none             { $$ = NULL; }
                    | return
                    | yield
                    | break
-                   | left-value TK_SUCC { $$ = new NodeSucc(leftval($1)); FixPos($$, @2); }
-                   | left-value TK_PRED { $$ = new NodePred(leftval($1)); FixPos($$, @2); }
+                   | left-value TK_SUCC { $$ = New<NodeSucc>(ctx, leftval(ctx, $1)); FixPos(ctx, $$, @2); }
+                   | left-value TK_PRED { $$ = New<NodePred>(ctx, leftval(ctx, $1)); FixPos(ctx, $$, @2); }
 
-call-stmt          : TK_IDENT { $$ = new NodeCallStmt(*$1, {}); FixPos($$, @1); delete($1); }
-                   | TK_IDENT TK_LPAREN exps TK_RPAREN { $$ = new NodeCallStmt(*$1, std::move(*$3)); FixPos($$, @1); delete($1); delete($3); }
+call-stmt          : TK_IDENT { $$ = New<NodeCallStmt>(ctx, Ident($1), std::vector<std::shared_ptr<NodeExp>>()); FixPos(ctx, $$, @1); }
+                   | TK_IDENT TK_LPAREN exps TK_RPAREN { $$ = New<NodeCallStmt>(ctx, Ident($1), std::move(*$3)); FixPos(ctx, $$, @1); delete($3); }
 
-yield              : TK_YIELD { $$ = new NodeYield(); FixPos($$, @1); }
-break              : TK_BREAK { $$ = new NodeBreak(); FixPos($$, @1); }
+yield              : TK_YIELD { $$ = New<NodeYield>(ctx); FixPos(ctx, $$, @1); }
+break              : TK_BREAK { $$ = New<NodeBreak>(ctx); FixPos(ctx, $$, @1); }
 
 new-scope           : { ctx->env = std::make_shared<Env>(ctx->env); }
 
 block              : TK_LBRACE stmts TK_RBRACE
                        {
-                           $$ = new NodeBlock(ctx->env->GetCurrentBlockNameTable(), std::move(*$2));
-                           FixPos($$, @1);
+                           $$ = New<NodeBlock>(ctx, ctx->env->GetCurrentBlockNameTable(), std::move(*$2));
+                           FixPos(ctx, $$, @1);
                            delete($2);
                            ctx->env = ctx->env->GetParent();
                        }
@@ -346,34 +371,34 @@ loop-stmt          : loop
                    | ascent
                    | descent
 
-builtin-sub-def    : TK_ATMARK TK_IDENT { CheckDupDef(ctx, @2, *$2); } new-scope opt-nullparams block { auto def = new NodeBuiltInSubDef(*$2, block($6)); FixPos(def, @1); AddDef(ctx, def); delete($2); }
+builtin-sub-def    : TK_ATMARK TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } new-scope opt-nullparams block { auto def = New<NodeBuiltInSubDef>(ctx, Ident($2), block(ctx, $6)); FixPos(ctx, def, @1); AddDef(ctx, def); }
 
-sub-def            : TK_SUB TK_IDENT { CheckDupDef(ctx, @2, *$2); } new-scope opt-nullparams block { auto def = new NodeSubDef(*$2, block($6)); FixPos(def, @1); AddDef(ctx, def); delete($2); }
+sub-def            : TK_SUB TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } new-scope opt-nullparams block { auto def = New<NodeSubDef>(ctx, Ident($2), block(ctx, $6)); FixPos(ctx, def, @1); AddDef(ctx, def); }
 
-func-def           : TK_FUNCTION TK_IDENT { CheckDupDef(ctx, @2, *$2); } new-scope opt-params
+func-def           : TK_FUNCTION TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } new-scope opt-params
                        {
-                         if (ctx->env->GetCurrentBlockNameTable()->count("result") == 0)
+                         if (ctx->env->GetCurrentBlockNameTable()->count(Ident("result")) == 0)
                          {
-                             auto result = new NodeResult();
-                             FixPos(result, @1);
+                             auto result = New<NodeResult>(ctx);
+                             FixPos(ctx, result, @1);
                              AddDef(ctx, result);
                          }
                        }
                        block
                        {
-                           auto def = new NodeFuncDef(*$2, std::move(*$5), block($7));
-                           FixPos(def, @1);
+                           auto def = New<NodeFuncDef>(ctx, Ident($2), std::move(*$5), block(ctx, $7));
+                           FixPos(ctx, def, @1);
                            AddDef(ctx, def);
-                           delete($2); delete($5);
+                           delete($5);
                        }
 
-task-def           : TK_TASK TK_IDENT { CheckDupDef(ctx, @2, *$2); } new-scope opt-params block { auto def = new NodeTaskDef(*$2, std::move(*$5), block($6)); FixPos(def, @1); AddDef(ctx, def); delete($2); delete($5); }
+task-def           : TK_TASK TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } new-scope opt-params block { auto def = New<NodeTaskDef>(ctx, Ident($2), std::move(*$5), block(ctx, $6)); FixPos(ctx, def, @1); AddDef(ctx, def); delete($5); }
 
 params             : params1 opt-comma { $$ = $1; }
-                   | none { $$ = new std::vector<std::string>(); }
-params1            : params1 TK_COMMA param { $$ = $1; $1->push_back(*$3); delete $3; }
-                   | param { $$ = new std::vector<std::string>{*$1}; delete $1; }
-param              : opt-declarator TK_IDENT { auto param = new NodeProcParam(*$2); FixPos(param, @2); AddDef(ctx, param); $$ = $2; }
+                   | none { $$ = new std::vector<Ident>(); }
+params1            : params1 TK_COMMA param { $$ = $1; $1->push_back(Ident($3)); }
+                   | param { $$ = new std::vector<Ident>{Ident($1)}; }
+param              : opt-declarator TK_IDENT { auto param = New<NodeProcParam>(ctx, Ident($2)); FixPos(ctx, param, @2); AddDef(ctx, param); $$ = $2; }
 
 opt-comma          : none | TK_COMMA
 
@@ -381,42 +406,42 @@ opt-declarator     : none
                    | declarator
 
 opt-params         : TK_LPAREN params TK_RPAREN { $$ = $2; }
-                   | none { $$ = new std::vector<std::string>(); }
+                   | none { $$ = new std::vector<Ident>(); }
 
 opt-nullparams     : TK_LPAREN TK_RPAREN
                    | none
 
-local              : TK_LOCAL new-scope block { $$ = new NodeLocal(block($3)); FixPos($$, @1); }
+local              : TK_LOCAL new-scope block { $$ = New<NodeLocal>(ctx, block(ctx, $3)); FixPos(ctx, $$, @1); }
 
-if                 : TK_IF cond new-scope block elsifs opt-else { $$ = new NodeIf(exp($2), block($4), std::move(*$5), block($6)); FixPos($$, @1); delete($5); }
+if                 : TK_IF cond new-scope block elsifs opt-else { $$ = New<NodeIf>(ctx, exp(ctx, $2), block(ctx, $4), std::move(*$5), block(ctx, $6)); FixPos(ctx, $$, @1); delete($5); }
 
 elsifs             : none         { $$ = new std::vector<std::shared_ptr<NodeElseIf>>(); }
-                   | elsifs elsif { $$ = $1; $$->push_back(std::shared_ptr<NodeElseIf>($2)); }
+                   | elsifs elsif { $$ = $1; $$->push_back(own(ctx, $2)); }
 
-elsif              : TK_ELSE TK_IF cond new-scope block { $$ = new NodeElseIf(exp($3), block($5)); FixPos($$, @1); }
+elsif              : TK_ELSE TK_IF cond new-scope block { $$ = New<NodeElseIf>(ctx, exp(ctx, $3), block(ctx, $5)); FixPos(ctx, $$, @1); }
 
 opt-else           : TK_ELSE new-scope block { $$ = $3; }
                    | none                    { $$ = NULL; }
 
-alternative        : TK_ALTERNATIVE TK_LPAREN exp TK_RPAREN cases opt-others { $$ = new NodeAlternative(exp($3), std::move(*$5), block($6)); FixPos($$, @1); delete($5); }
+alternative        : TK_ALTERNATIVE TK_LPAREN exp TK_RPAREN cases opt-others { $$ = New<NodeAlternative>(ctx, exp(ctx, $3), std::move(*$5), block(ctx, $6)); FixPos(ctx, $$, @1); delete($5); }
 
 cases              : none       { $$ = new std::vector<std::shared_ptr<NodeCase>>(); }
-                   | cases case { $$ = $1; $$->push_back(std::shared_ptr<NodeCase>($2)); }
+                   | cases case { $$ = $1; $$->push_back(own(ctx, $2)); }
 
-case               : TK_CASE TK_LPAREN exps1 TK_RPAREN new-scope block { $$ = new NodeCase(std::move(*$3), block($6)); FixPos($$, @1); delete $3; }
+case               : TK_CASE TK_LPAREN exps1 TK_RPAREN new-scope block { $$ = New<NodeCase>(ctx, std::move(*$3), block(ctx, $6)); FixPos(ctx, $$, @1); delete $3; }
 
-opt-others         : TK_OTHERS new-scope block  { $$ = $3; FixPos($3, @1); }
+opt-others         : TK_OTHERS new-scope block  { $$ = $3; FixPos(ctx, $3, @1); }
                    | none                       { $$ = NULL; }
 
-loop               : TK_LOOP new-scope block                         { $$ = new NodeLoop(block($3)); FixPos($$, @1); }
-                   | TK_LOOP TK_LPAREN exp TK_RPAREN new-scope block { $$ = new NodeTimes(exp($3), block($6)); FixPos($$, @1); }
+loop               : TK_LOOP new-scope block                         { $$ = New<NodeLoop>(ctx, block(ctx, $3)); FixPos(ctx, $$, @1); }
+                   | TK_LOOP TK_LPAREN exp TK_RPAREN new-scope block { $$ = New<NodeTimes>(ctx, exp(ctx, $3), block(ctx, $6)); FixPos(ctx, $$, @1); }
 
-times              : TK_TIMES TK_LPAREN exp TK_RPAREN new-scope loop-body { $$ = new NodeTimes(exp($3), block($6)); FixPos($$, @1); }
+times              : TK_TIMES TK_LPAREN exp TK_RPAREN new-scope loop-body { $$ = New<NodeTimes>(ctx, exp(ctx, $3), block(ctx, $6)); FixPos(ctx, $$, @1); }
 
-while              : TK_WHILE cond new-scope loop-body { $$ = new NodeWhile(exp($2), block($4)); FixPos($$, @1); }
+while              : TK_WHILE cond new-scope loop-body { $$ = New<NodeWhile>(ctx, exp(ctx, $2), block(ctx, $4)); FixPos(ctx, $$, @1); }
 
-ascent             : TK_ASCENT new-scope TK_LPAREN loop-param TK_IN range TK_RPAREN loop-body { $$ = new NodeAscent(*$4, std::shared_ptr<NodeRange>($6), block($8)); FixPos($$, @1); delete $4; }
-descent            : TK_DESCENT new-scope TK_LPAREN loop-param TK_IN range TK_RPAREN loop-body { $$ = new NodeDescent(*$4, std::shared_ptr<NodeRange>($6), block($8)); FixPos($$, @1); delete $4; }
+ascent             : TK_ASCENT new-scope TK_LPAREN loop-param TK_IN range TK_RPAREN loop-body { $$ = New<NodeAscent>(ctx, Ident($4), own(ctx, $6), block(ctx, $8)); FixPos(ctx, $$, @1); }
+descent            : TK_DESCENT new-scope TK_LPAREN loop-param TK_IN range TK_RPAREN loop-body { $$ = New<NodeDescent>(ctx, Ident($4), own(ctx, $6), block(ctx, $8)); FixPos(ctx, $$, @1); }
 
 loop-body          : TK_LOOP block { $$ = $2; }
                    | block
@@ -425,8 +450,8 @@ header             : TK_HEADER TK_LBRACKET header-params TK_RBRACKET
                        {
                            if (ctx->lexer->GetIncludeStackSize() == 1)
                            {
-                               auto header = new NodeHeader(*$1, std::move(*$3));
-                               FixPos(header, @1);
+                               auto header = New<NodeHeader>(ctx, *$1, std::move(*$3));
+                               FixPos(ctx, header, @1);
                                ctx->headers.push_back(*header);
                                $$ = header;
                            } else
@@ -447,8 +472,8 @@ header             : TK_HEADER TK_LBRACKET header-params TK_RBRACKET
                            {
                                if (ctx->lexer->GetIncludeStackSize() == 1)
                                {
-                                   auto header = new NodeHeader(name, {param});
-                                   FixPos(header, @1);
+                                   auto header = New<NodeHeader>(ctx, name, std::vector<std::wstring>{param});
+                                   FixPos(ctx, header, @1);
                                    ctx->headers.push_back(*header);
                                    $$ = header;
                                } else
@@ -466,43 +491,43 @@ header-params      : header-params header-param { $$ = $1; $1->push_back(*$2); d
                    | header-params TK_COMMA { $$ = $1;}
                    | none { $$ = new std::vector<std::wstring>(); }
 header-param       : TK_STR 
-                   | TK_IDENT { $$ = new std::wstring(ToUnicode(*$1)); delete($1); }
+                   | TK_IDENT { $$ = new std::wstring(ToUnicode(Ident($1))); }
                    | TK_NUM { $$ = new std::wstring(ToUnicode(*$1)); delete($1); }
 
-range              : exp TK_DOTDOT exp { $$ = new NodeRange(exp($1), exp($3)); FixPos($$, @2); }
+range              : exp TK_DOTDOT exp { $$ = New<NodeRange>(ctx, exp(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
 
 cond               : TK_LPAREN exp TK_RPAREN { $$ = $2; }
 
-loop-param         : opt-declarator TK_IDENT { auto param = new NodeLoopParam(*$2); FixPos(param, @2); AddDef(ctx, param); $$ = $2; }
+loop-param         : opt-declarator TK_IDENT { auto param = New<NodeLoopParam>(ctx, Ident($2)); FixPos(ctx, param, @2); AddDef(ctx, param); $$ = $2; }
 
 exps               : exps1 opt-comma { $$ = $1; }
                    | none { $$ = new std::vector<std::shared_ptr<NodeExp>>(); }
-exps1              : exps1 TK_COMMA exp { $$ = $1; $1->push_back(exp($3)); }
-                   | exp { $$ = new std::vector<std::shared_ptr<NodeExp>>{exp($1)}; }
+exps1              : exps1 TK_COMMA exp { $$ = $1; $1->push_back(exp(ctx, $3)); }
+                   | exp { $$ = new std::vector<std::shared_ptr<NodeExp>>{exp(ctx, $1)}; }
 
-return             : TK_RETURN exp { $$ = new NodeReturn(exp($2)); FixPos($$, @1); }
-                   | TK_RETURN     { $$ = new NodeReturnVoid(); FixPos($$, @1); }
+return             : TK_RETURN exp { $$ = New<NodeReturn>(ctx, exp(ctx, $2)); FixPos(ctx, $$, @1); }
+                   | TK_RETURN     { $$ = New<NodeReturnVoid>(ctx); FixPos(ctx, $$, @1); }
 
-left-value         : TK_IDENT indices { $$ = new NodeLeftVal(*$1, std::move(*$2)); FixPos($$, @1); delete($1); delete($2); }
+left-value         : TK_IDENT indices { $$ = New<NodeLeftVal>(ctx, Ident($1), std::move(*$2)); FixPos(ctx, $$, @1); delete($2); }
 
 indices            : indices1
                    | none  { $$ = new std::vector<std::shared_ptr<NodeExp>>(); }
-indices1           : TK_LBRACKET exp TK_RBRACKET          { $$ = new std::vector<std::shared_ptr<NodeExp>>{exp($2)}; }
-                   | indices1 TK_LBRACKET exp TK_RBRACKET { $$ = $1; $1->push_back(exp($3)); }
+indices1           : TK_LBRACKET exp TK_RBRACKET          { $$ = new std::vector<std::shared_ptr<NodeExp>>{exp(ctx, $2)}; }
+                   | indices1 TK_LBRACKET exp TK_RBRACKET { $$ = $1; $1->push_back(exp(ctx, $3)); }
 
 declarator         : TK_LET | TK_REAL | TK_VAR
-var-decl           : declarator TK_IDENT { CheckDupDef(ctx, @2, *$2); } { auto varDecl = new NodeVarDecl(*$2); FixPos(varDecl, @1); AddDef(ctx, varDecl); delete($2); }
+var-decl           : declarator TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } { auto varDecl = New<NodeVarDecl>(ctx, Ident($2)); FixPos(ctx, varDecl, @1); AddDef(ctx, varDecl); }
 
-var-init           : declarator TK_IDENT { CheckDupDef(ctx, @2, *$2); } TK_ASSIGN exp { $$ = new NodeVarInit(*$2, exp($5)); auto varDecl = new NodeVarDecl(*$2); FixPos($$, @1); FixPos(varDecl, @1); AddDef(ctx, varDecl); delete $2; }
+var-init           : declarator TK_IDENT { CheckDupDef(ctx, @2, Ident($2)); } TK_ASSIGN exp { $$ = New<NodeVarInit>(ctx, Ident($2), exp(ctx, $5)); auto varDecl = New<NodeVarDecl>(ctx, Ident($2)); FixPos(ctx, $$, @1); FixPos(ctx, varDecl, @1); AddDef(ctx, varDecl); }
 
-var-assign         : left-value TK_ASSIGN exp    { $$ = new NodeAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_ADDASSIGN exp { $$ = new NodeAddAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_SUBASSIGN exp { $$ = new NodeSubAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_MULASSIGN exp { $$ = new NodeMulAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_DIVASSIGN exp { $$ = new NodeDivAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_REMASSIGN exp { $$ = new NodeRemAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_POWASSIGN exp { $$ = new NodePowAssign(leftval($1), exp($3)); FixPos($$, @2); }
-                   | left-value TK_CATASSIGN exp { $$ = new NodeCatAssign(leftval($1), exp($3)); FixPos($$, @2); }
+var-assign         : left-value TK_ASSIGN exp    { $$ = New<NodeAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_ADDASSIGN exp { $$ = New<NodeAddAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_SUBASSIGN exp { $$ = New<NodeSubAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_MULASSIGN exp { $$ = New<NodeMulAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_DIVASSIGN exp { $$ = New<NodeDivAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_REMASSIGN exp { $$ = New<NodeRemAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_POWASSIGN exp { $$ = New<NodePowAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | left-value TK_CATASSIGN exp { $$ = New<NodeCatAssign>(ctx, leftval(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
 
 exp                : primary
                    | monoop
@@ -510,47 +535,47 @@ exp                : primary
 
 primary            : lit
                    | TK_LPAREN exp TK_RPAREN       { $$ = $2; }
-                   | TK_LABSPAREN exp TK_RABSPAREN { $$ = new NodeAbs(exp($2)); FixPos($$, @1); }
+                   | TK_LABSPAREN exp TK_RABSPAREN { $$ = New<NodeAbs>(ctx, exp(ctx, $2)); FixPos(ctx, $$, @1); }
                    | call-exp
                    | array-access
 
 monoop             : TK_PLUS  exp %prec UPLUS  { $$ = $2; }
-                   | TK_MINUS exp %prec UMINUS { $$ = new NodeNeg(exp($2)); FixPos($$, @1); }
-                   | TK_NOT   exp              { $$ = new NodeNot(exp($2)); FixPos($$, @1); }
-
-binop              : exp TK_PLUS exp  { $$ = new NodeAdd(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_MINUS exp { $$ = new NodeSub(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_MUL exp   { $$ = new NodeMul(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_DIV exp   { $$ = new NodeDiv(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_REM exp   { $$ = new NodeRem(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_POW exp   { $$ = new NodePow(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_CAT exp   { $$ = new NodeCat(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_LT exp    { $$ = new NodeLt(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_GT exp    { $$ = new NodeGt(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_LE exp    { $$ = new NodeLe(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_GE exp    { $$ = new NodeGe(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_EQ exp    { $$ = new NodeEq(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_NE exp    { $$ = new NodeNe(exp($1),exp($3));  FixPos($$, @2); }
-                   | exp TK_AND exp   { $$ = new NodeAnd(exp($1),exp($3)); FixPos($$, @2); }
-                   | exp TK_OR exp    { $$ = new NodeOr(exp($1),exp($3));  FixPos($$, @2); }
-
-call-exp           : TK_IDENT                          { $$ = new NodeNoParenCallExp(*$1); FixPos($$, @1); delete($1); }
-                   | TK_IDENT TK_LPAREN exps TK_RPAREN { $$ = new NodeCallExp(*$1, std::move(*$3)); FixPos($$, @1); delete($1); delete($3); }
-
-lit                : TK_NUM   { $$ = new NodeNum(std::move(*$1));  FixPos($$, @1); delete $1; }
-                   | TK_CHAR  { $$ = new NodeChar($1); FixPos($$, @1); }
+                   | TK_MINUS exp %prec UMINUS { $$ = New<NodeNeg>(ctx, exp(ctx, $2)); FixPos(ctx, $$, @1); }
+                   | TK_NOT   exp              { $$ = New<NodeNot>(ctx, exp(ctx, $2)); FixPos(ctx, $$, @1); }
+
+binop              : exp TK_PLUS exp  { $$ = New<NodeAdd>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_MINUS exp { $$ = New<NodeSub>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_MUL exp   { $$ = New<NodeMul>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_DIV exp   { $$ = New<NodeDiv>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_REM exp   { $$ = New<NodeRem>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_POW exp   { $$ = New<NodePow>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_CAT exp   { $$ = New<NodeCat>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_LT exp    { $$ = New<NodeLt>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_GT exp    { $$ = New<NodeGt>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_LE exp    { $$ = New<NodeLe>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_GE exp    { $$ = New<NodeGe>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_EQ exp    { $$ = New<NodeEq>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_NE exp    { $$ = New<NodeNe>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+                   | exp TK_AND exp   { $$ = New<NodeAnd>(ctx, exp(ctx, $1),exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | exp TK_OR exp    { $$ = New<NodeOr>(ctx, exp(ctx, $1),exp(ctx, $3));  FixPos(ctx, $$, @2); }
+
+call-exp           : TK_IDENT                          { $$ = New<NodeNoParenCallExp>(ctx, Ident($1)); FixPos(ctx, $$, @1); }
+                   | TK_IDENT TK_LPAREN exps TK_RPAREN { $$ = New<NodeCallExp>(ctx, Ident($1), std::move(*$3)); FixPos(ctx, $$, @1); delete($3); }
+
+lit                : TK_NUM   { $$ = New<NodeNum>(ctx, std::move(*$1));  FixPos(ctx, $$, @1); delete $1; }
+                   | TK_CHAR  { $$ = New<NodeChar>(ctx, $1); FixPos(ctx, $$, @1); }
                    | TK_STR
                        {
                            // escape: \x -> x
-                           $$ = new NodeStr(std::regex_replace(*$1, std::wregex(L"\\\\(.)"), L"$1"));  FixPos($$, @1);
+                           $$ = New<NodeStr>(ctx, std::regex_replace(*$1, std::wregex(L"\\\\(.)"), L"$1"));  FixPos(ctx, $$, @1);
                            delete $1 ;
                        }
                    | array
 
-array              : TK_LBRACKET exps TK_RBRACKET { $$ = new NodeArray(std::move(*$2)); FixPos($$, @1); delete($2); }
+array              : TK_LBRACKET exps TK_RBRACKET { $$ = New<NodeArray>(ctx, std::move(*$2)); FixPos(ctx, $$, @1); delete($2); }
 
-array-access       : primary TK_LBRACKET exp TK_RBRACKET   { $$ = new NodeArrayRef(exp($1), exp($3)); FixPos($$, @2); }
-                   | primary TK_LBRACKET range TK_RBRACKET { $$ = new NodeArraySlice(exp($1), std::shared_ptr<NodeRange>($3)); FixPos($$, @2); }
+array-access       : primary TK_LBRACKET exp TK_RBRACKET   { $$ = New<NodeArrayRef>(ctx, exp(ctx, $1), exp(ctx, $3)); FixPos(ctx, $$, @2); }
+                   | primary TK_LBRACKET range TK_RBRACKET { $$ = New<NodeArraySlice>(ctx, exp(ctx, $1), own(ctx, $3)); FixPos(ctx, $$, @2); }
 
 none :
 %%
@@ -8,9 +8,8 @@
 
 namespace bstorm
 {
-class Env;
-// Lがnullptrなら関数を登録せずに環境の作成のみを行う
-std::shared_ptr<Env> CreateInitRootEnv(ScriptType type, const std::wstring& version, lua_State* L);
+// ランタイムを読み込み, 組み込み関数を登録する
+void InitScriptRuntime(ScriptType type, lua_State* L);
 
 class Script;
 Script* GetScript(lua_State* L);
@@ -0,0 +1,179 @@
+﻿#include <bstorm/atlas_packer.hpp>
+
+#include <algorithm>
+#include <climits>
+
+namespace bstorm
+{
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding) :
+    pageWidth_(pageWidth),
+    pageHeight_(pageHeight),
+    padding_(padding)
+{
+}
+
+bool AtlasPacker::Insert(int width, int height, AtlasRegion* region)
+{
+    if (width <= 0 || height <= 0) return false;
+
+    // 右と下に隙間を空けて確保する
+    const int allocWidth = width + padding_;
+    const int allocHeight = height + padding_;
+    if (allocWidth > pageWidth_ || allocHeight > pageHeight_) return false;
+
+    for (int pageIdx = 0; pageIdx <= (int)pages_.size(); pageIdx++)
+    {
+        if (pageIdx == (int)pages_.size())
+        {
+            pages_.emplace_back();
+            InitPage(pages_.back());
+        }
+        auto& page = pages_[pageIdx];
+        int nodeIdx, x, y;
+        if (FindPosition(page, allocWidth, allocHeight, &nodeIdx, &x, &y))
+        {
+            AddSkylineLevel(page, nodeIdx, x, y, allocWidth, allocHeight);
+            page.regionCount++;
+            page.usedArea += (long long)width * height;
+            *region = AtlasRegion(pageIdx, x, y, width, height);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AtlasPacker::ClearPage(int page)
+{
+    if (page < 0 || page >= (int)pages_.size()) return;
+    InitPage(pages_[page]);
+}
+
+int AtlasPacker::GetPageCount() const
+{
+    return pages_.size();
+}
+
+int AtlasPacker::GetPageWidth() const
+{
+    return pageWidth_;
+}
+
+int AtlasPacker::GetPageHeight() const
+{
+    return pageHeight_;
+}
+
+int AtlasPacker::GetPadding() const
+{
+    return padding_;
+}
+
+AtlasPageStats AtlasPacker::GetPageStats(int page) const
+{
+    AtlasPageStats stats;
+    stats.width = pageWidth_;
+    stats.height = pageHeight_;
+    stats.regionCount = 0;
+    stats.usedArea = 0;
+    if (page >= 0 && page < (int)pages_.size())
+    {
+        stats.regionCount = pages_[page].regionCount;
+        stats.usedArea = pages_[page].usedArea;
+    }
+    return stats;
+}
+
+void AtlasPacker::InitPage(Page& page) const
+{
+    page.skyline.clear();
+    page.skyline.push_back(SkylineNode{ 0, 0, pageWidth_ });
+    page.regionCount = 0;
+    page.usedArea = 0;
+}
+
+bool AtlasPacker::FindPosition(const Page& page, int width, int height, int* nodeIdx, int* x, int* y) const
+{
+    // 最も低い位置, 同じ高さなら最も左に置く
+    int bestY = INT_MAX;
+    int bestIdx = -1;
+    const auto& skyline = page.skyline;
+    for (int i = 0; i < (int)skyline.size(); i++)
+    {
+        int left = skyline[i].x;
+        if (left + width > pageWidth_) break;
+        int top = 0;
+        int restWidth = width;
+        for (int j = i; restWidth > 0; j++)
+        {
+            top = std::max(top, skyline[j].y);
+            restWidth -= skyline[j].width;
+        }
+        if (top + height > pageHeight_) continue;
+        if (top < bestY)
+        {
+            bestY = top;
+            bestIdx = i;
+        }
+    }
+    if (bestIdx < 0) return false;
+    *nodeIdx = bestIdx;
+    *x = skyline[bestIdx].x;
+    *y = bestY;
+    return true;
+}
+
+void AtlasPacker::AddSkylineLevel(Page& page, int nodeIdx, int x, int y, int width, int height) const
+{
+    auto& skyline = page.skyline;
+    skyline.insert(skyline.begin() + nodeIdx, SkylineNode{ x, y + height, width });
+
+    // 新しい段に覆われた部分を削る
+    for (int i = nodeIdx + 1; i < (int)skyline.size(); i++)
+    {
+        const auto& prev = skyline[i - 1];
+        auto& node = skyline[i];
+        int prevRight = prev.x + prev.width;
+        if (node.x >= prevRight) break;
+        int shrink = prevRight - node.x;
+        node.x += shrink;
+        node.width -= shrink;
+        if (node.width > 0) break;
+        skyline.erase(skyline.begin() + i);
+        i--;
+    }
+
+    // 同じ高さの段を結合する
+    for (int i = 0; i + 1 < (int)skyline.size(); i++)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+            i--;
+        }
+    }
+}
+
+TextureSwitchCounter::TextureSwitchCounter()
+{
+    Reset();
+}
+
+void TextureSwitchCounter::Count(const void* texture, const void* sourceTexture)
+{
+    if (drawCount_ == 0 || texture != lastTexture_) switchCount_++;
+    if (drawCount_ == 0 || sourceTexture != lastSourceTexture_) sourceSwitchCount_++;
+    lastTexture_ = texture;
+    lastSourceTexture_ = sourceTexture;
+    drawCount_++;
+}
+
+void TextureSwitchCounter::Reset()
+{
+    lastTexture_ = nullptr;
+    lastSourceTexture_ = nullptr;
+    drawCount_ = 0;
+    switchCount_ = 0;
+    sourceSwitchCount_ = 0;
+}
+}
@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <bstorm/rect.hpp>
+
+#include <vector>
+
+namespace bstorm
+{
+// アトラスのページ上に配置された領域
+struct AtlasRegion
+{
+    AtlasRegion() : page(-1), x(0), y(0), width(0), height(0) {}
+    AtlasRegion(int page, int x, int y, int width, int height) : page(page), x(x), y(y), width(width), height(height) {}
+    bool IsValid() const { return page >= 0; }
+    // 元画像上の矩形をページ上の矩形に変換する, 未配置なら恒等変換
+    template <typename T>
+    Rect<T> Remap(const Rect<T>& rect) const
+    {
+        return Rect<T>(rect.left + x, rect.top + y, rect.right + x, rect.bottom + y);
+    }
+    int page;
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+struct AtlasPageStats
+{
+    int width;
+    int height;
+    int regionCount;
+    long long usedArea;
+    float GetOccupancy() const { return (width <= 0 || height <= 0) ? 0.0f : (float)usedArea / ((long long)width * height); }
+};
+
+// スカイライン法による矩形詰め込み
+// 描画デバイスに依存しない
+class AtlasPacker
+{
+public:
+    AtlasPacker(int pageWidth, int pageHeight, int padding);
+    // 領域を確保する, ページより大きければfalse
+    bool Insert(int width, int height, AtlasRegion* region);
+    // ページ内の領域を全て解放する
+    void ClearPage(int page);
+    int GetPageCount() const;
+    int GetPageWidth() const;
+    int GetPageHeight() const;
+    int GetPadding() const;
+    AtlasPageStats GetPageStats(int page) const;
+private:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+    struct Page
+    {
+        std::vector<SkylineNode> skyline;
+        int regionCount;
+        long long usedArea;
+    };
+    void InitPage(Page& page) const;
+    bool FindPosition(const Page& page, int width, int height, int* nodeIdx, int* x, int* y) const;
+    void AddSkylineLevel(Page& page, int nodeIdx, int x, int y, int width, int height) const;
+    const int pageWidth_;
+    const int pageHeight_;
+    const int padding_;
+    std::vector<Page> pages_;
+};
+
+// テクスチャの切り替え回数を数える
+// sourceTextureにはアトラス化する前のテクスチャを渡す
+class TextureSwitchCounter
+{
+public:
+    TextureSwitchCounter();
+    void Count(const void* texture, const void* sourceTexture);
+    void Reset();
+    int GetDrawCount() const { return drawCount_; }
+    int GetSwitchCount() const { return switchCount_; }
+    int GetSourceSwitchCount() const { return sourceSwitchCount_; }
+    // アトラス化によって減った切り替え回数
+    int GetSavedSwitchCount() const { return sourceSwitchCount_ - switchCount_; }
+private:
+    const void* lastTexture_;
+    const void* lastSourceTexture_;
+    int drawCount_;
+    int switchCount_;
+    int sourceSwitchCount_;
+};
+}
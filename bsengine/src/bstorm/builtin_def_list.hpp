@@ -0,0 +1,1116 @@
+﻿// 組み込み定数と組み込み関数の一覧
+// DefineBuiltInsの本体としてインクルードする(インクルードガードは付けない)
+// インクルードする側で以下を用意しておくこと
+//   dnh_const.hpp, node.hpp, builtin_registry.hpp のインクルード
+//   env, reg, type (DefineBuiltInsの引数)
+//   BUILTIN_FUNC(name) : 組み込み関数nameの実装(lua_CFunction)かnullptrに展開されるマクロ
+
+#define constI(name) (AddConstI(env, #name, name))
+#define builtin(name, paramc) (AddBuiltInFunc(env, #name, (paramc), reg, BUILTIN_FUNC(name)))
+#define builtin_real(name, paramc) (AddBuiltInFuncHasRealType(env, #name, (paramc), reg, BUILTIN_FUNC(name)))
+#define builtin_bool(name, paramc) (AddBuiltInFuncHasBoolType(env, #name, (paramc), reg, BUILTIN_FUNC(name)))
+#define builtin_str(name, paramc) (AddBuiltInFuncHasStringType(env, #name, (paramc), reg, BUILTIN_FUNC(name)))
+#define runtime(name, paramc) (AddRuntimeBuiltInFunc(env, #name, (paramc), reg))
+#define runtime_real(name, paramc) (AddRuntimeBuiltInFuncHasRealType(env, #name, (paramc), reg))
+#define runtime_str(name, paramc) (AddRuntimeBuiltInFuncHasStringType(env, #name, (paramc), reg))
+#define TypeIs(typeSet) ((typeSet) & type)
+
+constI(OBJ_PRIMITIVE_2D);
+constI(OBJ_SPRITE_2D);
+constI(OBJ_SPRITE_LIST_2D);
+constI(OBJ_PRIMITIVE_3D);
+constI(OBJ_SPRITE_3D);
+constI(OBJ_TRAJECTORY_3D);
+constI(OBJ_SHADER);
+constI(OBJ_MESH);
+constI(OBJ_TEXT);
+constI(OBJ_SOUND);
+constI(OBJ_FILE_TEXT);
+constI(OBJ_FILE_BINARY);
+constI(OBJ_PARTICLE_LIST_2D);
+
+if (TypeIs(~t_package))
+{
+    constI(OBJ_PLAYER);
+    constI(OBJ_SPELL_MANAGE);
+    constI(OBJ_SPELL);
+    constI(OBJ_ENEMY);
+    constI(OBJ_ENEMY_BOSS);
+    constI(OBJ_ENEMY_BOSS_SCENE);
+    constI(OBJ_SHOT);
+    constI(OBJ_LOOSE_LASER);
+    constI(OBJ_STRAIGHT_LASER);
+    constI(OBJ_CURVE_LASER);
+    constI(OBJ_ITEM);
+
+    constI(ITEM_1UP);
+    constI(ITEM_1UP_S);
+    constI(ITEM_SPELL);
+    constI(ITEM_SPELL_S);
+    constI(ITEM_POWER);
+    constI(ITEM_POWER_S);
+    constI(ITEM_POINT);
+    constI(ITEM_POINT_S);
+    constI(ITEM_USER);
+    constI(ITEM_MOVE_DOWN);
+    constI(ITEM_MOVE_TOPLAYER);
+}
+
+constI(BLEND_NONE);
+constI(BLEND_ALPHA);
+constI(BLEND_ADD_RGB);
+constI(BLEND_ADD_ARGB);
+constI(BLEND_MULTIPLY);
+constI(BLEND_SUBTRACT);
+constI(BLEND_SHADOW);
+constI(BLEND_INV_DESTRGB);
+
+	constI(FILTER_NONE); //FP FILTER
+	constI(FILTER_LINEAR); //FP FILTER
+
+	constI(IP_LINEAR_1X);
+	constI(IP_ACCEL_2X);
+	constI(IP_ACCEL_3X);
+	constI(IP_ACCEL_4X);
+	constI(IP_ACCEL_5X);
+	constI(IP_DECEL_2X);
+	constI(IP_DECEL_3X);
+	constI(IP_DECEL_4X);
+	constI(IP_DECEL_5X);
+	constI(IP_SMOOTH_2X);
+	constI(IP_SMOOTH_3X);
+	constI(IP_SMOOTH_4X);
+	constI(IP_SMOOTH_5X);
+
+constI(PRIMITIVE_TRIANGLEFAN);
+constI(PRIMITIVE_TRIANGLESTRIP);
+constI(PRIMITIVE_TRIANGLELIST);
+constI(PRIMITIVE_LINESTRIP);
+constI(PRIMITIVE_LINELIST);
+constI(PRIMITIVE_POINT_LIST);
+
+constI(BORDER_NONE);
+constI(BORDER_FULL);
+constI(BORDER_SHADOW);
+
+constI(TYPE_SCRIPT_ALL);
+constI(TYPE_SCRIPT_PLAYER);
+constI(TYPE_SCRIPT_SINGLE);
+constI(TYPE_SCRIPT_PLURAL);
+constI(TYPE_SCRIPT_STAGE);
+constI(TYPE_SCRIPT_PACKAGE);
+
+constI(VK_LEFT);
+constI(VK_RIGHT);
+constI(VK_UP);
+constI(VK_DOWN);
+constI(VK_OK);
+constI(VK_CANCEL);
+constI(VK_SHOT);
+constI(VK_BOMB);
+constI(VK_SPELL);
+constI(VK_SLOWMOVE);
+constI(VK_USER1);
+constI(VK_USER2);
+constI(VK_PAUSE);
+constI(VK_USER_ID_STAGE);
+constI(VK_USER_ID_PLAYER);
+
+constI(KEY_INVALID);
+constI(KEY_ESCAPE);
+constI(KEY_1);
+constI(KEY_2);
+constI(KEY_3);
+constI(KEY_4);
+constI(KEY_5);
+constI(KEY_6);
+constI(KEY_7);
+constI(KEY_8);
+constI(KEY_9);
+constI(KEY_0);
+constI(KEY_MINUS);
+constI(KEY_EQUALS);
+constI(KEY_BACK);
+constI(KEY_TAB);
+constI(KEY_Q);
+constI(KEY_W);
+constI(KEY_E);
+constI(KEY_R);
+constI(KEY_T);
+constI(KEY_Y);
+constI(KEY_U);
+constI(KEY_I);
+constI(KEY_O);
+constI(KEY_P);
+constI(KEY_LBRACKET);
+constI(KEY_RBRACKET);
+constI(KEY_RETURN);
+constI(KEY_LCONTROL);
+constI(KEY_A);
+constI(KEY_S);
+constI(KEY_D);
+constI(KEY_F);
+constI(KEY_G);
+constI(KEY_H);
+constI(KEY_J);
+constI(KEY_K);
+constI(KEY_L);
+constI(KEY_SEMICOLON);
+constI(KEY_APOSTROPHE);
+constI(KEY_GRAVE);
+constI(KEY_LSHIFT);
+constI(KEY_BACKSLASH);
+constI(KEY_Z);
+constI(KEY_X);
+constI(KEY_C);
+constI(KEY_V);
+constI(KEY_B);
+constI(KEY_N);
+constI(KEY_M);
+constI(KEY_COMMA);
+constI(KEY_PERIOD);
+constI(KEY_SLASH);
+constI(KEY_RSHIFT);
+constI(KEY_MULTIPLY);
+constI(KEY_LMENU);
+constI(KEY_SPACE);
+constI(KEY_CAPITAL);
+constI(KEY_F1);
+constI(KEY_F2);
+constI(KEY_F3);
+constI(KEY_F4);
+constI(KEY_F5);
+constI(KEY_F6);
+constI(KEY_F7);
+constI(KEY_F8);
+constI(KEY_F9);
+constI(KEY_F10);
+constI(KEY_NUMLOCK);
+constI(KEY_SCROLL);
+constI(KEY_NUMPAD7);
+constI(KEY_NUMPAD8);
+constI(KEY_NUMPAD9);
+constI(KEY_SUBTRACT);
+constI(KEY_NUMPAD4);
+constI(KEY_NUMPAD5);
+constI(KEY_NUMPAD6);
+constI(KEY_ADD);
+constI(KEY_NUMPAD1);
+constI(KEY_NUMPAD2);
+constI(KEY_NUMPAD3);
+constI(KEY_NUMPAD0);
+constI(KEY_DECIMAL);
+constI(KEY_F11);
+constI(KEY_F12);
+constI(KEY_F13);
+constI(KEY_F14);
+constI(KEY_F15);
+constI(KEY_KANA);
+constI(KEY_CONVERT);
+constI(KEY_NOCONVERT);
+constI(KEY_YEN);
+constI(KEY_NUMPADEQUALS);
+constI(KEY_CIRCUMFLEX);
+constI(KEY_AT);
+constI(KEY_COLON);
+constI(KEY_UNDERLINE);
+constI(KEY_KANJI);
+constI(KEY_STOP);
+constI(KEY_AX);
+constI(KEY_UNLABELED);
+constI(KEY_NUMPADENTER);
+constI(KEY_RCONTROL);
+constI(KEY_NUMPADCOMMA);
+constI(KEY_DIVIDE);
+constI(KEY_SYSRQ);
+constI(KEY_RMENU);
+constI(KEY_PAUSE);
+constI(KEY_HOME);
+constI(KEY_UP);
+constI(KEY_PRIOR);
+constI(KEY_LEFT);
+constI(KEY_RIGHT);
+constI(KEY_END);
+constI(KEY_DOWN);
+constI(KEY_NEXT);
+constI(KEY_INSERT);
+constI(KEY_DELETE);
+constI(KEY_LWIN);
+constI(KEY_RWIN);
+constI(KEY_APPS);
+constI(KEY_POWER);
+constI(KEY_SLEEP);
+
+constI(MOUSE_LEFT);
+constI(MOUSE_RIGHT);
+constI(MOUSE_MIDDLE);
+
+constI(KEY_FREE);
+constI(KEY_PUSH);
+constI(KEY_PULL);
+constI(KEY_HOLD);
+
+constI(ALIGNMENT_LEFT);
+constI(ALIGNMENT_RIGHT);
+constI(ALIGNMENT_CENTER);
+
+constI(SOUND_BGM);
+constI(SOUND_SE);
+constI(SOUND_VOICE);
+
+constI(RESULT_CANCEL);
+constI(RESULT_END);
+constI(RESULT_RETRY);
+constI(RESULT_SAVE_REPLAY);
+
+constI(REPLAY_INDEX_ACTIVE);
+constI(REPLAY_INDEX_DIGIT_MIN);
+constI(REPLAY_FILE_PATH);
+constI(REPLAY_DATE_TIME);
+constI(REPLAY_USER_NAME);
+constI(REPLAY_TOTAL_SCORE);
+constI(REPLAY_FPS_AVERAGE);
+constI(REPLAY_PLAYER_NAME);
+constI(REPLAY_STAGE_INDEX_LIST);
+constI(REPLAY_STAGE_START_SCORE_LIST);
+constI(REPLAY_STAGE_LAST_SCORE_LIST);
+constI(REPLAY_COMMENT);
+constI(REPLAY_INDEX_DIGIT_MAX);
+constI(REPLAY_INDEX_USER);
+
+if (TypeIs(~t_package))
+{
+    constI(EV_REQUEST_LIFE);
+    constI(EV_REQUEST_TIMER);
+    constI(EV_REQUEST_IS_SPELL);
+    constI(EV_REQUEST_IS_LAST_SPELL);
+    constI(EV_REQUEST_IS_DURABLE_SPELL);
+    constI(EV_REQUEST_SPELL_SCORE);
+    constI(EV_REQUEST_REPLAY_TARGET_COMMON_AREA);
+    constI(EV_TIMEOUT);
+    constI(EV_START_BOSS_SPELL);
+    constI(EV_GAIN_SPELL);
+    constI(EV_START_BOSS_STEP);
+    constI(EV_END_BOSS_STEP);
+    constI(EV_PLAYER_SHOOTDOWN);
+    constI(EV_PLAYER_SPELL);
+    constI(EV_PLAYER_REBIRTH);
+    constI(EV_PAUSE_ENTER);
+    constI(EV_PAUSE_LEAVE);
+}
+
+if (TypeIs(t_shot_custom))
+{
+    constI(EV_DELETE_SHOT_IMMEDIATE);
+    constI(EV_DELETE_SHOT_FADE);
+}
+if (TypeIs(t_shot_custom | t_item_custom))
+{
+    constI(EV_DELETE_SHOT_TO_ITEM);
+}
+
+if (TypeIs(t_player))
+{
+    constI(EV_REQUEST_SPELL);
+    constI(EV_GRAZE);
+    constI(EV_HIT);
+}
+
+if (TypeIs(t_player | t_item_custom))
+{
+    constI(EV_GET_ITEM);
+}
+
+constI(EV_USER_COUNT);
+constI(EV_USER);
+constI(EV_USER_SYSTEM);
+constI(EV_USER_STAGE);
+constI(EV_USER_PLAYER);
+constI(EV_USER_PACKAGE);
+
+constI(INFO_SCRIPT_TYPE);
+constI(INFO_SCRIPT_PATH);
+constI(INFO_SCRIPT_ID);
+constI(INFO_SCRIPT_TITLE);
+constI(INFO_SCRIPT_TEXT);
+constI(INFO_SCRIPT_IMAGE);
+constI(INFO_SCRIPT_REPLAY_NAME);
+
+if (TypeIs(~t_package))
+{
+    constI(INFO_LIFE);
+    constI(INFO_DAMAGE_RATE_SHOT);
+    constI(INFO_DAMAGE_RATE_SPELL);
+    constI(INFO_SHOT_HIT_COUNT);
+    constI(INFO_TIMER);
+    constI(INFO_TIMERF);
+    constI(INFO_ORGTIMERF);
+    constI(INFO_IS_SPELL);
+    constI(INFO_IS_LAST_SPELL);
+    constI(INFO_IS_DURABLE_SPELL);
+    constI(INFO_SPELL_SCORE);
+    constI(INFO_REMAIN_STEP_COUNT);
+    constI(INFO_ACTIVE_STEP_LIFE_COUNT);
+    constI(INFO_ACTIVE_STEP_TOTAL_MAX_LIFE);
+    constI(INFO_ACTIVE_STEP_TOTAL_LIFE);
+    constI(INFO_ACTIVE_STEP_LIFE_RATE_LIST);
+    constI(INFO_IS_LAST_STEP);
+    constI(INFO_PLAYER_SHOOTDOWN_COUNT);
+    constI(INFO_PLAYER_SPELL_COUNT);
+    constI(INFO_CURRENT_LIFE);
+    constI(INFO_CURRENT_LIFE_MAX);
+    constI(INFO_ITEM_SCORE);
+    constI(INFO_RECT);
+    constI(INFO_DELAY_COLOR);
+    constI(INFO_BLEND);
+    constI(INFO_COLLISION);
+    constI(INFO_COLLISION_LIST);
+
+    constI(STATE_NORMAL);
+    constI(STATE_HIT);
+    constI(STATE_DOWN);
+    constI(STATE_END);
+
+    constI(TYPE_ITEM);
+    constI(TYPE_ALL);
+    constI(TYPE_SHOT);
+    constI(TYPE_CHILD);
+    constI(TYPE_IMMEDIATE);
+    constI(TYPE_FADE);
+
+    constI(TARGET_PLAYER);
+    constI(TARGET_ENEMY);
+    constI(TARGET_ALL);
+
+    constI(NO_CHANGE);
+}
+
+constI(ID_INVALID);
+
+if (TypeIs(t_package))
+{
+    constI(STAGE_STATE_FINISHED);
+    constI(STAGE_RESULT_BREAK_OFF);
+    constI(STAGE_RESULT_PLAYER_DOWN);
+    constI(STAGE_RESULT_CLEARED);
+}
+
+constI(CODE_ACP);
+constI(CODE_UTF8);
+constI(CODE_UTF16LE);
+constI(CODE_UTF16BE);
+constI(ENDIAN_LITTLE);
+constI(ENDIAN_BIG);
+
+constI(CULL_NONE);
+constI(CULL_CW);
+constI(CULL_CCW);
+
+AddConst(env, "pi", "3.141592653589793", ExpType::REAL);
+AddConst(env, "true", "true", ExpType::BOOL);
+AddConst(env, "false", "false", ExpType::BOOL);
+
+runtime(concatenate, 2);
+runtime(add, 2);
+runtime(subtract, 2);
+runtime_real(multiply, 2);
+runtime_real(divide, 2);
+runtime_real(remainder, 2);
+runtime_real(power, 2);
+runtime(index_, 2);
+runtime(slice, 3);
+runtime(not, 1);
+runtime_real(negative, 1);
+runtime(successor, 1);
+runtime(predecessor, 1);
+runtime(append, 2);
+runtime(erase, 2);
+runtime_real(compare, 2);
+runtime_real(length, 1);
+
+runtime_real(min, 2);
+runtime_real(max, 2);
+runtime_real(log, 1);
+runtime_real(log10, 1);
+runtime_real(cos, 1);
+runtime_real(sin, 1);
+runtime_real(tan, 1);
+runtime_real(acos, 1);
+runtime_real(asin, 1);
+runtime_real(atan, 1);
+runtime_real(atan2, 2);
+runtime_real(rand, 2);
+runtime_real(round, 1);
+runtime_real(truncate, 1);
+runtime_real(trunc, 1);
+runtime_real(ceil, 1);
+runtime_real(floor, 1);
+runtime_real(absolute, 1);
+runtime_real(modc, 2);
+
+	builtin_real(Interpolate, 5);
+
+builtin(InstallFont, 1);
+builtin_str(ToString, 1);
+runtime_str(IntToString, 1);
+runtime_str(itoa, 1);
+runtime_str(rtoa, 1);
+builtin_real(atoi, 1);
+builtin_real(ator, 1);
+builtin(TrimString, 1);
+builtin(rtos, 2);
+builtin(vtos, 2);
+builtin(SplitString, 2);
+
+builtin(GetFileDirectory, 1);
+builtin(GetFilePathList, 1);
+builtin(GetDirectoryList, 1);
+builtin_str(GetModuleDirectory, 0);
+
+if (TypeIs(~t_package))
+{
+    builtin_str(GetMainStgScriptPath, 0);
+}
+
+builtin(GetMainPackageScriptPath, 0);
+
+if (TypeIs(~t_package))
+{
+    builtin_str(GetMainStgScriptDirectory, 0);
+}
+
+AddBuiltInFunc(env, "GetCurrentScriptDirectory", 0, reg, nullptr)->retType = ExpType::STRING;
+builtin(GetScriptPathList, 2);
+
+builtin(GetCurrentDateTimeS, 0);
+builtin_real(GetStageTime, 0);
+builtin_real(GetPackageTime, 0);
+builtin_real(GetCurrentFps, 0);
+
+if (TypeIs(~t_package))
+{
+    builtin_real(GetReplayFps, 0);
+}
+
+SetStrParams(builtin(WriteLog, 1), { 0 });
+SetStrParams(builtin(RaiseError, 1), { 0 });
+builtin(assert, 2);
+
+SetStrParams(builtin(SetCommonData, 2), { 0 });
+SetStrParams(builtin(GetCommonData, 2), { 0 });
+builtin(ClearCommonData, 0);
+SetStrParams(builtin(DeleteCommonData, 1), { 0 });
+SetStrParams(builtin(SetAreaCommonData, 3), { 0, 1 });
+SetStrParams(builtin(GetAreaCommonData, 3), { 0, 1 });
+builtin(ClearAreaCommonData, 1);
+builtin(DeleteAreaCommonData, 2);
+builtin(CreateCommonDataArea, 1);
+builtin_bool(IsCommonDataAreaExists, 1);
+builtin(CopyCommonDataArea, 2);
+builtin(GetCommonDataAreaKeyList, 0);
+builtin(GetCommonDataValueKeyList, 1);
+builtin_bool(SaveCommonDataAreaA1, 1);
+builtin_bool(LoadCommonDataAreaA1, 1);
+builtin_bool(SaveCommonDataAreaA2, 2);
+builtin_bool(LoadCommonDataAreaA2, 2);
+
+if (TypeIs(~t_package))
+{
+    builtin_bool(SaveCommonDataAreaToReplayFile, 1);
+    builtin_bool(LoadCommonDataAreaFromReplayFile, 1);
+}
+
+builtin(LoadSound, 1);
+builtin(RemoveSound, 1);
+builtin(PlayBGM, 3);
+builtin(PlaySE, 1);
+builtin(StopSound, 1);
+	builtin(LoadSoundStream, 1);
+	builtin(RemoveSoundStream, 1);
+	builtin(StreamBGM, 3);
+	builtin(StreamSE, 1);
+	builtin(StopSoundStream, 1);
+
+builtin_real(GetVirtualKeyState, 1);
+builtin(SetVirtualKeyState, 2);
+builtin(AddVirtualKey, 3);
+builtin(AddReplayTargetVirtualKey, 1);
+builtin_real(GetKeyState, 1);
+builtin_real(GetMouseState, 1);
+builtin_real(GetMouseX, 0);
+builtin_real(GetMouseY, 0);
+builtin_real(GetMouseMoveZ, 0);
+builtin(SetSkipModeKey, 1);
+builtin(LoadTexture, 1);
+builtin(LoadTextureInLoadThread, 1);
+builtin(RemoveTexture, 1);
+builtin_real(GetTextureWidth, 1);
+builtin_real(GetTextureHeight, 1);
+builtin(SetFogEnable, 1);
+builtin(SetFogParam, 5);
+builtin(ClearInvalidRenderPriority, 0);
+builtin(SetInvalidRenderPriorityA1, 2);
+builtin(GetReservedRenderTargetName, 1);
+builtin_bool(CreateRenderTarget, 1);
+builtin(RenderToTextureA1, 4);
+builtin(RenderToTextureB1, 3);
+builtin(SaveRenderedTextureA1, 2);
+builtin(SaveRenderedTextureA2, 6);
+builtin(SaveSnapShotA1, 1);
+builtin(SaveSnapShotA2, 5);
+builtin_bool(IsSaveImageCompleted, 1);
+builtin_bool(IsPixelShaderSupported, 2);
+builtin(SetShader, 3);
+builtin(SetShaderI, 3);
+builtin(ResetShader, 2);
+builtin(ResetShaderI, 2);
+
+builtin(SetCameraFocusX, 1);
+builtin(SetCameraFocusY, 1);
+builtin(SetCameraFocusZ, 1);
+builtin(SetCameraFocusXYZ, 3);
+builtin(SetCameraRadius, 1);
+builtin(SetCameraAzimuthAngle, 1);
+builtin(SetCameraElevationAngle, 1);
+builtin(SetCameraYaw, 1);
+builtin(SetCameraPitch, 1);
+builtin(SetCameraRoll, 1);
+
+builtin_real(GetCameraX, 0);
+builtin_real(GetCameraY, 0);
+builtin_real(GetCameraZ, 0);
+builtin_real(GetCameraFocusX, 0);
+builtin_real(GetCameraFocusY, 0);
+builtin_real(GetCameraFocusZ, 0);
+builtin_real(GetCameraRadius, 0);
+builtin_real(GetCameraAzimuthAngle, 0);
+builtin_real(GetCameraElevationAngle, 0);
+builtin_real(GetCameraYaw, 0);
+builtin_real(GetCameraPitch, 0);
+builtin_real(GetCameraRoll, 0);
+builtin(SetCameraPerspectiveClip, 2);
+
+builtin(Set2DCameraFocusX, 1);
+builtin(Set2DCameraFocusY, 1);
+builtin(Set2DCameraAngleZ, 1);
+builtin(Set2DCameraRatio, 1);
+builtin(Set2DCameraRatioX, 1);
+builtin(Set2DCameraRatioY, 1);
+builtin(Reset2DCamera, 0);
+builtin_real(Get2DCameraX, 0);
+builtin_real(Get2DCameraY, 0);
+builtin_real(Get2DCameraAngleZ, 0);
+builtin_real(Get2DCameraRatio, 0);
+builtin_real(Get2DCameraRatioX, 0);
+builtin_real(Get2DCameraRatioY, 0);
+
+builtin(LoadScript, 1);
+builtin(LoadScriptInThread, 1);
+builtin(StartScript, 1);
+builtin(CloseScript, 1);
+builtin_bool(IsCloseScript, 1);
+builtin(SetScriptArgument, 3);
+builtin(GetScriptArgument, 1);
+builtin(GetScriptArgumentCount, 0);
+
+if (TypeIs(~t_package))
+{
+    builtin(CloseStgScene, 0);
+}
+
+builtin_real(GetOwnScriptID, 0);
+runtime_real(GetEventType, 0);
+runtime(GetEventArgument, 1);
+builtin(SetScriptResult, 1);
+builtin(GetScriptResult, 1);
+builtin(SetAutoDeleteObject, 1);
+builtin(NotifyEvent, 3);
+builtin(NotifyEventAll, 2);
+builtin(GetScriptInfoA1, 2);
+
+if (TypeIs(~t_package))
+{
+    builtin(SetStgFrame, 6);
+}
+builtin_real(GetScore, 0);
+builtin(AddScore, 1);
+builtin_real(GetGraze, 0);
+builtin(AddGraze, 1);
+builtin_real(GetPoint, 0);
+builtin(AddPoint, 1);
+if (TypeIs(~t_package))
+{
+    builtin(SetItemRenderPriorityI, 1);
+    builtin(SetShotRenderPriorityI, 1);
+    builtin_real(GetStgFrameRenderPriorityMinI, 0);
+    builtin_real(GetStgFrameRenderPriorityMaxI, 0);
+    builtin_real(GetItemRenderPriorityI, 0);
+    builtin_real(GetShotRenderPriorityI, 0);
+    builtin_real(GetPlayerRenderPriorityI, 0);
+    builtin_real(GetCameraFocusPermitPriorityI, 0);
+}
+builtin_real(GetStgFrameLeft, 0);
+builtin_real(GetStgFrameTop, 0);
+builtin_real(GetStgFrameWidth, 0);
+builtin_real(GetStgFrameHeight, 0);
+builtin_real(GetScreenWidth, 0);
+builtin_real(GetScreenHeight, 0);
+builtin_bool(IsReplay, 0);
+builtin(AddArchiveFile, 1);
+
+if (TypeIs(~t_package))
+{
+    builtin_real(SCREEN_WIDTH, 0);
+    builtin_real(SCREEN_HEIGHT, 0);
+    builtin_real(GetPlayerObjectID, 0);
+    builtin_real(GetPlayerScriptID, 0);
+    builtin(SetPlayerSpeed, 2);
+    builtin(SetPlayerClip, 4);
+    builtin(SetPlayerLife, 1);
+    builtin(SetPlayerSpell, 1);
+    builtin(SetPlayerPower, 1);
+    builtin(SetPlayerInvincibilityFrame, 1);
+    builtin(SetPlayerDownStateFrame, 1);
+    builtin(SetPlayerRebirthFrame, 1);
+    builtin(SetPlayerRebirthLossFrame, 1);
+    builtin(SetPlayerAutoItemCollectLine, 1);
+    builtin(SetForbidPlayerShot, 1);
+    builtin(SetForbidPlayerSpell, 1);
+    builtin_real(GetPlayerX, 0);
+    builtin_real(GetPlayerY, 0);
+    builtin_real(GetPlayerState, 0);
+    builtin_real(GetPlayerSpeed, 0);
+    builtin(GetPlayerClip, 0);
+    builtin_real(GetPlayerLife, 0);
+    builtin_real(GetPlayerSpell, 0);
+    builtin_real(GetPlayerPower, 0);
+    builtin_real(GetPlayerInvincibilityFrame, 0);
+    builtin_real(GetPlayerDownStateFrame, 0);
+    builtin_real(GetPlayerRebirthFrame, 0);
+    builtin_bool(IsPermitPlayerShot, 0);
+    builtin_bool(IsPermitPlayerSpell, 0);
+    builtin_bool(IsPlayerLastSpellWait, 0);
+    builtin_bool(IsPlayerSpellActive, 0);
+    builtin_real(GetAngleToPlayer, 1);
+}
+
+builtin_str(GetPlayerID, 0);
+builtin_str(GetPlayerReplayName, 0);
+
+if (TypeIs(~t_package))
+{
+    builtin(GetEnemyIntersectionPosition, 3);
+    builtin(GetEnemyBossSceneObjectID, 0);
+    builtin(GetEnemyBossObjectID, 0);
+    builtin(GetAllEnemyID, 0);
+    builtin(GetIntersectionRegistedEnemyID, 0);
+    builtin(GetAllEnemyIntersectionPosition, 0);
+    builtin(GetEnemyIntersectionPositionByIdA1, 1);
+    builtin(GetEnemyIntersectionPositionByIdA2, 3);
+    builtin(LoadEnemyShotData, 1);
+    builtin(ReloadEnemyShotData, 1);
+
+    builtin(DeleteShotAll, 2);
+    builtin(DeleteShotInCircle, 5);
+    builtin_real(CreateShotA1, 6);
+    builtin_real(CreateShotA2, 8);
+    builtin_real(CreateShotOA1, 5);
+    builtin_real(CreateShotB1, 6);
+    builtin_real(CreateShotB2, 10);
+    builtin_real(CreateShotOB1, 5);
+    builtin_real(CreateLooseLaserA1, 8);
+    builtin_real(CreateStraightLaserA1, 8);
+    builtin_real(CreateCurveLaserA1, 8);
+    builtin(SetShotIntersectionCircle, 3);
+    builtin(SetShotIntersectionLine, 5);
+    builtin(GetShotIdInCircleA1, 3);
+    builtin(GetShotIdInCircleA2, 4);
+    builtin_real(GetShotCount, 1);
+    builtin(SetShotAutoDeleteClip, 4);
+    builtin(GetShotDataInfoA1, 3);
+    builtin(StartShotScript, 1);
+
+    builtin_real(CreateItemA1, 4);
+    builtin_real(CreateItemA2, 6);
+    builtin_real(CreateItemU1, 4);
+    builtin_real(CreateItemU2, 6);
+    builtin(CollectAllItems, 0);
+    builtin(CollectItemsByType, 1);
+    builtin(CollectItemsInCircle, 3);
+    builtin(CancelCollectItems, 0);
+    builtin(StartItemScript, 1);
+    builtin(SetDefaultBonusItemEnable, 1);
+    builtin(LoadItemData, 1);
+    builtin(ReloadItemData, 1);
+    builtin(StartSlow, 2);
+    builtin(StopSlow, 1);
+    builtin_bool(IsIntersected_Line_Circle, 8);
+    builtin_bool(IsIntersected_Obj_Obj, 2);
+}
+
+builtin_real(GetObjectDistance, 2);
+builtin(GetObject2dPosition, 1);
+builtin(Get2dPosition, 3);
+
+builtin(Obj_Delete, 1);
+builtin_bool(Obj_IsDeleted, 1);
+builtin(Obj_SetVisible, 2);
+builtin_bool(Obj_IsVisible, 1);
+builtin(Obj_SetRenderPriority, 2);
+builtin(Obj_SetRenderPriorityI, 2);
+builtin_real(Obj_GetRenderPriority, 1);
+builtin_real(Obj_GetRenderPriorityI, 1);
+builtin(Obj_GetValue, 2);
+builtin(Obj_GetValueD, 3);
+builtin(Obj_SetValue, 3);
+builtin(Obj_DeleteValue, 2);
+builtin_bool(Obj_IsValueExists, 2);
+builtin_real(Obj_GetType, 1);
+
+builtin(ObjRender_SetX, 2);
+builtin(ObjRender_SetY, 2);
+builtin(ObjRender_SetZ, 2);
+builtin(ObjRender_SetPosition, 4);
+builtin(ObjRender_SetAngleX, 2);
+builtin(ObjRender_SetAngleY, 2);
+builtin(ObjRender_SetAngleZ, 2);
+builtin(ObjRender_SetAngleXYZ, 4);
+builtin(ObjRender_SetScaleX, 2);
+builtin(ObjRender_SetScaleY, 2);
+builtin(ObjRender_SetScaleZ, 2);
+builtin(ObjRender_SetScaleXYZ, 4);
+builtin(ObjRender_SetColor, 4);
+builtin(ObjRender_SetColorHSV, 4);
+builtin(ObjRender_SetAlpha, 2);
+builtin(ObjRender_SetBlendType, 2);
+builtin(ObjRender_SetFilterType, 2); //FP FILTER
+
+builtin_real(ObjRender_GetX, 1);
+builtin_real(ObjRender_GetY, 1);
+builtin_real(ObjRender_GetZ, 1);
+builtin_real(ObjRender_GetAngleX, 1);
+builtin_real(ObjRender_GetAngleY, 1);
+builtin_real(ObjRender_GetAngleZ, 1);
+builtin_real(ObjRender_GetScaleX, 1);
+builtin_real(ObjRender_GetScaleY, 1);
+builtin_real(ObjRender_GetScaleZ, 1);
+builtin_real(ObjRender_GetBlendType, 1);
+
+builtin(ObjRender_SetZWrite, 2);
+builtin(ObjRender_SetZTest, 2);
+builtin(ObjRender_SetFogEnable, 2);
+builtin(ObjRender_SetPermitCamera, 2);
+builtin(ObjRender_SetCullingMode, 2);
+
+builtin_real(ObjPrim_Create, 1);
+builtin(ObjPrim_SetPrimitiveType, 2);
+builtin(ObjPrim_SetVertexCount, 2);
+builtin_real(ObjPrim_GetVertexCount, 1);
+SetStrParams(builtin(ObjPrim_SetTexture, 2), { 1 });
+builtin(ObjPrim_SetVertexPosition, 5);
+builtin(ObjPrim_GetVertexPosition, 2);
+builtin(ObjPrim_SetVertexUV, 4);
+builtin(ObjPrim_SetVertexUVT, 4);
+builtin(ObjPrim_SetVertexColor, 5);
+builtin(ObjPrim_SetVertexAlpha, 3);
+builtin(ObjPrim_SetVertexPositionArray, 3);
+builtin(ObjPrim_SetVertexUVArray, 3);
+builtin(ObjPrim_SetVertexUVTArray, 3);
+builtin(ObjPrim_SetVertexColorArray, 3);
+builtin(ObjPrim_SetVertexAlphaArray, 3);
+
+builtin(ObjSprite2D_SetSourceRect, 5);
+builtin(ObjSprite2D_SetDestRect, 5);
+builtin(ObjSprite2D_SetDestCenter, 1);
+
+builtin(ObjSpriteList2D_SetSourceRect, 5);
+builtin(ObjSpriteList2D_SetDestRect, 5);
+builtin(ObjSpriteList2D_SetDestCenter, 1);
+builtin(ObjSpriteList2D_AddVertex, 1);
+builtin(ObjSpriteList2D_Reserve, 2);
+builtin(ObjSpriteList2D_CloseVertex, 1);
+builtin(ObjSpriteList2D_ClearVertexCount, 1);
+
+builtin(ObjParticleList2D_SetSourceRect, 5);
+builtin(ObjParticleList2D_SetDestRect, 5);
+builtin(ObjParticleList2D_SetDestCenter, 1);
+builtin(ObjParticleList2D_SetAcceleration, 3);
+builtin(ObjParticleList2D_SetColorCurve, 7);
+builtin(ObjParticleList2D_SetAlphaCurve, 3);
+builtin(ObjParticleList2D_SetScaleCurve, 3);
+builtin(ObjParticleList2D_AddParticle, 6);
+builtin(ObjParticleList2D_AddParticlesA1, 9);
+builtin(ObjParticleList2D_AddParticlesA2, 4);
+builtin(ObjParticleList2D_Reserve, 2);
+builtin(ObjParticleList2D_ClearParticles, 1);
+builtin_real(ObjParticleList2D_GetParticleCount, 1);
+
+builtin(ObjSprite3D_SetSourceRect, 5);
+builtin(ObjSprite3D_SetDestRect, 5);
+builtin(ObjSprite3D_SetSourceDestRect, 5);
+builtin(ObjSprite3D_SetBillboard, 2);
+
+builtin(ObjTrajectory3D_SetComplementCount, 2);
+builtin(ObjTrajectory3D_SetAlphaVariation, 2);
+builtin(ObjTrajectory3D_SetInitialPoint, 7);
+
+builtin_real(ObjMesh_Create, 0);
+builtin(ObjMesh_Load, 2);
+builtin(ObjMesh_SetColor, 4);
+builtin(ObjMesh_SetAlpha, 2);
+builtin(ObjMesh_SetAnimation, 3);
+builtin(ObjMesh_SetCoordinate2D, 2);
+builtin(ObjMesh_GetPath, 1);
+
+builtin_real(ObjText_Create, 0);
+SetStrParams(builtin(ObjText_SetText, 2), { 1 });
+SetStrParams(builtin(ObjText_SetFontType, 2), { 1 });
+builtin(ObjText_SetFontSize, 2);
+builtin(ObjText_SetFontBold, 2);
+builtin(ObjText_SetFontColorTop, 4);
+builtin(ObjText_SetFontColorBottom, 4);
+builtin(ObjText_SetFontBorderWidth, 2);
+builtin(ObjText_SetFontBorderType, 2);
+builtin(ObjText_SetFontBorderColor, 4);
+
+builtin(ObjText_SetMaxWidth, 2);
+builtin(ObjText_SetMaxHeight, 2);
+builtin(ObjText_SetLinePitch, 2);
+builtin(ObjText_SetSidePitch, 2);
+builtin(ObjText_SetTransCenter, 3);
+builtin(ObjText_SetAutoTransCenter, 2);
+builtin(ObjText_SetHorizontalAlignment, 2);
+builtin(ObjText_SetSyntacticAnalysis, 2);
+builtin_real(ObjText_GetTextLength, 1);
+builtin_real(ObjText_GetTextLengthCU, 1);
+builtin(ObjText_GetTextLengthCUL, 1);
+builtin_real(ObjText_GetTotalWidth, 1);
+builtin_real(ObjText_GetTotalHeight, 1);
+
+builtin_real(ObjShader_Create, 0);
+builtin(ObjShader_SetShaderF, 2);
+builtin(ObjShader_SetShaderO, 2);
+builtin(ObjShader_ResetShader, 1);
+builtin(ObjShader_SetTechnique, 2);
+builtin(ObjShader_SetVector, 6);
+builtin(ObjShader_SetFloat, 3);
+builtin(ObjShader_SetFloatArray, 3);
+builtin(ObjShader_SetTexture, 3);
+
+builtin_real(ObjSound_Create, 0);
+builtin(ObjSound_Load, 2);
+builtin(ObjSound_LoadStream, 2);
+builtin(ObjSound_Play, 1);
+builtin(ObjSound_Stop, 1);
+builtin(ObjSound_SetVolumeRate, 2);
+builtin(ObjSound_SetPanRate, 2);
+builtin(ObjSound_SetFade, 2);
+builtin(ObjSound_SetLoopEnable, 2);
+builtin(ObjSound_SetLoopTime, 3);
+builtin(ObjSound_SetLoopSampleCount, 3);
+builtin(ObjSound_SetRestartEnable, 2);
+builtin(ObjSound_SetSoundDivision, 2);
+builtin_bool(ObjSound_IsPlaying, 1);
+builtin_real(ObjSound_GetVolumeRate, 1);
+
+builtin_real(ObjFile_Create, 1);
+builtin(ObjFile_Open, 2);
+builtin(ObjFile_OpenNW, 2);
+builtin(ObjFile_Store, 1);
+builtin_real(ObjFile_GetSize, 1);
+
+builtin_real(ObjFileT_GetLineCount, 1);
+builtin(ObjFileT_GetLineText, 2);
+builtin(ObjFileT_SplitLineText, 3);
+builtin(ObjFileT_AddLine, 2);
+builtin(ObjFileT_ClearLine, 1);
+
+builtin(ObjFileB_SetByteOrder, 2);
+builtin(ObjFileB_SetCharacterCode, 2);
+builtin_real(ObjFileB_GetPointer, 1);
+builtin(ObjFileB_Seek, 2);
+builtin_bool(ObjFileB_ReadBoolean, 1);
+builtin_real(ObjFileB_ReadByte, 1);
+builtin_real(ObjFileB_ReadShort, 1);
+builtin_real(ObjFileB_ReadInteger, 1);
+builtin_real(ObjFileB_ReadLong, 1);
+builtin_real(ObjFileB_ReadFloat, 1);
+builtin_real(ObjFileB_ReadDouble, 1);
+builtin(ObjFileB_ReadString, 2);
+
+if (TypeIs(~t_package))
+{
+		//ECL
+    builtin_real(__ecl_init, 1);
+    builtin(__et_set, 9);
+    builtin(__ex_spup, 5);
+    builtin(__et_on, 2);
+
+    builtin(ObjMove_SetX, 2);
+    builtin(ObjMove_SetY, 2);
+    builtin(ObjMove_SetPosition, 3);
+    builtin(ObjMove_SetSpeed, 2);
+    builtin(ObjMove_SetAngle, 2);
+    builtin(ObjMove_SetAcceleration, 2);
+    builtin(ObjMove_SetMaxSpeed, 2);
+    builtin(ObjMove_SetAngularVelocity, 2);
+
+    builtin(ObjMove_SetDestAtSpeed, 4);
+    builtin(ObjMove_SetDestAtFrame, 4);
+    builtin(ObjMove_SetDestAtWeight, 5);
+
+    builtin(ObjMove_AddPatternA1, 4);
+    builtin(ObjMove_AddPatternA2, 7);
+    builtin(ObjMove_AddPatternA3, 8);
+    builtin(ObjMove_AddPatternA4, 9);
+    builtin(ObjMove_AddPatternB1, 4);
+    builtin(ObjMove_AddPatternB2, 8);
+    builtin(ObjMove_AddPatternB3, 9);
+
+    builtin_real(ObjMove_GetX, 1);
+    builtin_real(ObjMove_GetY, 1);
+    builtin_real(ObjMove_GetSpeed, 1);
+    builtin_real(ObjMove_GetAngle, 1);
+
+    builtin_real(ObjEnemy_Create, 1);
+    builtin(ObjEnemy_Regist, 1);
+    builtin(ObjEnemy_GetInfo, 2);
+    builtin(ObjEnemy_SetLife, 2);
+    builtin(ObjEnemy_AddLife, 2);
+    builtin(ObjEnemy_SetDamageRate, 3);
+    builtin(ObjEnemy_SetIntersectionCircleToShot, 4);
+    builtin(ObjEnemy_SetIntersectionCircleToPlayer, 4);
+
+    builtin_real(ObjEnemyBossScene_Create, 0);
+    builtin(ObjEnemyBossScene_Regist, 1);
+    builtin(ObjEnemyBossScene_Add, 3);
+    builtin(ObjEnemyBossScene_LoadInThread, 1);
+    builtin(ObjEnemyBossScene_GetInfo, 2);
+    builtin(ObjEnemyBossScene_SetSpellTimer, 2);
+    builtin(ObjEnemyBossScene_StartSpell, 1);
+
+    builtin_real(ObjShot_Create, 1);
+    builtin(ObjShot_Regist, 1);
+    builtin(ObjShot_SetAutoDelete, 2);
+    builtin(ObjShot_FadeDelete, 1);
+    builtin(ObjShot_SetDeleteFrame, 2);
+    builtin(ObjShot_SetAutoDeleteDelay, 2); //FP AUTO TIMER
+    builtin(ObjShot_SetSpellResistDelay, 2); //FP SPELL RESIST DELAY
+    builtin(ObjShot_SetDamage, 2);
+    builtin(ObjShot_SetDelay, 2);
+    builtin(ObjShot_SetSpellResist, 2);
+    builtin(ObjShot_SetGraphic, 2);
+    builtin(ObjShot_SetSourceBlendType, 2);
+    builtin(ObjShot_SetPenetration, 2);
+    builtin(ObjShot_SetEraseShot, 2);
+    builtin(ObjShot_SetSpellFactor, 2);
+    builtin(ObjShot_ToItem, 1);
+    builtin(ObjShot_AddShotA1, 3);
+    builtin(ObjShot_AddShotA2, 5);
+    builtin(ObjShot_SetIntersectionEnable, 2);
+    builtin(ObjShot_SetIntersectionCircleA1, 2);
+    builtin(ObjShot_SetIntersectionCircleA2, 4);
+    builtin(ObjShot_SetIntersectionLine, 6);
+    builtin(ObjShot_SetItemChange, 2);
+		builtin_real(ObjShot_GetInitialX, 1);
+		builtin_real(ObjShot_GetInitialY, 1);
+		builtin_real(ObjShot_GetInitialSpeed, 1);
+		builtin_real(ObjShot_GetInitialAngle, 1);
+		builtin_real(ObjShot_GetInitialDelay, 1);
+    builtin_real(ObjShot_GetDamage, 1);
+    builtin_real(ObjShot_GetPenetration, 1);
+    builtin_real(ObjShot_GetDelay, 1);
+    builtin_bool(ObjShot_IsSpellResist, 1);
+    builtin_real(ObjShot_GetImageID, 1);
+
+    builtin(ObjLaser_SetLength, 2);
+    builtin(ObjLaser_SetRenderWidth, 2);
+    builtin(ObjLaser_SetIntersectionWidth, 2);
+    builtin(ObjLaser_SetGrazeInvalidFrame, 2);
+    builtin(ObjLaser_SetInvalidLength, 3);
+    builtin(ObjLaser_SetItemDistance, 2);
+    builtin_real(ObjLaser_GetLength, 1);
+
+    builtin(ObjStLaser_SetAngle, 2);
+    builtin_real(ObjStLaser_GetAngle, 1);
+    builtin(ObjStLaser_SetSource, 2);
+
+    builtin(ObjCrLaser_SetTipDecrement, 2);
+
+    builtin(ObjItem_SetItemID, 2);
+    builtin(ObjItem_SetRenderScoreEnable, 2);
+    builtin(ObjItem_SetAutoCollectEnable, 2);
+    builtin(ObjItem_SetDefinedMovePatternA1, 2);
+    builtin(ObjItem_GetInfo, 2);
+
+    builtin(ObjPlayer_AddIntersectionCircleA1, 5);
+    builtin(ObjPlayer_AddIntersectionCircleA2, 4);
+    builtin(ObjPlayer_ClearIntersection, 1);
+
+    builtin_bool(ObjCol_IsIntersected, 1);
+    builtin(ObjCol_GetListOfIntersectedEnemyID, 1);
+    builtin(ObjCol_GetIntersectedCount, 1);
+}
+
+if (TypeIs(t_player))
+{
+    builtin_real(CreatePlayerShotA1, 7);
+    builtin(CallSpell, 0);
+    builtin(LoadPlayerShotData, 1);
+    builtin(ReloadPlayerShotData, 1);
+    builtin_real(GetSpellManageObject, 0);
+
+    builtin_real(ObjSpell_Create, 0);
+    builtin(ObjSpell_Regist, 1);
+    builtin(ObjSpell_SetDamage, 2);
+    builtin(ObjSpell_SetEraseShot, 2);
+    builtin(ObjSpell_SetIntersectionCircle, 4);
+    builtin(ObjSpell_SetIntersectionLine, 6);
+}
+
+builtin(SetPauseScriptPath, 1);
+builtin(SetEndSceneScriptPath, 1);
+builtin(SetReplaySaveSceneScriptPath, 1);
+builtin(GetTransitionRenderTargetName, 0);
+
+if (TypeIs(t_shot_custom))
+{
+    builtin(SetShotDeleteEventEnable, 2);
+}
+
+if (TypeIs(t_package))
+{
+    builtin(ClosePackage, 0);
+    builtin(InitializeStageScene, 0);
+    builtin(FinalizeStageScene, 0);
+    builtin(StartStageScene, 0);
+    builtin(SetStageIndex, 1);
+    builtin(SetStageMainScript, 1);
+    builtin(SetStagePlayerScript, 1);
+    builtin(SetStageReplayFile, 1);
+    builtin(GetStageSceneState, 0);
+    builtin(GetStageSceneResult, 0);
+    builtin(PauseStageScene, 1);
+    builtin(TerminateStageScene, 0);
+
+    builtin(GetLoadFreePlayerScriptList, 0);
+    builtin(GetFreePlayerScriptCount, 0);
+    builtin(GetFreePlayerScriptInfo, 2);
+
+    builtin(LoadReplayList, 0);
+    builtin(GetValidReplayIndices, 0);
+    builtin_bool(IsValidReplayIndex, 1);
+    builtin(GetReplayInfo, 2);
+    builtin(SetReplayInfo, 2);
+    builtin(SaveReplay, 2);
+}
+
+#undef constI
+#undef builtin
+#undef builtin_real
+#undef builtin_bool
+#undef builtin_str
+#undef runtime
+#undef runtime_real
+#undef runtime_str
+#undef TypeIs
@@ -0,0 +1,145 @@
+﻿#include <bstorm/builtin_registry.hpp>
+
+#include <bstorm/node.hpp>
+#include <bstorm/script_name_prefix.hpp>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace bstorm
+{
+void AddConst(const std::shared_ptr<Env>& env, const char* name, const char* value, ExpType expType)
+{
+    Ident ident(name);
+    env->AddDef(ident, std::make_shared<NodeConst>(ident, value, expType));
+}
+
+void AddConstI(const std::shared_ptr<Env>& env, const char* name, int value)
+{
+    Ident ident(name);
+    env->AddDef(ident, std::make_shared<NodeConst>(ident, value));
+}
+
+const std::shared_ptr<NodeDef>& AddBuiltInFunc(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func)
+{
+    Ident ident(name);
+    auto& def = env->AddDef(ident, std::make_shared<NodeBuiltInFunc>(ident, paramc));
+    if (func)
+    {
+        reg.funcNames.push_back(std::string(DNH_BUILTIN_FUNC_PREFIX) + def->convertedName);
+        reg.funcs.push_back(luaL_Reg{ nullptr, func });
+    }
+    return def;
+}
+
+void AddBuiltInFuncHasRealType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func)
+{
+    auto& def = AddBuiltInFunc(env, name, paramc, reg, func);
+    def->retType = ExpType::REAL;
+}
+
+void AddBuiltInFuncHasBoolType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func)
+{
+    auto& def = AddBuiltInFunc(env, name, paramc, reg, func);
+    def->retType = ExpType::BOOL;
+}
+
+void AddBuiltInFuncHasStringType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func)
+{
+    auto& def = AddBuiltInFunc(env, name, paramc, reg, func);
+    def->retType = ExpType::STRING;
+}
+
+void SetStrParams(const std::shared_ptr<NodeDef>& def, std::initializer_list<int> paramIndices)
+{
+    auto func = std::static_pointer_cast<NodeBuiltInFunc>(def);
+    for (int idx : paramIndices)
+    {
+        func->strParamMask |= 1u << idx;
+    }
+}
+
+const std::shared_ptr<NodeDef>& AddRuntimeBuiltInFunc(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg)
+{
+    Ident ident(name);
+    auto func = std::make_shared<NodeBuiltInFunc>(ident, paramc);
+    func->isRuntime = true;
+    auto& def = env->AddDef(ident, func);
+    // get from runtime lib.
+    reg.runtimeFuncs.emplace_back(std::string(DNH_RUNTIME_BUILTIN_PREFIX) + name, std::string(DNH_BUILTIN_FUNC_PREFIX) + def->convertedName);
+    return def;
+}
+
+void AddRuntimeBuiltInFuncHasRealType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg)
+{
+    auto& def = AddRuntimeBuiltInFunc(env, name, paramc, reg);
+    def->retType = ExpType::REAL;
+}
+
+void AddRuntimeBuiltInFuncHasStringType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg)
+{
+    auto& def = AddRuntimeBuiltInFunc(env, name, paramc, reg);
+    def->retType = ExpType::STRING;
+}
+
+static ScriptTypeSet GetScriptTypeSet(ScriptType scriptType)
+{
+    switch (scriptType.value)
+    {
+        case ScriptType::Value::PLAYER:
+            return t_player;
+        case ScriptType::Value::PACKAGE:
+            return t_package;
+        case ScriptType::Value::SHOT_CUSTOM:
+            return t_shot_custom;
+        case ScriptType::Value::ITEM_CUSTOM:
+            return t_item_custom;
+        case ScriptType::Value::STAGE:
+        default:
+            return t_stage;
+    }
+}
+
+static std::shared_ptr<const BuiltInRegistry> CreateBuiltInRegistry(ScriptTypeSet type)
+{
+    auto registry = std::make_shared<BuiltInRegistry>();
+    auto& reg = *registry;
+    auto env = std::make_shared<Env>();
+
+    DefineBuiltIns(env, reg, type);
+
+    // 組み込みの定義は共有されるので, 解析で書き換えられないように到達可能にしておく
+    for (const auto& bind : *(env->GetCurrentBlockNameTable()))
+    {
+        bind.second->unreachable = false;
+    }
+    reg.defs = env->GetCurrentBlockNameTable();
+    for (size_t i = 0; i < reg.funcs.size(); i++)
+    {
+        reg.funcs[i].name = reg.funcNames[i].c_str();
+    }
+    reg.funcs.push_back(luaL_Reg{ nullptr, nullptr });
+    return registry;
+}
+
+std::shared_ptr<const BuiltInRegistry> GetBuiltInRegistry(ScriptType scriptType)
+{
+    static std::mutex mutex;
+    static std::unordered_map<ScriptTypeSet, std::shared_ptr<const BuiltInRegistry>> registries;
+    ScriptTypeSet type = GetScriptTypeSet(scriptType);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& registry = registries[type];
+    if (!registry)
+    {
+        registry = CreateBuiltInRegistry(type);
+    }
+    return registry;
+}
+
+std::shared_ptr<Env> CreateInitRootEnv(ScriptType type)
+{
+    // 共有の表をコピーしてユーザ定義を追加していく(定義自体は共有する)
+    auto registry = GetBuiltInRegistry(type);
+    return std::make_shared<Env>(std::make_shared<DefNameTable>(*registry->defs), nullptr);
+}
+}
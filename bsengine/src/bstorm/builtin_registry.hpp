@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <bstorm/env.hpp>
+#include <bstorm/script_info.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <luajit/lua.hpp>
+
+namespace bstorm
+{
+class ExpType;
+
+// 組み込みの定義と, lua_Stateに登録する関数の一覧
+// スクリプトの種類ごとに一度だけ作り, 全てのコンパイルとlua_Stateで共有する(作成後は変更しない)
+struct BuiltInRegistry
+{
+    std::shared_ptr<const DefNameTable> defs;
+    std::vector<std::string> funcNames;
+    std::vector<luaL_Reg> funcs; // 名前はfuncNamesを指す
+    std::vector<std::pair<std::string, std::string>> runtimeFuncs; // ランタイムでの名前, 登録する名前
+};
+
+using ScriptTypeSet = uint8_t;
+
+constexpr ScriptTypeSet t_player = 1;
+constexpr ScriptTypeSet t_stage = 2;
+constexpr ScriptTypeSet t_package = 4;
+constexpr ScriptTypeSet t_shot_custom = 8;
+constexpr ScriptTypeSet t_item_custom = 16;
+constexpr ScriptTypeSet t_all = 0xff;
+
+void AddConst(const std::shared_ptr<Env>& env, const char* name, const char* value, ExpType expType);
+void AddConstI(const std::shared_ptr<Env>& env, const char* name, int value);
+// funcがnullptrならlua_Stateには登録しない
+const std::shared_ptr<NodeDef>& AddBuiltInFunc(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func);
+void AddBuiltInFuncHasRealType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func);
+void AddBuiltInFuncHasBoolType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func);
+void AddBuiltInFuncHasStringType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg, lua_CFunction func);
+// 文字列として読むだけの引数を指定する
+void SetStrParams(const std::shared_ptr<NodeDef>& def, std::initializer_list<int> paramIndices);
+const std::shared_ptr<NodeDef>& AddRuntimeBuiltInFunc(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg);
+void AddRuntimeBuiltInFuncHasRealType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg);
+void AddRuntimeBuiltInFuncHasStringType(const std::shared_ptr<Env>& env, const char* name, uint8_t paramc, BuiltInRegistry& reg);
+
+// 組み込みの定義を全て登録する
+// 本体はbuiltin_def_list.hpp, エンジンではapi.cppが関数の実装と一緒に定義する
+void DefineBuiltIns(const std::shared_ptr<Env>& env, BuiltInRegistry& reg, ScriptTypeSet type);
+
+std::shared_ptr<const BuiltInRegistry> GetBuiltInRegistry(ScriptType type);
+
+// 組み込みの定義を持つトップレベルの環境を作る
+// 組み込みの定義はスクリプトの種類ごとに一度だけ作って共有する
+std::shared_ptr<Env> CreateInitRootEnv(ScriptType type);
+}
@@ -0,0 +1,41 @@
+﻿#include <bstorm/cache_file.hpp>
+
+#include <bstorm/file_util.hpp>
+
+#include <cwchar>
+
+namespace bstorm
+{
+uint64_t HashFNV1a64(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::wstring GetHashFileName(uint64_t hash)
+{
+    wchar_t name[17];
+    swprintf(name, 17, L"%016llx", (unsigned long long)hash);
+    return name;
+}
+
+bool ReadCacheFile(const std::wstring& path, std::vector<char>* buf)
+{
+    return ReadFileBytes(path, buf);
+}
+
+bool ReplaceCacheFile(const std::wstring& tmpPath, const std::wstring& path)
+{
+    if (RenameFile(tmpPath, path))
+    {
+        return true;
+    }
+    RemoveFile(tmpPath);
+    return false;
+}
+}
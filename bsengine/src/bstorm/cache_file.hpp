@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bstorm
+{
+// 実行ごとに変わらないハッシュ(FNV-1a)
+constexpr uint64_t FNV1A_64_OFFSET_BASIS = 14695981039346656037ull;
+uint64_t HashFNV1a64(const void* data, size_t size, uint64_t hash = FNV1A_64_OFFSET_BASIS);
+// ハッシュ値をファイル名にする(16桁の16進数)
+std::wstring GetHashFileName(uint64_t hash);
+
+// ファイル全体を1回で読み込む, 開けなければfalse
+bool ReadCacheFile(const std::wstring& path, std::vector<char>* buf);
+// 書き込み途中のファイルを読まないように, 一時ファイルに書いてから置き換える
+// 置き換えられなければ一時ファイルを消してfalse
+bool ReplaceCacheFile(const std::wstring& tmpPath, const std::wstring& path);
+
+// 読み込んだファイル全体から順に値を取り出す
+// 範囲外を読もうとしたら以降は全て失敗する
+class CacheFileReader
+{
+public:
+    CacheFileReader(const std::vector<char>& buf) : buf_(buf), pos_(0), isFailed_(false) {}
+    bool Read(void* dst, size_t size)
+    {
+        if (isFailed_ || size > buf_.size() - pos_)
+        {
+            isFailed_ = true;
+            return false;
+        }
+        std::memcpy(dst, buf_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+    template <class T>
+    bool Read(T* dst) { return Read(dst, sizeof(T)); }
+    bool ReadString(std::string* dst)
+    {
+        uint32_t len = 0;
+        if (!Read(&len)) return false;
+        if (len > buf_.size() - pos_) { isFailed_ = true; return false; }
+        dst->assign(buf_.data() + pos_, len);
+        pos_ += len;
+        return true;
+    }
+    bool IsEnd() const { return !isFailed_ && pos_ == buf_.size(); }
+    // 残りのバイト数, 件数から確保する大きさを決める前の検証に使う
+    size_t GetRestSize() const { return isFailed_ ? 0 : buf_.size() - pos_; }
+private:
+    const std::vector<char>& buf_;
+    size_t pos_;
+    bool isFailed_;
+};
+
+template <class T>
+void WriteCacheValue(std::ostream& out, const T& value)
+{
+    out.write((const char*)&value, sizeof(T));
+}
+
+inline void WriteCacheString(std::ostream& out, const std::string& s)
+{
+    WriteCacheValue(out, (uint32_t)s.size());
+    out.write(s.data(), s.size());
+}
+}
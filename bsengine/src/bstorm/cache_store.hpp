@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bstorm/task_pool.hpp>
+
 #include <memory>
 #include <future>
 #include <unordered_map>
@@ -16,18 +18,32 @@ template <class K, class V>
 class CacheStore
 {
 private:
-    template <class V>
     struct CacheEntry
     {
         CacheEntry(bool reserve, std::shared_future<std::shared_ptr<V>>& future) :
             isReserved(reserve),
-            future(future)
+            future(future),
+            pool(nullptr),
+            taskId(0),
+            pendingLoadCount(0)
+        {
+        }
+        // v[ŖsȂĂяõXbhŎs
+        void RunPendingTask() const
+        {
+            if (pool) pool->RunNow(taskId);
+        }
+        void CancelPendingTask() const
         {
+            if (pool) pool->Cancel(taskId);
         }
         bool isReserved;
         std::shared_future<std::shared_ptr<V>> future;
+        TaskPool* pool; // v[Ń[hꍇ
+        TaskPool::TaskId taskId;
+        int pendingLoadCount; // v[ł̃[h҂Ăv̐, CancelLoadŌ炷
     };
-    std::unordered_map<K, CacheEntry<V>> cacheMap_;
+    std::unordered_map<K, CacheEntry> cacheMap_;
     mutable std::mutex mutex;
 public:
     // blocking
@@ -37,6 +53,7 @@ public:
         auto it = cacheMap_.find(key);
         if (it != cacheMap_.end())
         {
+            it->second.RunPendingTask();
             return it->second.future.get();
         }
         throw std::runtime_error("cache not exist.");
@@ -66,6 +83,7 @@ public:
         auto it = cacheMap_.find(key);
         if (it != cacheMap_.end())
         {
+            it->second.RunPendingTask();
             return it->second.future.get();
         }
 
@@ -92,17 +110,72 @@ public:
         return cacheMap_.at(key).future;
     }
 
+    // pool̃[J[XbhŃ[h, priorityقǐɎs
+    // Ƀ[hȂ炻g, 荂Dxw肳ꂽDxグ
+    template <class... Args>
+    const std::shared_future<std::shared_ptr<V>>& LoadAsync(TaskPool& pool, int priority, const K& key, Args&&... args) noexcept(true)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cacheMap_.find(key);
+        if (it != cacheMap_.end())
+        {
+            if (it->second.pool) it->second.pool->RaisePriority(it->second.taskId, priority);
+            it->second.pendingLoadCount++;
+            return it->second.future;
+        }
+
+        auto task = std::make_shared<std::packaged_task<std::shared_ptr<V>()>>([args...]()
+        {
+            return std::make_shared<V>(args...);
+        });
+        std::shared_future<std::shared_ptr<V>> future = task->get_future().share();
+        auto& entry = cacheMap_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(false, future)).first->second;
+        entry.pool = &pool;
+        entry.taskId = pool.Push(priority, [task]() { (*task)(); });
+        entry.pendingLoadCount = 1;
+        return entry.future;
+    }
+
+    // LoadAsync(pool, ...)̗v1艺
+    // ɑ҂Ăv, v[ŖsȂ烍[h, true
+    bool CancelLoad(const K& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cacheMap_.find(key);
+        if (it != cacheMap_.end())
+        {
+            auto& entry = it->second;
+            if (entry.pendingLoadCount > 0) entry.pendingLoadCount--;
+            if (entry.pendingLoadCount > 0) return false;
+            if (entry.pool && entry.pool->Cancel(entry.taskId))
+            {
+                cacheMap_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
     void Remove(const K& key)
     {
         std::lock_guard<std::mutex> lock(mutex);
-        cacheMap_.erase(key);
+        auto it = cacheMap_.find(key);
+        if (it != cacheMap_.end())
+        {
+            it->second.CancelPendingTask();
+            cacheMap_.erase(it);
+        }
     }
 
     void RemoveAll()
     {
         std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& pair : cacheMap_)
+        {
+            pair.second.CancelPendingTask();
+        }
         // gɂă
-        std::unordered_map<K, CacheEntry<V>>().swap(cacheMap_);
+        std::unordered_map<K, CacheEntry>().swap(cacheMap_);
     }
 
     // non blocking
@@ -163,7 +236,7 @@ public:
         for (auto& pair : cacheMap_)
         {
             const K& key = pair.first;
-            CacheEntry<V>& entry = pair.second;
+            CacheEntry& entry = pair.second;
             bool& reserved = entry.isReserved;
             auto& future = entry.future;
             if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
@@ -1,11 +1,22 @@
 ﻿#include <bstorm/camera2D.hpp>
 
+#include <bstorm/dx_util.hpp>
+
 #include <algorithm>
 #include <d3dx9.h>
 
 namespace bstorm
 {
-Camera2D::Camera2D()
+Camera2D::Camera2D() :
+    focusX_(0.0f),
+    focusY_(0.0f),
+    angleZ_(0.0f),
+    ratioX_(1.0f),
+    ratioY_(1.0f),
+    viewMatrix_(IdentityMatrix4()),
+    isViewMatrixDirty_(true),
+    projMatrix_(IdentityMatrix4()),
+    projParams_{ 0.0f, 0.0f, 0.0f, 0.0f }
 {
     Reset(0.0f, 0.0f);
 }
@@ -20,26 +31,36 @@ void Camera2D::Reset(float focusX, float focusY)
     SetRatio(1.0f);
 }
 
+const Matrix4& Camera2D::GetViewMatrix() const
+{
+    if (isViewMatrixDirty_)
+    {
+        viewMatrix_ = Camera2DViewMatrix4(focusX_, focusY_, angleZ_, ratioX_, ratioY_);
+        isViewMatrixDirty_ = false;
+    }
+    return viewMatrix_;
+}
+
+const Matrix4& Camera2D::GetProjMatrix(float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY) const
+{
+    if (projParams_[0] != screenWidth || projParams_[1] != screenHeight || projParams_[2] != cameraScreenX || projParams_[3] != cameraScreenY)
+    {
+        projMatrix_ = Camera2DProjMatrix4(screenWidth, screenHeight, cameraScreenX, cameraScreenY);
+        projParams_[0] = screenWidth;
+        projParams_[1] = screenHeight;
+        projParams_[2] = cameraScreenX;
+        projParams_[3] = cameraScreenY;
+    }
+    return projMatrix_;
+}
+
 void Camera2D::GenerateViewMatrix(D3DXMATRIX* view) const
 {
-    // カメラ中心に変換してから拡大して回転
-    D3DXMATRIX rot;
-    D3DXMatrixLookAtLH(view, &D3DXVECTOR3(focusX_, focusY_, 1.0f), &D3DXVECTOR3(focusX_, focusY_, 0.0f), &D3DXVECTOR3(0.0f, -1.0f, 0.0f));
-    D3DXMatrixRotationZ(&rot, D3DXToRadian(-angleZ_));
-    rot._11 *= ratioX_; rot._12 *= ratioX_;
-    rot._21 *= ratioY_; rot._22 *= ratioY_;
-    *view = (*view) * rot;
+    *view = ToD3DXMatrix(GetViewMatrix());
 }
 
 void Camera2D::GenerateProjMatrix(D3DXMATRIX* proj, float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY) const
 {
-    // 移動してから拡大
-    const float tx = -screenWidth / 2.0f + cameraScreenX;
-    const float ty = screenHeight / 2.0f - cameraScreenY;
-    const float sx = 2.0f / screenWidth;
-    const float sy = 2.0f / screenHeight;
-    D3DXMatrixScaling(proj, sx, sy, 1.0f);
-    proj->_41 = sx * tx;
-    proj->_42 = sy * ty;
+    *proj = ToD3DXMatrix(GetProjMatrix(screenWidth, screenHeight, cameraScreenX, cameraScreenY));
 }
 }
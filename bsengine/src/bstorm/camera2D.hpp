@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <bstorm/matrix.hpp>
+
 struct D3DXMATRIX;
 
 namespace bstorm
@@ -9,12 +11,12 @@ class Camera2D
 public:
     Camera2D();
     ~Camera2D() {};
-    void SetFocusX(float fx) { focusX_ = fx; }
-    void SetFocusY(float fy) { focusY_ = fy; }
-    void SetAngleZ(float rotZ) { angleZ_ = rotZ; }
+    void SetFocusX(float fx) { SetParam(focusX_, fx); }
+    void SetFocusY(float fy) { SetParam(focusY_, fy); }
+    void SetAngleZ(float rotZ) { SetParam(angleZ_, rotZ); }
     void SetRatio(float r) { SetRatioX(r); SetRatioY(r); }
-    void SetRatioX(float rx) { ratioX_ = rx; }
-    void SetRatioY(float ry) { ratioY_ = ry; }
+    void SetRatioX(float rx) { SetParam(ratioX_, rx); }
+    void SetRatioY(float ry) { SetParam(ratioY_, ry); }
     float GetX() const { return focusX_; }
     float GetY() const { return focusY_; }
     float GetAngleZ() const { return angleZ_; }
@@ -22,14 +24,30 @@ public:
     float GetRatioX() const { return ratioX_; }
     float GetRatioY() const { return ratioY_; }
     void Reset(float focusX, float focusY);
+    // 行列はパラメータが変わった時だけ再計算する
+    const Matrix4& GetViewMatrix() const;
+    const Matrix4& GetProjMatrix(float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY) const;
     void GenerateViewMatrix(D3DXMATRIX* view) const;
     void GenerateProjMatrix(D3DXMATRIX* proj, float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY) const;
 private:
+    void SetParam(float& param, float value)
+    {
+        if (param != value)
+        {
+            param = value;
+            isViewMatrixDirty_ = true;
+        }
+    }
     // focus: カメラの中心に持ってきたいワールド座標
     float focusX_;
     float focusY_;
     float angleZ_;
     float ratioX_;
     float ratioY_;
+    mutable Matrix4 viewMatrix_;
+    mutable bool isViewMatrixDirty_;
+    // 射影行列は最後に求めた時の引数と一緒に保持する
+    mutable Matrix4 projMatrix_;
+    mutable float projParams_[4];
 };
 }
@@ -9,10 +9,260 @@ namespace bstorm
 {
 // NOTE: B\ȕ
 
+// ^_̂܂܂ĂȂ^
+static constexpr ExpType::T UNKNOWN = 11;
+// ^_ł؂͉
+static constexpr int MAX_TYPE_INFERENCE_PASS = 16;
+
+static bool ContainsUnknown(ExpType t)
+{
+    while (t.IsArray() && t.t != 0) t = ExpType::ARRAY_ELEM(t);
+    return t.t == UNKNOWN;
+}
+
+// m̌^͌Ŋm肵^ƓɂȂƂ݂Ȃ
+static ExpType JoinType(ExpType x, ExpType y)
+{
+    if (ContainsUnknown(x)) return y;
+    if (ContainsUnknown(y)) return x;
+    return x == y ? x : ExpType::ANY;
+}
+
+static ExpType ElemType(ExpType t)
+{
+    if (ContainsUnknown(t)) return UNKNOWN;
+    return t.IsArray() ? ExpType::ARRAY_ELEM(t) : ExpType::ANY;
+}
+
+static ExpType AssignResultType(ExpType, ExpType r) { return r; }
+static ExpType ArithAndArrayResultType(ExpType l, ExpType r)
+{
+    if (l == ExpType::REAL && r == ExpType::REAL) return ExpType::REAL;
+    if (ContainsUnknown(l) || ContainsUnknown(r)) return UNKNOWN;
+    return ExpType::ANY;
+}
+static ExpType ArithResultType(ExpType, ExpType) { return ExpType::REAL; }
+static ExpType CatResultType(ExpType l, ExpType r)
+{
+    if (ContainsUnknown(l) || ContainsUnknown(r)) return UNKNOWN;
+    if (l == r && l.IsArray()) return l;
+    return ExpType::ARRAY(ExpType::ANY);
+}
+
+static bool IsUserProc(const std::shared_ptr<NodeDef>& def)
+{
+    if (std::dynamic_pointer_cast<NodeFuncDef>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeTaskDef>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeSubDef>(def)) return true;
+    return false;
+}
+
+static bool IsInferredDef(const std::shared_ptr<NodeDef>& def)
+{
+    if (std::dynamic_pointer_cast<NodeVarDecl>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeProcParam>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeLoopParam>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeResult>(def)) return true;
+    if (std::dynamic_pointer_cast<NodeFuncDef>(def)) return true;
+    return false;
+}
+
 void CodeAnalyzer::Analyze(Node & n)
+{
+    // 1ڂœB\, QƐ, ߂
+    // 2ڈȍ~͑ꂽľ^ϐ, , ֐̖߂ľ^߂Č^ςȂȂ܂ŉ͂
+    inferredDefs_.clear();
+    undeterminedDefs_.clear();
+    procEntryAssignedDefs_.clear();
+    isFirstPass_ = true;
+    AnalyzeReachable(n);
+    isFirstPass_ = false;
+    int passCnt = 1;
+    while (UpdateInferredTypes())
+    {
+        if (++passCnt > MAX_TYPE_INFERENCE_PASS)
+        {
+            for (auto def : inferredDefs_) def->retType = ExpType::ANY;
+            AnalyzeReachable(n);
+            break;
+        }
+        AnalyzeReachable(n);
+    }
+}
+
+void CodeAnalyzer::AnalyzeReachable(Node & n)
 {
     env_ = nullptr;
+    analyzedDefs_.clear();
+    assignedTypes_.clear();
+    procStack_.clear();
+    flow_ = FlowState();
+    nextProcEntryAssignedDefs_.clear();
+    hasProcEntry_ = false;
     n.Traverse(*this);
+    // 葱͉͏Ɋ֌WȂĂ΂̂, ̉͂őÕgbvx̌ʂg
+    procEntryAssignedDefs_ = std::move(nextProcEntryAssignedDefs_);
+}
+
+bool CodeAnalyzer::UpdateInferredTypes()
+{
+    bool isChanged = false;
+    bool hasUnknown = false;
+    for (auto def : inferredDefs_)
+    {
+        auto it = assignedTypes_.find(def);
+        ExpType type = it == assignedTypes_.end() ? UNKNOWN : it->second;
+        if (undeterminedDefs_.count(def) != 0) type = ExpType::ANY;
+        if (ContainsUnknown(type)) hasUnknown = true;
+        if (type != def->retType)
+        {
+            def->retType = type;
+            isChanged = true;
+        }
+    }
+    if (!isChanged && hasUnknown)
+    {
+        // ľ܂Ȃ(xȂϐȂ)ANYɂ
+        for (auto def : inferredDefs_)
+        {
+            if (ContainsUnknown(def->retType))
+            {
+                def->retType = ExpType::ANY;
+                undeterminedDefs_.insert(def);
+            }
+        }
+        isChanged = true;
+    }
+    return isChanged;
+}
+
+void CodeAnalyzer::AddAssignedType(const NodeDef * def, ExpType type)
+{
+    auto it = assignedTypes_.find(def);
+    if (it == assignedTypes_.end())
+    {
+        assignedTypes_[def] = type;
+    } else
+    {
+        it->second = JoinType(it->second, type);
+    }
+}
+
+void CodeAnalyzer::AnalyzeProc(NodeDef & def, NodeBlock & blk)
+{
+    // 葱̒ł͊O̕ϐ͎葱̊Jnɑς݂̂̂ς݂Ƃ
+    auto outerFlow = std::move(flow_);
+    flow_ = FlowState();
+    flow_.assignedDefs = procEntryAssignedDefs_;
+    auto func = dynamic_cast<NodeFuncDef*>(&def);
+    procStack_.push_back(func);
+    blk.Traverse(*this);
+    if (func && !flow_.isDead)
+    {
+        // Ō܂ŎsꂽresultԂ
+        AddAssignedType(func, GetResultType(*func));
+    }
+    procStack_.pop_back();
+    flow_ = std::move(outerFlow);
+}
+
+ExpType CodeAnalyzer::GetResultType(const NodeFuncDef & func) const
+{
+    // QƂȂresult̓R[hŏ̂nilԂ
+    auto it = func.block->nameTable->find(Ident("result"));
+    if (it == func.block->nameTable->end()) return ExpType::NIL;
+    auto result = std::dynamic_pointer_cast<NodeResult>(it->second);
+    if (!result || result->unreachable) return ExpType::NIL;
+    ExpType type = result->retType;
+    if (flow_.assignedDefs.count(result.get()) == 0)
+    {
+        type = JoinType(type, ExpType::NIL);
+    }
+    return type;
+}
+
+void CodeAnalyzer::ReadVar(const std::shared_ptr<NodeDef>& def)
+{
+    // Oɓǂ܂ꂤϐ(let x;, result)nil܂
+    if (flow_.isDead) return;
+    if (!std::dynamic_pointer_cast<NodeVarDecl>(def) && !std::dynamic_pointer_cast<NodeResult>(def)) return;
+    if (flow_.assignedDefs.count(def.get()) != 0) return;
+    AddAssignedType(def.get(), ExpType::NIL);
+}
+
+void CodeAnalyzer::AddProcEntry(const std::shared_ptr<NodeDef>& callee)
+{
+    // gbvx葱Ăԏ, gbvx̏IŎ葱sn߂
+    if (!procStack_.empty() || flow_.isDead) return;
+    if (callee && !IsUserProc(callee)) return;
+    if (!hasProcEntry_)
+    {
+        nextProcEntryAssignedDefs_ = flow_.assignedDefs;
+        hasProcEntry_ = true;
+        return;
+    }
+    for (auto it = nextProcEntryAssignedDefs_.begin(); it != nextProcEntryAssignedDefs_.end();)
+    {
+        if (flow_.assignedDefs.count(*it) == 0)
+        {
+            it = nextProcEntryAssignedDefs_.erase(it);
+        } else
+        {
+            ++it;
+        }
+    }
+}
+
+CodeAnalyzer::FlowState CodeAnalyzer::JoinFlow(const FlowState & x, const FlowState & y)
+{
+    // BȂ͖, őς݂̂̂c
+    if (x.isDead) return y;
+    if (y.isDead) return x;
+    FlowState joined;
+    for (auto def : x.assignedDefs)
+    {
+        if (y.assignedDefs.count(def) != 0)
+        {
+            joined.assignedDefs.insert(def);
+        }
+    }
+    return joined;
+}
+
+void CodeAnalyzer::AddArgTypes(const std::shared_ptr<NodeDef>& def, const std::vector<std::shared_ptr<NodeExp>>& args)
+{
+    // SĂ̌Ăяo̎̌^̌^Ƃ
+    const std::vector<Ident>* params = nullptr;
+    std::shared_ptr<NodeBlock> blk;
+    if (auto func = std::dynamic_pointer_cast<NodeFuncDef>(def))
+    {
+        params = &func->params;
+        blk = func->block;
+    } else if (auto task = std::dynamic_pointer_cast<NodeTaskDef>(def))
+    {
+        params = &task->params;
+        blk = task->block;
+    } else
+    {
+        return;
+    }
+    for (size_t i = 0; i < params->size() && i < args.size(); i++)
+    {
+        auto it = blk->nameTable->find((*params)[i]);
+        if (it != blk->nameTable->end())
+        {
+            AddAssignedType(it->second.get(), args[i]->expType);
+        }
+    }
+}
+
+void CodeAnalyzer::AddLoopParamType(const Ident& param, const NodeBlock & blk, const NodeRange & range)
+{
+    auto it = blk.nameTable->find(param);
+    if (it != blk.nameTable->end())
+    {
+        AddAssignedType(it->second.get(), JoinType(range.start->expType, range.end->expType));
+    }
 }
 void CodeAnalyzer::Traverse(NodeNum & lit)
 {
@@ -51,11 +301,12 @@ void CodeAnalyzer::Traverse(NodeArray & array)
     array.expType = ExpType::ARRAY(ExpType::ANY);
     if (!array.elems.empty())
     {
-        auto firstElemExpType = array.elems[0]->expType;
-        if (std::all_of(array.elems.begin(), array.elems.end(), [firstElemExpType](auto& e) { return e->expType == firstElemExpType; }))
+        ExpType elemType = UNKNOWN;
+        for (auto& e : array.elems)
         {
-            array.expType = ExpType::ARRAY(firstElemExpType);
+            elemType = JoinType(elemType, e->expType);
         }
+        array.expType = ExpType::ARRAY(elemType);
     }
 }
 void CodeAnalyzer::Traverse(NodeNeg& exp) { AnalyzeMonoOp(exp); exp.expType = ExpType::REAL; }
@@ -79,13 +330,7 @@ void CodeAnalyzer::Traverse(NodeCat& exp)
 {
     exp.copyRequired = false;
     AnalyzeBinOp(exp);
-    if (exp.lhs->expType == exp.rhs->expType && exp.lhs->expType.IsArray())
-    {
-        exp.expType = exp.lhs->expType;
-    } else
-    {
-        exp.expType = ExpType::ARRAY(ExpType::ANY);
-    }
+    exp.expType = CatResultType(exp.lhs->expType, exp.rhs->expType);
 }
 void CodeAnalyzer::Traverse(NodeNoParenCallExp & call)
 {
@@ -99,8 +344,10 @@ void CodeAnalyzer::Traverse(NodeNoParenCallExp & call)
     call.noSubEffect = def->noSubEffect;
     if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(def))
     {
-        varDecl->refCnt++;
+        if (isFirstPass_) varDecl->refCnt++;
     }
+    ReadVar(def);
+    AddProcEntry(def);
     call.expType = def->retType;
 }
 void CodeAnalyzer::Traverse(NodeCallExp & call)
@@ -121,6 +368,8 @@ void CodeAnalyzer::Traverse(NodeCallExp & call)
             call.noSubEffect = false;
         }
     }
+    AddArgTypes(def, call.args);
+    AddProcEntry(def);
     call.expType = def->retType;
 }
 void CodeAnalyzer::Traverse(NodeArrayRef& exp)
@@ -129,6 +378,7 @@ void CodeAnalyzer::Traverse(NodeArrayRef& exp)
     exp.array->Traverse(*this);
     exp.idx->Traverse(*this);
     exp.noSubEffect = exp.array->noSubEffect && exp.idx->noSubEffect;
+    exp.expType = ElemType(exp.array->expType);
 }
 void CodeAnalyzer::Traverse(NodeRange& range)
 {
@@ -142,6 +392,7 @@ void CodeAnalyzer::Traverse(NodeArraySlice& exp)
     exp.array->Traverse(*this);
     exp.range->Traverse(*this);
     exp.noSubEffect = exp.array->noSubEffect && exp.range->noSubEffect;
+    exp.expType = exp.array->expType.IsArray() || ContainsUnknown(exp.array->expType) ? exp.array->expType : ExpType::ANY;
 }
 void CodeAnalyzer::Traverse(NodeNop &) {}
 void CodeAnalyzer::Traverse(NodeLeftVal & left)
@@ -153,17 +404,17 @@ void CodeAnalyzer::Traverse(NodeLeftVal & left)
     }
     if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(env_->FindDef(left.name)))
     {
-        varDecl->assignCnt++;
+        if (isFirstPass_) varDecl->assignCnt++;
     }
 }
-void CodeAnalyzer::Traverse(NodeAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeAddAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeSubAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeMulAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeDivAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeRemAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodePowAssign& stmt) { AnalyzeAssign(stmt); }
-void CodeAnalyzer::Traverse(NodeCatAssign& stmt) { AnalyzeAssign(stmt); }
+void CodeAnalyzer::Traverse(NodeAssign& stmt) { AnalyzeAssign(stmt, AssignResultType); }
+void CodeAnalyzer::Traverse(NodeAddAssign& stmt) { AnalyzeAssign(stmt, ArithAndArrayResultType); }
+void CodeAnalyzer::Traverse(NodeSubAssign& stmt) { AnalyzeAssign(stmt, ArithAndArrayResultType); }
+void CodeAnalyzer::Traverse(NodeMulAssign& stmt) { AnalyzeAssign(stmt, ArithResultType); }
+void CodeAnalyzer::Traverse(NodeDivAssign& stmt) { AnalyzeAssign(stmt, ArithResultType); }
+void CodeAnalyzer::Traverse(NodeRemAssign& stmt) { AnalyzeAssign(stmt, ArithResultType); }
+void CodeAnalyzer::Traverse(NodePowAssign& stmt) { AnalyzeAssign(stmt, ArithResultType); }
+void CodeAnalyzer::Traverse(NodeCatAssign& stmt) { AnalyzeAssign(stmt, CatResultType); }
 void CodeAnalyzer::Traverse(NodeBlock & blk)
 {
     env_ = std::make_shared<Env>(blk.nameTable, env_);
@@ -172,7 +423,7 @@ void CodeAnalyzer::Traverse(NodeBlock & blk)
     {
         for (auto&& name : SCRIPT_ENTRY_ROUTINE_NAMES)
         {
-            AnalyzeDef(name);
+            AnalyzeDef(Ident(name));
         }
     }
 
@@ -181,23 +432,28 @@ void CodeAnalyzer::Traverse(NodeBlock & blk)
         stmt->Traverse(*this);
     }
 
+    if (env_->IsRoot())
+    {
+        AddProcEntry(nullptr);
+    }
+
     env_ = env_->GetParent();
 }
 void CodeAnalyzer::Traverse(NodeSubDef & def)
 {
-    def.block->Traverse(*this);
+    AnalyzeProc(def, *def.block);
 }
 void CodeAnalyzer::Traverse(NodeBuiltInSubDef & def)
 {
-    def.block->Traverse(*this);
+    AnalyzeProc(def, *def.block);
 }
 void CodeAnalyzer::Traverse(NodeFuncDef & def)
 {
-    def.block->Traverse(*this);
+    AnalyzeProc(def, *def.block);
 }
 void CodeAnalyzer::Traverse(NodeTaskDef & def)
 {
-    def.block->Traverse(*this);
+    AnalyzeProc(def, *def.block);
 }
 void CodeAnalyzer::Traverse(NodeBuiltInFunc &) {}
 void CodeAnalyzer::Traverse(NodeConst &) {}
@@ -205,29 +461,42 @@ void CodeAnalyzer::Traverse(NodeLocal & stmt)
 {
     stmt.block->Traverse(*this);
 }
+// [v̒g͎sȂƂ̂, [v̌̓[v̑ȌԂɖ߂
 void CodeAnalyzer::Traverse(NodeLoop & stmt)
 {
+    const auto in = flow_;
     stmt.block->Traverse(*this);
+    flow_ = in;
 }
 void CodeAnalyzer::Traverse(NodeTimes & stmt)
 {
     stmt.cnt->Traverse(*this);
+    const auto in = flow_;
     stmt.block->Traverse(*this);
+    flow_ = in;
 }
 void CodeAnalyzer::Traverse(NodeWhile & stmt)
 {
     stmt.cond->Traverse(*this);
+    const auto in = flow_;
     stmt.block->Traverse(*this);
+    flow_ = in;
 }
 void CodeAnalyzer::Traverse(NodeAscent & stmt)
 {
     stmt.range->Traverse(*this);
+    AddLoopParamType(stmt.param, *stmt.block, *stmt.range);
+    const auto in = flow_;
     stmt.block->Traverse(*this);
+    flow_ = in;
 }
 void CodeAnalyzer::Traverse(NodeDescent & stmt)
 {
     stmt.range->Traverse(*this);
+    AddLoopParamType(stmt.param, *stmt.block, *stmt.range);
+    const auto in = flow_;
     stmt.block->Traverse(*this);
+    flow_ = in;
 }
 
 void CodeAnalyzer::Traverse(NodeElseIf& elsif)
@@ -237,10 +506,20 @@ void CodeAnalyzer::Traverse(NodeElseIf& elsif)
 }
 void CodeAnalyzer::Traverse(NodeIf& stmt)
 {
+    // ̌͑SĂ̕őς݂̂̂ς
     stmt.cond->Traverse(*this);
+    const auto in = flow_;
     stmt.thenBlock->Traverse(*this);
-    for (auto& elsif : stmt.elsifs) elsif->Traverse(*this);
+    auto out = flow_;
+    for (auto& elsif : stmt.elsifs)
+    {
+        flow_ = in;
+        elsif->Traverse(*this);
+        out = JoinFlow(out, flow_);
+    }
+    flow_ = in;
     if (stmt.elseBlock) stmt.elseBlock->Traverse(*this);
+    flow_ = JoinFlow(out, flow_);
 }
 void CodeAnalyzer::Traverse(NodeCase& c)
 {
@@ -253,8 +532,18 @@ void CodeAnalyzer::Traverse(NodeCase& c)
 void CodeAnalyzer::Traverse(NodeAlternative& stmt)
 {
     stmt.cond->Traverse(*this);
-    for (auto& c : stmt.cases) c->Traverse(*this);
+    const auto in = flow_;
+    FlowState out;
+    out.isDead = true;
+    for (auto& c : stmt.cases)
+    {
+        flow_ = in;
+        c->Traverse(*this);
+        out = JoinFlow(out, flow_);
+    }
+    flow_ = in;
     if (stmt.others) stmt.others->Traverse(*this);
+    flow_ = JoinFlow(out, flow_);
 }
 void CodeAnalyzer::Traverse(NodeCallStmt & call)
 {
@@ -263,21 +552,45 @@ void CodeAnalyzer::Traverse(NodeCallStmt & call)
     {
         arg->Traverse(*this);
     }
+    AddArgTypes(env_->FindDef(call.name), call.args);
+    AddProcEntry(env_->FindDef(call.name));
 }
 void CodeAnalyzer::Traverse(NodeReturn & stmt)
 {
     stmt.ret->Traverse(*this);
+    if (!procStack_.empty() && procStack_.back())
+    {
+        AddAssignedType(procStack_.back(), stmt.ret->expType);
+    }
+    flow_.isDead = true;
+}
+void CodeAnalyzer::Traverse(NodeReturnVoid &)
+{
+    if (procStack_.empty())
+    {
+        // gbvxreturň͎葱sn߂
+        AddProcEntry(nullptr);
+    } else if (auto func = dynamic_cast<NodeFuncDef*>(procStack_.back()))
+    {
+        AddAssignedType(func, GetResultType(*func));
+    }
+    flow_.isDead = true;
 }
-void CodeAnalyzer::Traverse(NodeReturnVoid &) {}
 void CodeAnalyzer::Traverse(NodeYield &) {}
-void CodeAnalyzer::Traverse(NodeBreak &) {}
+void CodeAnalyzer::Traverse(NodeBreak &)
+{
+    flow_.isDead = true;
+}
+// CNg, fNgł͌^͕ςȂ
 void CodeAnalyzer::Traverse(NodeSucc& stmt)
 {
     stmt.lhs->Traverse(*this);
+    ReadVar(env_->FindDef(stmt.lhs->name));
 }
 void CodeAnalyzer::Traverse(NodePred& stmt)
 {
     stmt.lhs->Traverse(*this);
+    ReadVar(env_->FindDef(stmt.lhs->name));
 }
 void CodeAnalyzer::Traverse(NodeVarDecl& def)
 {
@@ -291,7 +604,9 @@ void CodeAnalyzer::Traverse(NodeVarInit& stmt)
     stmt.noSubEffect = false;
     if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(env_->FindDef(stmt.name)))
     {
-        varDecl->assignCnt++;
+        if (isFirstPass_) varDecl->assignCnt++;
+        AddAssignedType(varDecl.get(), stmt.rhs->expType);
+        flow_.assignedDefs.insert(varDecl.get());
     }
 }
 void CodeAnalyzer::Traverse(NodeProcParam & def)
@@ -310,7 +625,7 @@ void CodeAnalyzer::Traverse(NodeResult & def)
 
 void CodeAnalyzer::Traverse(NodeHeader &) {}
 
-void CodeAnalyzer::AnalyzeDef(const std::string& name)
+void CodeAnalyzer::AnalyzeDef(const Ident& name)
 {
     auto defEnv = env_;
 
@@ -322,11 +637,17 @@ void CodeAnalyzer::AnalyzeDef(const std::string& name)
     if (defEnv)
     {
         auto& def = (*(defEnv->GetCurrentBlockNameTable()))[name];
-        if (def->unreachable)
+        if (analyzedDefs_.insert(def.get()).second)
         {
+            if (isFirstPass_ && IsInferredDef(def))
+            {
+                def->retType = UNKNOWN;
+                inferredDefs_.push_back(def.get());
+            }
             auto prevEnv = env_;
             env_ = defEnv;
-            def->unreachable = false;
+            // gݍ݂̒`͋LĂ̂ŏ܂Ȃ
+            if (def->unreachable) def->unreachable = false;
             def->Traverse(*this);
             env_ = prevEnv;
         }
@@ -348,10 +669,7 @@ void CodeAnalyzer::AnalyzeArithAndArrayBinOp(NodeBinOp & exp)
 {
     exp.copyRequired = false;
     AnalyzeBinOp(exp);
-    if (exp.lhs->expType == ExpType::REAL && exp.rhs->expType == ExpType::REAL)
-    {
-        exp.expType = ExpType::REAL;
-    }
+    exp.expType = ArithAndArrayResultType(exp.lhs->expType, exp.rhs->expType);
 }
 void CodeAnalyzer::AnalyzeArithBinOp(NodeBinOp & exp)
 {
@@ -371,13 +689,42 @@ void CodeAnalyzer::AnalyzeLogBinOp(NodeBinOp & exp)
     if (exp.lhs->expType == exp.rhs->expType)
     {
         exp.expType = exp.lhs->expType;
+    } else if (ContainsUnknown(exp.lhs->expType) || ContainsUnknown(exp.rhs->expType))
+    {
+        exp.expType = UNKNOWN;
+    } else
+    {
+        exp.expType = ExpType::ANY;
     }
     exp.copyRequired = exp.lhs->copyRequired || exp.rhs->copyRequired;
 }
-void CodeAnalyzer::AnalyzeAssign(NodeAssign & stmt)
+void CodeAnalyzer::AnalyzeAssign(NodeAssign & stmt, ExpType(*resultType)(ExpType, ExpType))
 {
     stmt.lhs->Traverse(*this);
     stmt.rhs->Traverse(*this);
     stmt.noSubEffect = false;
+
+    // a[i][j] op= e Ȃ a̗vf̗vfe猋ʂ̌^߂Ĕzŕ
+    auto def = env_->FindDef(stmt.lhs->name);
+    if (!def) return;
+    // PȑȊO͌̒lǂ
+    if (resultType == AssignResultType && stmt.lhs->indices.empty())
+    {
+        flow_.assignedDefs.insert(def.get());
+    } else
+    {
+        ReadVar(def);
+    }
+    ExpType elemType = def->retType;
+    for (size_t i = 0; i < stmt.lhs->indices.size(); i++)
+    {
+        elemType = ElemType(elemType);
+    }
+    ExpType type = resultType(elemType, stmt.rhs->expType);
+    for (size_t i = 0; i < stmt.lhs->indices.size(); i++)
+    {
+        type = ExpType::ARRAY(type);
+    }
+    AddAssignedType(def.get(), type);
 }
 }
\ No newline at end of file
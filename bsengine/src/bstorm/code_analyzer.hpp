@@ -1,6 +1,10 @@
 #pragma once
 #include <bstorm/node.hpp>
 
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace bstorm
 {
 class Env;
@@ -8,6 +12,8 @@ class CodeAnalyzer : public NodeTraverser
 {
 public:
     void Analyze(Node& n);
+    // variables surely assigned whenever a procedure starts running
+    const std::unordered_set<const NodeDef*>& GetProcEntryAssignedDefs() const { return procEntryAssignedDefs_; }
     void Traverse(NodeNum&) override;
     void Traverse(NodeChar&) override;
     void Traverse(NodeStr&) override;
@@ -76,14 +82,44 @@ public:
     void Traverse(NodeAlternative&) override;
     void Traverse(NodeHeader&) override;
 private:
+    // variables that are surely assigned at the current point of the walk
+    struct FlowState
+    {
+        std::unordered_set<const NodeDef*> assignedDefs;
+        bool isDead = false;
+    };
     std::shared_ptr<Env> env_;
-    void AnalyzeDef(const std::string& name);
+    bool isFirstPass_;
+    std::unordered_set<const NodeDef*> analyzedDefs_;
+    // targets of type inference (variables, parameters, functions) and the types assigned to them
+    std::vector<NodeDef*> inferredDefs_;
+    std::unordered_map<const NodeDef*, ExpType> assignedTypes_;
+    // types still undetermined at a fixpoint, fixed to ANY for the later walks
+    std::unordered_set<const NodeDef*> undeterminedDefs_;
+    // enclosing procedures: the function, or nullptr for subs and tasks
+    std::vector<NodeDef*> procStack_;
+    FlowState flow_;
+    // variables surely assigned whenever a procedure starts running (previous walk / this walk)
+    std::unordered_set<const NodeDef*> procEntryAssignedDefs_;
+    std::unordered_set<const NodeDef*> nextProcEntryAssignedDefs_;
+    bool hasProcEntry_;
+    void AnalyzeReachable(Node& n);
+    bool UpdateInferredTypes();
+    void AddAssignedType(const NodeDef* def, ExpType type);
+    void AnalyzeProc(NodeDef& def, NodeBlock& blk);
+    ExpType GetResultType(const NodeFuncDef& func) const;
+    void ReadVar(const std::shared_ptr<NodeDef>& def);
+    void AddProcEntry(const std::shared_ptr<NodeDef>& callee);
+    static FlowState JoinFlow(const FlowState& x, const FlowState& y);
+    void AddArgTypes(const std::shared_ptr<NodeDef>& def, const std::vector<std::shared_ptr<NodeExp>>& args);
+    void AddLoopParamType(const Ident& param, const NodeBlock& blk, const NodeRange& range);
+    void AnalyzeDef(const Ident& name);
     void AnalyzeMonoOp(NodeMonoOp& exp);
     void AnalyzeBinOp(NodeBinOp& exp);
     void AnalyzeArithAndArrayBinOp(NodeBinOp& exp);
     void AnalyzeArithBinOp(NodeBinOp& exp);
     void AnalyzeCmpBinOp(NodeBinOp& exp);
     void AnalyzeLogBinOp(NodeBinOp& exp);
-    void AnalyzeAssign(NodeAssign& stmt);
+    void AnalyzeAssign(NodeAssign& stmt, ExpType(*resultType)(ExpType, ExpType));
 };
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <bstorm/string_util.hpp>
 #include <bstorm/file_util.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <regex>
 
@@ -24,12 +25,36 @@ static std::string varname(const std::shared_ptr<NodeDef>& def)
     return bstorm::DNH_VAR_PREFIX + def->convertedName;
 }
 
-static std::string varname(const std::string& name, const std::shared_ptr<Env>& env)
+static std::string varname(const Ident& name, const std::shared_ptr<Env>& env)
 {
     auto def = env->FindDef(name);
     return bstorm::DNH_VAR_PREFIX + def->convertedName;
 }
 
+// Luaの文字列リテラル
+static std::string ToLuaStrLiteral(const std::wstring& s)
+{
+    std::string lit = "\"";
+    for (char c : ToUTF8(s))
+    {
+        switch (c)
+        {
+            case '\\': lit += "\\\\"; break;
+            case '"': lit += "\\\""; break;
+            case '\n': lit += "\\n"; break;
+            case '\r': lit += "\\r"; break;
+            case '\0': lit += "\\000"; break;
+            default: lit += c; break;
+        }
+    }
+    return lit + "\"";
+}
+
+static bool IsBuiltInCall(const std::shared_ptr<NodeDef>& def, const std::string& name, const char* builtInName)
+{
+    return name == builtInName && std::dynamic_pointer_cast<NodeBuiltInFunc>(def);
+}
+
 static bool isDeclarationNeeded(const std::shared_ptr<NodeDef>& def)
 {
     if (std::dynamic_pointer_cast<NodeVarDecl>(def)) return true;
@@ -53,7 +78,85 @@ void CodeGenerator::Generate(Node & n)
 {
     env_ = nullptr;
     code_.clear();
+    rootDefs_.clear();
+    rootRefCnts_.clear();
+    procRootRefs_.clear();
     n.Traverse(*this);
+    if (option_.promoteGlobalToLocal)
+    {
+        PromoteRootDefs();
+    }
+}
+
+std::string CodeGenerator::VarName(const std::shared_ptr<NodeDef>& def)
+{
+    // チャンク直下からの参照はupvalueにならないので関数内の参照だけ数える
+    if (!procStack_.empty())
+    {
+        auto it = rootRefCnts_.find(def.get());
+        if (it != rootRefCnts_.end())
+        {
+            it->second++;
+            procRootRefs_.back().insert(def.get());
+        }
+    }
+    return varname(def);
+}
+
+std::string CodeGenerator::VarName(const Ident& name)
+{
+    return VarName(env_->FindDef(name));
+}
+
+void CodeGenerator::PromoteRootDefs()
+{
+    // 参照の多いものから順にチャンクのローカル変数にする
+    // ローカル変数の上限(200)とupvalueの上限(60)を超えないように余裕を持たせる
+    constexpr size_t maxChunkLocalCnt = 150;
+    constexpr size_t maxRootUpvalueCnt = 40;
+
+    std::vector<std::shared_ptr<NodeDef>> candidates;
+    for (const auto& def : rootDefs_)
+    {
+        if (rootRefCnts_[def.get()] > 0) candidates.push_back(def);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [this](const std::shared_ptr<NodeDef>& a, const std::shared_ptr<NodeDef>& b)
+    {
+        uint32_t cntA = rootRefCnts_[a.get()];
+        uint32_t cntB = rootRefCnts_[b.get()];
+        if (cntA != cntB) return cntA > cntB;
+        return a->convertedName < b->convertedName;
+    });
+
+    std::vector<size_t> promotedCnts(procRootRefs_.size(), 0);
+    std::string decl;
+    size_t promotedCnt = 0;
+    for (const auto& def : candidates)
+    {
+        if (promotedCnt >= maxChunkLocalCnt) break;
+        bool canPromote = true;
+        for (size_t i = 0; i < procRootRefs_.size(); i++)
+        {
+            if (procRootRefs_[i].count(def.get()) != 0 && promotedCnts[i] >= maxRootUpvalueCnt)
+            {
+                canPromote = false;
+                break;
+            }
+        }
+        if (!canPromote) continue;
+        for (size_t i = 0; i < procRootRefs_.size(); i++)
+        {
+            if (procRootRefs_[i].count(def.get()) != 0) promotedCnts[i]++;
+        }
+        decl += decl.empty() ? "local " : ",";
+        decl += varname(def);
+        promotedCnt++;
+    }
+    if (!decl.empty())
+    {
+        // 行番号がずれないように改行せずに先頭に挿入する
+        code_.insert(0, decl + "; ");
+    }
 }
 
 void CodeGenerator::Traverse(NodeNum& exp)
@@ -70,7 +173,7 @@ void CodeGenerator::Traverse(NodeChar& exp)
 void CodeGenerator::Traverse(NodeStr& exp)
 {
     AddCode("{");
-    for (int i = 0; i < exp.str.size(); i++)
+    for (size_t i = 0; i < exp.str.size(); i++)
     {
         if (i != 0) AddCode(",");
         NodeChar(exp.str[i]).Traverse(*this);
@@ -84,7 +187,7 @@ void CodeGenerator::Traverse(NodeArray& exp)
         AddCode(runtime("arr"));
     }
     AddCode("({");
-    for (int i = 0; i < exp.elems.size(); i++)
+    for (size_t i = 0; i < exp.elems.size(); i++)
     {
         if (i != 0) AddCode(",");
         exp.elems[i]->Traverse(*this);
@@ -103,13 +206,7 @@ void CodeGenerator::Traverse(NodeNeg& exp)
 }
 void CodeGenerator::Traverse(NodeNot& exp)
 {
-    if (exp.rhs->expType == ExpType::BOOL)
-    {
-        AddCode("(not("); exp.rhs->Traverse(*this); AddCode("))");
-    } else
-    {
-        GenMonoOp("not", exp);
-    }
+    AddCode("(not("); GenCondition(exp.rhs); AddCode("))");
 }
 void CodeGenerator::Traverse(NodeAbs& exp) { GenMonoOp("abs", exp); }
 
@@ -124,8 +221,8 @@ void CodeGenerator::Traverse(NodeLt& exp) { GenArithBinOp("lt", "<", exp); }
 void CodeGenerator::Traverse(NodeGt& exp) { GenArithBinOp("gt", ">", exp); }
 void CodeGenerator::Traverse(NodeLe& exp) { GenArithBinOp("le", "<=", exp); }
 void CodeGenerator::Traverse(NodeGe& exp) { GenArithBinOp("ge", ">=", exp); }
-void CodeGenerator::Traverse(NodeEq& exp) { GenArithBinOp("eq", "==", exp); }
-void CodeGenerator::Traverse(NodeNe& exp) { GenArithBinOp("ne", "~=", exp); }
+void CodeGenerator::Traverse(NodeEq& exp) { GenEqBinOp("eq", "==", exp); }
+void CodeGenerator::Traverse(NodeNe& exp) { GenEqBinOp("ne", "~=", exp); }
 
 void CodeGenerator::Traverse(NodeAnd& exp) { GenLogBinOp("and", exp); }
 void CodeGenerator::Traverse(NodeOr& exp) { GenLogBinOp("or", exp); }
@@ -173,7 +270,7 @@ void CodeGenerator::Traverse(NodeNoParenCallExp& call)
 #endif
     } else
     {
-        AddCode(varname(def) + "()");
+        AddCode(VarName(def) + "()");
     }
 }
 
@@ -189,17 +286,17 @@ void CodeGenerator::Traverse(NodeCallExp& call)
 #ifdef _DEBUG
         AddCode(" --[[ " + call.name + " ]]");
 #endif
-    } else
+    } else if (!GenNativeMathCall(def, call))
     {
         bool isUserFunc = !std::dynamic_pointer_cast<NodeBuiltInFunc>(def);
         if (isUserFunc)
         {
-            AddCode(varname(def) + "(");
+            AddCode(VarName(def) + "(");
         } else
         {
             AddCode(builtin(def) + "(");
         }
-        for (int i = 0; i < call.args.size(); i++)
+        for (size_t i = 0; i < call.args.size(); i++)
         {
             if (i != 0) AddCode(",");
             if (isUserFunc)
@@ -207,7 +304,7 @@ void CodeGenerator::Traverse(NodeCallExp& call)
                 GenCopy(*call.args[i]);
             } else
             {
-                call.args[i]->Traverse(*this);
+                GenBuiltInArg(def, i, *call.args[i]);
             }
         }
         AddCode(")");
@@ -238,9 +335,9 @@ void CodeGenerator::NewLine()
     AddCode("\n");
     isLineHead_ = true;
 }
-void CodeGenerator::NewLine(const std::shared_ptr<SourcePos>& srcPos)
+void CodeGenerator::NewLine(const NodePos* srcPos)
 {
-    srcMap_.LogSourcePos(outputLine_, srcPos->filename, srcPos->line);
+    srcMap_.LogSourcePos(outputLine_, srcPos->GetFilename(), srcPos->line);
     NewLine();
 }
 void CodeGenerator::Indent()
@@ -283,6 +380,17 @@ void CodeGenerator::GenArithBinOp(const std::string & fname, const std::string&
 }
 void CodeGenerator::GenLogBinOp(const std::string & fname, NodeBinOp & exp)
 {
+    if (exp.lhs->expType == ExpType::BOOL)
+    {
+        // 左辺がboolならLuaのand/orと同じ結果になる
+        AddCode("(");
+        exp.lhs->Traverse(*this);
+        AddCode(" " + fname + " ");
+        exp.rhs->Traverse(*this);
+        AddCode(")");
+        return;
+    }
+    // 左辺の値をそのまま返す必要があるので右辺を遅延評価する
     AddCode(runtime(fname) + "(");
     exp.lhs->Traverse(*this);
     AddCode(", function() return ");
@@ -290,27 +398,216 @@ void CodeGenerator::GenLogBinOp(const std::string & fname, NodeBinOp & exp)
     AddCode(" end");
     AddCode(")");
 }
-void CodeGenerator::GenNilCheckExp(const std::string & name)
+void CodeGenerator::GenEqBinOp(const std::string & fname, const std::string & op, NodeBinOp & exp)
+{
+    // 文字列同士は1文字ずつ比較せずLuaの文字列にして比較する
+    if (exp.lhs->expType == ExpType::STRING && exp.rhs->expType == ExpType::STRING)
+    {
+        AddCode("(");
+        GenNativeStr(*exp.lhs);
+        AddCode(op);
+        GenNativeStr(*exp.rhs);
+        AddCode(")");
+    } else
+    {
+        GenArithBinOp(fname, op, exp);
+    }
+}
+// 文字列型の式を文字の配列ではなくLuaの文字列として生成する
+// 添字アクセスも変更もされない場所でのみ使う
+void CodeGenerator::GenNativeStr(NodeExp & exp)
+{
+    assert(exp.expType == ExpType::STRING);
+    if (auto str = dynamic_cast<NodeStr*>(&exp))
+    {
+        AddCode(ToLuaStrLiteral(str->str));
+        return;
+    }
+    if (auto cat = dynamic_cast<NodeCat*>(&exp))
+    {
+        auto leftStr = std::dynamic_pointer_cast<NodeStr>(cat->lhs);
+        auto rightStr = std::dynamic_pointer_cast<NodeStr>(cat->rhs);
+        if (leftStr && rightStr)
+        {
+            AddCode(ToLuaStrLiteral(leftStr->str + rightStr->str));
+            return;
+        }
+        AddCode("(");
+        GenNativeStr(*cat->lhs);
+        AddCode("..");
+        GenNativeStr(*cat->rhs);
+        AddCode(")");
+        return;
+    }
+    if (auto call = dynamic_cast<NodeNoParenCallExp*>(&exp))
+    {
+        if (IsBuiltInCall(env_->FindDef(call->name), call->name, "GetCurrentScriptDirectory"))
+        {
+            AddCode(ToLuaStrLiteral(GetParentPath(*call->srcPos->filename) + L"/"));
+            return;
+        }
+    }
+    if (auto call = dynamic_cast<NodeCallExp*>(&exp))
+    {
+        auto def = env_->FindDef(call->name);
+        if (IsBuiltInCall(def, call->name, "GetCurrentScriptDirectory"))
+        {
+            AddCode(ToLuaStrLiteral(GetParentPath(*call->srcPos->filename) + L"/"));
+            return;
+        }
+        if (call->args.size() == 1)
+        {
+            auto& arg = *call->args[0];
+            if (IsBuiltInCall(def, call->name, "IntToString") || IsBuiltInCall(def, call->name, "itoa"))
+            {
+                AddCode(runtime("itostr") + "("); arg.Traverse(*this); AddCode(")");
+                return;
+            }
+            // ToStringは実数を%fで変換するのでrtoaと同じ
+            if (IsBuiltInCall(def, call->name, "rtoa") || (IsBuiltInCall(def, call->name, "ToString") && arg.expType == ExpType::REAL))
+            {
+                AddCode(runtime("rtostr") + "("); arg.Traverse(*this); AddCode(")");
+                return;
+            }
+            if (IsBuiltInCall(def, call->name, "ToString") && arg.expType == ExpType::STRING)
+            {
+                GenNativeStr(arg);
+                return;
+            }
+        }
+    }
+    AddCode(runtime("tostr") + "("); exp.Traverse(*this); AddCode(")");
+}
+// rb_*を経由せずmathの関数で計算できる数学関数
+// NOTE: LuaJITのmath.rad, math.degは定数を掛けるだけなので, 同じ定数を掛ければ結果はビット単位で一致する
+struct MathFunc
+{
+    const char* name;
+    const char* head;
+    const char* sep;
+    const char* tail;
+};
+static const MathFunc mathFuncs[] = {
+    { "cos", "math.cos((", nullptr, ")*0.017453292519943295)" },
+    { "sin", "math.sin((", nullptr, ")*0.017453292519943295)" },
+    { "tan", "math.tan((", nullptr, ")*0.017453292519943295)" },
+    { "acos", "(math.acos(", nullptr, ")*57.29577951308232)" },
+    { "asin", "(math.asin(", nullptr, ")*57.29577951308232)" },
+    { "atan", "(math.atan(", nullptr, ")*57.29577951308232)" },
+    { "atan2", "(math.atan2(", ",", ")*57.29577951308232)" },
+    { "absolute", "math.abs(", nullptr, ")" },
+    { "floor", "math.floor(", nullptr, ")" },
+    { "ceil", "math.ceil(", nullptr, ")" },
+    { "round", "math.floor((", nullptr, ")+0.5)" },
+    { "truncate", "(math.modf(", nullptr, "))" },
+    { "trunc", "(math.modf(", nullptr, "))" },
+    { "log", "math.log(", nullptr, ")" },
+    { "log10", "math.log10(", nullptr, ")" },
+    { "min", "math.min(", ",", ")" },
+    { "max", "math.max(", ",", ")" },
+    { "modc", "math.fmod(", ",", ")" },
+    { "power", "((", ")^(", "))" },
+};
+
+// 必ず数値になる式(数値リテラル, 実数の算術演算, 数学関数の呼び出し)
+// 変数や配列の要素, 関数の戻り値はnilになりうるのでr_tonumを通す
+static bool IsNumExp(NodeExp& exp, const std::shared_ptr<Env>& env)
+{
+    if (dynamic_cast<NodeNum*>(&exp)) return true;
+    if (exp.expType != ExpType::REAL) return false;
+    if (auto call = dynamic_cast<NodeCallExp*>(&exp))
+    {
+        // 組み込みの数学関数はrb_*でもmathでも数値を返す
+        auto func = std::dynamic_pointer_cast<NodeBuiltInFunc>(env->FindDef(call->name));
+        if (!func || !func->isRuntime) return false;
+        return std::any_of(std::begin(mathFuncs), std::end(mathFuncs), [&](const MathFunc& f) { return call->name == f.name; });
+    }
+    if (dynamic_cast<NodeNeg*>(&exp) ||
+        dynamic_cast<NodeAbs*>(&exp) ||
+        dynamic_cast<NodeAdd*>(&exp) ||
+        dynamic_cast<NodeSub*>(&exp) ||
+        dynamic_cast<NodeMul*>(&exp) ||
+        dynamic_cast<NodeDiv*>(&exp) ||
+        dynamic_cast<NodeRem*>(&exp) ||
+        dynamic_cast<NodePow*>(&exp))
+    {
+        return true;
+    }
+    return false;
+}
+
+bool CodeGenerator::GenNativeMathCall(const std::shared_ptr<NodeDef>& def, NodeCallExp & call)
+{
+    // 実数を受け取る数学関数はrb_*を経由せずmathの関数を直接呼ぶ
+    auto func = std::dynamic_pointer_cast<NodeBuiltInFunc>(def);
+    if (!func || !func->isRuntime) return false;
+    for (const auto& arg : call.args)
+    {
+        if (arg->expType != ExpType::REAL) return false;
+    }
+    auto genArg = [this](NodeExp& arg)
+    {
+        if (IsNumExp(arg, env_))
+        {
+            arg.Traverse(*this);
+        } else
+        {
+            AddCode(runtime("tonum") + "("); arg.Traverse(*this); AddCode(")");
+        }
+    };
+    for (const auto& mathFunc : mathFuncs)
+    {
+        if (call.name != mathFunc.name) continue;
+        if (call.args.size() != (mathFunc.sep ? 2 : 1)) return false;
+        AddCode(mathFunc.head);
+        genArg(*call.args[0]);
+        if (mathFunc.sep)
+        {
+            AddCode(mathFunc.sep);
+            genArg(*call.args[1]);
+        }
+        AddCode(mathFunc.tail);
+        return true;
+    }
+    return false;
+}
+
+void CodeGenerator::GenBuiltInArg(const std::shared_ptr<NodeDef>& def, int idx, NodeExp & arg)
+{
+    auto func = std::dynamic_pointer_cast<NodeBuiltInFunc>(def);
+    if (func && func->IsStrParam(idx) && arg.expType == ExpType::STRING)
+    {
+        GenNativeStr(arg);
+    } else
+    {
+        arg.Traverse(*this);
+    }
+}
+void CodeGenerator::GenNilCheckExp(const Ident& name)
 {
     if (option_.enableNilCheck)
     {
-        AddCode(runtime("nc") + "(" + varname(name, env_) + ", \"" + name + "\")");
+        AddCode(runtime("nc") + "(" + VarName(name) + ", \"" + name + "\")");
     } else
     {
-        AddCode(varname(name, env_));
+        AddCode(VarName(name));
     }
 }
-void CodeGenerator::GenNilCheckStmt(const std::string & name)
+void CodeGenerator::GenNilCheckStmt(const Ident& name)
 {
     if (option_.enableNilCheck)
     {
-        AddCode(runtime("nc") + "(" + varname(name, env_) + ", \"" + name + "\")");
+        AddCode(runtime("nc") + "(" + VarName(name) + ", \"" + name + "\")");
     }
 }
-void CodeGenerator::GenProc(const std::shared_ptr<NodeDef>& def, const std::vector<std::string>& params_, NodeBlock & blk)
+void CodeGenerator::GenProc(const std::shared_ptr<NodeDef>& def, const std::vector<Ident>& params_, NodeBlock & blk)
 {
     AddCode(varname(def) + " = function(");
-    for (int i = 0; i < params_.size(); i++)
+    if (procStack_.size() == 1)
+    {
+        procRootRefs_.emplace_back();
+    }
+    for (size_t i = 0; i < params_.size(); i++)
     {
         if (i != 0) AddCode(",");
         AddCode(varname(params_[i], std::make_shared<Env>(blk.nameTable, env_)));
@@ -319,12 +616,12 @@ void CodeGenerator::GenProc(const std::shared_ptr<NodeDef>& def, const std::vect
     if (std::dynamic_pointer_cast<NodeFuncDef>(def))
     {
         blk.Traverse(*this);
-        if (auto result = std::dynamic_pointer_cast<NodeResult>(blk.nameTable->at("result")))
+        if (auto result = std::dynamic_pointer_cast<NodeResult>(blk.nameTable->at(Ident("result"))))
         {
             if (!(result->unreachable && option_.deleteUnreachableDefinition))
             {
                 Indent();
-                AddCode("return " + varname(result) + ";");
+                AddCode("return " + VarName(result) + ";");
                 NewLine(result->srcPos);
                 Unindent();
             }
@@ -340,7 +637,25 @@ void CodeGenerator::GenBlock(NodeBlock & blk, bool doTCO)
     env_ = std::make_shared<Env>(blk.nameTable, env_);
 
     // 宣言生成
-    if (!env_->IsRoot()) // トップレベルはグローバル変数に入れるので宣言不要
+    if (env_->IsRoot()) // トップレベルはグローバル変数に入れる
+    {
+        // 参照数を数えておいて生成後にローカル変数に昇格させる
+        if (option_.promoteGlobalToLocal)
+        {
+            for (const auto& bind : *(blk.nameTable))
+            {
+                auto& def = bind.second;
+                if (def->unreachable && option_.deleteUnreachableDefinition) continue;
+                // @Initializeなどはエンジンから参照されるのでグローバルのまま
+                if (std::dynamic_pointer_cast<NodeBuiltInSubDef>(def)) continue;
+                if (isDeclarationNeeded(def))
+                {
+                    rootDefs_.push_back(def);
+                    rootRefCnts_[def.get()] = 0;
+                }
+            }
+        }
+    } else
     {
 
         Indent();
@@ -365,7 +680,7 @@ void CodeGenerator::GenBlock(NodeBlock & blk, bool doTCO)
     }
 
     // ブロック内の文生成
-    for (int i = 0; i < blk.stmts.size(); i++)
+    for (size_t i = 0; i < blk.stmts.size(); i++)
     {
         auto & stmt = blk.stmts[i];
         if (i == blk.stmts.size() - 1)
@@ -406,7 +721,7 @@ void CodeGenerator::GenCallStmt(NodeCallStmt & call, bool doTCO)
             AddCode(std::to_string(call.args.size())); // 0 ~ max
         }
         AddCode("(");
-        AddCode(varname(def)); // func
+        AddCode(VarName(def)); // func
         if (call.args.size() > 0) // fork0以外
         {
             AddCode(", ");
@@ -419,14 +734,14 @@ void CodeGenerator::GenCallStmt(NodeCallStmt & call, bool doTCO)
     {
         if (isUserFunc)
         {
-            AddCode(varname(def));
+            AddCode(VarName(def));
         } else
         {
             AddCode(builtin(def));
         }
         AddCode("(");
     }
-    for (int i = 0; i < call.args.size(); i++)
+    for (size_t i = 0; i < call.args.size(); i++)
     {
         if (i != 0) AddCode(",");
         if (isUserFunc)
@@ -434,7 +749,7 @@ void CodeGenerator::GenCallStmt(NodeCallStmt & call, bool doTCO)
             GenCopy(*call.args[i]);
         } else
         {
-            call.args[i]->Traverse(*this);
+            GenBuiltInArg(def, i, *call.args[i]);
         }
     }
     if (isTask)
@@ -453,7 +768,7 @@ void CodeGenerator::GenOpAssign(const std::string & fname, const std::shared_ptr
         case 0:
             // in  : a += e;
             // out : a = add(r_nc(a), e);
-            AddCode(varname(left->name, env_) + " = ");
+            AddCode(VarName(left->name) + " = ");
             AddCode(runtime(fname) + "(");
             GenNilCheckExp(left->name);
             if (right)
@@ -472,9 +787,9 @@ void CodeGenerator::GenOpAssign(const std::string & fname, const std::shared_ptr
             GenNilCheckStmt(left->name);
             NewLine(left->srcPos);
             AddCode("local i = "); left->indices[0]->Traverse(*this); AddCode(";"); NewLine(left->srcPos);
-            AddCode(runtime("write1") + "(" + varname(left->name, env_) + ", i, ");
+            AddCode(runtime("write1") + "(" + VarName(left->name) + ", i, ");
             AddCode(runtime(fname) + "(");
-            AddCode(runtime("read") + "(" + varname(left->name, env_) + ", i)");
+            AddCode(runtime("read") + "(" + VarName(left->name) + ", i)");
             if (right)
             {
                 AddCode(",");
@@ -491,20 +806,20 @@ void CodeGenerator::GenOpAssign(const std::string & fname, const std::shared_ptr
             AddCode("do"); NewLine();
             GenNilCheckStmt(left->name); NewLine(left->srcPos);
             AddCode("local is = {");
-            for (int i = 0; i < left->indices.size(); i++)
+            for (size_t i = 0; i < left->indices.size(); i++)
             {
                 if (i != 0) AddCode(",");
                 left->indices[i]->Traverse(*this);
             }
             AddCode("};"); NewLine(left->srcPos);
-            AddCode(runtime("write") + "(" + varname(left->name, env_) + ", is");
+            AddCode(runtime("write") + "(" + VarName(left->name) + ", is");
             AddCode("," + runtime(fname) + "(");
-            for (int i = 0; i < left->indices.size(); i++)
+            for (size_t i = 0; i < left->indices.size(); i++)
             {
                 AddCode(runtime("read") + "(");
             }
-            AddCode(varname(left->name, env_) + ",");
-            for (int i = 0; i < left->indices.size(); i++)
+            AddCode(VarName(left->name) + ",");
+            for (size_t i = 0; i < left->indices.size(); i++)
             {
                 if (i != 0) AddCode(",");
                 AddCode("is[" + std::to_string(i + 1) + "])");
@@ -521,7 +836,9 @@ void CodeGenerator::GenOpAssign(const std::string & fname, const std::shared_ptr
 }
 void CodeGenerator::GenCopy(NodeExp& exp)
 {
-    if (exp.copyRequired)
+    // 配列でないことが分かっている値はコピーしても同じ
+    bool isScalar = exp.expType == ExpType::REAL || exp.expType == ExpType::BOOL || exp.expType == ExpType::CHAR;
+    if (exp.copyRequired && !isScalar)
     {
         AddCode(runtime("cp")); AddCode("("); exp.Traverse(*this); AddCode(")");
     } else
@@ -532,7 +849,14 @@ void CodeGenerator::GenCopy(NodeExp& exp)
 
 void CodeGenerator::GenCondition(std::shared_ptr<NodeExp>& exp)
 {
-    if (exp->expType == ExpType::BOOL)
+    // 条件式では真偽だけを見るので値を保持せずに短絡評価する
+    if (auto andExp = std::dynamic_pointer_cast<NodeAnd>(exp))
+    {
+        AddCode("("); GenCondition(andExp->lhs); AddCode(" and "); GenCondition(andExp->rhs); AddCode(")");
+    } else if (auto orExp = std::dynamic_pointer_cast<NodeOr>(exp))
+    {
+        AddCode("("); GenCondition(orExp->lhs); AddCode(" or "); GenCondition(orExp->rhs); AddCode(")");
+    } else if (exp->expType == ExpType::BOOL)
     {
         exp->Traverse(*this);
     } else
@@ -546,7 +870,7 @@ void CodeGenerator::GenCase(NodeCase & cs, ExpType condType)
     assert(!cs.exps.empty());
     AddCode("if ");
     // orの右結合計算列を作る(右結合の方が早く短絡するので)
-    for (int i = 0; i < cs.exps.size(); i++)
+    for (size_t i = 0; i < cs.exps.size(); i++)
     {
         auto& exp = cs.exps[i];
         if (i != 0) AddCode(" or (");
@@ -559,7 +883,7 @@ void CodeGenerator::GenCase(NodeCase & cs, ExpType condType)
             AddCode(runtime("eq") + "(c,"); exp->Traverse(*this); AddCode(")");
         }
     }
-    for (int i = 0; i < cs.exps.size() - 1; i++)
+    for (size_t i = 0; i < cs.exps.size() - 1; i++)
     {
         AddCode(")");
     }
@@ -606,7 +930,7 @@ void CodeGenerator::Traverse(NodeAssign& stmt)
                     {
                         AddCode(runtime("mcat"));
                         AddCode("(");
-                        AddCode(varname(def));
+                        AddCode(VarName(def));
                         AddCode(",");
                         binOp->rhs->Traverse(*this);
                         AddCode(");");
@@ -616,7 +940,7 @@ void CodeGenerator::Traverse(NodeAssign& stmt)
             }
             // in  : a = e;
             // out : a = r_cp(e);
-            AddCode(varname(def) + " = "); GenCopy(*stmt.rhs); AddCode(";");
+            AddCode(VarName(def) + " = "); GenCopy(*stmt.rhs); AddCode(";");
             break;
         case 1:
             // in  : a[i] = e;
@@ -637,7 +961,7 @@ void CodeGenerator::Traverse(NodeAssign& stmt)
             AddCode("(");
             GenNilCheckExp(def->name);
             AddCode(", {");
-            for (int i = 0; i < stmt.lhs->indices.size(); i++)
+            for (size_t i = 0; i < stmt.lhs->indices.size(); i++)
             {
                 if (i != 0) AddCode(",");
                 stmt.lhs->indices[i]->Traverse(*this);
@@ -676,12 +1000,12 @@ void CodeGenerator::Traverse(NodeReturnVoid& stmt)
     {
         if (auto func = std::dynamic_pointer_cast<NodeFuncDef>(procStack_.top()))
         {
-            if (auto result = std::dynamic_pointer_cast<NodeResult>(func->block->nameTable->at("result")))
+            if (auto result = std::dynamic_pointer_cast<NodeResult>(func->block->nameTable->at(Ident("result"))))
             {
                 if (!(result->unreachable && option_.deleteUnreachableDefinition))
                 {
                     // return result
-                    AddCode("do return " + varname(result) + " end");
+                    AddCode("do return " + VarName(result) + " end");
                 } else
                 {
                     AddCode("do return end");
@@ -738,13 +1062,13 @@ void CodeGenerator::Traverse(NodeVarInit& stmt)
         }
     }
 
-    AddCode(varname(stmt.name, env_) + " = "); GenCopy(*stmt.rhs); AddCode(";");
+    AddCode(VarName(stmt.name) + " = "); GenCopy(*stmt.rhs); AddCode(";");
     NewLine(stmt.rhs->srcPos);
 }
 void CodeGenerator::Traverse(NodeProcParam &) {}
 void CodeGenerator::Traverse(NodeLoopParam& param)
 {
-    AddCode("local " + varname(param.name, env_) + " = " + runtime("cp") + "(i);");
+    AddCode("local " + VarName(param.name) + " = " + runtime("cp") + "(i);");
     NewLine(param.srcPos);
 }
 void CodeGenerator::Traverse(NodeResult &) {}
@@ -883,7 +1207,7 @@ void CodeGenerator::Traverse(NodeAlternative& stmt)
     AddCode("do"); NewLine();
     AddCode("local c = "); GenCopy(*stmt.cond); AddCode(";"); NewLine(stmt.cond->srcPos);
     /* gen if-seq */
-    for (int i = 0; i < stmt.cases.size(); i++)
+    for (size_t i = 0; i < stmt.cases.size(); i++)
     {
         // case
         if (i != 0) AddCode("else"); // 1つ目以降のcaseはelse if
@@ -8,6 +8,8 @@
 #include <string>
 #include <stack>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace bstorm
 {
@@ -19,6 +21,8 @@ public:
         bool enableNilCheck = true;
         bool deleteUnreachableDefinition = false;
         bool deleteUnneededAssign = false;
+        bool promoteGlobalToLocal = false;
+        bool foldConstants = true; // CompileDnhScriptがConstantFolderを通す
     };
     CodeGenerator(const Option& option);
     void Generate(Node& program);
@@ -95,26 +99,37 @@ private:
     void AddCode(const std::wstring& s);
     void AddCode(const std::string& s);
     void NewLine();
-    void NewLine(const std::shared_ptr<SourcePos>& srcPos);
+    void NewLine(const NodePos* srcPos);
     void Indent();
     void Unindent();
     void GenMonoOp(const std::string& fname, NodeMonoOp& exp);
     void GenBinOp(const std::string& fname, NodeBinOp& exp);
     void GenArithBinOp(const std::string& fname, const std::string& op, NodeBinOp& exp);
     void GenLogBinOp(const std::string& fname, NodeBinOp& exp);
-    void GenNilCheckExp(const std::string& name);
-    void GenNilCheckStmt(const std::string& name);
-    void GenProc(const std::shared_ptr<NodeDef>& def, const std::vector<std::string>& params_, NodeBlock& blk);
+    void GenEqBinOp(const std::string& fname, const std::string& op, NodeBinOp& exp);
+    void GenNativeStr(NodeExp& exp);
+    void GenBuiltInArg(const std::shared_ptr<NodeDef>& def, int idx, NodeExp& arg);
+    bool GenNativeMathCall(const std::shared_ptr<NodeDef>& def, NodeCallExp& call);
+    void GenNilCheckExp(const Ident& name);
+    void GenNilCheckStmt(const Ident& name);
+    void GenProc(const std::shared_ptr<NodeDef>& def, const std::vector<Ident>& params_, NodeBlock& blk);
     void GenBlock(NodeBlock& blk, bool doTCO);
     void GenCallStmt(NodeCallStmt& call, bool doTCO);
     void GenOpAssign(const std::string& fname, const std::shared_ptr<NodeLeftVal>& left, const NullableSharedPtr<NodeExp>& right);
     void GenCopy(NodeExp& exp);
     void GenCondition(std::shared_ptr<NodeExp>& exp);
     void GenCase(NodeCase& cs, ExpType condType);
+    std::string VarName(const std::shared_ptr<NodeDef>& def);
+    std::string VarName(const Ident& name);
+    void PromoteRootDefs();
     std::shared_ptr<Env> env_;
     std::stack<std::shared_ptr<NodeDef>> procStack_;
     std::string code_;
     SourceMap srcMap_;
+    // トップレベルの定義をチャンクのローカル変数に昇格させるための情報
+    std::vector<std::shared_ptr<NodeDef>> rootDefs_;
+    std::unordered_map<const NodeDef*, uint32_t> rootRefCnts_;
+    std::vector<std::unordered_set<const NodeDef*>> procRootRefs_; // トップレベルの関数毎に参照している定義
     int indentLevel_;
     int outputLine_;
     bool isLineHead_;
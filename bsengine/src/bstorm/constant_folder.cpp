@@ -0,0 +1,671 @@
+﻿#include <bstorm/constant_folder.hpp>
+
+#include <bstorm/env.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bstorm
+{
+// NOTE: 到達可能な部分だけ畳み込む
+
+static std::string FormatNum(double v)
+{
+    char buf[32];
+    if (v == std::floor(v) && std::abs(v) < 1e15)
+    {
+        snprintf(buf, sizeof(buf), "%.0f", v);
+    } else
+    {
+        snprintf(buf, sizeof(buf), "%.17g", v);
+    }
+    // 負数は a - -1 が a--1 (コメント) にならないように括弧で囲む
+    return std::signbit(v) ? ("(" + std::string(buf) + ")") : buf;
+}
+
+static bool ParseNum(std::string s, double& v)
+{
+    if (s.size() >= 2 && s.front() == '(' && s.back() == ')')
+    {
+        s = s.substr(1, s.size() - 2);
+    }
+    char* end;
+    v = std::strtod(s.c_str(), &end);
+    return !s.empty() && *end == '\0';
+}
+
+static double Add(double x, double y) { return x + y; }
+static double Sub(double x, double y) { return x - y; }
+static double Mul(double x, double y) { return x * y; }
+static double Div(double x, double y) { return x / y; }
+static double Rem(double x, double y) { return x - std::floor(x / y) * y; } // Luaの%と同じ
+static double Pow(double x, double y) { return std::pow(x, y); }
+static bool Lt(double x, double y) { return x < y; }
+static bool Gt(double x, double y) { return x > y; }
+static bool Le(double x, double y) { return x <= y; }
+static bool Ge(double x, double y) { return x >= y; }
+
+ConstantFolder::ConstantFolder() :
+    isConst_(false),
+    procEntryAssignedDefs_(nullptr)
+{
+}
+
+void ConstantFolder::Fold(Node & n, const std::unordered_set<const NodeDef*>& procEntryAssignedDefs)
+{
+    env_ = nullptr;
+    constVars_.clear();
+    procEntryAssignedDefs_ = &procEntryAssignedDefs;
+    n.Traverse(*this);
+    procEntryAssignedDefs_ = nullptr;
+}
+
+void ConstantFolder::Traverse(NodeNum & lit)
+{
+    double v;
+    if (ParseNum(lit.number, v)) SetReal(v);
+}
+void ConstantFolder::Traverse(NodeChar & lit)
+{
+    isConst_ = true;
+    value_ = ConstValue();
+    value_.type = ConstValue::Type::CHAR;
+    value_.c = lit.c;
+}
+void ConstantFolder::Traverse(NodeStr & lit) { SetStr(lit.str); }
+void ConstantFolder::Traverse(NodeArray & array)
+{
+    for (auto& e : array.elems)
+    {
+        FoldExp(e);
+    }
+    isConst_ = false;
+}
+void ConstantFolder::Traverse(NodeNeg & exp)
+{
+    if (FoldExp(exp.rhs) && value_.type == ConstValue::Type::REAL)
+    {
+        SetReal(-value_.real);
+    } else
+    {
+        isConst_ = false;
+    }
+}
+void ConstantFolder::Traverse(NodeNot & exp)
+{
+    int truth = FoldExp(exp.rhs) ? GetTruth(value_) : -1;
+    if (truth != -1)
+    {
+        SetBool(!truth);
+    } else
+    {
+        isConst_ = false;
+    }
+}
+void ConstantFolder::Traverse(NodeAbs & exp)
+{
+    if (FoldExp(exp.rhs) && value_.type == ConstValue::Type::REAL)
+    {
+        SetReal(std::abs(value_.real));
+    } else
+    {
+        isConst_ = false;
+    }
+}
+void ConstantFolder::Traverse(NodeAdd & exp) { FoldArithBinOp(exp, Add); }
+void ConstantFolder::Traverse(NodeSub & exp) { FoldArithBinOp(exp, Sub); }
+void ConstantFolder::Traverse(NodeMul & exp) { FoldArithBinOp(exp, Mul); }
+void ConstantFolder::Traverse(NodeDiv & exp) { FoldArithBinOp(exp, Div); }
+void ConstantFolder::Traverse(NodeRem & exp) { FoldArithBinOp(exp, Rem); }
+void ConstantFolder::Traverse(NodePow & exp) { FoldArithBinOp(exp, Pow); }
+void ConstantFolder::Traverse(NodeLt & exp) { FoldCmpBinOp(exp, Lt); }
+void ConstantFolder::Traverse(NodeGt & exp) { FoldCmpBinOp(exp, Gt); }
+void ConstantFolder::Traverse(NodeLe & exp) { FoldCmpBinOp(exp, Le); }
+void ConstantFolder::Traverse(NodeGe & exp) { FoldCmpBinOp(exp, Ge); }
+void ConstantFolder::Traverse(NodeEq & exp) { FoldEqBinOp(exp, true); }
+void ConstantFolder::Traverse(NodeNe & exp) { FoldEqBinOp(exp, false); }
+void ConstantFolder::Traverse(NodeAnd & exp) { FoldLogBinOp(exp, true); }
+void ConstantFolder::Traverse(NodeOr & exp) { FoldLogBinOp(exp, false); }
+void ConstantFolder::Traverse(NodeCat & exp)
+{
+    bool isLeftConst = FoldExp(exp.lhs);
+    auto l = value_;
+    bool isRightConst = FoldExp(exp.rhs);
+    auto r = value_;
+    if (isLeftConst && isRightConst && l.type == ConstValue::Type::STRING && r.type == ConstValue::Type::STRING)
+    {
+        SetStr(l.str + r.str);
+    } else
+    {
+        isConst_ = false;
+    }
+}
+void ConstantFolder::Traverse(NodeNoParenCallExp & call)
+{
+    isConst_ = false;
+    auto def = env_->FindDef(call.name);
+    if (auto c = std::dynamic_pointer_cast<NodeConst>(def))
+    {
+        double v;
+        if (c->retType == ExpType::BOOL)
+        {
+            SetBool(c->value == "true");
+        } else if (c->retType == ExpType::REAL && ParseNum(c->value, v))
+        {
+            SetReal(v);
+        }
+    } else if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(def))
+    {
+        auto it = constVars_.find(varDecl.get());
+        if (it != constVars_.end())
+        {
+            // リテラルに置き換わるので参照数から外す
+            if (varDecl->refCnt > 0) varDecl->refCnt--;
+            isConst_ = true;
+            value_ = it->second;
+        }
+    }
+}
+void ConstantFolder::Traverse(NodeCallExp & call)
+{
+    std::vector<ConstValue> args;
+    bool isAllConst = true;
+    for (auto& arg : call.args)
+    {
+        if (FoldExp(arg))
+        {
+            args.push_back(value_);
+        } else
+        {
+            isAllConst = false;
+        }
+    }
+    isConst_ = false;
+    if (isAllConst && std::dynamic_pointer_cast<NodeBuiltInFunc>(env_->FindDef(call.name)))
+    {
+        FoldBuiltInCall(call.name, args);
+    }
+}
+void ConstantFolder::Traverse(NodeArrayRef & exp)
+{
+    FoldExp(exp.array);
+    FoldExp(exp.idx);
+    isConst_ = false;
+}
+void ConstantFolder::Traverse(NodeRange & range)
+{
+    FoldExp(range.start);
+    FoldExp(range.end);
+}
+void ConstantFolder::Traverse(NodeArraySlice & exp)
+{
+    FoldExp(exp.array);
+    exp.range->Traverse(*this);
+    isConst_ = false;
+}
+void ConstantFolder::Traverse(NodeNop &) {}
+void ConstantFolder::Traverse(NodeLeftVal & left)
+{
+    for (auto& idx : left.indices)
+    {
+        FoldExp(idx);
+    }
+}
+void ConstantFolder::Traverse(NodeAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeAddAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeSubAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeMulAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeDivAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeRemAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodePowAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeCatAssign & stmt) { FoldAssign(stmt); }
+void ConstantFolder::Traverse(NodeCallStmt & call)
+{
+    for (auto& arg : call.args)
+    {
+        FoldExp(arg);
+    }
+}
+void ConstantFolder::Traverse(NodeReturn & stmt)
+{
+    FoldExp(stmt.ret);
+}
+void ConstantFolder::Traverse(NodeReturnVoid &) {}
+void ConstantFolder::Traverse(NodeYield &) {}
+void ConstantFolder::Traverse(NodeBreak &) {}
+void ConstantFolder::Traverse(NodeSucc & stmt)
+{
+    stmt.lhs->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodePred & stmt)
+{
+    stmt.lhs->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeVarDecl &) {}
+void ConstantFolder::Traverse(NodeVarInit & stmt)
+{
+    if (FoldExp(stmt.rhs))
+    {
+        // 初期化以外で代入されない変数は定数
+        if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(env_->FindDef(stmt.name)))
+        {
+            if (varDecl->assignCnt == 1)
+            {
+                constVars_[varDecl.get()] = value_;
+            }
+        }
+    }
+}
+void ConstantFolder::Traverse(NodeProcParam &) {}
+void ConstantFolder::Traverse(NodeLoopParam &) {}
+void ConstantFolder::Traverse(NodeResult &) {}
+void ConstantFolder::Traverse(NodeBlock & blk)
+{
+    env_ = std::make_shared<Env>(blk.nameTable, env_);
+
+    for (auto& stmt : blk.stmts)
+    {
+        replacedStmt_ = nullptr;
+        stmt->Traverse(*this);
+        if (replacedStmt_)
+        {
+            stmt = replacedStmt_;
+            replacedStmt_ = nullptr;
+        }
+    }
+
+    // 初期化済みの変数を関数の中に伝播させるため定義は文の後に処理する
+    for (const auto& bind : *(blk.nameTable))
+    {
+        auto& def = bind.second;
+        if (def->unreachable) continue;
+        def->Traverse(*this);
+    }
+
+    env_ = env_->GetParent();
+}
+void ConstantFolder::Traverse(NodeSubDef & def)
+{
+    FoldProc(*def.block);
+}
+void ConstantFolder::Traverse(NodeBuiltInSubDef & def)
+{
+    FoldProc(*def.block);
+}
+void ConstantFolder::Traverse(NodeFuncDef & def)
+{
+    FoldProc(*def.block);
+}
+void ConstantFolder::Traverse(NodeTaskDef & def)
+{
+    FoldProc(*def.block);
+}
+void ConstantFolder::Traverse(NodeBuiltInFunc &) {}
+void ConstantFolder::Traverse(NodeConst &) {}
+void ConstantFolder::Traverse(NodeLocal & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeLoop & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeTimes & stmt)
+{
+    FoldExp(stmt.cnt);
+    stmt.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeWhile & stmt)
+{
+    bool isConst = FoldExp(stmt.cond);
+    auto cond = value_;
+    stmt.block->Traverse(*this);
+    if (isConst && GetTruth(cond) == 0)
+    {
+        replacedStmt_ = std::make_shared<NodeNop>();
+        replacedStmt_->srcPos = stmt.srcPos;
+    }
+}
+void ConstantFolder::Traverse(NodeAscent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeDescent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeElseIf & elsif)
+{
+    FoldExp(elsif.cond);
+    elsif.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeIf & stmt)
+{
+    auto foldCond = [this](std::shared_ptr<NodeExp>& cond) -> int
+    {
+        return FoldExp(cond) ? GetTruth(value_) : -1;
+    };
+
+    std::vector<int> conds;
+    conds.push_back(foldCond(stmt.cond));
+    stmt.thenBlock->Traverse(*this);
+    for (auto& elsif : stmt.elsifs)
+    {
+        conds.push_back(foldCond(elsif->cond));
+        elsif->block->Traverse(*this);
+    }
+    if (stmt.elseBlock) stmt.elseBlock->Traverse(*this);
+
+    if (std::all_of(conds.begin(), conds.end(), [](int c) { return c == -1; })) return;
+
+    // 偽の分岐を除き, 真の分岐以降はelseにする
+    std::vector<std::shared_ptr<NodeElseIf>> branches;
+    auto elseBlock = stmt.elseBlock;
+    for (size_t i = 0; i < conds.size(); i++)
+    {
+        auto& cond = i == 0 ? stmt.cond : stmt.elsifs[i - 1]->cond;
+        auto& block = i == 0 ? stmt.thenBlock : stmt.elsifs[i - 1]->block;
+        if (conds[i] == 0) continue;
+        if (conds[i] == 1)
+        {
+            elseBlock = block;
+            break;
+        }
+        if (i == 0)
+        {
+            branches.push_back(std::make_shared<NodeElseIf>(cond, block));
+            branches.back()->srcPos = stmt.srcPos;
+        } else
+        {
+            branches.push_back(stmt.elsifs[i - 1]);
+        }
+    }
+
+    if (branches.empty())
+    {
+        if (elseBlock)
+        {
+            replacedStmt_ = std::make_shared<NodeLocal>(elseBlock);
+        } else
+        {
+            replacedStmt_ = std::make_shared<NodeNop>();
+        }
+    } else
+    {
+        auto first = branches.front();
+        branches.erase(branches.begin());
+        replacedStmt_ = std::make_shared<NodeIf>(first->cond, first->block, std::move(branches), elseBlock);
+    }
+    replacedStmt_->srcPos = stmt.srcPos;
+}
+void ConstantFolder::Traverse(NodeCase & c)
+{
+    for (auto& exp : c.exps)
+    {
+        FoldExp(exp);
+    }
+    c.block->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeAlternative & stmt)
+{
+    FoldExp(stmt.cond);
+    for (auto& c : stmt.cases) c->Traverse(*this);
+    if (stmt.others) stmt.others->Traverse(*this);
+}
+void ConstantFolder::Traverse(NodeHeader &) {}
+
+bool ConstantFolder::FoldExp(std::shared_ptr<NodeExp>& exp)
+{
+    isConst_ = false;
+    replacedExp_ = nullptr;
+    exp->Traverse(*this);
+    if (replacedExp_)
+    {
+        exp = replacedExp_;
+        replacedExp_ = nullptr;
+    }
+    if (isConst_) exp->noSubEffect = true;
+    if (isConst_ && !IsLiteral(exp))
+    {
+        if (auto lit = CreateLiteral(value_))
+        {
+            lit->srcPos = exp->srcPos;
+            exp = lit;
+        }
+    }
+    return isConst_;
+}
+
+bool ConstantFolder::IsLiteral(const std::shared_ptr<NodeExp>& exp) const
+{
+    if (std::dynamic_pointer_cast<NodeNum>(exp)) return true;
+    if (std::dynamic_pointer_cast<NodeChar>(exp)) return true;
+    if (std::dynamic_pointer_cast<NodeStr>(exp)) return true;
+    if (auto call = std::dynamic_pointer_cast<NodeNoParenCallExp>(exp))
+    {
+        return (bool)std::dynamic_pointer_cast<NodeConst>(env_->FindDef(call->name));
+    }
+    return false;
+}
+
+std::shared_ptr<NodeExp> ConstantFolder::CreateLiteral(const ConstValue & value) const
+{
+    switch (value.type)
+    {
+        case ConstValue::Type::REAL:
+            return std::make_shared<NodeNum>(FormatNum(value.real));
+        case ConstValue::Type::CHAR:
+            return std::make_shared<NodeChar>(value.c);
+        case ConstValue::Type::STRING:
+            return std::make_shared<NodeStr>(std::wstring(value.str));
+        case ConstValue::Type::BOOL:
+        {
+            // boolのリテラルは組み込み定数のtrue, falseを参照する
+            const Ident name(value.b ? "true" : "false");
+            if (!std::dynamic_pointer_cast<NodeConst>(env_->FindDef(name))) return nullptr;
+            auto lit = std::make_shared<NodeNoParenCallExp>(name);
+            lit->expType = ExpType::BOOL;
+            lit->noSubEffect = true;
+            lit->copyRequired = false;
+            return lit;
+        }
+    }
+    return nullptr;
+}
+
+int ConstantFolder::GetTruth(const ConstValue & value)
+{
+    // r_toboolと同じ, 文字はNULでなければ真
+    switch (value.type)
+    {
+        case ConstValue::Type::REAL: return value.real != 0;
+        case ConstValue::Type::BOOL: return value.b;
+        case ConstValue::Type::CHAR: return value.c != L'\0';
+        case ConstValue::Type::STRING: return !value.str.empty();
+    }
+    return -1;
+}
+
+void ConstantFolder::FoldArithBinOp(NodeBinOp & exp, double(*op)(double, double))
+{
+    bool isLeftConst = FoldExp(exp.lhs);
+    auto l = value_;
+    bool isRightConst = FoldExp(exp.rhs);
+    auto r = value_;
+    if (isLeftConst && isRightConst && l.type == ConstValue::Type::REAL && r.type == ConstValue::Type::REAL)
+    {
+        SetReal(op(l.real, r.real));
+    } else
+    {
+        isConst_ = false;
+    }
+}
+
+void ConstantFolder::FoldCmpBinOp(NodeBinOp & exp, bool(*op)(double, double))
+{
+    bool isLeftConst = FoldExp(exp.lhs);
+    auto l = value_;
+    bool isRightConst = FoldExp(exp.rhs);
+    auto r = value_;
+    if (isLeftConst && isRightConst && l.type == ConstValue::Type::REAL && r.type == ConstValue::Type::REAL)
+    {
+        SetBool(op(l.real, r.real));
+    } else
+    {
+        isConst_ = false;
+    }
+}
+
+void ConstantFolder::FoldEqBinOp(NodeBinOp & exp, bool isEq)
+{
+    bool isLeftConst = FoldExp(exp.lhs);
+    auto l = value_;
+    bool isRightConst = FoldExp(exp.rhs);
+    auto r = value_;
+    isConst_ = false;
+    // 型が違う場合は実行時エラーになるので畳み込まない
+    if (!isLeftConst || !isRightConst || l.type != r.type) return;
+    bool eq = false;
+    switch (l.type)
+    {
+        case ConstValue::Type::REAL: eq = l.real == r.real; break;
+        case ConstValue::Type::BOOL: eq = l.b == r.b; break;
+        case ConstValue::Type::CHAR: eq = l.c == r.c; break;
+        case ConstValue::Type::STRING: eq = l.str == r.str; break;
+    }
+    SetBool(isEq ? eq : !eq);
+}
+
+void ConstantFolder::FoldLogBinOp(NodeBinOp & exp, bool isAnd)
+{
+    bool isLeftConst = FoldExp(exp.lhs);
+    auto l = value_;
+    bool isRightConst = FoldExp(exp.rhs);
+    auto r = value_;
+    isConst_ = false;
+    int truth = isLeftConst ? GetTruth(l) : -1;
+    if (truth == -1) return;
+    // r_and, r_orと同じく左辺か右辺の値そのものになる
+    if ((truth == 1) == isAnd)
+    {
+        replacedExp_ = exp.rhs;
+        isConst_ = isRightConst;
+        value_ = r;
+    } else
+    {
+        replacedExp_ = exp.lhs;
+        isConst_ = true;
+        value_ = l;
+    }
+}
+
+void ConstantFolder::FoldBuiltInCall(const std::string & name, const std::vector<ConstValue>& args)
+{
+    // 副作用がなく結果が引数だけで決まる組み込み関数
+    if (args.size() == 1)
+    {
+        const auto& x = args[0];
+        if (name == "ToString")
+        {
+            if (x.type == ConstValue::Type::REAL) SetStr(std::to_wstring(x.real));
+            if (x.type == ConstValue::Type::BOOL) SetStr(x.b ? L"true" : L"false");
+            if (x.type == ConstValue::Type::STRING && !x.str.empty()) SetStr(x.str);
+            return;
+        }
+        if (x.type != ConstValue::Type::REAL) return;
+        const double v = x.real;
+        if (name == "absolute")
+        {
+            SetReal(std::abs(v));
+        } else if (name == "truncate" || name == "trunc")
+        {
+            SetReal(std::trunc(v));
+        } else if (name == "round")
+        {
+            SetReal(std::floor(v + 0.5));
+        } else if (name == "floor")
+        {
+            SetReal(std::floor(v));
+        } else if (name == "ceil")
+        {
+            SetReal(std::ceil(v));
+        } else if (name == "IntToString" || name == "itoa")
+        {
+            if (std::abs(v) < 2147483648.0) SetStr(std::to_wstring((long long)std::trunc(v)));
+        } else if (name == "rtoa")
+        {
+            SetStr(std::to_wstring(v));
+        }
+    } else if (args.size() == 2)
+    {
+        const auto& x = args[0];
+        const auto& y = args[1];
+        if (x.type != ConstValue::Type::REAL || y.type != ConstValue::Type::REAL) return;
+        if (name == "min")
+        {
+            SetReal(std::fmin(x.real, y.real));
+        } else if (name == "max")
+        {
+            SetReal(std::fmax(x.real, y.real));
+        } else if (name == "power")
+        {
+            SetReal(std::pow(x.real, y.real));
+        } else if (name == "modc")
+        {
+            SetReal(std::fmod(x.real, y.real));
+        }
+    }
+}
+
+void ConstantFolder::FoldAssign(NodeAssign & stmt)
+{
+    stmt.lhs->Traverse(*this);
+    FoldExp(stmt.rhs);
+}
+
+void ConstantFolder::FoldProc(NodeBlock & blk)
+{
+    // 手続きは外側の初期化より前に呼ばれうるので, 手続きの開始時に必ず初期化済みの変数だけ伝播させる
+    auto outerConstVars = constVars_;
+    for (auto it = constVars_.begin(); it != constVars_.end();)
+    {
+        if (procEntryAssignedDefs_->count(it->first) == 0)
+        {
+            it = constVars_.erase(it);
+        } else
+        {
+            ++it;
+        }
+    }
+    blk.Traverse(*this);
+    constVars_ = std::move(outerConstVars);
+}
+void ConstantFolder::SetReal(double v)
+{
+    // inf, nanはリテラルにできない
+    isConst_ = std::isfinite(v);
+    value_ = ConstValue();
+    value_.type = ConstValue::Type::REAL;
+    value_.real = v;
+}
+
+void ConstantFolder::SetBool(bool b)
+{
+    isConst_ = true;
+    value_ = ConstValue();
+    value_.type = ConstValue::Type::BOOL;
+    value_.b = b;
+}
+
+void ConstantFolder::SetStr(const std::wstring & s)
+{
+    isConst_ = true;
+    value_ = ConstValue();
+    value_.type = ConstValue::Type::STRING;
+    value_.str = s;
+}
+}
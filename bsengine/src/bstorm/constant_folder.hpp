@@ -0,0 +1,123 @@
+﻿#pragma once
+
+#include <bstorm/node.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace bstorm
+{
+class Env;
+// 定数式の畳み込み, 再代入されない変数の定数伝播, 条件が定数の分岐の除去を行う
+// CodeAnalyzerの解析結果(型, 代入回数, 到達可能性)を使うので解析後に行う
+class ConstantFolder : public NodeTraverser
+{
+public:
+    ConstantFolder();
+    // procEntryAssignedDefs: CodeAnalyzer::GetProcEntryAssignedDefs
+    void Fold(Node& program, const std::unordered_set<const NodeDef*>& procEntryAssignedDefs);
+    void Traverse(NodeNum&) override;
+    void Traverse(NodeChar&) override;
+    void Traverse(NodeStr&) override;
+    void Traverse(NodeArray&) override;
+    void Traverse(NodeNeg&) override;
+    void Traverse(NodeNot&) override;
+    void Traverse(NodeAbs&) override;
+    void Traverse(NodeAdd&) override;
+    void Traverse(NodeSub&) override;
+    void Traverse(NodeMul&) override;
+    void Traverse(NodeDiv&) override;
+    void Traverse(NodeRem&) override;
+    void Traverse(NodePow&) override;
+    void Traverse(NodeLt&) override;
+    void Traverse(NodeGt&) override;
+    void Traverse(NodeLe&) override;
+    void Traverse(NodeGe&) override;
+    void Traverse(NodeEq&) override;
+    void Traverse(NodeNe&) override;
+    void Traverse(NodeAnd&) override;
+    void Traverse(NodeOr&) override;
+    void Traverse(NodeCat&) override;
+    void Traverse(NodeNoParenCallExp&) override;
+    void Traverse(NodeCallExp&) override;
+    void Traverse(NodeArrayRef&) override;
+    void Traverse(NodeRange&) override;
+    void Traverse(NodeArraySlice&) override;
+    void Traverse(NodeNop&) override;
+    void Traverse(NodeLeftVal&) override;
+    void Traverse(NodeAssign&) override;
+    void Traverse(NodeAddAssign&) override;
+    void Traverse(NodeSubAssign&) override;
+    void Traverse(NodeMulAssign&) override;
+    void Traverse(NodeDivAssign&) override;
+    void Traverse(NodeRemAssign&) override;
+    void Traverse(NodePowAssign&) override;
+    void Traverse(NodeCatAssign&) override;
+    void Traverse(NodeCallStmt&) override;
+    void Traverse(NodeReturn&) override;
+    void Traverse(NodeReturnVoid&) override;
+    void Traverse(NodeYield&) override;
+    void Traverse(NodeBreak&) override;
+    void Traverse(NodeSucc&) override;
+    void Traverse(NodePred&) override;
+    void Traverse(NodeVarDecl&) override;
+    void Traverse(NodeVarInit&) override;
+    void Traverse(NodeProcParam&) override;
+    void Traverse(NodeLoopParam&) override;
+    void Traverse(NodeResult&) override;
+    void Traverse(NodeBlock&) override;
+    void Traverse(NodeSubDef&) override;
+    void Traverse(NodeBuiltInSubDef&) override;
+    void Traverse(NodeFuncDef&) override;
+    void Traverse(NodeTaskDef&) override;
+    void Traverse(NodeBuiltInFunc&) override;
+    void Traverse(NodeConst&) override;
+    void Traverse(NodeLocal&) override;
+    void Traverse(NodeLoop&) override;
+    void Traverse(NodeTimes&) override;
+    void Traverse(NodeWhile&) override;
+    void Traverse(NodeAscent&) override;
+    void Traverse(NodeDescent&) override;
+    void Traverse(NodeElseIf&) override;
+    void Traverse(NodeIf&) override;
+    void Traverse(NodeCase&) override;
+    void Traverse(NodeAlternative&) override;
+    void Traverse(NodeHeader&) override;
+private:
+    struct ConstValue
+    {
+        enum class Type { REAL, BOOL, CHAR, STRING };
+        Type type = Type::REAL;
+        double real = 0.0;
+        bool b = false;
+        wchar_t c = L'\0';
+        std::wstring str;
+    };
+    // 式を畳み込み, 定数ならリテラルに置き換えてtrueを返す, 値はvalue_に入る
+    bool FoldExp(std::shared_ptr<NodeExp>& exp);
+    bool IsLiteral(const std::shared_ptr<NodeExp>& exp) const;
+    // 真偽が決まるなら 0:偽, 1:真, 決まらないなら-1
+    static int GetTruth(const ConstValue& value);
+    std::shared_ptr<NodeExp> CreateLiteral(const ConstValue& value) const;
+    void FoldArithBinOp(NodeBinOp& exp, double(*op)(double, double));
+    void FoldCmpBinOp(NodeBinOp& exp, bool(*op)(double, double));
+    void FoldEqBinOp(NodeBinOp& exp, bool isEq);
+    void FoldLogBinOp(NodeBinOp& exp, bool isAnd);
+    void FoldBuiltInCall(const std::string& name, const std::vector<ConstValue>& args);
+    void FoldAssign(NodeAssign& stmt);
+    void FoldProc(NodeBlock& blk);
+    void SetReal(double v);
+    void SetBool(bool b);
+    void SetStr(const std::wstring& s);
+    std::shared_ptr<Env> env_;
+    bool isConst_;
+    ConstValue value_;
+    std::shared_ptr<NodeExp> replacedExp_; // 定数ではない式に置き換える場合
+    std::shared_ptr<NodeStmt> replacedStmt_;
+    std::unordered_map<const NodeDef*, ConstValue> constVars_;
+    const std::unordered_set<const NodeDef*>* procEntryAssignedDefs_;
+};
+}
@@ -24,6 +24,7 @@ constexpr uint8_t OBJ_TEXT = 9;
 constexpr uint8_t OBJ_SOUND = 10;
 constexpr uint8_t OBJ_FILE_TEXT = 11;
 constexpr uint8_t OBJ_FILE_BINARY = 12;
+constexpr uint8_t OBJ_PARTICLE_LIST_2D = 13;
 constexpr uint8_t OBJ_PLAYER = 100;
 constexpr uint8_t OBJ_SPELL_MANAGE = 101;
 constexpr uint8_t OBJ_SPELL = 102;
@@ -0,0 +1,98 @@
+﻿#include "reflex/dnh_lexer.hpp"
+#include "bison/dnh.tab.hpp"
+
+#include <bstorm/string_util.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/file_loader.hpp>
+#include <bstorm/env.hpp>
+#include <bstorm/node.hpp>
+#include <bstorm/node_arena.hpp>
+#include <bstorm/parser.hpp>
+
+namespace bstorm
+{
+static ScriptInfo CreateScriptInfo(const std::wstring& filePath, const std::vector<NodeHeader>& headers)
+{
+    ScriptInfo info;
+    info.path = GetCanonicalPath(filePath);
+    info.id = info.path;
+    info.version = SCRIPT_VERSION_PH3;
+    for (const auto& header : headers)
+    {
+        if (header.params.empty()) continue;
+        if (header.name == L"TouhouDanmakufu")
+        {
+            info.type = ScriptType::FromName(ToUTF8(header.params[0]));
+        } else if (header.name == L"ScriptVersion")
+        {
+            info.version = header.params[0];
+        } else if (header.name == L"ID")
+        {
+            info.id = header.params[0];
+        } else if (header.name == L"Title")
+        {
+            info.title = header.params[0];
+        } else if (header.name == L"Text")
+        {
+            info.text = header.params[0];
+        } else if (header.name == L"Image")
+        {
+            info.imagePath = header.params[0];
+        } else if (header.name == L"System")
+        {
+            info.systemPath = header.params[0];
+        } else if (header.name == L"Background")
+        {
+            info.backgroundPath = header.params[0];
+        } else if (header.name == L"BGM")
+        {
+            info.bgmPath = header.params[0];
+        } else if (header.name == L"Player")
+        {
+            info.playerScriptPaths = header.params;
+        } else if (header.name == L"ReplayName")
+        {
+            info.replayName = header.params[0];
+        }
+    }
+    info.imagePath = ExpandIncludePath(info.path, info.imagePath);
+    info.systemPath = ExpandIncludePath(info.path, info.systemPath);
+    info.backgroundPath = ExpandIncludePath(info.path, info.backgroundPath);
+    info.bgmPath = ExpandIncludePath(info.path, info.bgmPath);
+    for (auto& playerPath : info.playerScriptPaths)
+    {
+        playerPath = ExpandIncludePath(info.path, playerPath);
+    }
+    return info;
+}
+std::shared_ptr<NodeBlock> ParseDnhScript(const std::wstring& filePath, const std::shared_ptr<Env>& globalEnv, bool expandInclude, ScriptInfo* scriptInfo, const std::shared_ptr<FileLoader>& loader, const std::shared_ptr<DnhTokenCache>& tokenCache, NodeArena* arena, std::vector<std::wstring>* sourcePaths)
+{
+    DnhLexer lexer;
+    lexer.SetLoader(loader);
+    lexer.SetTokenCache(tokenCache);
+    lexer.PushInclude(filePath);
+    DnhParseContext ctx(globalEnv, &lexer, arena, expandInclude);
+    DnhParser parser(&ctx);
+    parser.parse();
+    lexer.PopInclude();
+    if (sourcePaths)
+    {
+        const auto& visitedFilePaths = lexer.GetVisitedFilePaths();
+        sourcePaths->assign(visitedFilePaths.begin(), visitedFilePaths.end());
+    }
+    *scriptInfo = CreateScriptInfo(filePath, ctx.headers);
+    return ctx.result;
+}
+ScriptInfo ScanDnhScriptInfo(const std::wstring & filePath, const std::shared_ptr<FileLoader>& loader)
+{
+    NodeArena arena;
+    DnhLexer lexer;
+    lexer.SetLoader(loader);
+    lexer.PushInclude(filePath);
+    DnhParseContext ctx(&lexer, &arena, false);
+    DnhParser parser(&ctx);
+    parser.parse();
+    lexer.PopInclude();
+    return CreateScriptInfo(filePath, ctx.headers);
+}
+}
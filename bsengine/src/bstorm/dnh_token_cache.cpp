@@ -0,0 +1,47 @@
+﻿#include <bstorm/dnh_token_cache.hpp>
+
+namespace bstorm
+{
+DnhTokenCache::DnhTokenCache(size_t maxTokenCount) :
+    maxTokenCount_(maxTokenCount),
+    totalTokenCount_(0)
+{
+}
+
+std::shared_ptr<const DnhTokenList> DnhTokenCache::Find(const std::wstring& path, TimeStamp lastUpdateTime) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end() || it->second.lastUpdateTime != lastUpdateTime)
+    {
+        return nullptr;
+    }
+    return it->second.tokens;
+}
+
+void DnhTokenCache::Add(const std::wstring& path, TimeStamp lastUpdateTime, const std::shared_ptr<const DnhTokenList>& tokens)
+{
+    if (lastUpdateTime == TIME_STAMP_NONE || tokens->size() > maxTokenCount_) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it != entries_.end())
+    {
+        totalTokenCount_ -= it->second.tokens->size();
+        entries_.erase(it);
+    }
+    if (totalTokenCount_ + tokens->size() > maxTokenCount_)
+    {
+        entries_.clear();
+        totalTokenCount_ = 0;
+    }
+    entries_[path] = Entry{ lastUpdateTime, tokens };
+    totalTokenCount_ += tokens->size();
+}
+
+void DnhTokenCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    totalTokenCount_ = 0;
+}
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <bstorm/ident.hpp>
+#include <bstorm/time_stamp.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bstorm
+{
+// 字句解析済みのトークン
+struct DnhToken
+{
+    int type;
+    int line;
+    int column;
+    std::string str; // TK_NUM
+    Ident ident; // TK_IDENT
+    std::wstring wstr; // TK_HEADER, TK_STR
+    wchar_t wchar; // TK_CHAR
+};
+
+using DnhTokenList = std::vector<DnhToken>;
+
+// キャッシュに保持するトークン数の上限, 超えたら全て破棄する
+constexpr size_t DNH_TOKEN_CACHE_MAX_TOKEN_COUNT = 4 * 1024 * 1024;
+
+// インクルードファイル1つ分のトークン列を保持する
+// 複数のスクリプトから同じファイルがインクルードされた時に読み込みと字句解析を省略する
+// パスと更新日時が一致したときだけ再利用する
+// should be thread safe.
+class DnhTokenCache
+{
+public:
+    DnhTokenCache(size_t maxTokenCount);
+    std::shared_ptr<const DnhTokenList> Find(const std::wstring& path, TimeStamp lastUpdateTime) const;
+    void Add(const std::wstring& path, TimeStamp lastUpdateTime, const std::shared_ptr<const DnhTokenList>& tokens);
+    void Clear();
+private:
+    struct Entry
+    {
+        TimeStamp lastUpdateTime;
+        std::shared_ptr<const DnhTokenList> tokens;
+    };
+    const size_t maxTokenCount_;
+    size_t totalTokenCount_;
+    std::unordered_map<std::wstring, Entry> entries_;
+    mutable std::mutex mutex_;
+};
+}
@@ -155,6 +155,13 @@ bool DnhValue::ToBool(lua_State* L, int idx)
 
 std::wstring DnhValue::ToString(lua_State*L, int idx)
 {
+    if (lua_type(L, idx) == LUA_TSTRING)
+    {
+        // 文字またはLuaの文字列で渡された文字列, 途中のNULも残すため長さを指定する
+        size_t len;
+        const char* str = lua_tolstring(L, idx, &len);
+        return ToUnicode(std::string(str, len));
+    }
     return DnhValue::Get(L, idx)->ToString();
 }
 
@@ -165,7 +172,11 @@ std::string DnhValue::ToStringU8(lua_State * L, int idx)
         case LUA_TNUMBER:
             return std::to_string(lua_tonumber(L, idx));
         case LUA_TSTRING:
-            return lua_tostring(L, idx);
+        {
+            size_t len;
+            const char* str = lua_tolstring(L, idx, &len);
+            return std::string(str, len);
+        }
         case LUA_TBOOLEAN:
             return lua_toboolean(L, idx) ? "true" : "false";
         case LUA_TTABLE:
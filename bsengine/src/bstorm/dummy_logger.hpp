@@ -2,7 +2,11 @@
 
 #include <bstorm/logger.hpp>
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cstdio>
+#endif
 
 namespace bstorm
 {
@@ -17,8 +21,12 @@ private:
     };
     void log(Log&& lg) noexcept(false) override
     {
+#ifdef _WIN32
         OutputDebugStringA(lg.ToString().c_str());
         OutputDebugStringA("\n");
+#else
+        fprintf(stderr, "%s\n", lg.ToString().c_str());
+#endif
     };
 };
 }
\ No newline at end of file
@@ -1,30 +1,26 @@
 #include <bstorm/dx_util.hpp>
 
+#include <cstring>
+
 namespace bstorm
 {
 D3DXMATRIX CreateScaleRotTransMatrix(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz)
 {
-    D3DXMATRIX mat;
-    //]
-    D3DXMatrixRotationYawPitchRoll(&mat, D3DXToRadian(ry), D3DXToRadian(rx), D3DXToRadian(rz));
-
-    //gk
-    mat._11 *= sx;
-    mat._12 *= sx;
-    mat._13 *= sx;
-
-    mat._21 *= sy;
-    mat._22 *= sy;
-    mat._23 *= sy;
+    return ToD3DXMatrix(ScaleRotTransMatrix4(x, y, z, rx, ry, rz, sx, sy, sz));
+}
 
-    mat._31 *= sz;
-    mat._32 *= sz;
-    mat._33 *= sz;
+D3DXMATRIX ToD3DXMatrix(const Matrix4& mat)
+{
+    static_assert(sizeof(D3DXMATRIX) == sizeof(Matrix4), "layout mismatch");
+    D3DXMATRIX result;
+    std::memcpy(&result, &mat, sizeof(D3DXMATRIX));
+    return result;
+}
 
-    //ړ
-    mat._41 = x;
-    mat._42 = y;
-    mat._43 = z;
-    return mat;
+Matrix4 FromD3DXMatrix(const D3DXMATRIX& mat)
+{
+    Matrix4 result;
+    std::memcpy(&result, &mat, sizeof(Matrix4));
+    return result;
 }
 }
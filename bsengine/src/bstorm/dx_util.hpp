@@ -1,9 +1,13 @@
 #pragma once
 
+#include <bstorm/matrix.hpp>
+
 #include <d3dx9.h>
 
 namespace bstorm
 {
 // gA]Aړ̏ԂŊ|s
 D3DXMATRIX CreateScaleRotTransMatrix(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz);
+D3DXMATRIX ToD3DXMatrix(const Matrix4& mat);
+Matrix4 FromD3DXMatrix(const D3DXMATRIX& mat);
 }
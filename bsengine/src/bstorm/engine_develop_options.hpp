@@ -7,5 +7,6 @@ class EngineDevelopOptions
 public:
     bool renderIntersectionEnable = false;
     bool forcePlayerInvincibleEnable = false;
+    bool parallelRenderRecordEnable = true;
 };
 }
@@ -27,9 +27,9 @@ Env::Env(const std::shared_ptr<DefNameTable>& table, const std::shared_ptr<Env>&
 {
 }
 
-const std::shared_ptr<NodeDef>& Env::AddDef(const std::string & name, const std::shared_ptr<NodeDef>& def)
+const std::shared_ptr<NodeDef>& Env::AddDef(const Ident& name, const std::shared_ptr<NodeDef>& def)
 {
-    return AddDef(std::move(std::string(name)), std::move(std::shared_ptr<NodeDef>(def)));
+    return AddDef(name, std::move(std::shared_ptr<NodeDef>(def)));
 }
 
 static std::string getShortName(size_t i, int depth)
@@ -53,16 +53,16 @@ static std::string getShortName(size_t i, int depth)
     return name;
 }
 
-const std::shared_ptr<NodeDef>& Env::AddDef(std::string && name, std::shared_ptr<NodeDef>&& def)
+const std::shared_ptr<NodeDef>& Env::AddDef(const Ident& name, std::shared_ptr<NodeDef>&& def)
 {
     if (table_->count(name) != 0) { return (*table_)[name]; }
 #ifndef _DEBUG
     def->convertedName = std::move(getShortName(table_->size(), depth_));
 #endif
-    return (*table_)[std::move(name)] = std::move(def);
+    return (*table_)[name] = std::move(def);
 }
 
-NullableSharedPtr<NodeDef> Env::FindDef(const std::string & name) const
+NullableSharedPtr<NodeDef> Env::FindDef(const Ident& name) const
 {
     auto it = table_->find(name);
     if (it != table_->end())
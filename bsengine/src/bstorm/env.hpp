@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <bstorm/nullable_shared_ptr.hpp>
+#include <bstorm/ident.hpp>
 
 #include <unordered_map>
 #include <memory>
@@ -8,16 +9,16 @@
 namespace bstorm
 {
 struct NodeDef;
-using DefNameTable = std::unordered_map<std::string, std::shared_ptr<NodeDef>>;
+using DefNameTable = std::unordered_map<Ident, std::shared_ptr<NodeDef>>;
 class Env
 {
 public:
     Env();
     Env(const std::shared_ptr<Env>& parent);
     Env(const std::shared_ptr<DefNameTable>& table, const std::shared_ptr<Env>& parent);
-    const std::shared_ptr<NodeDef>& AddDef(const std::string& name, const std::shared_ptr<NodeDef>& def);
-    const std::shared_ptr<NodeDef>& AddDef(std::string&& name, std::shared_ptr<NodeDef>&& def);
-    NullableSharedPtr<NodeDef> FindDef(const std::string& name) const;
+    const std::shared_ptr<NodeDef>& AddDef(const Ident& name, const std::shared_ptr<NodeDef>& def);
+    const std::shared_ptr<NodeDef>& AddDef(const Ident& name, std::shared_ptr<NodeDef>&& def);
+    NullableSharedPtr<NodeDef> FindDef(const Ident& name) const;
     bool IsRoot() const;
     const std::shared_ptr<DefNameTable>& GetCurrentBlockNameTable() { return table_; }
     const std::shared_ptr<Env>& GetParent() const { return parent_; }
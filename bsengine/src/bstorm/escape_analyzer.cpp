@@ -0,0 +1,429 @@
+﻿#include <bstorm/escape_analyzer.hpp>
+
+#include <bstorm/env.hpp>
+
+namespace bstorm
+{
+// NOTE: 配列は代入, 引数, 要素の書き込みの度にコピーされるので, 各変数は自分だけの配列を持つ
+// NOTE: 引数をコピーしなくてよいのは, 関数が引数を書き換えず, コピーせずに保持せず,
+// NOTE: 呼び出し中に渡した配列が他から書き換えられない場合
+// NOTE: 書き換えうるのは外側の変数への代入, yield中の他のタスク, 組み込み関数から再入した@Event
+
+static bool IsScalarType(ExpType type)
+{
+    return type == ExpType::REAL || type == ExpType::BOOL || type == ExpType::CHAR;
+}
+
+void EscapeAnalyzer::Analyze(Node & program)
+{
+    env_ = nullptr;
+    procStack_.clear();
+    ownerProcs_.clear();
+    procInfos_.clear();
+    escapedParams_.clear();
+    safeFuncs_.clear();
+    pureFuncs_.clear();
+    callSites_.clear();
+    program.Traverse(*this);
+    PropagateSafety();
+    ElideArgCopies();
+}
+
+void EscapeAnalyzer::Traverse(NodeNum &) {}
+void EscapeAnalyzer::Traverse(NodeChar &) {}
+void EscapeAnalyzer::Traverse(NodeStr &) {}
+void EscapeAnalyzer::Traverse(NodeArray & array)
+{
+    for (auto& e : array.elems)
+    {
+        e->Traverse(*this);
+        CheckStore(*e, false);
+    }
+}
+void EscapeAnalyzer::Traverse(NodeNeg & exp) { AnalyzeMonoOp(exp); }
+void EscapeAnalyzer::Traverse(NodeNot & exp) { AnalyzeMonoOp(exp); }
+void EscapeAnalyzer::Traverse(NodeAbs & exp) { AnalyzeMonoOp(exp); }
+void EscapeAnalyzer::Traverse(NodeAdd & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeSub & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeMul & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeDiv & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeRem & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodePow & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeLt & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeGt & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeLe & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeGe & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeEq & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeNe & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeAnd & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeOr & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeCat & exp) { AnalyzeBinOp(exp); }
+void EscapeAnalyzer::Traverse(NodeNoParenCallExp & call)
+{
+    std::vector<std::shared_ptr<NodeExp>> noArgs;
+    AnalyzeCall(call.name, noArgs);
+}
+void EscapeAnalyzer::Traverse(NodeCallExp & call)
+{
+    AnalyzeCall(call.name, call.args);
+}
+void EscapeAnalyzer::Traverse(NodeArrayRef & exp)
+{
+    exp.array->Traverse(*this);
+    exp.idx->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeRange & range)
+{
+    range.start->Traverse(*this);
+    range.end->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeArraySlice & exp)
+{
+    exp.array->Traverse(*this);
+    exp.range->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeNop &) {}
+void EscapeAnalyzer::Traverse(NodeLeftVal & left) { AnalyzeLeftVal(left); }
+void EscapeAnalyzer::Traverse(NodeAssign & stmt)
+{
+    AnalyzeLeftVal(*stmt.lhs);
+    stmt.rhs->Traverse(*this);
+    // 添字付きの代入はr_writeでコピーされる
+    if (stmt.lhs->indices.empty())
+    {
+        CheckStore(*stmt.rhs, true);
+    }
+}
+void EscapeAnalyzer::Traverse(NodeAddAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeSubAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeMulAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeDivAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeRemAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodePowAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeCatAssign & stmt) { AnalyzeLeftVal(*stmt.lhs); stmt.rhs->Traverse(*this); }
+void EscapeAnalyzer::Traverse(NodeCallStmt & call)
+{
+    AnalyzeCall(call.name, call.args);
+}
+void EscapeAnalyzer::Traverse(NodeReturn & stmt)
+{
+    stmt.ret->Traverse(*this);
+    CheckStore(*stmt.ret, false);
+}
+void EscapeAnalyzer::Traverse(NodeReturnVoid &) {}
+void EscapeAnalyzer::Traverse(NodeYield &)
+{
+    if (auto proc = CurrentProc()) proc->hasSideEffect = true;
+}
+void EscapeAnalyzer::Traverse(NodeBreak &) {}
+void EscapeAnalyzer::Traverse(NodeSucc & stmt) { AnalyzeLeftVal(*stmt.lhs); }
+void EscapeAnalyzer::Traverse(NodePred & stmt) { AnalyzeLeftVal(*stmt.lhs); }
+void EscapeAnalyzer::Traverse(NodeVarDecl &) {}
+void EscapeAnalyzer::Traverse(NodeVarInit & stmt)
+{
+    stmt.rhs->Traverse(*this);
+    CheckStore(*stmt.rhs, true);
+}
+void EscapeAnalyzer::Traverse(NodeProcParam &) {}
+void EscapeAnalyzer::Traverse(NodeLoopParam &) {}
+void EscapeAnalyzer::Traverse(NodeResult &) {}
+void EscapeAnalyzer::Traverse(NodeBlock & blk)
+{
+    env_ = std::make_shared<Env>(blk.nameTable, env_);
+    const NodeDef* owner = procStack_.empty() ? nullptr : procStack_.back();
+    for (const auto& bind : *(blk.nameTable))
+    {
+        ownerProcs_[bind.second.get()] = owner;
+    }
+
+    for (auto& stmt : blk.stmts)
+    {
+        stmt->Traverse(*this);
+    }
+
+    for (const auto& bind : *(blk.nameTable))
+    {
+        auto& def = bind.second;
+        if (def->unreachable) continue;
+        def->Traverse(*this);
+    }
+
+    env_ = env_->GetParent();
+}
+void EscapeAnalyzer::Traverse(NodeSubDef & def) { AnalyzeProc(def, *def.block); }
+void EscapeAnalyzer::Traverse(NodeBuiltInSubDef & def) { AnalyzeProc(def, *def.block); }
+void EscapeAnalyzer::Traverse(NodeFuncDef & def) { AnalyzeProc(def, *def.block); }
+void EscapeAnalyzer::Traverse(NodeTaskDef & def) { AnalyzeProc(def, *def.block); }
+void EscapeAnalyzer::Traverse(NodeBuiltInFunc &) {}
+void EscapeAnalyzer::Traverse(NodeConst &) {}
+void EscapeAnalyzer::Traverse(NodeLocal & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeLoop & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeTimes & stmt)
+{
+    stmt.cnt->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeWhile & stmt)
+{
+    stmt.cond->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeAscent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeDescent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeElseIf & elsif)
+{
+    elsif.cond->Traverse(*this);
+    elsif.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeIf & stmt)
+{
+    stmt.cond->Traverse(*this);
+    stmt.thenBlock->Traverse(*this);
+    for (auto& elsif : stmt.elsifs)
+    {
+        elsif->Traverse(*this);
+    }
+    if (stmt.elseBlock) stmt.elseBlock->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeCase & c)
+{
+    for (auto& exp : c.exps)
+    {
+        exp->Traverse(*this);
+    }
+    c.block->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeAlternative & stmt)
+{
+    stmt.cond->Traverse(*this);
+    CheckStore(*stmt.cond, true);
+    for (auto& c : stmt.cases)
+    {
+        c->Traverse(*this);
+    }
+    if (stmt.others) stmt.others->Traverse(*this);
+}
+void EscapeAnalyzer::Traverse(NodeHeader &) {}
+
+EscapeAnalyzer::ProcInfo * EscapeAnalyzer::CurrentProc()
+{
+    if (procStack_.empty()) return nullptr;
+    return &procInfos_[procStack_.back()];
+}
+
+void EscapeAnalyzer::AnalyzeMonoOp(NodeMonoOp & exp)
+{
+    exp.rhs->Traverse(*this);
+}
+
+void EscapeAnalyzer::AnalyzeBinOp(NodeBinOp & exp)
+{
+    exp.lhs->Traverse(*this);
+    exp.rhs->Traverse(*this);
+}
+
+void EscapeAnalyzer::AnalyzeLeftVal(NodeLeftVal & left)
+{
+    for (auto& idx : left.indices)
+    {
+        idx->Traverse(*this);
+    }
+    auto def = env_->FindDef(left.name);
+    if (!def) return;
+    if (std::dynamic_pointer_cast<NodeProcParam>(def))
+    {
+        escapedParams_.insert(def.get());
+    }
+    if (auto proc = CurrentProc())
+    {
+        auto it = ownerProcs_.find(def.get());
+        if (it == ownerProcs_.end() || it->second != procStack_.back())
+        {
+            proc->hasSideEffect = true;
+        }
+    }
+}
+
+void EscapeAnalyzer::AnalyzeCall(const Ident& name, std::vector<std::shared_ptr<NodeExp>>& args)
+{
+    for (auto& arg : args)
+    {
+        arg->Traverse(*this);
+    }
+    auto def = env_->FindDef(name);
+    if (!def) return;
+    auto proc = CurrentProc();
+    if (std::dynamic_pointer_cast<NodeProcParam>(def))
+    {
+        // 入れ子の手続きから参照されると呼び出しの後にも残る
+        auto it = ownerProcs_.find(def.get());
+        if (procStack_.empty() || it == ownerProcs_.end() || it->second != procStack_.back())
+        {
+            escapedParams_.insert(def.get());
+        }
+    } else if (auto func = std::dynamic_pointer_cast<NodeFuncDef>(def))
+    {
+        if (proc) proc->callees.push_back(func.get());
+        if (args.empty()) return;
+        CallSite callSite;
+        callSite.func = func.get();
+        callSite.args = &args;
+        for (auto& arg : args)
+        {
+            CheckStore(*arg, true);
+            callSite.isOwnedArg.push_back(IsOwnedVar(*arg));
+        }
+        callSites_.push_back(std::move(callSite));
+    } else if (std::dynamic_pointer_cast<NodeTaskDef>(def) || std::dynamic_pointer_cast<NodeSubDef>(def))
+    {
+        if (proc) proc->hasSideEffect = true;
+        for (auto& arg : args)
+        {
+            CheckStore(*arg, true);
+        }
+    } else if (auto builtIn = std::dynamic_pointer_cast<NodeBuiltInFunc>(def))
+    {
+        if (proc && !builtIn->isRuntime) proc->callsNative = true;
+    }
+}
+
+void EscapeAnalyzer::AnalyzeProc(const NodeDef & def, NodeBlock & blk)
+{
+    procStack_.push_back(&def);
+    procInfos_[&def];
+    blk.Traverse(*this);
+    procStack_.pop_back();
+}
+
+void EscapeAnalyzer::CheckStore(NodeExp & exp, bool isCopied)
+{
+    if (isCopied && exp.copyRequired) return;
+    if (IsScalarType(exp.expType)) return;
+    if (auto call = dynamic_cast<NodeNoParenCallExp*>(&exp))
+    {
+        auto def = env_->FindDef(call->name);
+        if (std::dynamic_pointer_cast<NodeProcParam>(def))
+        {
+            escapedParams_.insert(def.get());
+        }
+    } else if (auto call = dynamic_cast<NodeCallExp*>(&exp))
+    {
+        // min, maxなどは引数をそのまま返す
+        if (std::dynamic_pointer_cast<NodeBuiltInFunc>(env_->FindDef(call->name)))
+        {
+            for (auto& arg : call->args)
+            {
+                CheckStore(*arg, false);
+            }
+        }
+    } else if (auto andExp = dynamic_cast<NodeAnd*>(&exp))
+    {
+        // r_and, r_orは被演算子をそのまま返す
+        CheckStore(*andExp->lhs, false);
+        CheckStore(*andExp->rhs, false);
+    } else if (auto orExp = dynamic_cast<NodeOr*>(&exp))
+    {
+        CheckStore(*orExp->lhs, false);
+        CheckStore(*orExp->rhs, false);
+    }
+}
+
+bool EscapeAnalyzer::IsOwnedVar(const NodeExp & exp) const
+{
+    auto call = dynamic_cast<const NodeNoParenCallExp*>(&exp);
+    if (!call) return false;
+    auto def = env_->FindDef(call->name);
+    if (!def || !def->IsVariable()) return false;
+    auto it = ownerProcs_.find(def.get());
+    return it != ownerProcs_.end() && it->second != nullptr;
+}
+
+void EscapeAnalyzer::PropagateSafety()
+{
+    for (const auto& entry : procInfos_)
+    {
+        if (!dynamic_cast<const NodeFuncDef*>(entry.first)) continue;
+        const auto& info = entry.second;
+        if (info.hasSideEffect) continue;
+        safeFuncs_.insert(entry.first);
+        if (!info.callsNative) pureFuncs_.insert(entry.first);
+    }
+    // 呼び出し先が安全でなければ呼び出し元も安全でない
+    auto propagate = [this](std::unordered_set<const NodeDef*>& funcs)
+    {
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto it = funcs.begin(); it != funcs.end();)
+            {
+                const auto& callees = procInfos_[*it].callees;
+                bool isSafe = true;
+                for (auto callee : callees)
+                {
+                    if (funcs.count(callee) == 0)
+                    {
+                        isSafe = false;
+                        break;
+                    }
+                }
+                if (isSafe)
+                {
+                    ++it;
+                } else
+                {
+                    it = funcs.erase(it);
+                    changed = true;
+                }
+            }
+        }
+    };
+    propagate(safeFuncs_);
+    propagate(pureFuncs_);
+}
+
+void EscapeAnalyzer::ElideArgCopies()
+{
+    for (auto& callSite : callSites_)
+    {
+        auto func = callSite.func;
+        if (safeFuncs_.count(func) == 0) continue;
+        auto& args = *callSite.args;
+        // 後の引数の評価で渡した配列が書き換わらないように, 他の引数は副作用なしに限る
+        int subEffectArgCnt = 0;
+        for (auto& arg : args)
+        {
+            if (!arg->noSubEffect) subEffectArgCnt++;
+        }
+        bool isPure = pureFuncs_.count(func) != 0;
+        for (size_t i = 0; i < args.size() && i < func->params.size(); i++)
+        {
+            auto& arg = args[i];
+            if (!arg->copyRequired || IsScalarType(arg->expType)) continue;
+            if (subEffectArgCnt - (arg->noSubEffect ? 0 : 1) > 0) continue;
+            auto it = func->block->nameTable->find(func->params[i]);
+            if (it == func->block->nameTable->end()) continue;
+            if (escapedParams_.count(it->second.get()) != 0) continue;
+            // 手続きの外の変数は組み込み関数から再入した@Eventが書き換えうる
+            if (callSite.isOwnedArg[i] || isPure)
+            {
+                arg->copyRequired = false;
+            }
+        }
+    }
+}
+}
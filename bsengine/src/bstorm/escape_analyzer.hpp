@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <bstorm/node.hpp>
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace bstorm
+{
+class Env;
+// 関数の引数が書き換えられたり外に持ち出されたりしないかを調べ,
+// 呼び出し元の配列をコピーせずに渡せる引数のcopyRequiredを落とす
+// 型や到達可能性を使うのでCodeAnalyzer, ConstantFolderの後に行う
+class EscapeAnalyzer : public NodeTraverser
+{
+public:
+    void Analyze(Node& program);
+    void Traverse(NodeNum&) override;
+    void Traverse(NodeChar&) override;
+    void Traverse(NodeStr&) override;
+    void Traverse(NodeArray&) override;
+    void Traverse(NodeNeg&) override;
+    void Traverse(NodeNot&) override;
+    void Traverse(NodeAbs&) override;
+    void Traverse(NodeAdd&) override;
+    void Traverse(NodeSub&) override;
+    void Traverse(NodeMul&) override;
+    void Traverse(NodeDiv&) override;
+    void Traverse(NodeRem&) override;
+    void Traverse(NodePow&) override;
+    void Traverse(NodeLt&) override;
+    void Traverse(NodeGt&) override;
+    void Traverse(NodeLe&) override;
+    void Traverse(NodeGe&) override;
+    void Traverse(NodeEq&) override;
+    void Traverse(NodeNe&) override;
+    void Traverse(NodeAnd&) override;
+    void Traverse(NodeOr&) override;
+    void Traverse(NodeCat&) override;
+    void Traverse(NodeNoParenCallExp&) override;
+    void Traverse(NodeCallExp&) override;
+    void Traverse(NodeArrayRef&) override;
+    void Traverse(NodeRange&) override;
+    void Traverse(NodeArraySlice&) override;
+    void Traverse(NodeNop&) override;
+    void Traverse(NodeLeftVal&) override;
+    void Traverse(NodeAssign&) override;
+    void Traverse(NodeAddAssign&) override;
+    void Traverse(NodeSubAssign&) override;
+    void Traverse(NodeMulAssign&) override;
+    void Traverse(NodeDivAssign&) override;
+    void Traverse(NodeRemAssign&) override;
+    void Traverse(NodePowAssign&) override;
+    void Traverse(NodeCatAssign&) override;
+    void Traverse(NodeCallStmt&) override;
+    void Traverse(NodeReturn&) override;
+    void Traverse(NodeReturnVoid&) override;
+    void Traverse(NodeYield&) override;
+    void Traverse(NodeBreak&) override;
+    void Traverse(NodeSucc&) override;
+    void Traverse(NodePred&) override;
+    void Traverse(NodeVarDecl&) override;
+    void Traverse(NodeVarInit&) override;
+    void Traverse(NodeProcParam&) override;
+    void Traverse(NodeLoopParam&) override;
+    void Traverse(NodeResult&) override;
+    void Traverse(NodeBlock&) override;
+    void Traverse(NodeSubDef&) override;
+    void Traverse(NodeBuiltInSubDef&) override;
+    void Traverse(NodeFuncDef&) override;
+    void Traverse(NodeTaskDef&) override;
+    void Traverse(NodeBuiltInFunc&) override;
+    void Traverse(NodeConst&) override;
+    void Traverse(NodeLocal&) override;
+    void Traverse(NodeLoop&) override;
+    void Traverse(NodeTimes&) override;
+    void Traverse(NodeWhile&) override;
+    void Traverse(NodeAscent&) override;
+    void Traverse(NodeDescent&) override;
+    void Traverse(NodeElseIf&) override;
+    void Traverse(NodeIf&) override;
+    void Traverse(NodeCase&) override;
+    void Traverse(NodeAlternative&) override;
+    void Traverse(NodeHeader&) override;
+private:
+    struct ProcInfo
+    {
+        bool hasSideEffect = false; // yield, タスクの起動, 外側の変数の書き換え
+        bool callsNative = false; // C++の組み込み関数はイベントで再入しうる
+        std::vector<const NodeDef*> callees;
+    };
+    struct CallSite
+    {
+        const NodeFuncDef* func;
+        std::vector<std::shared_ptr<NodeExp>>* args;
+        std::vector<bool> isOwnedArg; // 手続き内で宣言された変数
+    };
+    ProcInfo* CurrentProc();
+    void AnalyzeMonoOp(NodeMonoOp& exp);
+    void AnalyzeBinOp(NodeBinOp& exp);
+    void AnalyzeLeftVal(NodeLeftVal& left);
+    void AnalyzeCall(const Ident& name, std::vector<std::shared_ptr<NodeExp>>& args);
+    void AnalyzeProc(const NodeDef& def, NodeBlock& blk);
+    // コピーされずに値が保持される箇所
+    void CheckStore(NodeExp& exp, bool isCopied);
+    bool IsOwnedVar(const NodeExp& exp) const;
+    void PropagateSafety();
+    void ElideArgCopies();
+    std::shared_ptr<Env> env_;
+    std::vector<const NodeDef*> procStack_;
+    std::unordered_map<const NodeDef*, const NodeDef*> ownerProcs_; // 変数 -> 宣言された手続き
+    std::unordered_map<const NodeDef*, ProcInfo> procInfos_;
+    std::unordered_set<const NodeDef*> escapedParams_;
+    std::unordered_set<const NodeDef*> safeFuncs_; // 呼び出し中に外の配列が書き換わらない関数
+    std::unordered_set<const NodeDef*> pureFuncs_; // 加えてC++の組み込み関数を呼ばない関数
+    std::vector<CallSite> callSites_;
+};
+}
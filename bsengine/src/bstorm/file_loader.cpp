@@ -1,15 +1,23 @@
 ﻿#include <bstorm/file_loader.hpp>
 
+#include <bstorm/string_util.hpp>
+
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace bstorm
 {
 FILE* FileLoader::OpenFile(const std::wstring& path)
 {
+#ifdef _WIN32
     return _wfopen(path.c_str(), L"rb");
+#else
+    return fopen(ToUTF8(path).c_str(), "rb");
+#endif
 }
 
-void FileLoader::CloseFile(const std::wstring& path, FILE* fp)
+void FileLoader::CloseFile(const std::wstring&, FILE* fp)
 {
     fclose(fp);
 }
@@ -3,21 +3,144 @@
 #include <bstorm/string_util.hpp>
 
 #include <algorithm>
+#include <cstdio>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
 
 namespace bstorm
 {
+static bool IsDirectory(const std::wstring& path)
+{
+#ifdef _WIN32
+    auto attr = GetFileAttributes(path.c_str());
+    return attr != -1 && (attr & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat st;
+    return stat(ToUTF8(path).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+// dir直下の項目を列挙する("."と".."は除く)
+template <class F>
+static void ForEachDirEntry(const std::wstring& dir, F callback)
+{
+    if (dir.empty()) return;
+#ifdef _WIN32
+    WIN32_FIND_DATA data;
+    HANDLE fh = FindFirstFile((dir + L"/*").c_str(), &data);
+    if (fh == INVALID_HANDLE_VALUE) return;
+    do
+    {
+        std::wstring fileName(data.cFileName);
+        if (fileName == L".." || fileName == L".")
+        {
+            continue;
+        }
+        callback(ConcatPath(dir, fileName), (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+    } while (FindNextFile(fh, &data));
+    FindClose(fh);
+#else
+    DIR* dp = opendir(ToUTF8(dir).c_str());
+    if (!dp) return;
+    while (struct dirent* ent = readdir(dp))
+    {
+        std::wstring fileName = ToUnicode(ent->d_name);
+        if (fileName == L".." || fileName == L".")
+        {
+            continue;
+        }
+        std::wstring path = ConcatPath(dir, fileName);
+        bool isDir = IsDirectory(path);
+        callback(path, isDir);
+    }
+    closedir(dp);
+#endif
+}
+
 void MakeDirectoryP(const std::wstring& dirName)
 {
-    auto attr = GetFileAttributes(dirName.c_str());
-    if (attr != -1 && (attr & FILE_ATTRIBUTE_DIRECTORY)) return;
+    if (IsDirectory(dirName)) return;
+    const std::wstring path = GetCanonicalPath(dirName);
     std::wstring dir = L"";
-    for (auto& name : Split(GetCanonicalPath(dirName), L'/'))
+#ifndef _WIN32
+    // keep root of absolute path
+    if (!path.empty() && path[0] == L'/') dir = L"/";
+#endif
+    for (auto& name : Split(path, L'/'))
     {
-        if (name.empty()) break;
+        if (name.empty()) continue;
         dir += name + L"/";
+#ifdef _WIN32
         _wmkdir(dir.c_str());
+#else
+        mkdir(ToUTF8(dir).c_str(), 0755);
+#endif
+    }
+}
+
+bool ReadFileBytes(const std::wstring& path, std::vector<char>* buf)
+{
+    buf->clear();
+#ifdef _WIN32
+    FILE* fp = _wfopen(path.c_str(), L"rb");
+#else
+    FILE* fp = fopen(ToUTF8(path).c_str(), "rb");
+#endif
+    if (!fp) return false;
+#ifdef _WIN32
+    _fseeki64(fp, 0, SEEK_END);
+    const int64_t fileSize = _ftelli64(fp);
+    _fseeki64(fp, 0, SEEK_SET);
+#else
+    fseeko(fp, 0, SEEK_END);
+    const int64_t fileSize = ftello(fp);
+    fseeko(fp, 0, SEEK_SET);
+#endif
+    if (fileSize > 0)
+    {
+        buf->resize((size_t)fileSize);
+        if (fread(buf->data(), 1, buf->size(), fp) != buf->size()) buf->clear();
     }
+    fclose(fp);
+    return true;
+}
+
+bool RenameFile(const std::wstring& from, const std::wstring& to)
+{
+#ifdef _WIN32
+    return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(ToUTF8(from).c_str(), ToUTF8(to).c_str()) == 0;
+#endif
+}
+
+bool RemoveFile(const std::wstring& path)
+{
+#ifdef _WIN32
+    return _wremove(path.c_str()) == 0;
+#else
+    return remove(ToUTF8(path).c_str()) == 0;
+#endif
+}
+
+bool GetFileStatus(const std::wstring& path, uint64_t* lastWriteTime, uint64_t* size)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attr)) return false;
+    *lastWriteTime = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32u) | attr.ftLastWriteTime.dwLowDateTime;
+    *size = ((uint64_t)attr.nFileSizeHigh << 32u) | attr.nFileSizeLow;
+#else
+    struct stat st;
+    if (stat(ToUTF8(path).c_str(), &st) != 0) return false;
+    *lastWriteTime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+    *size = (uint64_t)st.st_size;
+#endif
+    return true;
 }
 
 std::wstring GetExt(const std::wstring& path)
@@ -65,7 +188,7 @@ std::wstring GetOmittedFileName(const std::wstring & path, int size)
     std::wstring ret;
     int omittedStemSize = std::max(0, size - (int)ext.size());
     ret += stem.substr(0, omittedStemSize);
-    if (omittedStemSize < stem.size())
+    if ((size_t)omittedStemSize < stem.size())
     {
         ret += L"…";
     }
@@ -80,19 +203,9 @@ void GetFilePathsRecursively(const std::wstring& dir, std::vector<std::wstring>&
 
 void GetFilePaths(const std::wstring & dir, std::vector<std::wstring>& pathList, const std::unordered_set<std::wstring>& ignoreExts, bool doRecursive)
 {
-    if (dir.empty()) return;
-    WIN32_FIND_DATA data;
-    HANDLE fh = FindFirstFile((dir + L"/*").c_str(), &data);
-    if (fh == INVALID_HANDLE_VALUE) return;
-    do
+    ForEachDirEntry(dir, [&](const std::wstring& path, bool isDir)
     {
-        std::wstring fileName(data.cFileName);
-        if (fileName == L".." || fileName == L".")
-        {
-            continue;
-        }
-        std::wstring path = ConcatPath(dir, fileName);
-        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        if (isDir)
         {
             if (doRecursive) GetFilePathsRecursively(path, pathList, ignoreExts);
         } else
@@ -103,31 +216,19 @@ void GetFilePaths(const std::wstring & dir, std::vector<std::wstring>& pathList,
                 pathList.push_back(path);
             }
         }
-    } while (FindNextFile(fh, &data));
-    FindClose(fh);
+    });
 }
 
 void GetDirs(const std::wstring & dir, std::vector<std::wstring>& dirList, bool doRecursive)
 {
-    if (dir.empty()) return;
-    WIN32_FIND_DATA data;
-    HANDLE fh = FindFirstFile((dir + L"/*").c_str(), &data);
-    if (fh == INVALID_HANDLE_VALUE) return;
-    do
+    ForEachDirEntry(dir, [&](const std::wstring& path, bool isDir)
     {
-        std::wstring fileName(data.cFileName);
-        if (fileName == L".." || fileName == L".")
-        {
-            continue;
-        }
-        std::wstring path = ConcatPath(dir, fileName);
-        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        if (isDir)
         {
             dirList.push_back(path);
             if (doRecursive) GetDirsRecursively(path, dirList);
         }
-    } while (FindNextFile(fh, &data));
-    FindClose(fh);
+    });
 }
 
 void GetDirsRecursively(const std::wstring & dir, std::vector<std::wstring>& dirList)
@@ -141,15 +242,14 @@ std::wstring GetCanonicalPath(const std::wstring& path)
     std::vector<std::wstring> trail; trail.reserve(16);
     {
         std::wstring tmp;
-        size_t i = 0;
-        for (; i < pathSize; ++i)
+        for (size_t i = 0; i <= pathSize; ++i)
         {
-            const wchar_t& c = path[i];
+            // end of string is treated as a separator
+            const wchar_t c = i < pathSize ? path[i] : L'/';
             switch (c)
             {
                 case L'/':
                 case L'\\':
-separator:
                     if (tmp.empty())
                     {
                     } else if (tmp == L".")
@@ -169,6 +269,7 @@ separator:
                     } else
                     {
                         trail.push_back(std::move(tmp));
+                        tmp.clear();
                     }
                     break;
                 default:
@@ -177,12 +278,17 @@ separator:
 
             }
         }
-
-        if (i == pathSize) goto separator; // end of string
     }
 
     // concat
     std::wstring ret; ret.reserve(pathSize + 1);
+#ifndef _WIN32
+    // keep root of absolute path
+    if (pathSize > 0 && path[0] == L'/')
+    {
+        ret.push_back(L'/');
+    }
+#endif
     for (const auto& s : trail)
     {
         ret += s;
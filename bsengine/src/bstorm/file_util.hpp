@@ -4,12 +4,22 @@
 #include <vector>
 #include <string>
 #include <unordered_set>
+#include <cstdint>
 
 namespace bstorm
 {
 // mkdir -p
 void MakeDirectoryP(const std::wstring& dirName);
 
+// ファイル全体を読み込む, 開けなければfalse
+bool ReadFileBytes(const std::wstring& path, std::vector<char>* buf);
+// toが既にあれば置き換える
+bool RenameFile(const std::wstring& from, const std::wstring& to);
+bool RemoveFile(const std::wstring& path);
+// 最終更新時刻とサイズ, 取得できなければfalse
+// 時刻の単位は環境依存(WindowsではFILETIME), 同じ環境での比較にのみ使う
+bool GetFileStatus(const std::wstring& path, uint64_t* lastWriteTime, uint64_t* size);
+
 std::wstring GetExt(const std::wstring& path);
 std::wstring GetLowerExt(const std::wstring& path);
 std::wstring GetStem(const std::wstring& path);
@@ -5,6 +5,11 @@
 #include <bstorm/ptr_util.hpp>
 #include <bstorm/thread_util.hpp>
 #include <bstorm/graphic_device.hpp>
+#include <bstorm/texture.hpp>
+#include <bstorm/logger.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 namespace bstorm
 {
@@ -17,39 +22,43 @@ static ColorRGB LerpColor(float y, float height, const ColorRGB& topColor, const
     return ColorRGB(fontR, fontG, fontB);
 }
 
+// ラスタライズ結果
+struct GlyphBitmap
+{
+    std::vector<D3DCOLOR> pixels; // width * height
+    Glyph metrics;
+};
+
 // FUTURE : error check
 // NOTE: Windows GDIを使っているので非同期に作成してはいけない
-Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDevice>& graphicDevice) :
-    texture_(NULL),
-    params_(params)
+static void RasterizeGlyph(const FontParams& params, HWND hWnd, GlyphBitmap& glyphBmp)
 {
-    if (params_.borderType == BORDER_NONE)
+    if (params.borderType == BORDER_NONE)
     {
-        HFONT hFont = CreateFont(params_.size, 0, 0, 0, params_.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params_.fontName.c_str());
+        HFONT hFont = CreateFont(params.size, 0, 0, 0, params.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params.fontName.c_str());
         HDC hDC = GetDC(hWnd);
         HFONT hOldFont = (HFONT)SelectObject(hDC, hFont);
         TEXTMETRIC tm;
         GetTextMetrics(hDC, &tm);
-        UINT code = (UINT)params_.c;
+        UINT code = (UINT)params.c;
         MAT2 mat = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } }; // 回転行列
         GLYPHMETRICS gm;
         int bmpFormat = GGO_GRAY8_BITMAP; // 65階調
         const BYTE grad = 65; // 階調
         DWORD bmpSize = GetGlyphOutline(hDC, code, bmpFormat, &gm, 0, NULL, &mat);
-        BYTE *fontBmp = new BYTE[bmpSize];
-        GetGlyphOutline(hDC, code, bmpFormat, &gm, bmpSize, fontBmp, &mat);
+        std::vector<BYTE> fontBmp(bmpSize);
+        if (bmpSize != 0)
+        {
+            GetGlyphOutline(hDC, code, bmpFormat, &gm, bmpSize, fontBmp.data(), &mat);
+        }
 
         SelectObject(hDC, hOldFont); DeleteObject(hFont);
         ReleaseDC(hWnd, hDC);
 
         const int fontWidth = gm.gmBlackBoxX;
         const int fontHeight = gm.gmBlackBoxY;
-        const int texWidth = NextPow2(fontWidth);
-        const int texHeight = NextPow2(fontHeight);
-        graphicDevice->GetDevice()->CreateTexture(texWidth, texHeight, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &texture_, NULL);
-        D3DLOCKED_RECT texRect;
-        texture_->LockRect(0, &texRect, NULL, D3DLOCK_DISCARD);
-        D3DCOLOR* texMem = (D3DCOLOR*)texRect.pBits;
+        glyphBmp.pixels.assign(fontWidth * fontHeight, 0);
+        D3DCOLOR* texMem = glyphBmp.pixels.data();
 
         const int bmpWidth = (fontWidth + 3) & ~3; // DWORD-align
         ParallelTimes(fontHeight, [&](int y)
@@ -57,11 +66,12 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
             for (int x = 0; x < fontWidth; x++)
             {
                 const int bmpPos = y * bmpWidth + x;
-                const int texPos = y * texWidth + x;
-                const BYTE alpha = (BYTE)(fontBmp[bmpPos] * 255.0 / (grad - 1));
+                const int texPos = y * fontWidth + x;
+                // 空白文字はビットマップが空
+                const BYTE alpha = bmpPos < bmpSize ? (BYTE)(fontBmp[bmpPos] * 255.0 / (grad - 1)) : 0;
                 if (alpha != 0)
                 {
-                    texMem[texPos] = LerpColor(y, fontHeight, params_.topColor, params_.bottomColor).ToD3DCOLOR(alpha);
+                    texMem[texPos] = LerpColor(y, fontHeight, params.topColor, params.bottomColor).ToD3DCOLOR(alpha);
                 } else
                 {
                     // BLEND_ADD_RGB時に色が加算されないようにするため0
@@ -71,17 +81,13 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
             }
         });
 
-        texture_->UnlockRect(0);
-        delete[] fontBmp;
-
-        this->width_ = fontWidth;
-        this->height_ = fontHeight;
-        this->printOffsetX_ = gm.gmptGlyphOrigin.x;
-        this->printOffsetY_ = tm.tmAscent - gm.gmptGlyphOrigin.y;
-        this->rightCharOffsetX_ = gm.gmCellIncX;
-        this->nextLineOffsetY_ = tm.tmHeight;
-        this->textureWidth_ = texWidth;
-        this->textureHeight_ = texHeight;
+
+        glyphBmp.metrics.width = fontWidth;
+        glyphBmp.metrics.height = fontHeight;
+        glyphBmp.metrics.printOffsetX = gm.gmptGlyphOrigin.x;
+        glyphBmp.metrics.printOffsetY = tm.tmAscent - gm.gmptGlyphOrigin.y;
+        glyphBmp.metrics.rightCharOffsetX = gm.gmCellIncX;
+        glyphBmp.metrics.nextLineOffsetY = tm.tmHeight;
     } else
     {
         // BORDER_SHADOWは廃止
@@ -94,7 +100,7 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
 
         /* フォントの作成 */
         /** ssaaQuality倍の大きさで取得 */
-        HFONT hFont = CreateFont(params_.size * ssaaQuality, 0, 0, 0, params_.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params_.fontName.c_str());
+        HFONT hFont = CreateFont(params.size * ssaaQuality, 0, 0, 0, params.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params.fontName.c_str());
         HFONT hOldFont = (HFONT)SelectObject(memDC, hFont);
 
         /* フォントのパラメータ取得 */
@@ -102,9 +108,9 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
         GLYPHMETRICS gm;
         const MAT2 mat = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } };
         GetTextMetrics(memDC, &tm);
-        GetGlyphOutline(memDC, (UINT)params_.c, GGO_METRICS, &gm, 0, NULL, &mat);
+        GetGlyphOutline(memDC, (UINT)params.c, GGO_METRICS, &gm, 0, NULL, &mat);
 
-        const int penSize = 2 * params_.borderWidth * ssaaQuality;
+        const int penSize = 2 * params.borderWidth * ssaaQuality;
 
         /* フォント矩形 */
         /** 幅と高さがssaaQualityの倍数になるように調整 */
@@ -144,13 +150,13 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
 
         //縁取りを先に描く
         BeginPath(memDC);
-        TextOut(memDC, -drawOffsetX, -drawOffsetY, (std::wstring{ params_.c }).c_str(), 1);
+        TextOut(memDC, -drawOffsetX, -drawOffsetY, (std::wstring{ params.c }).c_str(), 1);
         EndPath(memDC);
         StrokePath(memDC);
 
         //文字を塗りつぶす
         BeginPath(memDC);
-        TextOut(memDC, -drawOffsetX, -drawOffsetY, (std::wstring{ params_.c }).c_str(), 1);
+        TextOut(memDC, -drawOffsetX, -drawOffsetY, (std::wstring{ params.c }).c_str(), 1);
         EndPath(memDC);
         FillPath(memDC);
 
@@ -163,13 +169,8 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
         /* テクスチャ取得 */
         const int fontWidth = fontRect.right / ssaaQuality;
         const int fontHeight = fontRect.bottom / ssaaQuality;
-        const int texWidth = NextPow2(fontWidth);
-        const int texHeight = NextPow2(fontHeight);
-
-        graphicDevice->GetDevice()->CreateTexture(texWidth, texHeight, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &texture_, NULL);
-        D3DLOCKED_RECT texRect;
-        texture_->LockRect(0, &texRect, NULL, D3DLOCK_DISCARD);
-        D3DCOLOR* texMem = (D3DCOLOR*)texRect.pBits;
+        glyphBmp.pixels.assign(fontWidth * fontHeight, 0);
+        D3DCOLOR* texMem = glyphBmp.pixels.data();
 
         /* フォントビットマップからテクスチャに書き込み */
         const int bmpWidth = (fontRect.right * 3 + 3) & ~3;
@@ -177,7 +178,7 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
         {
             for (int x = 0; x < fontWidth; x++)
             {
-                const int texPos = y * texWidth + x;
+                const int texPos = y * fontWidth + x;
                 int ch = 0; // 文字
                 int border = 0; // 縁取り
                 int bg = 0; // 背景
@@ -204,55 +205,153 @@ Font::Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDev
                     texMem[texPos] = 0;
                 } else if (alpha < 0xff)
                 {
-                    texMem[texPos] = D3DCOLOR_ARGB(alpha, params_.borderColor.GetR(), params_.borderColor.GetG(), params_.borderColor.GetB());
+                    texMem[texPos] = D3DCOLOR_ARGB(alpha, params.borderColor.GetR(), params.borderColor.GetG(), params.borderColor.GetB());
                 } else
                 {
                     /* フォントの色を線形補間で生成 */
-                    const ColorRGB fontColor = LerpColor(y, fontHeight, params_.topColor, params_.bottomColor);
+                    const ColorRGB fontColor = LerpColor(y, fontHeight, params.topColor, params.bottomColor);
                     /* 混ぜる */
-                    const int r = ((fontColor.GetR() * ch) >> 8) + ((params_.borderColor.GetR() * border) >> 8);
-                    const int g = ((fontColor.GetG() * ch) >> 8) + ((params_.borderColor.GetG() * border) >> 8);
-                    const int b = ((fontColor.GetB() * ch) >> 8) + ((params_.borderColor.GetB() * border) >> 8);
+                    const int r = ((fontColor.GetR() * ch) >> 8) + ((params.borderColor.GetR() * border) >> 8);
+                    const int g = ((fontColor.GetG() * ch) >> 8) + ((params.borderColor.GetG() * border) >> 8);
+                    const int b = ((fontColor.GetB() * ch) >> 8) + ((params.borderColor.GetB() * border) >> 8);
                     texMem[texPos] = D3DCOLOR_ARGB(alpha, (BYTE)r, (BYTE)g, (BYTE)b);
                 }
             }
         });
-        texture_->UnlockRect(0);
         SelectObject(memDC, hOldBmp); DeleteObject(hBmp);
         DeleteDC(memDC);
 
         /* フィールド設定 */
-        hFont = CreateFont(params_.size, 0, 0, 0, params_.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params_.fontName.c_str());
+        hFont = CreateFont(params.size, 0, 0, 0, params.weight, 0, 0, 0, DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, params.fontName.c_str());
         hOldFont = (HFONT)SelectObject(hDC, hFont);
         GetTextMetrics(hDC, &tm);
-        GetGlyphOutline(hDC, (UINT)params_.c, GGO_METRICS, &gm, 0, NULL, &mat);
+        GetGlyphOutline(hDC, (UINT)params.c, GGO_METRICS, &gm, 0, NULL, &mat);
         SelectObject(hDC, hOldFont); DeleteObject(hFont);
         ReleaseDC(hWnd, hDC);
-        this->width_ = fontWidth;
-        this->height_ = fontHeight;
-        this->printOffsetX_ = gm.gmptGlyphOrigin.x;
-        this->printOffsetY_ = tm.tmAscent - gm.gmptGlyphOrigin.y;
-        this->rightCharOffsetX_ = gm.gmCellIncX + params_.borderWidth;
-        this->nextLineOffsetY_ = tm.tmHeight;
-        this->textureWidth_ = texWidth;
-        this->textureHeight_ = texHeight;
+        glyphBmp.metrics.width = fontWidth;
+        glyphBmp.metrics.height = fontHeight;
+        glyphBmp.metrics.printOffsetX = gm.gmptGlyphOrigin.x;
+        glyphBmp.metrics.printOffsetY = tm.tmAscent - gm.gmptGlyphOrigin.y;
+        glyphBmp.metrics.rightCharOffsetX = gm.gmCellIncX + params.borderWidth;
+        glyphBmp.metrics.nextLineOffsetY = tm.tmHeight;
     }
 }
 
-Font::~Font()
+// ページ上の(left, top)に文字画像を書き込む
+static void WriteGlyph(const std::shared_ptr<Texture>& page, int left, int top, const GlyphBitmap& glyphBmp)
 {
-    safe_release(texture_);
+    const int width = glyphBmp.metrics.width;
+    const int height = glyphBmp.metrics.height;
+    if (width <= 0 || height <= 0) return;
+    RECT rect = { left, top, left + width, top + height };
+    D3DLOCKED_RECT texRect;
+    if (FAILED(page->GetTexture()->LockRect(0, &texRect, &rect, 0))) return;
+    for (int y = 0; y < height; y++)
+    {
+        memcpy((BYTE*)texRect.pBits + y * texRect.Pitch, glyphBmp.pixels.data() + y * width, width * sizeof(D3DCOLOR));
+    }
+    page->GetTexture()->UnlockRect(0);
 }
 
-FontStore::FontStore(HWND hWnd, const std::shared_ptr<GraphicDevice>& graphicDevice) :
+GlyphAtlas::GlyphAtlas(HWND hWnd, int pageSize, int maxPageCount, const std::shared_ptr<GraphicDevice>& graphicDevice) :
     hWnd_(hWnd),
+    pageSize_(pageSize),
+    cache_(pageSize, maxPageCount),
     graphicDevice_(graphicDevice)
 {
 }
 
+GlyphAtlas::~GlyphAtlas()
+{
+}
+
+Glyph GlyphAtlas::Get(const FontParams& params)
+{
+    FontParams faceParams = params;
+    faceParams.c = L'\0';
+
+    // 登録済み
+    Glyph glyph;
+    if (cache_.Find(faceParams, params.c, &glyph))
+    {
+        return glyph;
+    }
+
+    GlyphBitmap glyphBmp;
+    RasterizeGlyph(params, hWnd_, glyphBmp);
+    glyph = glyphBmp.metrics;
+
+    bool isInserted = cache_.Insert(faceParams, params.c, &glyph, [&](int pageIdx)
+    {
+        return std::make_shared<Texture>(L"glyph-page-" + params.fontName + L"-" + std::to_wstring(params.size) + L"-" + std::to_wstring(pageIdx), pageSize_, pageSize_, graphicDevice_);
+    });
+    if (!isInserted)
+    {
+        // ページより大きい文字は専用のテクスチャを作る
+        glyph.page = std::make_shared<Texture>(L"glyph-" + params.fontName + L"-" + std::wstring{ params.c }, NextPow2(glyph.width), NextPow2(glyph.height), graphicDevice_);
+        glyph.region = AtlasRegion();
+        glyph.region.width = glyph.width;
+        glyph.region.height = glyph.height;
+        WriteGlyph(glyph.page, 0, 0, glyphBmp);
+        return glyph;
+    }
+
+    WriteGlyph(glyph.page, glyph.region.x, glyph.region.y, glyphBmp);
+    return glyph;
+}
+
+int GlyphAtlas::GetPageCount() const
+{
+    return cache_.GetPageCount();
+}
+
+int GlyphAtlas::GetMaxPageCount() const
+{
+    return cache_.GetMaxPageCount();
+}
+
+int GlyphAtlas::GetGlyphCount() const
+{
+    return cache_.GetGlyphCount();
+}
+
+Font::Font(const FontParams& params, const std::shared_ptr<GlyphAtlas>& glyphAtlas) :
+    params_(params),
+    glyph_(glyphAtlas->Get(params))
+{
+}
+
+Font::~Font()
+{
+}
+
+int Font::GetTextureWidth() const
+{
+    return glyph_.page->GetWidth();
+}
+
+int Font::GetTextureHeight() const
+{
+    return glyph_.page->GetHeight();
+}
+
+IDirect3DTexture9* Font::GetTexture() const
+{
+    return glyph_.page->GetTexture();
+}
+
+// 512x512のページを64枚(64MB)まで
+constexpr int GLYPH_PAGE_SIZE = 512;
+constexpr int GLYPH_MAX_PAGE_COUNT = 64;
+
+FontStore::FontStore(HWND hWnd, const std::shared_ptr<GraphicDevice>& graphicDevice) :
+    glyphAtlas_(std::make_shared<GlyphAtlas>(hWnd, GLYPH_PAGE_SIZE, GLYPH_MAX_PAGE_COUNT, graphicDevice))
+{
+}
+
 const std::shared_ptr<Font>& FontStore::Create(const FontParams& params)
 {
-    return cacheStore_.Load(params, params, hWnd_, graphicDevice_);
+    return cacheStore_.Load(params, params, glyphAtlas_);
 }
 
 bool FontStore::Contains(const FontParams & params) const
@@ -265,6 +364,11 @@ void FontStore::RemoveUnusedFont()
     cacheStore_.RemoveUnused();
 }
 
+const std::shared_ptr<GlyphAtlas>& FontStore::GetGlyphAtlas() const
+{
+    return glyphAtlas_;
+}
+
 bool InstallFont(const std::wstring& path)
 {
     int result = AddFontResourceEx(path.c_str(), FR_PRIVATE, NULL);
@@ -4,43 +4,60 @@
 #include <bstorm/non_copyable.hpp>
 #include <bstorm/color_rgb.hpp>
 #include <bstorm/cache_store.hpp>
+#include <bstorm/glyph_page_cache.hpp>
 
 #include <windows.h>
 #include <string>
 #include <memory>
-#include <unordered_map>
 #include <d3d9.h>
 
 namespace bstorm
 {
 class GraphicDevice;
+class Texture;
+
+// 書体・サイズ・装飾が同じ文字を共有のページに詰め込む
+// ページ数が上限に達したら, 最も長く使われていないページから追い出す
+class GlyphAtlas : private NonCopyable
+{
+public:
+    GlyphAtlas(HWND hWnd, int pageSize, int maxPageCount, const std::shared_ptr<GraphicDevice>& graphicDevice);
+    ~GlyphAtlas();
+    // 登録済みでなければラスタライズして登録する
+    Glyph Get(const FontParams& params);
+    int GetPageCount() const;
+    int GetMaxPageCount() const;
+    int GetGlyphCount() const;
+    template <class Fn>
+    void ForEachPage(Fn func) const { cache_.ForEachPage(func); }
+private:
+    HWND hWnd_;
+    const int pageSize_;
+    GlyphPageCache<FontParams> cache_; // key : 文字を除いたフォントパラメータ
+    const std::shared_ptr<GraphicDevice> graphicDevice_;
+};
+
 class Font : private NonCopyable
 {
 public:
-    Font(const FontParams& params, HWND hWnd, const std::shared_ptr<GraphicDevice>& graphicDevice);
+    Font(const FontParams& params, const std::shared_ptr<GlyphAtlas>& glyphAtlas);
     ~Font();
-    int GetWidth() const { return width_; }
-    int GetHeight() const { return height_; }
-    int GetTextureWidth() const { return textureWidth_; }
-    int GetTextureHeight() const { return textureHeight_; }
-    int GetPrintOffsetX() const { return printOffsetX_; }
-    int GetPrintOffsetY() const { return printOffsetY_; }
-    int GetRightCharOffsetX() const { return rightCharOffsetX_; }
-    int GetNextLineOffsetY() const { return nextLineOffsetY_; }
-    IDirect3DTexture9* GetTexture() const { return texture_; }
+    int GetWidth() const { return glyph_.width; }
+    int GetHeight() const { return glyph_.height; }
+    int GetTextureWidth() const;
+    int GetTextureHeight() const;
+    int GetPrintOffsetX() const { return glyph_.printOffsetX; }
+    int GetPrintOffsetY() const { return glyph_.printOffsetY; }
+    int GetRightCharOffsetX() const { return glyph_.rightCharOffsetX; }
+    int GetNextLineOffsetY() const { return glyph_.nextLineOffsetY; }
+    IDirect3DTexture9* GetTexture() const;
+    const std::shared_ptr<Texture>& GetPage() const { return glyph_.page; }
+    // ページ上のセルの位置
+    const AtlasRegion& GetRegion() const { return glyph_.region; }
     const FontParams& GetParams() const { return params_; }
 private:
     FontParams params_;
-    IDirect3DTexture9 *texture_; // セル(文字画像)を格納したテクスチャ, 綺麗に出力できるように高さと幅は2のn乗に揃える
-    int width_;  // セルの幅
-    int height_; // セルの高さ
-    /* セルの左上を置いた位置から描画開始位置までの距離 */
-    int printOffsetX_;
-    int printOffsetY_;
-    int rightCharOffsetX_; // 右に来る文字のまでの距離
-    int nextLineOffsetY_; // 次の行までの距離
-    int textureWidth_; // テクスチャの幅(2のn乗)
-    int textureHeight_; // テクスチャの高さ(2のn乗)
+    Glyph glyph_;
 };
 
 class FontStore
@@ -52,9 +69,9 @@ public:
     void RemoveUnusedFont();
     template <class Fn>
     void ForEach(Fn func) { cacheStore_.ForEach(func); }
+    const std::shared_ptr<GlyphAtlas>& GetGlyphAtlas() const;
 private:
-    HWND hWnd_;
-    const std::shared_ptr<GraphicDevice> graphicDevice_;
+    const std::shared_ptr<GlyphAtlas> glyphAtlas_;
     CacheStore<FontParams, Font> cacheStore_;
 };
 
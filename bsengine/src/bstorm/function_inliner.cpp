@@ -0,0 +1,457 @@
+﻿#include <bstorm/function_inliner.hpp>
+
+#include <bstorm/env.hpp>
+
+namespace bstorm
+{
+// NOTE: 到達可能な部分だけ展開する
+// NOTE: 引数は関数本体の中で評価されるようになるので, 評価の順序や回数が変わっても結果が同じ
+// NOTE: リテラル, 定数, 実数などの変数に限る
+
+// 展開する関数本体の大きさ(式のノード数)の上限
+constexpr int maxInlineExpSize = 16;
+
+static bool IsScalarType(ExpType type)
+{
+    return type == ExpType::REAL || type == ExpType::BOOL || type == ExpType::CHAR;
+}
+
+// 部分式を列挙する, 展開できない種類の式ならfalse
+static bool GetSubExps(NodeExp& exp, std::vector<std::shared_ptr<NodeExp>*>& subExps)
+{
+    if (auto mono = dynamic_cast<NodeMonoOp*>(&exp))
+    {
+        subExps.push_back(&mono->rhs);
+    } else if (auto bin = dynamic_cast<NodeBinOp*>(&exp))
+    {
+        subExps.push_back(&bin->lhs);
+        subExps.push_back(&bin->rhs);
+    } else if (auto array = dynamic_cast<NodeArray*>(&exp))
+    {
+        for (auto& e : array->elems) subExps.push_back(&e);
+    } else if (auto call = dynamic_cast<NodeCallExp*>(&exp))
+    {
+        for (auto& arg : call->args) subExps.push_back(&arg);
+    } else if (auto ref = dynamic_cast<NodeArrayRef*>(&exp))
+    {
+        subExps.push_back(&ref->array);
+        subExps.push_back(&ref->idx);
+    } else if (auto slice = dynamic_cast<NodeArraySlice*>(&exp))
+    {
+        subExps.push_back(&slice->array);
+        subExps.push_back(&slice->range->start);
+        subExps.push_back(&slice->range->end);
+    } else if (!dynamic_cast<NodeNum*>(&exp) && !dynamic_cast<NodeChar*>(&exp) &&
+               !dynamic_cast<NodeStr*>(&exp) && !dynamic_cast<NodeNoParenCallExp*>(&exp))
+    {
+        return false;
+    }
+    return true;
+}
+
+template <class T>
+static bool CopyAs(const NodeExp& exp, std::shared_ptr<NodeExp>& copy)
+{
+    if (auto e = dynamic_cast<const T*>(&exp))
+    {
+        copy = std::make_shared<T>(*e);
+        return true;
+    }
+    return false;
+}
+
+// 部分式は共有したままのコピー
+static std::shared_ptr<NodeExp> ShallowCopy(const NodeExp& exp)
+{
+    std::shared_ptr<NodeExp> copy;
+    CopyAs<NodeNum>(exp, copy) || CopyAs<NodeChar>(exp, copy) || CopyAs<NodeStr>(exp, copy) ||
+        CopyAs<NodeArray>(exp, copy) || CopyAs<NodeNeg>(exp, copy) || CopyAs<NodeNot>(exp, copy) ||
+        CopyAs<NodeAbs>(exp, copy) || CopyAs<NodeAdd>(exp, copy) || CopyAs<NodeSub>(exp, copy) ||
+        CopyAs<NodeMul>(exp, copy) || CopyAs<NodeDiv>(exp, copy) || CopyAs<NodeRem>(exp, copy) ||
+        CopyAs<NodePow>(exp, copy) || CopyAs<NodeLt>(exp, copy) || CopyAs<NodeGt>(exp, copy) ||
+        CopyAs<NodeLe>(exp, copy) || CopyAs<NodeGe>(exp, copy) || CopyAs<NodeEq>(exp, copy) ||
+        CopyAs<NodeNe>(exp, copy) || CopyAs<NodeAnd>(exp, copy) || CopyAs<NodeOr>(exp, copy) ||
+        CopyAs<NodeCat>(exp, copy) || CopyAs<NodeNoParenCallExp>(exp, copy) || CopyAs<NodeCallExp>(exp, copy) ||
+        CopyAs<NodeArrayRef>(exp, copy) || CopyAs<NodeArraySlice>(exp, copy);
+    if (auto slice = std::dynamic_pointer_cast<NodeArraySlice>(copy))
+    {
+        slice->range = std::make_shared<NodeRange>(*slice->range);
+    }
+    return copy;
+}
+
+void FunctionInliner::Inline(Node & program)
+{
+    env_ = nullptr;
+    replacedExp_ = nullptr;
+    bodies_.clear();
+    program.Traverse(*this);
+}
+
+void FunctionInliner::Traverse(NodeNum &) {}
+void FunctionInliner::Traverse(NodeChar &) {}
+void FunctionInliner::Traverse(NodeStr &) {}
+void FunctionInliner::Traverse(NodeArray & array)
+{
+    for (auto& e : array.elems)
+    {
+        InlineExp(e);
+    }
+}
+void FunctionInliner::Traverse(NodeNeg & exp) { InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeNot & exp) { InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeAbs & exp) { InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeAdd & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeSub & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeMul & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeDiv & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeRem & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodePow & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeLt & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeGt & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeLe & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeGe & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeEq & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeNe & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeAnd & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeOr & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeCat & exp) { InlineExp(exp.lhs); InlineExp(exp.rhs); }
+void FunctionInliner::Traverse(NodeNoParenCallExp & call)
+{
+    InlineCall(call.name, {});
+}
+void FunctionInliner::Traverse(NodeCallExp & call)
+{
+    for (auto& arg : call.args)
+    {
+        InlineExp(arg);
+    }
+    InlineCall(call.name, call.args);
+}
+void FunctionInliner::Traverse(NodeArrayRef & exp)
+{
+    InlineExp(exp.array);
+    InlineExp(exp.idx);
+}
+void FunctionInliner::Traverse(NodeRange & range)
+{
+    InlineExp(range.start);
+    InlineExp(range.end);
+}
+void FunctionInliner::Traverse(NodeArraySlice & exp)
+{
+    InlineExp(exp.array);
+    exp.range->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeNop &) {}
+void FunctionInliner::Traverse(NodeLeftVal & left)
+{
+    for (auto& idx : left.indices)
+    {
+        InlineExp(idx);
+    }
+}
+void FunctionInliner::Traverse(NodeAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeAddAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeSubAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeMulAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeDivAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeRemAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodePowAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeCatAssign & stmt) { stmt.lhs->Traverse(*this); InlineExp(stmt.rhs); }
+void FunctionInliner::Traverse(NodeCallStmt & call)
+{
+    for (auto& arg : call.args)
+    {
+        InlineExp(arg);
+    }
+}
+void FunctionInliner::Traverse(NodeReturn & stmt)
+{
+    InlineExp(stmt.ret);
+}
+void FunctionInliner::Traverse(NodeReturnVoid &) {}
+void FunctionInliner::Traverse(NodeYield &) {}
+void FunctionInliner::Traverse(NodeBreak &) {}
+void FunctionInliner::Traverse(NodeSucc & stmt)
+{
+    stmt.lhs->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodePred & stmt)
+{
+    stmt.lhs->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeVarDecl &) {}
+void FunctionInliner::Traverse(NodeVarInit & stmt)
+{
+    InlineExp(stmt.rhs);
+}
+void FunctionInliner::Traverse(NodeProcParam &) {}
+void FunctionInliner::Traverse(NodeLoopParam &) {}
+void FunctionInliner::Traverse(NodeResult &) {}
+void FunctionInliner::Traverse(NodeBlock & blk)
+{
+    env_ = std::make_shared<Env>(blk.nameTable, env_);
+    for (auto& stmt : blk.stmts)
+    {
+        stmt->Traverse(*this);
+    }
+    for (const auto& bind : *(blk.nameTable))
+    {
+        auto& def = bind.second;
+        if (def->unreachable) continue;
+        def->Traverse(*this);
+    }
+    env_ = env_->GetParent();
+}
+void FunctionInliner::Traverse(NodeSubDef & def)
+{
+    def.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeBuiltInSubDef & def)
+{
+    def.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeFuncDef & def)
+{
+    def.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeTaskDef & def)
+{
+    def.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeBuiltInFunc &) {}
+void FunctionInliner::Traverse(NodeConst &) {}
+void FunctionInliner::Traverse(NodeLocal & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeLoop & stmt)
+{
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeTimes & stmt)
+{
+    InlineExp(stmt.cnt);
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeWhile & stmt)
+{
+    InlineExp(stmt.cond);
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeAscent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeDescent & stmt)
+{
+    stmt.range->Traverse(*this);
+    stmt.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeElseIf & elsif)
+{
+    InlineExp(elsif.cond);
+    elsif.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeIf & stmt)
+{
+    InlineExp(stmt.cond);
+    stmt.thenBlock->Traverse(*this);
+    for (auto& elsif : stmt.elsifs)
+    {
+        elsif->Traverse(*this);
+    }
+    if (stmt.elseBlock) stmt.elseBlock->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeCase & c)
+{
+    for (auto& exp : c.exps)
+    {
+        InlineExp(exp);
+    }
+    c.block->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeAlternative & stmt)
+{
+    InlineExp(stmt.cond);
+    for (auto& c : stmt.cases) c->Traverse(*this);
+    if (stmt.others) stmt.others->Traverse(*this);
+}
+void FunctionInliner::Traverse(NodeHeader &) {}
+
+void FunctionInliner::InlineExp(std::shared_ptr<NodeExp>& exp)
+{
+    replacedExp_ = nullptr;
+    exp->Traverse(*this);
+    if (replacedExp_)
+    {
+        exp = replacedExp_;
+        replacedExp_ = nullptr;
+    }
+}
+
+void FunctionInliner::InlineCall(const Ident& name, const std::vector<std::shared_ptr<NodeExp>>& args)
+{
+    replacedExp_ = nullptr;
+    auto func = std::dynamic_pointer_cast<NodeFuncDef>(env_->FindDef(name));
+    if (!func || func->params.size() != args.size()) return;
+    const auto& body = GetInlineBody(name, *func);
+    if (!body.isInlinable) return;
+
+    // 関数の中で参照している名前が呼び出し元でも同じものを指すこと
+    for (const auto& freeName : body.freeNames)
+    {
+        if (env_->FindDef(freeName.first).get() != freeName.second) return;
+    }
+
+    std::unordered_map<Ident, std::shared_ptr<NodeExp>> paramArgs;
+    for (size_t i = 0; i < args.size(); i++)
+    {
+        const auto& arg = args[i];
+        bool isLiteral = dynamic_cast<NodeNum*>(arg.get()) || dynamic_cast<NodeChar*>(arg.get()) || dynamic_cast<NodeStr*>(arg.get());
+        if (auto argRef = std::dynamic_pointer_cast<NodeNoParenCallExp>(arg))
+        {
+            auto def = env_->FindDef(argRef->name);
+            if (std::dynamic_pointer_cast<NodeConst>(def))
+            {
+                isLiteral = true;
+            } else if (def && def->IsVariable() && IsScalarType(arg->expType))
+            {
+                // 変数の読み出しが関数本体の呼び出しより後になるので, 呼び出しで書き換えられないこと
+                // グローバル変数は組み込み関数から再入した@Eventが書き換えうる
+                if (body.hasUserCall) return;
+                if (body.hasNativeCall && IsRootVar(argRef->name)) return;
+            } else
+            {
+                return;
+            }
+        } else if (!isLiteral)
+        {
+            return;
+        }
+        paramArgs[func->params[i]] = arg;
+    }
+
+    auto inlined = CloneExp(body.exp, paramArgs);
+
+    // 元の引数の変数参照は展開した式の中の参照に置き換わる
+    for (const auto& arg : args)
+    {
+        if (auto argRef = std::dynamic_pointer_cast<NodeNoParenCallExp>(arg))
+        {
+            if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(env_->FindDef(argRef->name)))
+            {
+                if (varDecl->refCnt > 0) varDecl->refCnt--;
+            }
+        }
+    }
+    replacedExp_ = inlined;
+}
+
+const FunctionInliner::InlineBody & FunctionInliner::GetInlineBody(const Ident& name, const NodeFuncDef & func)
+{
+    auto it = bodies_.find(&func);
+    if (it != bodies_.end()) return it->second;
+
+    auto& body = bodies_[&func];
+    if (func.block->stmts.size() != 1) return body;
+    auto ret = std::dynamic_pointer_cast<NodeReturn>(func.block->stmts[0]);
+    if (!ret) return body;
+    // 引数とresult以外の定義を持たない
+    for (const auto& bind : *(func.block->nameTable))
+    {
+        if (!std::dynamic_pointer_cast<NodeProcParam>(bind.second) && !std::dynamic_pointer_cast<NodeResult>(bind.second))
+        {
+            return body;
+        }
+    }
+
+    // 関数が定義されたスコープ
+    auto defEnv = env_;
+    while (defEnv && defEnv->GetCurrentBlockNameTable()->count(name) == 0)
+    {
+        defEnv = defEnv->GetParent();
+    }
+    if (!defEnv) return body;
+    Env funcEnv(func.block->nameTable, defEnv);
+
+    body.exp = ret->ret;
+    body.isInlinable = AnalyzeBody(*body.exp, func, funcEnv, body) && body.size <= maxInlineExpSize;
+    return body;
+}
+
+bool FunctionInliner::AnalyzeBody(NodeExp & exp, const NodeFuncDef & func, const Env & funcEnv, InlineBody & body)
+{
+    body.size++;
+    const Ident* name = nullptr;
+    if (auto call = dynamic_cast<NodeNoParenCallExp*>(&exp))
+    {
+        name = &call->name;
+    } else if (auto call = dynamic_cast<NodeCallExp*>(&exp))
+    {
+        name = &call->name;
+    }
+    if (name)
+    {
+        auto def = funcEnv.FindDef(*name);
+        if (!def || def.get() == &func) return false; // 再帰
+        if (auto builtIn = std::dynamic_pointer_cast<NodeBuiltInFunc>(def))
+        {
+            if (!builtIn->isRuntime) body.hasNativeCall = true;
+        } else if (!def->IsVariable() && !std::dynamic_pointer_cast<NodeConst>(def))
+        {
+            body.hasUserCall = true;
+        }
+        if (func.block->nameTable->count(*name) == 0)
+        {
+            body.freeNames.emplace_back(*name, def.get());
+        } else if (!std::dynamic_pointer_cast<NodeProcParam>(def))
+        {
+            return false; // result
+        }
+    }
+    std::vector<std::shared_ptr<NodeExp>*> subExps;
+    if (!GetSubExps(exp, subExps)) return false;
+    for (auto subExp : subExps)
+    {
+        if (!AnalyzeBody(**subExp, func, funcEnv, body)) return false;
+    }
+    return true;
+}
+
+bool FunctionInliner::IsRootVar(const Ident& name) const
+{
+    auto env = env_;
+    while (env && env->GetCurrentBlockNameTable()->count(name) == 0)
+    {
+        env = env->GetParent();
+    }
+    return env && env->IsRoot();
+}
+
+std::shared_ptr<NodeExp> FunctionInliner::CloneExp(const std::shared_ptr<NodeExp>& exp, const std::unordered_map<Ident, std::shared_ptr<NodeExp>>& args)
+{
+    if (auto call = std::dynamic_pointer_cast<NodeNoParenCallExp>(exp))
+    {
+        auto it = args.find(call->name);
+        if (it != args.end())
+        {
+            return CloneExp(it->second, {});
+        }
+        if (auto varDecl = std::dynamic_pointer_cast<NodeVarDecl>(env_->FindDef(call->name)))
+        {
+            varDecl->refCnt++;
+        }
+    }
+    auto copy = ShallowCopy(*exp);
+    std::vector<std::shared_ptr<NodeExp>*> subExps;
+    GetSubExps(*copy, subExps);
+    for (auto subExp : subExps)
+    {
+        *subExp = CloneExp(*subExp, args);
+    }
+    return copy;
+}
+}
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include <bstorm/node.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace bstorm
+{
+class Env;
+// returnするだけの小さな関数の呼び出しを, 引数を置き換えた関数本体の式で置き換える
+// 型を使うのでCodeAnalyzerの後, 展開した式を畳み込めるようにConstantFolderの前に行う
+class FunctionInliner : public NodeTraverser
+{
+public:
+    void Inline(Node& program);
+    void Traverse(NodeNum&) override;
+    void Traverse(NodeChar&) override;
+    void Traverse(NodeStr&) override;
+    void Traverse(NodeArray&) override;
+    void Traverse(NodeNeg&) override;
+    void Traverse(NodeNot&) override;
+    void Traverse(NodeAbs&) override;
+    void Traverse(NodeAdd&) override;
+    void Traverse(NodeSub&) override;
+    void Traverse(NodeMul&) override;
+    void Traverse(NodeDiv&) override;
+    void Traverse(NodeRem&) override;
+    void Traverse(NodePow&) override;
+    void Traverse(NodeLt&) override;
+    void Traverse(NodeGt&) override;
+    void Traverse(NodeLe&) override;
+    void Traverse(NodeGe&) override;
+    void Traverse(NodeEq&) override;
+    void Traverse(NodeNe&) override;
+    void Traverse(NodeAnd&) override;
+    void Traverse(NodeOr&) override;
+    void Traverse(NodeCat&) override;
+    void Traverse(NodeNoParenCallExp&) override;
+    void Traverse(NodeCallExp&) override;
+    void Traverse(NodeArrayRef&) override;
+    void Traverse(NodeRange&) override;
+    void Traverse(NodeArraySlice&) override;
+    void Traverse(NodeNop&) override;
+    void Traverse(NodeLeftVal&) override;
+    void Traverse(NodeAssign&) override;
+    void Traverse(NodeAddAssign&) override;
+    void Traverse(NodeSubAssign&) override;
+    void Traverse(NodeMulAssign&) override;
+    void Traverse(NodeDivAssign&) override;
+    void Traverse(NodeRemAssign&) override;
+    void Traverse(NodePowAssign&) override;
+    void Traverse(NodeCatAssign&) override;
+    void Traverse(NodeCallStmt&) override;
+    void Traverse(NodeReturn&) override;
+    void Traverse(NodeReturnVoid&) override;
+    void Traverse(NodeYield&) override;
+    void Traverse(NodeBreak&) override;
+    void Traverse(NodeSucc&) override;
+    void Traverse(NodePred&) override;
+    void Traverse(NodeVarDecl&) override;
+    void Traverse(NodeVarInit&) override;
+    void Traverse(NodeProcParam&) override;
+    void Traverse(NodeLoopParam&) override;
+    void Traverse(NodeResult&) override;
+    void Traverse(NodeBlock&) override;
+    void Traverse(NodeSubDef&) override;
+    void Traverse(NodeBuiltInSubDef&) override;
+    void Traverse(NodeFuncDef&) override;
+    void Traverse(NodeTaskDef&) override;
+    void Traverse(NodeBuiltInFunc&) override;
+    void Traverse(NodeConst&) override;
+    void Traverse(NodeLocal&) override;
+    void Traverse(NodeLoop&) override;
+    void Traverse(NodeTimes&) override;
+    void Traverse(NodeWhile&) override;
+    void Traverse(NodeAscent&) override;
+    void Traverse(NodeDescent&) override;
+    void Traverse(NodeElseIf&) override;
+    void Traverse(NodeIf&) override;
+    void Traverse(NodeCase&) override;
+    void Traverse(NodeAlternative&) override;
+    void Traverse(NodeHeader&) override;
+private:
+    struct InlineBody
+    {
+        bool isInlinable = false;
+        bool hasUserCall = false; // ユーザ定義の手続きの呼び出しを含む
+        bool hasNativeCall = false; // C++の組み込み関数の呼び出しを含む
+        int size = 0;
+        std::shared_ptr<NodeExp> exp;
+        std::vector<std::pair<Ident, const NodeDef*>> freeNames; // 関数の外で定義された名前
+    };
+    // 式を辿り, 展開できる呼び出しなら置き換える
+    void InlineExp(std::shared_ptr<NodeExp>& exp);
+    void InlineCall(const Ident& name, const std::vector<std::shared_ptr<NodeExp>>& args);
+    const InlineBody& GetInlineBody(const Ident& name, const NodeFuncDef& func);
+    bool AnalyzeBody(NodeExp& exp, const NodeFuncDef& func, const Env& funcEnv, InlineBody& body);
+    bool IsRootVar(const Ident& name) const;
+    std::shared_ptr<NodeExp> CloneExp(const std::shared_ptr<NodeExp>& exp, const std::unordered_map<Ident, std::shared_ptr<NodeExp>>& args);
+    std::shared_ptr<Env> env_;
+    std::shared_ptr<NodeExp> replacedExp_;
+    std::unordered_map<const NodeDef*, InlineBody> bodies_;
+};
+}
@@ -0,0 +1,188 @@
+﻿#pragma once
+
+#include <bstorm/non_copyable.hpp>
+#include <bstorm/atlas_packer.hpp>
+#include <bstorm/logger.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace bstorm
+{
+class Texture;
+
+// ラスタライズした1文字分の画像と配置情報
+struct Glyph
+{
+    std::shared_ptr<Texture> page; // 文字画像を格納したページ
+    AtlasRegion region; // ページ上の位置
+    int width;  // セルの幅
+    int height; // セルの高さ
+    /* セルの左上を置いた位置から描画開始位置までの距離 */
+    int printOffsetX;
+    int printOffsetY;
+    int rightCharOffsetX; // 右に来る文字のまでの距離
+    int nextLineOffsetY; // 次の行までの距離
+};
+
+// 書体(FaceKey)ごとに文字の配置をページ単位で管理する
+// ページ数が上限に達したら, 外から参照されていないページのうち最も長く使われていないものを追い出す
+// 文字画像の作成とページへの書き込みは呼び出し側で行う
+template <class FaceKey>
+class GlyphPageCache : private NonCopyable
+{
+public:
+    GlyphPageCache(int pageSize, int maxPageCount) :
+        pageSize_(pageSize),
+        maxPageCount_(maxPageCount),
+        pageCount_(0),
+        time_(0)
+    {
+    }
+    // 登録済みなら文字を返してページの使用時刻を更新する
+    bool Find(const FaceKey& faceKey, wchar_t c, Glyph* glyph)
+    {
+        time_++;
+        auto faceIt = faces_.find(faceKey);
+        if (faceIt == faces_.end()) return false;
+        Face& face = *faceIt->second;
+        auto glyphIt = face.glyphs.find(c);
+        if (glyphIt == face.glyphs.end()) return false;
+        *glyph = glyphIt->second;
+        Page& page = face.pages[glyph->region.page];
+        page.lastUsedTime = time_;
+        glyph->page = page.texture;
+        return true;
+    }
+    // 文字の大きさの領域を確保して登録する
+    // 新しいページが必要ならcreatePage(ページ番号)で作る
+    // ページに収まらない大きさならfalse
+    template <class CreatePage>
+    bool Insert(const FaceKey& faceKey, wchar_t c, Glyph* glyph, CreatePage createPage)
+    {
+        time_++;
+        auto faceIt = faces_.find(faceKey);
+        if (faceIt == faces_.end())
+        {
+            faceIt = faces_.emplace(faceKey, std::make_unique<Face>(pageSize_)).first;
+        }
+        Face& face = *faceIt->second;
+
+        AtlasRegion region;
+        if (!face.packer.Insert(std::max(1, glyph->width), std::max(1, glyph->height), &region)) return false;
+
+        if (region.page >= (int)face.pages.size())
+        {
+            face.pages.resize(region.page + 1, Page{ nullptr, 0 });
+        }
+        Page& page = face.pages[region.page];
+        if (!page.texture)
+        {
+            // 全て参照中なら上限を超えるが, 参照が切れた後のページ作成時に上限まで追い出される
+            while (pageCount_ >= maxPageCount_ && EvictLeastRecentlyUsedPage(&face, region.page))
+            {
+            }
+            page.texture = createPage(region.page);
+            pageCount_++;
+        }
+        page.lastUsedTime = time_;
+
+        // キャッシュ内ではページを持たない(持つと参照数で追い出し可能か判定できない)
+        glyph->page = nullptr;
+        glyph->region = region;
+        face.glyphs[c] = *glyph;
+        glyph->page = page.texture;
+        return true;
+    }
+    int GetPageCount() const { return pageCount_; }
+    int GetMaxPageCount() const { return maxPageCount_; }
+    int GetGlyphCount() const
+    {
+        int cnt = 0;
+        for (const auto& entry : faces_)
+        {
+            cnt += entry.second->glyphs.size();
+        }
+        return cnt;
+    }
+    template <class Fn>
+    void ForEachPage(Fn func) const
+    {
+        for (const auto& entry : faces_)
+        {
+            const auto& face = *entry.second;
+            for (int i = 0; i < (int)face.pages.size(); i++)
+            {
+                if (face.pages[i].texture)
+                {
+                    func(entry.first, face.pages[i].texture, face.packer.GetPageStats(i));
+                }
+            }
+        }
+    }
+private:
+    struct Page
+    {
+        std::shared_ptr<Texture> texture;
+        uint64_t lastUsedTime;
+    };
+    struct Face
+    {
+        Face(int pageSize) : packer(pageSize, pageSize, 1) {}
+        AtlasPacker packer;
+        std::vector<Page> pages;
+        std::unordered_map<wchar_t, Glyph> glyphs;
+    };
+    bool EvictLeastRecentlyUsedPage(const Face* excludeFace, int excludePage)
+    {
+        Face* victimFace = nullptr;
+        int victimPage = -1;
+        for (auto& entry : faces_)
+        {
+            Face& face = *entry.second;
+            for (int i = 0; i < (int)face.pages.size(); i++)
+            {
+                const Page& page = face.pages[i];
+                if (!page.texture) continue;
+                if (&face == excludeFace && i == excludePage) continue;
+                // 描画中の文字が載っているページは追い出せない
+                if (page.texture.use_count() > 1) continue;
+                if (victimFace == nullptr || page.lastUsedTime < victimFace->pages[victimPage].lastUsedTime)
+                {
+                    victimFace = &face;
+                    victimPage = i;
+                }
+            }
+        }
+        if (victimFace == nullptr) return false;
+
+        Logger::Write(std::move(
+            Log(LogLevel::LV_INFO)
+            .Msg("Evicted glyph page.")));
+
+        victimFace->pages[victimPage].texture.reset();
+        victimFace->packer.ClearPage(victimPage);
+        auto it = victimFace->glyphs.begin();
+        while (it != victimFace->glyphs.end())
+        {
+            if (it->second.region.page == victimPage)
+            {
+                victimFace->glyphs.erase(it++);
+            } else
+            {
+                ++it;
+            }
+        }
+        pageCount_--;
+        return true;
+    }
+    const int pageSize_;
+    const int maxPageCount_;
+    int pageCount_;
+    uint64_t time_;
+    std::unordered_map<FaceKey, std::unique_ptr<Face>> faces_;
+};
+}
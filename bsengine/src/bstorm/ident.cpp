@@ -0,0 +1,52 @@
+﻿#include <bstorm/ident.hpp>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace bstorm
+{
+namespace
+{
+// 要素を消さないので, 登録した要素のアドレスは変わらない
+struct IdentTable
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, size_t> entries;
+};
+
+IdentTable& GetIdentTable()
+{
+    static IdentTable table;
+    return table;
+}
+}
+
+Ident::Ident()
+{
+    // トークンごとに作られるので, 空文字列の要素は1度だけ引く
+    static const Entry* empty = Intern("");
+    entry_ = empty;
+}
+
+Ident::Ident(const std::string& s) :
+    entry_(Intern(s))
+{
+}
+
+Ident::Ident(const char* s) :
+    entry_(Intern(s))
+{
+}
+
+const Ident::Entry* Ident::Intern(const std::string& s)
+{
+    auto& table = GetIdentTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.entries.find(s);
+    if (it == table.entries.end())
+    {
+        it = table.entries.emplace(s, std::hash<std::string>()(s)).first;
+    }
+    return &*it;
+}
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace bstorm
+{
+// 登録済みの識別子
+// 同じ綴りの識別子は同じ要素を指すので, 比較はポインタ, ハッシュは登録時に計算した値で済む
+// 要素はプロセスの終了まで解放しない, 登録はスレッドセーフ
+class Ident
+{
+public:
+    // (綴り, std::hash<std::string>の値)
+    // ハッシュを文字列と同じにして, 名前表の走査順を変えない
+    using Entry = std::pair<const std::string, size_t>;
+    Ident(); // 空文字列
+    explicit Ident(const std::string& s);
+    explicit Ident(const char* s);
+    explicit Ident(const Entry* entry) : entry_(entry) {}
+    const std::string& GetString() const { return entry_->first; }
+    size_t GetHash() const { return entry_->second; }
+    const Entry* GetEntry() const { return entry_; }
+    operator const std::string&() const { return entry_->first; }
+private:
+    static const Entry* Intern(const std::string& s);
+    const Entry* entry_;
+};
+
+inline bool operator==(const Ident& a, const Ident& b) { return a.GetEntry() == b.GetEntry(); }
+inline bool operator!=(const Ident& a, const Ident& b) { return a.GetEntry() != b.GetEntry(); }
+// 文字列との比較は登録せずに綴りを比べる
+inline bool operator==(const Ident& a, const std::string& b) { return a.GetString() == b; }
+inline bool operator==(const std::string& a, const Ident& b) { return a == b.GetString(); }
+inline bool operator==(const Ident& a, const char* b) { return a.GetString() == b; }
+inline bool operator==(const char* a, const Ident& b) { return a == b.GetString(); }
+inline bool operator!=(const Ident& a, const std::string& b) { return a.GetString() != b; }
+inline bool operator!=(const std::string& a, const Ident& b) { return a != b.GetString(); }
+inline bool operator!=(const Ident& a, const char* b) { return a.GetString() != b; }
+inline bool operator!=(const char* a, const Ident& b) { return a != b.GetString(); }
+inline std::string operator+(const Ident& a, const Ident& b) { return a.GetString() + b.GetString(); }
+inline std::string operator+(const Ident& a, const std::string& b) { return a.GetString() + b; }
+inline std::string operator+(const std::string& a, const Ident& b) { return a + b.GetString(); }
+inline std::string operator+(const Ident& a, const char* b) { return a.GetString() + b; }
+inline std::string operator+(const char* a, const Ident& b) { return a + b.GetString(); }
+inline std::string operator+(std::string&& a, const Ident& b) { return std::move(a += b.GetString()); }
+}
+
+namespace std
+{
+template <>
+struct hash<bstorm::Ident>
+{
+    size_t operator()(const bstorm::Ident& ident) const { return ident.GetHash(); }
+};
+}
@@ -0,0 +1,311 @@
+﻿#include <bstorm/image_encoder.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace bstorm
+{
+namespace
+{
+// deflateのビット列は下位ビットから詰める
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t>* out) : out_(out), bitBuf_(0), bitCnt_(0) {}
+    void Write(uint32_t bits, int cnt)
+    {
+        bitBuf_ |= bits << bitCnt_;
+        bitCnt_ += cnt;
+        while (bitCnt_ >= 8)
+        {
+            out_->push_back((uint8_t)(bitBuf_ & 0xff));
+            bitBuf_ >>= 8;
+            bitCnt_ -= 8;
+        }
+    }
+    // ハフマン符号は上位ビットから詰める
+    void WriteHuffman(uint32_t code, int len)
+    {
+        uint32_t rev = 0;
+        for (int i = 0; i < len; i++)
+        {
+            rev = (rev << 1) | ((code >> i) & 1);
+        }
+        Write(rev, len);
+    }
+    void Flush()
+    {
+        if (bitCnt_ > 0)
+        {
+            out_->push_back((uint8_t)(bitBuf_ & 0xff));
+        }
+        bitBuf_ = 0;
+        bitCnt_ = 0;
+    }
+private:
+    std::vector<uint8_t>* out_;
+    uint32_t bitBuf_;
+    int bitCnt_;
+};
+
+constexpr int MIN_MATCH = 3;
+constexpr int MAX_MATCH = 258;
+constexpr int WINDOW_SIZE = 32768;
+constexpr int HASH_BITS = 15;
+constexpr int MAX_CHAIN = 32;
+
+constexpr std::array<uint16_t, 29> LENGTH_BASES = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<uint8_t, 29> LENGTH_EXTRAS = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<uint16_t, 30> DIST_BASES = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<uint8_t, 30> DIST_EXTRAS = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// 固定ハフマン符号でリテラル/長さの記号を書く
+void WriteFixedLitLen(BitWriter& writer, int sym)
+{
+    if (sym < 144) writer.WriteHuffman(0x30 + sym, 8);
+    else if (sym < 256) writer.WriteHuffman(0x190 + (sym - 144), 9);
+    else if (sym < 280) writer.WriteHuffman(sym - 256, 7);
+    else writer.WriteHuffman(0xc0 + (sym - 280), 8);
+}
+
+void WriteMatch(BitWriter& writer, int len, int dist)
+{
+    int lenIdx = (int)LENGTH_BASES.size() - 1;
+    while (LENGTH_BASES[lenIdx] > len) lenIdx--;
+    WriteFixedLitLen(writer, 257 + lenIdx);
+    writer.Write(len - LENGTH_BASES[lenIdx], LENGTH_EXTRAS[lenIdx]);
+
+    int distIdx = (int)DIST_BASES.size() - 1;
+    while (DIST_BASES[distIdx] > dist) distIdx--;
+    writer.WriteHuffman(distIdx, 5);
+    writer.Write(dist - DIST_BASES[distIdx], DIST_EXTRAS[distIdx]);
+}
+
+uint32_t HashAt(const uint8_t* p)
+{
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & ((1 << HASH_BITS) - 1);
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size)
+{
+    uint32_t a = 1, b = 0;
+    while (size > 0)
+    {
+        // 剰余を取るまでにオーバーフローしない長さずつ処理する
+        const size_t n = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < n; i++)
+        {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += n;
+        size -= n;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+{
+    static const std::array<uint32_t, 256> table = []()
+    {
+        std::array<uint32_t, 256> t;
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void PushBE32(std::vector<uint8_t>* out, uint32_t v)
+{
+    out->push_back((uint8_t)(v >> 24));
+    out->push_back((uint8_t)(v >> 16));
+    out->push_back((uint8_t)(v >> 8));
+    out->push_back((uint8_t)v);
+}
+
+void PushLE32(std::vector<uint8_t>* out, uint32_t v)
+{
+    out->push_back((uint8_t)v);
+    out->push_back((uint8_t)(v >> 8));
+    out->push_back((uint8_t)(v >> 16));
+    out->push_back((uint8_t)(v >> 24));
+}
+
+void PushLE16(std::vector<uint8_t>* out, uint16_t v)
+{
+    out->push_back((uint8_t)v);
+    out->push_back((uint8_t)(v >> 8));
+}
+
+void WritePngChunk(std::vector<uint8_t>* out, const char* type, const std::vector<uint8_t>& data)
+{
+    PushBE32(out, (uint32_t)data.size());
+    const size_t typePos = out->size();
+    out->insert(out->end(), type, type + 4);
+    out->insert(out->end(), data.begin(), data.end());
+    PushBE32(out, Crc32(out->data() + typePos, 4 + data.size()));
+}
+}
+
+void CompressZlib(const uint8_t* data, size_t size, std::vector<uint8_t>* out)
+{
+    // CMF, FLG (32K窓, 圧縮レベル指定なし)
+    out->push_back(0x78);
+    out->push_back(0x01);
+
+    BitWriter writer(out);
+    writer.Write(1, 1); // BFINAL
+    writer.Write(1, 2); // BTYPE = 固定ハフマン
+
+    std::vector<int32_t> head(1 << HASH_BITS, -1);
+    std::vector<int32_t> prev(WINDOW_SIZE, -1);
+    auto insertHash = [&](size_t pos)
+    {
+        if (pos + MIN_MATCH > size) return;
+        const uint32_t h = HashAt(data + pos);
+        prev[pos % WINDOW_SIZE] = head[h];
+        head[h] = (int32_t)pos;
+    };
+
+    size_t pos = 0;
+    while (pos < size)
+    {
+        int bestLen = 0;
+        int bestDist = 0;
+        if (pos + MIN_MATCH <= size)
+        {
+            const size_t maxLen = std::min<size_t>(MAX_MATCH, size - pos);
+            int32_t cand = head[HashAt(data + pos)];
+            for (int chain = 0; cand >= 0 && chain < MAX_CHAIN; chain++)
+            {
+                const size_t dist = pos - cand;
+                if (dist > WINDOW_SIZE) break;
+                size_t len = 0;
+                while (len < maxLen && data[cand + len] == data[pos + len]) len++;
+                if ((int)len > bestLen)
+                {
+                    bestLen = (int)len;
+                    bestDist = (int)dist;
+                    if (len == maxLen) break;
+                }
+                const int32_t next = prev[cand % WINDOW_SIZE];
+                if (next >= cand) break; // 窓の外で上書きされた
+                cand = next;
+            }
+        }
+        if (bestLen >= MIN_MATCH)
+        {
+            WriteMatch(writer, bestLen, bestDist);
+            for (int i = 0; i < bestLen; i++) insertHash(pos + i);
+            pos += bestLen;
+        } else
+        {
+            WriteFixedLitLen(writer, data[pos]);
+            insertHash(pos);
+            pos++;
+        }
+    }
+    WriteFixedLitLen(writer, 256); // ブロック終端
+    writer.Flush();
+
+    PushBE32(out, Adler32(data, size));
+}
+
+void EncodePng(const ImageBGRA& image, std::vector<uint8_t>* out)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    out->assign(signature, signature + sizeof(signature));
+
+    std::vector<uint8_t> header;
+    PushBE32(&header, (uint32_t)image.width);
+    PushBE32(&header, (uint32_t)image.height);
+    header.push_back(8); // ビット深度
+    header.push_back(6); // RGBA
+    header.push_back(0); // 圧縮方式
+    header.push_back(0); // フィルタ方式
+    header.push_back(0); // インターレースなし
+    WritePngChunk(out, "IHDR", header);
+
+    // 各行にSubフィルタをかけてRGBAに並べ替える
+    const size_t rowSize = 1 + 4 * (size_t)image.width;
+    std::vector<uint8_t> raw(rowSize * image.height);
+    for (int y = 0; y < image.height; y++)
+    {
+        const uint8_t* src = image.pixels.data() + 4 * (size_t)image.width * y;
+        uint8_t* dst = raw.data() + rowSize * y;
+        dst[0] = 1;
+        uint8_t left[4] = { 0, 0, 0, 0 };
+        for (int x = 0; x < image.width; x++)
+        {
+            const uint8_t rgba[4] = { src[4 * x + 2], src[4 * x + 1], src[4 * x], src[4 * x + 3] };
+            for (int c = 0; c < 4; c++)
+            {
+                dst[1 + 4 * x + c] = (uint8_t)(rgba[c] - left[c]);
+                left[c] = rgba[c];
+            }
+        }
+    }
+    std::vector<uint8_t> compressed;
+    CompressZlib(raw.data(), raw.size(), &compressed);
+    WritePngChunk(out, "IDAT", compressed);
+    WritePngChunk(out, "IEND", {});
+}
+
+void EncodeBmp(const ImageBGRA& image, std::vector<uint8_t>* out)
+{
+    const uint32_t rowSize = (3 * image.width + 3) & ~3u;
+    const uint32_t dataSize = rowSize * image.height;
+    const uint32_t headerSize = 14 + 40;
+    out->clear();
+    out->reserve(headerSize + dataSize);
+
+    // BITMAPFILEHEADER
+    out->push_back('B');
+    out->push_back('M');
+    PushLE32(out, headerSize + dataSize);
+    PushLE32(out, 0);
+    PushLE32(out, headerSize);
+    // BITMAPINFOHEADER
+    PushLE32(out, 40);
+    PushLE32(out, (uint32_t)image.width);
+    PushLE32(out, (uint32_t)image.height); // 下の行から並べる
+    PushLE16(out, 1);
+    PushLE16(out, 24);
+    PushLE32(out, 0); // BI_RGB
+    PushLE32(out, dataSize);
+    PushLE32(out, 2835); // 72dpi
+    PushLE32(out, 2835);
+    PushLE32(out, 0);
+    PushLE32(out, 0);
+
+    for (int y = image.height - 1; y >= 0; y--)
+    {
+        const uint8_t* src = image.pixels.data() + 4 * (size_t)image.width * y;
+        for (int x = 0; x < image.width; x++)
+        {
+            out->push_back(src[4 * x]);
+            out->push_back(src[4 * x + 1]);
+            out->push_back(src[4 * x + 2]);
+        }
+        for (uint32_t i = 3 * image.width; i < rowSize; i++)
+        {
+            out->push_back(0);
+        }
+    }
+}
+}
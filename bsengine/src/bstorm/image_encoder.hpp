@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bstorm
+{
+// 32bitの画像
+// 画素はB, G, R, Aの順(D3DFMT_A8R8G8B8のメモリ上の配置)で, 上の行から並べる
+struct ImageBGRA
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// DirectXに依存しない画像のエンコーダ
+// 描画スレッド以外から呼んでもよい
+void EncodePng(const ImageBGRA& image, std::vector<uint8_t>* out);
+// 24bit BMP (アルファは捨てる)
+void EncodeBmp(const ImageBGRA& image, std::vector<uint8_t>* out);
+// zlib形式で圧縮する (固定ハフマン符号)
+void CompressZlib(const uint8_t* data, size_t size, std::vector<uint8_t>* out);
+}
@@ -0,0 +1,105 @@
+﻿#include <bstorm/image_save_queue.hpp>
+
+#include <bstorm/logger.hpp>
+#include <bstorm/string_util.hpp>
+
+#include <fstream>
+
+namespace bstorm
+{
+ImageSaveQueue::ImageSaveQueue(size_t capacity) :
+    capacity_(capacity),
+    isTerminated_(false)
+{
+    worker_ = std::thread([this]() { Run(); });
+}
+
+ImageSaveQueue::~ImageSaveQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isTerminated_ = true;
+    }
+    pushed_.notify_all();
+    worker_.join();
+}
+
+void ImageSaveQueue::Push(const std::wstring& path, ImageFileFormat format, ImageBGRA&& image)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        popped_.wait(lock, [this]() { return jobs_.size() < capacity_; });
+        jobs_.push_back(Job{ path, format, std::move(image) });
+        pendingCount_[path]++;
+    }
+    pushed_.notify_one();
+}
+
+bool ImageSaveQueue::IsCompleted(const std::wstring& path) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pendingCount_.count(path) == 0;
+}
+
+bool ImageSaveQueue::IsAllCompleted() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pendingCount_.empty();
+}
+
+void ImageSaveQueue::Run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pushed_.wait(lock, [this]() { return isTerminated_ || !jobs_.empty(); });
+            // 終了時も残りは書き出す
+            if (jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        popped_.notify_one();
+
+        Save(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = pendingCount_.find(job.path);
+            if (--(it->second) <= 0)
+            {
+                pendingCount_.erase(it);
+            }
+        }
+    }
+}
+
+void ImageSaveQueue::Save(const Job& job)
+{
+    std::vector<uint8_t> data;
+    if (job.format == ImageFileFormat::BMP)
+    {
+        EncodeBmp(job.image, &data);
+    } else
+    {
+        EncodePng(job.image, &data);
+    }
+
+    std::ofstream out;
+#ifdef _WIN32
+    out.open(job.path, std::ios::out | std::ios::binary | std::ios::trunc);
+#else
+    out.open(ToUTF8(job.path), std::ios::out | std::ios::binary | std::ios::trunc);
+#endif
+    if (out.good())
+    {
+        out.write((const char*)data.data(), data.size());
+        if (out.good()) return;
+    }
+    Logger::Write(std::move(
+        Log(LogLevel::LV_WARN)
+        .Msg("Failed to save image.")
+        .Param(LogParam(LogParam::Tag::TEXT, job.path))));
+}
+}
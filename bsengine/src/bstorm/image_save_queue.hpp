@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <bstorm/non_copyable.hpp>
+#include <bstorm/image_encoder.hpp>
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace bstorm
+{
+enum class ImageFileFormat
+{
+    PNG,
+    BMP
+};
+
+// 読み出し済みの画素を別スレッドでエンコードしてファイルに書き出す
+class ImageSaveQueue : private NonCopyable
+{
+public:
+    // capacity : 処理待ちの最大数, 超えるとPushが空くまで待つ
+    ImageSaveQueue(size_t capacity);
+    ~ImageSaveQueue(); // 処理待ちを全て書き出してから終了する
+    void Push(const std::wstring& path, ImageFileFormat format, ImageBGRA&& image);
+    bool IsCompleted(const std::wstring& path) const;
+    bool IsAllCompleted() const;
+private:
+    struct Job
+    {
+        std::wstring path;
+        ImageFileFormat format;
+        ImageBGRA image;
+    };
+    void Run();
+    void Save(const Job& job);
+    const size_t capacity_;
+    std::deque<Job> jobs_;
+    std::unordered_map<std::wstring, int> pendingCount_; // パス毎の書き出し中の数
+    bool isTerminated_;
+    mutable std::mutex mutex_;
+    std::condition_variable pushed_;
+    std::condition_variable popped_;
+    std::thread worker_;
+};
+}
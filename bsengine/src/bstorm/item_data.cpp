@@ -34,6 +34,11 @@ void ItemDataTable::Add(const std::shared_ptr<ItemData>& data)
 {
     if (data->texture)
     {
+        if (!data->renderTexture)
+        {
+            data->renderTexture = data->texture;
+            data->atlasRegion = AtlasRegion();
+        }
         table_.emplace(data->id, data);
     }
 }
@@ -58,10 +63,14 @@ void ItemDataTable::Reload(const std::wstring & path, const std::shared_ptr<Sour
     std::wstring uniqPath = GetCanonicalPath(path);
     auto userItemData = ParseUserItemData(uniqPath, fileLoader_);
     auto& texture = textureStore_->Load(userItemData->imagePath);
+    AtlasRegion atlasRegion;
+    auto renderTexture = textureStore_->RegisterToAtlas(texture, &atlasRegion);
     for (auto& entry : userItemData->dataMap)
     {
         auto& data = entry.second;
         data.texture = texture;
+        data.renderTexture = renderTexture;
+        data.atlasRegion = atlasRegion;
         table_.emplace(data.id, std::make_shared<ItemData>(data));
     }
     loadedPaths_.insert(uniqPath);
@@ -0,0 +1,81 @@
+﻿#include <bstorm/item_score_text.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace bstorm
+{
+void ItemScoreTextList::Add(float x, float y, PlayerScore score)
+{
+    scoreTexts_.push_back(ScoreText{ score, x, y, 0 });
+}
+
+void ItemScoreTextList::Update()
+{
+    // 時間切れのものを取り除きつつ前に詰める, 配列の領域は使い回す
+    size_t alive = 0;
+    for (size_t i = 0; i < scoreTexts_.size(); i++)
+    {
+        ScoreText scoreText = scoreTexts_[i];
+        scoreText.age++;
+        if (scoreText.age >= SCORE_TEXT_LIFE) continue;
+        scoreText.y -= SCORE_TEXT_HOVER_SPEED;
+        scoreTexts_[alive++] = scoreText;
+    }
+    scoreTexts_.resize(alive);
+}
+
+bool ItemScoreTextList::GetBounds(Rect<float>* bounds) const
+{
+    if (scoreTexts_.empty()) return false;
+    // 最大桁数の幅で見積もる
+    constexpr int maxDigitCnt = 20;
+    *bounds = Rect<float>(scoreTexts_[0].x, scoreTexts_[0].y, scoreTexts_[0].x, scoreTexts_[0].y);
+    for (const auto& scoreText : scoreTexts_)
+    {
+        bounds->left = std::min(bounds->left, scoreText.x);
+        bounds->top = std::min(bounds->top, scoreText.y);
+        bounds->right = std::max(bounds->right, scoreText.x);
+        bounds->bottom = std::max(bounds->bottom, scoreText.y);
+    }
+    bounds->right += maxDigitCnt * (SCORE_TEXT_DIGIT_WIDTH - 1) + 1;
+    bounds->bottom += SCORE_TEXT_DIGIT_HEIGHT;
+    return true;
+}
+
+void ItemScoreTextList::WriteVertices(int texWidth, int texHeight, std::vector<Vertex>* vertices) const
+{
+    vertices->clear();
+    const float v0 = 0.0f;
+    const float v1 = (float)SCORE_TEXT_DIGIT_SRC_HEIGHT / texHeight;
+    for (const auto& scoreText : scoreTexts_)
+    {
+        // 寿命に合わせて薄くなる
+        const int alpha = std::max(0xff - 8 * scoreText.age, 0);
+        const D3DCOLOR color = D3DCOLOR_ARGB(alpha, 0xff, 0xff, 0xff);
+        char digits[24];
+        const int digitCnt = snprintf(digits, sizeof(digits), "%lld", (long long)scoreText.score);
+        for (int i = 0; i < digitCnt; i++)
+        {
+            if (digits[i] < '0' || digits[i] > '9') continue;
+            const int n = digits[i] - '0';
+            const float u0 = (float)(n * SCORE_TEXT_DIGIT_SRC_WIDTH) / texWidth;
+            const float u1 = (float)((n + 1) * SCORE_TEXT_DIGIT_SRC_WIDTH) / texWidth;
+            const float l = scoreText.x + i * (SCORE_TEXT_DIGIT_WIDTH - 1);
+            const float t = scoreText.y;
+            const float r = l + SCORE_TEXT_DIGIT_WIDTH;
+            const float b = t + SCORE_TEXT_DIGIT_HEIGHT;
+            const Vertex leftTop(l, t, 0, color, u0, v0);
+            const Vertex leftBottom(l, b, 0, color, u0, v1);
+            const Vertex rightTop(r, t, 0, color, u1, v0);
+            const Vertex rightBottom(r, b, 0, color, u1, v1);
+            vertices->push_back(leftTop);
+            vertices->push_back(leftBottom);
+            vertices->push_back(rightTop);
+            vertices->push_back(rightTop);
+            vertices->push_back(leftBottom);
+            vertices->push_back(rightBottom);
+        }
+    }
+}
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <bstorm/vertex.hpp>
+#include <bstorm/rect.hpp>
+#include <bstorm/stage_common_player_params.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace bstorm
+{
+constexpr int SCORE_TEXT_LIFE = 32;
+constexpr float SCORE_TEXT_HOVER_SPEED = 1.0f;
+constexpr int SCORE_TEXT_DIGIT_WIDTH = 8;
+constexpr int SCORE_TEXT_DIGIT_HEIGHT = 14;
+constexpr int SCORE_TEXT_DIGIT_SRC_WIDTH = 36; // 数字画像の1文字の幅
+constexpr int SCORE_TEXT_DIGIT_SRC_HEIGHT = 32;
+
+// アイテム取得時の点数表示の集合
+// (点数, 位置, 経過フレーム)の組だけを持つ. 描画APIに依存しない
+class ItemScoreTextList
+{
+public:
+    void Add(float x, float y, PlayerScore score);
+    // 1フレーム進めて上に動かす, 時間切れのものは取り除く(残ったものの順序は保つ)
+    void Update();
+    size_t GetCount() const { return scoreTexts_.size(); }
+    float GetX(size_t i) const { return scoreTexts_[i].x; }
+    float GetY(size_t i) const { return scoreTexts_[i].y; }
+    int GetAge(size_t i) const { return scoreTexts_[i].age; }
+    // 全ての数字を内包する矩形, 空ならfalse
+    bool GetBounds(Rect<float>* bounds) const;
+    // 数字1文字毎の四角形を三角形リスト(6頂点)で書き込む, 並びはObjSpriteList2Dと同じ
+    // 数字画像は0から9が横に並んだもの
+    void WriteVertices(int texWidth, int texHeight, std::vector<Vertex>* vertices) const;
+private:
+    struct ScoreText
+    {
+        PlayerScore score;
+        float x;
+        float y;
+        int age;
+    };
+    std::vector<ScoreText> scoreTexts_;
+};
+}
@@ -147,6 +147,12 @@ Log & Log::AddSourcePos(const std::shared_ptr<SourcePos>& srcPos)
     return *this;
 }
 
+Log & Log::AddSourcePos(const NodePos* srcPos)
+{
+    if (srcPos) srcPosStack_.emplace_back(srcPos->line, srcPos->column, srcPos->GetFilename());
+    return *this;
+}
+
 Log & Log::Level(LogLevel level)
 {
     this->level_ = level;
@@ -61,6 +61,7 @@ public:
     Log& Level(LogLevel level);
     LogLevel Level() const { return level_; }
     Log& AddSourcePos(const std::shared_ptr<SourcePos>& srcPos);
+    Log& AddSourcePos(const NodePos* srcPos);
     const std::vector<SourcePos>& GetSourcePosStack() const { return srcPosStack_; }
     std::string ToString() const;
     Log&& move() { return std::move(*this); }
@@ -1,12 +1,12 @@
 #include <bstorm/lua_util.hpp>
 
-static int AccumChunkSize(lua_State* L, const void* data, size_t dataSize, size_t* totalSize)
+static int AccumChunkSize(lua_State*, const void*, size_t dataSize, size_t* totalSize)
 {
     *totalSize += dataSize;
     return 0;
 }
 
-static int ChunkWriter(lua_State* L, const void* data, size_t dataSize, std::string* dst)
+static int ChunkWriter(lua_State*, const void* data, size_t dataSize, std::string* dst)
 {
     dst->append((const char*)data, dataSize);
     return 0;
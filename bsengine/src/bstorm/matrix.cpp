@@ -0,0 +1,169 @@
+﻿#include <bstorm/matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace bstorm
+{
+static constexpr float PI = 3.14159265358979323846f;
+
+static float ToRadian(float deg)
+{
+    return deg * (PI / 180.0f);
+}
+
+Matrix4 IdentityMatrix4()
+{
+    Matrix4 mat = {};
+    mat.m[0][0] = mat.m[1][1] = mat.m[2][2] = mat.m[3][3] = 1.0f;
+    return mat;
+}
+
+Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+    Matrix4 mat;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            mat.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+        }
+    }
+    return mat;
+}
+
+bool InverseMatrix4(const Matrix4& mat, Matrix4* inv)
+{
+    // 余因子展開
+    const float* a = &mat.m[0][0];
+    float r[16];
+    r[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    r[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    r[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    r[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    r[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    r[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    r[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    r[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    r[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    r[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    r[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    r[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    r[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    r[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    r[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    r[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    const float det = a[0] * r[0] + a[1] * r[4] + a[2] * r[8] + a[3] * r[12];
+    if (det == 0.0f) return false;
+
+    const float invDet = 1.0f / det;
+    for (int i = 0; i < 16; i++)
+    {
+        inv->m[i / 4][i % 4] = r[i] * invDet;
+    }
+    return true;
+}
+
+Matrix4 ScaleRotTransMatrix4(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz)
+{
+    // 回転 (Z軸 -> X軸 -> Y軸)
+    const float cosP = std::cos(ToRadian(rx)), sinP = std::sin(ToRadian(rx));
+    const float cosY = std::cos(ToRadian(ry)), sinY = std::sin(ToRadian(ry));
+    const float cosR = std::cos(ToRadian(rz)), sinR = std::sin(ToRadian(rz));
+
+    Matrix4 mat;
+    mat.m[0][0] = cosR * cosY + sinR * sinP * sinY;
+    mat.m[0][1] = sinR * cosP;
+    mat.m[0][2] = sinR * sinP * cosY - cosR * sinY;
+    mat.m[1][0] = cosR * sinP * sinY - sinR * cosY;
+    mat.m[1][1] = cosR * cosP;
+    mat.m[1][2] = sinR * sinY + cosR * sinP * cosY;
+    mat.m[2][0] = cosP * sinY;
+    mat.m[2][1] = -sinP;
+    mat.m[2][2] = cosP * cosY;
+
+    // 拡大縮小
+    for (int j = 0; j < 3; j++)
+    {
+        mat.m[0][j] *= sx;
+        mat.m[1][j] *= sy;
+        mat.m[2][j] *= sz;
+    }
+    mat.m[0][3] = mat.m[1][3] = mat.m[2][3] = 0.0f;
+
+    // 移動
+    mat.m[3][0] = x;
+    mat.m[3][1] = y;
+    mat.m[3][2] = z;
+    mat.m[3][3] = 1.0f;
+    return mat;
+}
+
+Matrix4 TransMatrix4(float x, float y, float z)
+{
+    Matrix4 mat = IdentityMatrix4();
+    mat.m[3][0] = x;
+    mat.m[3][1] = y;
+    mat.m[3][2] = z;
+    return mat;
+}
+
+Matrix4 Camera2DViewMatrix4(float focusX, float focusY, float angleZ, float ratioX, float ratioY)
+{
+    // 視点(focusX, focusY, 1)から-z方向を見る, 上方向は(0, -1, 0)
+    // その後Z軸回転して拡大
+    const float c = std::cos(ToRadian(-angleZ));
+    const float s = std::sin(ToRadian(-angleZ));
+    Matrix4 mat = {};
+    mat.m[0][0] = c * ratioX;
+    mat.m[0][1] = s * ratioX;
+    mat.m[1][0] = s * ratioY;
+    mat.m[1][1] = -c * ratioY;
+    mat.m[2][2] = -1.0f;
+    mat.m[3][0] = -focusX * c * ratioX - focusY * s * ratioY;
+    mat.m[3][1] = -focusX * s * ratioX + focusY * c * ratioY;
+    mat.m[3][2] = 1.0f;
+    mat.m[3][3] = 1.0f;
+    return mat;
+}
+
+Matrix4 Camera2DProjMatrix4(float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY)
+{
+    // 移動してから拡大
+    const float tx = -screenWidth / 2.0f + cameraScreenX;
+    const float ty = screenHeight / 2.0f - cameraScreenY;
+    const float sx = 2.0f / screenWidth;
+    const float sy = 2.0f / screenHeight;
+    Matrix4 mat = IdentityMatrix4();
+    mat.m[0][0] = sx;
+    mat.m[1][1] = sy;
+    mat.m[3][0] = sx * tx;
+    mat.m[3][1] = sy * ty;
+    return mat;
+}
+
+ScaleRotTransMatrixCache::ScaleRotTransMatrixCache() :
+    params_{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+    isValid_(false),
+    mat_(IdentityMatrix4())
+{
+}
+
+const Matrix4& ScaleRotTransMatrixCache::Get(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz)
+{
+    const float params[9] = { x, y, z, rx, ry, rz, sx, sy, sz };
+    bool isChanged = !isValid_;
+    for (int i = 0; i < 9 && !isChanged; i++)
+    {
+        isChanged = params_[i] != params[i];
+    }
+    if (isChanged)
+    {
+        mat_ = ScaleRotTransMatrix4(x, y, z, rx, ry, rz, sx, sy, sz);
+        std::copy(params, params + 9, params_);
+        isValid_ = true;
+    }
+    return mat_;
+}
+}
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+namespace bstorm
+{
+// 4x4行列
+// D3DXMATRIXと同じ配置(行ベクトルに右から掛ける, 行優先)で, DirectXに依存しない
+struct Matrix4
+{
+    float m[4][4];
+};
+
+Matrix4 IdentityMatrix4();
+Matrix4 operator*(const Matrix4& a, const Matrix4& b);
+// 逆行列. 逆行列が存在しなければfalseを返し, invは変更しない
+bool InverseMatrix4(const Matrix4& mat, Matrix4* inv);
+// 拡大、回転、移動の順に掛けた行列. 角度は度数法
+// 回転はD3DXMatrixRotationYawPitchRoll(ry, rx, rz)と同じ
+Matrix4 ScaleRotTransMatrix4(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz);
+// 移動行列
+Matrix4 TransMatrix4(float x, float y, float z);
+// 2Dカメラのビュー行列
+// focusをカメラ中心に持ってきてから拡大してZ軸回転する
+Matrix4 Camera2DViewMatrix4(float focusX, float focusY, float angleZ, float ratioX, float ratioY);
+// 2Dカメラの射影行列, カメラ中心をスクリーン上の(cameraScreenX, cameraScreenY)に写す
+Matrix4 Camera2DProjMatrix4(float screenWidth, float screenHeight, float cameraScreenX, float cameraScreenY);
+
+// ScaleRotTransMatrix4の結果を引数と一緒に保持し, 引数が変わった時だけ計算し直す
+// 描画時に位置や角度を補正するオブジェクトが毎フレーム行列を作らないようにする
+class ScaleRotTransMatrixCache
+{
+public:
+    ScaleRotTransMatrixCache();
+    const Matrix4& Get(float x, float y, float z, float rx, float ry, float rz, float sx, float sy, float sz);
+private:
+    float params_[9];
+    bool isValid_;
+    Matrix4 mat_;
+};
+}
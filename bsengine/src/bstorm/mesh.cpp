@@ -1,5 +1,6 @@
 #include <bstorm/mesh.hpp>
 
+#include <bstorm/mesh_cache.hpp>
 #include <bstorm/file_util.hpp>
 #include <bstorm/logger.hpp>
 #include <bstorm/texture.hpp>
@@ -7,119 +8,56 @@
 #include <bstorm/file_loader.hpp>
 #include <bstorm/parser.hpp>
 
-#include <array>
-
 namespace bstorm
 {
-static inline D3DXVECTOR3 ToD3DXVECTOR3(const MqoVec3& vec)
-{
-    return D3DXVECTOR3(vec.x, vec.y, -vec.z); // En獶nɕϊ̂zW𔽓]
-}
-
-static D3DXVECTOR3 CalcFaceNormal(const D3DXVECTOR3& a, const D3DXVECTOR3& b, const D3DXVECTOR3& c)
-{
-    D3DXVECTOR3 n;
-    D3DXVECTOR3 ab = b - a;
-    D3DXVECTOR3 ac = c - a;
-    D3DXVec3Cross(&n, &ab, &ac);
-    if (D3DXVec3Length(&n) != 0.0f)
-    {
-        D3DXVec3Normalize(&n, &n);
-    }
-    return n;
-}
-
-static void CreateMeshMaterials(const Mqo & mqo, const std::shared_ptr<TextureStore>& textureStore, std::vector<MeshMaterial>& materials)
+static void CreateMeshMaterials(const std::wstring& meshDir, std::vector<MeshMaterialData>&& materialData, const std::shared_ptr<TextureStore>& textureStore, std::vector<MeshMaterial>& materials)
 {
-    auto mqoDir = GetParentPath(mqo.path);
-
     // eNX`v[h
-    for (const auto& mqoMat : mqo.materials)
+    for (const auto& mat : materialData)
     {
-        textureStore->LoadInThread(ConcatPath(mqoDir, mqoMat.tex));
+        textureStore->LoadInThread(ConcatPath(meshDir, mat.texturePath));
     }
 
-    materials.reserve(mqo.materials.size());
+    materials.reserve(materialData.size());
 
-    // ގRs[
-    for (const auto& mqoMat : mqo.materials)
+    for (auto& mat : materialData)
     {
-        auto& texture = textureStore->Load(ConcatPath(mqoDir, mqoMat.tex));
-        materials.emplace_back(mqoMat.col.r, mqoMat.col.g, mqoMat.col.b, mqoMat.col.a, mqoMat.dif, mqoMat.amb, mqoMat.emi, texture);
+        auto& texture = textureStore->Load(ConcatPath(meshDir, mat.texturePath));
+        materials.emplace_back(mat.r, mat.g, mat.b, mat.a, mat.dif, mat.amb, mat.emi, texture);
+        materials.back().vertices = std::move(mat.vertices);
     }
+}
 
-    // ގʂɒ_z𐶐
-    for (const auto& obj : mqo.objects)
+Mesh::Mesh(const std::wstring& path, const std::shared_ptr<TextureStore>& textureStore, const std::shared_ptr<FileLoader>& fileLoader) :
+    path_(path)
+{
+    // ϊς݂̃LbV΃p[XȂ
+    std::vector<MeshMaterialData> materialData;
+    MeshSourceInfo sourceInfo;
+    const bool hasSourceInfo = GetMeshSourceInfo(path, &sourceInfo);
+    const std::wstring cachePath = GetMeshCachePath(path);
+    if (!hasSourceInfo || !LoadMeshCache(cachePath, sourceInfo, &materialData))
     {
-        // e_̖@vZ
-        std::vector<D3DXVECTOR3> vertexNormals(obj.vertices.size(), D3DXVECTOR3(0.0f, 0.0f, 0.0f));
-        // ʂ̖@̓LbVĂ
-        std::vector<std::vector<D3DXVECTOR3>> faceNormals(obj.faces.size());
-        for (int faceIdx = 0; faceIdx < obj.faces.size(); faceIdx++)
-        {
-            const auto& face = obj.faces[faceIdx];
-            for (int i = 0; i < face.vertexIndices.size() - 2; i++)
-            {
-                int vi2 = face.vertexIndices[0];
-                int vi1 = face.vertexIndices[i + 1];
-                int vi0 = face.vertexIndices[i + 2];
-                const D3DXVECTOR3 v0 = ToD3DXVECTOR3(obj.vertices[vi0]);
-                const D3DXVECTOR3 v1 = ToD3DXVECTOR3(obj.vertices[vi1]);
-                const D3DXVECTOR3 v2 = ToD3DXVECTOR3(obj.vertices[vi2]);
-                const auto& faceNormal = CalcFaceNormal(v0, v1, v2);
-                vertexNormals[vi0] += faceNormal;
-                vertexNormals[vi1] += faceNormal;
-                vertexNormals[vi2] += faceNormal;
-                faceNormals[faceIdx].push_back(faceNormal);
-            }
-        }
-
-        // @̐K
-        for (auto& normal : vertexNormals)
+        auto mqo = ParseMqo(path, fileLoader);
+        if (!mqo)
         {
-            // ʂɎgĂȂ_͖
-            if (normal.x == 0.0f && normal.y == 0.0f && normal.z == 0.0f) continue;
-            D3DXVec3Normalize(&normal, &normal);
+            throw Log(LogLevel::LV_ERROR)
+                .Msg("Failed to load mesh.")
+                .Param(LogParam(LogParam::Tag::TEXT, path));
         }
-
-        // WA
-        const float facet = D3DXToRadian(obj.facet);
-
-        // _
-        for (int faceIdx = 0; faceIdx < obj.faces.size(); faceIdx++)
+        CreateMeshMaterialData(*mqo, materialData);
+        if (hasSourceInfo)
         {
-            const auto& face = obj.faces[faceIdx];
-            auto& meshMat = materials[face.materialIndex];
-            for (int i = 0; i < face.vertexIndices.size() - 2; i++)
+            try
+            {
+                SaveMeshCache(cachePath, sourceInfo, materialData);
+            } catch (Log& log)
             {
-                const auto& faceNormal = faceNormals[faceIdx][i];
-                for (auto j : std::array<int, 3>{ i + 2, i + 1, 0 })
-                {
-                    int vIdx = face.vertexIndices[j];
-                    // psfacetȉȂʖ@𒸓_̖@ɐݒ
-                    float s = acos(D3DXVec3Dot(&faceNormal, &vertexNormals[vIdx]));
-                    const auto& pos = obj.vertices[vIdx];
-                    const auto& nor = facet < s ? vertexNormals[vIdx] : faceNormal;
-                    const auto& uv = j < face.uvs.size() ? face.uvs[j] : MqoVec2{ 0.0f, 0.0f };
-                    meshMat.vertices.emplace_back(pos.x, pos.y, -pos.z, nor.x, nor.y, nor.z, uv.x, uv.y);
-                }
+                Logger::Write(std::move(log));
             }
         }
     }
-}
-
-Mesh::Mesh(const std::wstring& path, const std::shared_ptr<TextureStore>& textureStore, const std::shared_ptr<FileLoader>& fileLoader) :
-    path_(path)
-{
-    if (auto mqo = ParseMqo(path, fileLoader))
-    {
-        CreateMeshMaterials(*mqo, textureStore, materials);
-    } else
-    {
-        throw Log(LogLevel::LV_ERROR)
-            .Msg("Failed to load mesh.")
-            .Param(LogParam(LogParam::Tag::TEXT, path));
-    }
+    CreateMeshMaterials(GetParentPath(path), std::move(materialData), textureStore, materials);
 }
 
 Mesh::~Mesh()
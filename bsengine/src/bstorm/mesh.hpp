@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bstorm/cache_store.hpp>
+#include <bstorm/mesh_vertex.hpp>
 
 #include <vector>
 #include <memory>
@@ -9,16 +10,6 @@
 
 namespace bstorm
 {
-struct MeshVertex
-{
-    MeshVertex() : x(0), y(0), z(0), nx(0), ny(0), nz(0), u(0), v(0) {}
-    MeshVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v) : x(x), y(y), z(z), nx(nx), ny(ny), nz(nz), u(u), v(v) {}
-    float x, y, z;
-    float nx, ny, nz;
-    float u, v;
-    static constexpr DWORD Format = D3DFVF_XYZ | D3DFVF_NORMAL | D3DFVF_TEX1;
-};
-
 class Texture;
 struct MeshMaterial
 {
@@ -0,0 +1,245 @@
+﻿#include <bstorm/mesh_cache.hpp>
+
+#include <bstorm/cache_file.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/string_util.hpp>
+#include <bstorm/path_const.hpp>
+#include <bstorm/logger.hpp>
+#include <bstorm/mqo.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace bstorm
+{
+static constexpr char MESH_CACHE_MAGIC[8] = { 'B', 'S', 'M', 'E', 'S', 'H', '\0', '\0' };
+// 材質1つ分の最小の大きさ (色と係数, テクスチャパスの長さ, 頂点数)
+static constexpr size_t MIN_MATERIAL_DATA_SIZE = sizeof(float) * 7 + sizeof(uint32_t) * 2;
+
+// 右手系から左手系に変換するのでz座標を反転
+static inline MqoVec3 ToLeftHanded(const MqoVec3& vec)
+{
+    return MqoVec3{ vec.x, vec.y, -vec.z };
+}
+
+static inline MqoVec3 Sub(const MqoVec3& a, const MqoVec3& b)
+{
+    return MqoVec3{ a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+static inline float Dot(const MqoVec3& a, const MqoVec3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline float Length(const MqoVec3& v)
+{
+    return std::sqrt(Dot(v, v));
+}
+
+// D3DXVec3Normalizeと同じく長さ0ならそのまま
+static inline MqoVec3 Normalize(const MqoVec3& v)
+{
+    const float len = Length(v);
+    if (len == 0.0f) return v;
+    return MqoVec3{ v.x / len, v.y / len, v.z / len };
+}
+
+static MqoVec3 CalcFaceNormal(const MqoVec3& a, const MqoVec3& b, const MqoVec3& c)
+{
+    const MqoVec3 ab = Sub(b, a);
+    const MqoVec3 ac = Sub(c, a);
+    const MqoVec3 n{ ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+    return Normalize(n);
+}
+
+void CreateMeshMaterialData(const Mqo& mqo, std::vector<MeshMaterialData>& materials)
+{
+    materials.reserve(mqo.materials.size());
+
+    // 材質情報をコピー
+    for (const auto& mqoMat : mqo.materials)
+    {
+        MeshMaterialData mat;
+        mat.r = mqoMat.col.r;
+        mat.g = mqoMat.col.g;
+        mat.b = mqoMat.col.b;
+        mat.a = mqoMat.col.a;
+        mat.dif = mqoMat.dif;
+        mat.amb = mqoMat.amb;
+        mat.emi = mqoMat.emi;
+        mat.texturePath = mqoMat.tex;
+        materials.push_back(std::move(mat));
+    }
+
+    // 材質別に頂点配列を生成
+    for (const auto& obj : mqo.objects)
+    {
+        // 各頂点の法線を計算
+        std::vector<MqoVec3> vertexNormals(obj.vertices.size(), MqoVec3{ 0.0f, 0.0f, 0.0f });
+        // 面の法線はキャッシュしておく
+        std::vector<std::vector<MqoVec3>> faceNormals(obj.faces.size());
+        for (size_t faceIdx = 0; faceIdx < obj.faces.size(); faceIdx++)
+        {
+            const auto& face = obj.faces[faceIdx];
+            for (size_t i = 0; i + 2 < face.vertexIndices.size(); i++)
+            {
+                int vi2 = face.vertexIndices[0];
+                int vi1 = face.vertexIndices[i + 1];
+                int vi0 = face.vertexIndices[i + 2];
+                const MqoVec3 faceNormal = CalcFaceNormal(ToLeftHanded(obj.vertices[vi0]), ToLeftHanded(obj.vertices[vi1]), ToLeftHanded(obj.vertices[vi2]));
+                for (int vi : { vi0, vi1, vi2 })
+                {
+                    vertexNormals[vi].x += faceNormal.x;
+                    vertexNormals[vi].y += faceNormal.y;
+                    vertexNormals[vi].z += faceNormal.z;
+                }
+                faceNormals[faceIdx].push_back(faceNormal);
+            }
+        }
+
+        // 法線の正規化, 面に使われてない頂点は0のまま
+        for (auto& normal : vertexNormals)
+        {
+            normal = Normalize(normal);
+        }
+
+        // ラジアンに
+        const float facet = obj.facet * (3.141592654f / 180.0f);
+
+        // 頂点生成
+        for (size_t faceIdx = 0; faceIdx < obj.faces.size(); faceIdx++)
+        {
+            const auto& face = obj.faces[faceIdx];
+            auto& meshMat = materials[face.materialIndex];
+            for (size_t i = 0; i + 2 < face.vertexIndices.size(); i++)
+            {
+                const auto& faceNormal = faceNormals[faceIdx][i];
+                for (auto j : std::array<size_t, 3>{ i + 2, i + 1, 0 })
+                {
+                    int vIdx = face.vertexIndices[j];
+                    // 角sがfacet以下なら面法線を頂点の法線に設定
+                    float s = std::acos(Dot(faceNormal, vertexNormals[vIdx]));
+                    const auto& pos = obj.vertices[vIdx];
+                    const auto& nor = facet < s ? vertexNormals[vIdx] : faceNormal;
+                    const auto& uv = j < face.uvs.size() ? face.uvs[j] : MqoVec2{ 0.0f, 0.0f };
+                    meshMat.vertices.emplace_back(pos.x, pos.y, -pos.z, nor.x, nor.y, nor.z, uv.x, uv.y);
+                }
+            }
+        }
+    }
+}
+
+bool GetMeshSourceInfo(const std::wstring& path, MeshSourceInfo* info)
+{
+    if (!GetFileStatus(path, &info->lastUpdateTime, &info->size)) return false;
+    info->path = path;
+    return true;
+}
+
+std::wstring GetMeshCachePath(const std::wstring& sourcePath)
+{
+    const std::string path = ToUTF8(sourcePath);
+    return ConcatPath(MESH_CACHE_DIR, GetHashFileName(HashFNV1a64(path.data(), path.size())) + L".bsmesh");
+}
+
+bool LoadMeshCache(const std::wstring& cachePath, const MeshSourceInfo& source, std::vector<MeshMaterialData>* materials)
+{
+    std::vector<char> buf;
+    if (!ReadCacheFile(cachePath, &buf)) return false;
+
+    CacheFileReader reader(buf);
+    char magic[sizeof(MESH_CACHE_MAGIC)];
+    uint32_t version = 0;
+    uint32_t vertexSize = 0;
+    uint64_t lastUpdateTime = 0;
+    uint64_t size = 0;
+    std::string path;
+    if (!reader.Read(magic, sizeof(magic)) || std::memcmp(magic, MESH_CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (!reader.Read(&version) || version != MESH_CACHE_VERSION) return false;
+    if (!reader.Read(&vertexSize) || vertexSize != sizeof(MeshVertex)) return false;
+    if (!reader.Read(&lastUpdateTime) || lastUpdateTime != source.lastUpdateTime) return false;
+    if (!reader.Read(&size) || size != source.size) return false;
+    // ハッシュの衝突に備えてパスも比べる
+    if (!reader.ReadString(&path) || path != ToUTF8(source.path)) return false;
+
+    uint32_t materialCount = 0;
+    if (!reader.Read(&materialCount)) return false;
+    // 壊れた件数で巨大な領域を確保しないように, 残りの大きさに収まるか確かめる
+    if (materialCount > reader.GetRestSize() / MIN_MATERIAL_DATA_SIZE) return false;
+    std::vector<MeshMaterialData> result(materialCount);
+    for (auto& mat : result)
+    {
+        std::string texturePath;
+        uint32_t vertexCount = 0;
+        if (!reader.Read(&mat.r) || !reader.Read(&mat.g) || !reader.Read(&mat.b) || !reader.Read(&mat.a)) return false;
+        if (!reader.Read(&mat.dif) || !reader.Read(&mat.amb) || !reader.Read(&mat.emi)) return false;
+        if (!reader.ReadString(&texturePath)) return false;
+        if (!reader.Read(&vertexCount)) return false;
+        if (vertexCount > reader.GetRestSize() / sizeof(MeshVertex)) return false;
+        mat.texturePath = ToUnicode(texturePath);
+        mat.vertices.resize(vertexCount);
+        if (!reader.Read(mat.vertices.data(), vertexCount * sizeof(MeshVertex))) return false;
+    }
+    if (!reader.IsEnd()) return false;
+    *materials = std::move(result);
+    return true;
+}
+
+void SaveMeshCache(const std::wstring& cachePath, const MeshSourceInfo& source, const std::vector<MeshMaterialData>& materials) noexcept(false)
+{
+    // 書き込み途中のファイルを読まないように一時ファイルに書いてから置き換える
+    const std::wstring tmpPath = cachePath + L".tmp";
+    MakeDirectoryP(GetParentPath(cachePath));
+    {
+        std::ofstream out;
+#ifdef _WIN32
+        out.open(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+#else
+        out.open(ToUTF8(tmpPath), std::ios::out | std::ios::binary | std::ios::trunc);
+#endif
+        if (!out.good())
+        {
+            throw Log(LogLevel::LV_WARN)
+                .Msg("Failed to save mesh cache.")
+                .Param(LogParam(LogParam::Tag::TEXT, cachePath));
+        }
+        out.write(MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+        WriteCacheValue(out, MESH_CACHE_VERSION);
+        WriteCacheValue(out, (uint32_t)sizeof(MeshVertex));
+        WriteCacheValue(out, source.lastUpdateTime);
+        WriteCacheValue(out, source.size);
+        WriteCacheString(out, ToUTF8(source.path));
+        WriteCacheValue(out, (uint32_t)materials.size());
+        for (const auto& mat : materials)
+        {
+            WriteCacheValue(out, mat.r);
+            WriteCacheValue(out, mat.g);
+            WriteCacheValue(out, mat.b);
+            WriteCacheValue(out, mat.a);
+            WriteCacheValue(out, mat.dif);
+            WriteCacheValue(out, mat.amb);
+            WriteCacheValue(out, mat.emi);
+            WriteCacheString(out, ToUTF8(mat.texturePath));
+            WriteCacheValue(out, (uint32_t)mat.vertices.size());
+            out.write((const char*)mat.vertices.data(), mat.vertices.size() * sizeof(MeshVertex));
+        }
+        if (!out.good())
+        {
+            out.close();
+            RemoveFile(tmpPath);
+            throw Log(LogLevel::LV_WARN)
+                .Msg("Failed to save mesh cache.")
+                .Param(LogParam(LogParam::Tag::TEXT, cachePath));
+        }
+    }
+    if (!ReplaceCacheFile(tmpPath, cachePath))
+    {
+        throw Log(LogLevel::LV_WARN)
+            .Msg("Failed to save mesh cache.")
+            .Param(LogParam(LogParam::Tag::TEXT, cachePath));
+    }
+}
+}
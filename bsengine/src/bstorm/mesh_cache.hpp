@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <bstorm/mesh_vertex.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bstorm
+{
+struct Mqo;
+
+// テクスチャを読み込む前のメッシュの材質
+struct MeshMaterialData
+{
+    float r, g, b, a;
+    float dif;
+    float amb;
+    float emi;
+    std::wstring texturePath; // メッシュファイルのディレクトリからの相対パス
+    std::vector<MeshVertex> vertices; // 三角形分割, 法線計算済み
+};
+
+// mqoの面を三角形に分割し, 法線を計算して材質別の頂点配列にする
+// Direct3Dに依存しないので単体テストできる
+void CreateMeshMaterialData(const Mqo& mqo, std::vector<MeshMaterialData>& materials);
+
+// キャッシュが元ファイルと一致するかの判定に使う
+struct MeshSourceInfo
+{
+    std::wstring path;
+    uint64_t lastUpdateTime;
+    uint64_t size;
+};
+
+// 取得できなければfalse
+bool GetMeshSourceInfo(const std::wstring& path, MeshSourceInfo* info);
+
+// 変換済みのメッシュを保存するバイナリ形式
+// 形式やメッシュの生成処理を変えたらバージョンを上げること
+constexpr uint32_t MESH_CACHE_VERSION = 2;
+std::wstring GetMeshCachePath(const std::wstring& sourcePath);
+// キャッシュが無い, 壊れている, バージョンや元ファイルが一致しない場合はfalse
+bool LoadMeshCache(const std::wstring& cachePath, const MeshSourceInfo& source, std::vector<MeshMaterialData>* materials);
+void SaveMeshCache(const std::wstring& cachePath, const MeshSourceInfo& source, const std::vector<MeshMaterialData>& materials) noexcept(false);
+}
@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <cstdint>
 
+#include <bstorm/ident.hpp>
+
 namespace bstorm
 {
 struct NodeNum;
@@ -149,13 +151,13 @@ public:
     virtual void Traverse(NodeHeader&) = 0;
 };
 
-struct SourcePos;
+struct NodePos;
 struct Node
 {
-    Node() : noSubEffect(false) {}
+    Node() : srcPos(nullptr), noSubEffect(false) {}
     virtual ~Node() {};
     virtual void Traverse(NodeTraverser& Traverser) = 0;
-    std::shared_ptr<SourcePos> srcPos;
+    const NodePos* srcPos; // ノードと同じアリーナに置く
     bool noSubEffect;
 };
 
@@ -391,16 +393,16 @@ struct NodeCat : public NodeBinOp
 
 struct NodeNoParenCallExp : public NodeExp
 {
-    NodeNoParenCallExp(const std::string& name) : NodeExp(), name(name) {}
+    NodeNoParenCallExp(const Ident& name) : NodeExp(), name(name) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string name;
+    Ident name;
 };
 
 struct NodeCallExp : public NodeExp
 {
-    NodeCallExp(const std::string& name, std::vector<std::shared_ptr<NodeExp>>&& as) :NodeExp(), name(name), args(std::move(as)) {}
+    NodeCallExp(const Ident& name, std::vector<std::shared_ptr<NodeExp>>&& as) :NodeExp(), name(name), args(std::move(as)) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string name;
+    Ident name;
     std::vector<std::shared_ptr<NodeExp>> args;
 };
 
@@ -442,9 +444,9 @@ struct NodeNop : public NodeStmt
 
 struct NodeLeftVal : public Node
 {
-    NodeLeftVal(const std::string& name, std::vector<std::shared_ptr<NodeExp>>&& is) : Node(), name(name), indices(std::move(is)) {}
+    NodeLeftVal(const Ident& name, std::vector<std::shared_ptr<NodeExp>>&& is) : Node(), name(name), indices(std::move(is)) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string name;
+    Ident name;
     std::vector<std::shared_ptr<NodeExp>> indices;
 };
 
@@ -494,9 +496,9 @@ struct NodeCatAssign : public NodeAssign
 
 struct NodeCallStmt : public NodeStmt
 {
-    NodeCallStmt(const std::string& name, std::vector<std::shared_ptr<NodeExp>>&& as) : NodeStmt(), name(name), args(std::move(as)) {}
+    NodeCallStmt(const Ident& name, std::vector<std::shared_ptr<NodeExp>>&& as) : NodeStmt(), name(name), args(std::move(as)) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string name;
+    Ident name;
     std::vector<std::shared_ptr<NodeExp>> args;
 };
 
@@ -540,9 +542,9 @@ struct NodePred : public NodeSucc
 
 struct NodeDef : public Node
 {
-    NodeDef(const std::string& name) : Node(), name(name), convertedName(name), unreachable(true) {}
+    NodeDef(const Ident& name) : Node(), name(name), convertedName(name), unreachable(true) {}
     virtual bool IsVariable() const = 0;
-    std::string name;
+    Ident name;
     std::string convertedName; // 名前変換用
     bool unreachable; // 到達不可能フラグ
     ExpType retType;
@@ -550,7 +552,7 @@ struct NodeDef : public Node
 
 struct NodeVarDecl : public NodeDef
 {
-    NodeVarDecl(const std::string& name) :
+    NodeVarDecl(const Ident& name) :
         NodeDef(name),
         assignCnt(0u),
         refCnt(0u)
@@ -559,22 +561,21 @@ struct NodeVarDecl : public NodeDef
     }
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
     virtual bool IsVariable() const override { return true; }
-    std::string name;
     uint32_t assignCnt;
     uint32_t refCnt;
 };
 
 struct NodeVarInit : public NodeStmt
 {
-    NodeVarInit(const std::string& name, const std::shared_ptr<NodeExp>& r) : NodeStmt(), name(name), rhs(r) {}
+    NodeVarInit(const Ident& name, const std::shared_ptr<NodeExp>& r) : NodeStmt(), name(name), rhs(r) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string name;
+    Ident name;
     std::shared_ptr<NodeExp> rhs;
 };
 
 struct NodeProcParam : public NodeDef
 {
-    NodeProcParam(const std::string& name) : NodeDef(name)
+    NodeProcParam(const Ident& name) : NodeDef(name)
     {
         unreachable = false;
         noSubEffect = true;
@@ -585,7 +586,7 @@ struct NodeProcParam : public NodeDef
 
 struct NodeLoopParam : public NodeDef
 {
-    NodeLoopParam(const std::string& name) : NodeDef(name)
+    NodeLoopParam(const Ident& name) : NodeDef(name)
     {
         noSubEffect = true;
     }
@@ -595,7 +596,7 @@ struct NodeLoopParam : public NodeDef
 
 struct NodeResult : public NodeDef
 {
-    NodeResult() : NodeDef("result")
+    NodeResult() : NodeDef(Ident("result"))
     {
         noSubEffect = true;
     }
@@ -603,7 +604,7 @@ struct NodeResult : public NodeDef
     virtual bool IsVariable() const override { return true; }
 };
 
-using DefNameTable = std::unordered_map<std::string, std::shared_ptr<NodeDef>>;
+using DefNameTable = std::unordered_map<Ident, std::shared_ptr<NodeDef>>;
 struct NodeBlock : public Node
 {
     NodeBlock(const std::shared_ptr<DefNameTable>& nameTable, std::vector <std::shared_ptr<NodeStmt>>&& ss) : Node(), nameTable(nameTable), stmts(std::move(ss)) {}
@@ -614,7 +615,7 @@ struct NodeBlock : public Node
 
 struct NodeSubDef : public NodeDef
 {
-    NodeSubDef(const std::string& name, const std::shared_ptr<NodeBlock>& blk) : NodeDef(name), block(blk) {}
+    NodeSubDef(const Ident& name, const std::shared_ptr<NodeBlock>& blk) : NodeDef(name), block(blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
     virtual bool IsVariable() const override { return false; }
     std::shared_ptr<NodeBlock> block;
@@ -622,43 +623,48 @@ struct NodeSubDef : public NodeDef
 
 struct NodeBuiltInSubDef : public NodeSubDef
 {
-    NodeBuiltInSubDef(const std::string& name, const std::shared_ptr<NodeBlock>& blk) : NodeSubDef(name, blk) {}
+    NodeBuiltInSubDef(const Ident& name, const std::shared_ptr<NodeBlock>& blk) : NodeSubDef(name, blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
 };
 
 struct NodeFuncDef : public NodeDef
 {
-    NodeFuncDef(const std::string& name, std::vector<std::string>&& ps, const std::shared_ptr<NodeBlock>& blk) : NodeDef(name), params(std::move(ps)), block(blk) {}
+    NodeFuncDef(const Ident& name, std::vector<Ident>&& ps, const std::shared_ptr<NodeBlock>& blk) : NodeDef(name), params(std::move(ps)), block(blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
     virtual bool IsVariable() const override { return false; }
-    std::vector<std::string> params;
+    std::vector<Ident> params;
     std::shared_ptr<NodeBlock> block;
 };
 
 struct NodeTaskDef : public NodeDef
 {
-    NodeTaskDef(const std::string& name, std::vector<std::string>&& ps, std::shared_ptr<NodeBlock>& blk) : NodeDef(name), params(std::move(ps)), block(blk) {}
+    NodeTaskDef(const Ident& name, std::vector<Ident>&& ps, const std::shared_ptr<NodeBlock>& blk) : NodeDef(name), params(std::move(ps)), block(blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
     virtual bool IsVariable() const override { return false; }
-    std::vector<std::string> params;
+    std::vector<Ident> params;
     std::shared_ptr<NodeBlock> block;
 };
 
 struct NodeBuiltInFunc : public NodeDef
 {
-    NodeBuiltInFunc(const std::string& name, uint8_t paramc) : NodeDef(name), paramCnt(paramc) {}
+    NodeBuiltInFunc(const Ident& name, uint8_t paramc) : NodeDef(name), paramCnt(paramc), strParamMask(0u), isRuntime(false) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
     virtual bool IsVariable() const override { return false; }
+    bool IsStrParam(int idx) const { return idx < 32 && (strParamMask & (1u << idx)); }
     uint8_t paramCnt;
+    // 文字列として読むだけの引数(DnhValue::ToString, ToStringU8)のビット
+    // 文字列型の式ならLuaの文字列のまま渡せる
+    uint32_t strParamMask;
+    bool isRuntime; // ランタイム(Lua)で実装されていてスクリプトに再入しない
 };
 
 struct NodeConst : public NodeDef
 {
-    NodeConst(const std::string& name, const std::string& c, ExpType expType) : NodeDef(name), value(c)
+    NodeConst(const Ident& name, const std::string& c, ExpType expType) : NodeDef(name), value(c)
     {
         retType = expType;
     }
-    NodeConst(const std::string& name, int c) : NodeDef(name), value(std::to_string(c))
+    NodeConst(const Ident& name, int c) : NodeDef(name), value(std::to_string(c))
     {
         retType = ExpType::REAL;
     }
@@ -699,18 +705,18 @@ struct NodeWhile : public NodeStmt
 
 struct NodeAscent : public NodeStmt
 {
-    NodeAscent(const std::string& p, const std::shared_ptr<NodeRange>& r, const std::shared_ptr<NodeBlock>& blk) : NodeStmt(), param(p), range(r), block(blk) {}
+    NodeAscent(const Ident& p, const std::shared_ptr<NodeRange>& r, const std::shared_ptr<NodeBlock>& blk) : NodeStmt(), param(p), range(r), block(blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string param;
+    Ident param;
     std::shared_ptr<NodeRange> range;
     std::shared_ptr<NodeBlock> block;
 };
 
 struct NodeDescent : public NodeStmt
 {
-    NodeDescent(const std::string& p, const std::shared_ptr<NodeRange>& r, const std::shared_ptr<NodeBlock>& blk) : NodeStmt(), param(p), range(r), block(blk) {}
+    NodeDescent(const Ident& p, const std::shared_ptr<NodeRange>& r, const std::shared_ptr<NodeBlock>& blk) : NodeStmt(), param(p), range(r), block(blk) {}
     void Traverse(NodeTraverser& Traverser) { Traverser.Traverse(*this); }
-    std::string param;
+    Ident param;
     std::shared_ptr<NodeRange> range;
     std::shared_ptr<NodeBlock> block;
 };
@@ -0,0 +1,51 @@
+﻿#include <bstorm/node_arena.hpp>
+
+#include <cstdint>
+
+namespace bstorm
+{
+NodeArena::NodeArena() :
+    ptr_(nullptr),
+    rest_(0),
+    allocatedSize_(0),
+    reservedSize_(0),
+    objectCount_(0),
+    liveObjectCount_(0)
+{
+}
+
+NodeArena::~NodeArena()
+{
+    for (auto block : blocks_)
+    {
+        delete[] block;
+    }
+}
+
+void* NodeArena::Allocate(size_t size, size_t align)
+{
+    allocatedSize_ += size;
+    if (size + align > blockSize)
+    {
+        // 大きすぎるものは専用のブロックを確保
+        char* block = new char[size + align];
+        blocks_.push_back(block);
+        reservedSize_ += size + align;
+        size_t padding = (align - (reinterpret_cast<uintptr_t>(block) & (align - 1))) & (align - 1);
+        return block + padding;
+    }
+    size_t padding = (align - (reinterpret_cast<uintptr_t>(ptr_) & (align - 1))) & (align - 1);
+    if (padding + size > rest_)
+    {
+        blocks_.push_back(new char[blockSize]);
+        reservedSize_ += blockSize;
+        ptr_ = blocks_.back();
+        rest_ = blockSize;
+        padding = (align - (reinterpret_cast<uintptr_t>(ptr_) & (align - 1))) & (align - 1);
+    }
+    void* p = ptr_ + padding;
+    ptr_ += padding + size;
+    rest_ -= padding + size;
+    return p;
+}
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace bstorm
+{
+// 1回のコンパイルで作るノードをまとめて確保する領域
+// 確保したメモリは個別には解放せず, アリーナの破棄時にまとめて解放する
+// アリーナで作ったノードを指すshared_ptrは全てアリーナより先に破棄すること
+// スレッドセーフではないので, コンパイルごとに1つ作る
+class NodeArena
+{
+public:
+    // 1ブロックの大きさ, これを超えるものは専用のブロックに置く
+    static constexpr size_t blockSize = 64 * 1024;
+    NodeArena();
+    ~NodeArena();
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    void* Allocate(size_t size, size_t align);
+    // 確保した総バイト数
+    size_t GetAllocatedSize() const { return allocatedSize_; }
+    // ブロックとして確保した総バイト数
+    size_t GetReservedSize() const { return reservedSize_; }
+    // Newで作ったオブジェクトの数
+    size_t GetObjectCount() const { return objectCount_; }
+    // Newで作ってまだ破棄していないオブジェクトの数
+    size_t GetLiveObjectCount() const { return liveObjectCount_; }
+    // アリーナ上にオブジェクトを作る, 破棄はDestroyかOwnで作ったshared_ptrで行う
+    template <class T, class... Args>
+    T* New(Args&&... args)
+    {
+        T* p = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        objectCount_++;
+        liveObjectCount_++;
+        return p;
+    }
+    // デストラクタだけを呼ぶ(メモリはアリーナの破棄時に解放)
+    template <class T>
+    void Destroy(T* p)
+    {
+        if (!p) return;
+        p->~T();
+        liveObjectCount_--;
+    }
+    // Newで作ったオブジェクトをshared_ptrで管理する, 制御ブロックもアリーナ上に置く
+    template <class T>
+    std::shared_ptr<T> Own(T* p);
+    // make_sharedのアリーナ版
+    template <class T, class... Args>
+    std::shared_ptr<T> Make(Args&&... args);
+private:
+    std::vector<char*> blocks_;
+    char* ptr_;
+    size_t rest_;
+    size_t allocatedSize_;
+    size_t reservedSize_;
+    size_t objectCount_;
+    size_t liveObjectCount_;
+};
+
+// NodeArenaから確保するアロケータ, deallocateは何もしない
+template <class T>
+class NodeArenaAllocator
+{
+public:
+    using value_type = T;
+    NodeArenaAllocator(NodeArena* arena) noexcept : arena_(arena) {}
+    template <class U>
+    NodeArenaAllocator(const NodeArenaAllocator<U>& other) noexcept : arena_(other.GetArena()) {}
+    T* allocate(size_t n) { return static_cast<T*>(arena_->Allocate(sizeof(T) * n, alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+    NodeArena* GetArena() const noexcept { return arena_; }
+    template <class U>
+    bool operator==(const NodeArenaAllocator<U>& other) const noexcept { return arena_ == other.GetArena(); }
+    template <class U>
+    bool operator!=(const NodeArenaAllocator<U>& other) const noexcept { return arena_ != other.GetArena(); }
+private:
+    NodeArena* arena_;
+};
+
+template <class T>
+std::shared_ptr<T> NodeArena::Own(T* p)
+{
+    if (!p) return nullptr;
+    return std::shared_ptr<T>(p, [this](T* p) { Destroy(p); }, NodeArenaAllocator<T>(this));
+}
+
+template <class T, class... Args>
+std::shared_ptr<T> NodeArena::Make(Args&&... args)
+{
+    return std::allocate_shared<T>(NodeArenaAllocator<T>(this), std::forward<Args>(args)...);
+}
+}
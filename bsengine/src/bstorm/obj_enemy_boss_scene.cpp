@@ -98,14 +98,17 @@ void ObjEnemyBossScene::LoadInThread(const std::shared_ptr<SourcePos>& srcPos)
     auto package = GetPackage().lock();
     if (!package) return;
     if (isRegistered_) return;
+    // 先に使うフェーズから順にコンパイルさせる
+    int phaseOrder = 0;
     for (auto& entry : steps_)
     {
         for (auto& phase : entry.second)
         {
             if (phase.scriptId < 0)
             {
-                phase.scriptId = package->LoadScriptInThread(phase.path, ScriptType::Value::SINGLE, SCRIPT_VERSION_PH3, srcPos)->GetID();
+                phase.scriptId = package->LoadScriptInThread(phase.path, ScriptType::Value::SINGLE, SCRIPT_VERSION_PH3, SCRIPT_COMPILE_PRIORITY_PREFETCH + phaseOrder, srcPos)->GetID();
             }
+            phaseOrder++;
         }
     }
 }
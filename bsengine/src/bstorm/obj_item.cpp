@@ -11,6 +11,9 @@
 #include <bstorm/obj_prim.hpp>
 #include <bstorm/package.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace bstorm
 {
 ObjItem::ObjItem(int itemType, const std::shared_ptr<CollisionDetector>& colDetector, const std::shared_ptr<Package>& package) :
@@ -136,7 +139,7 @@ void ObjItem::Update()
             // 点数文字列生成
             if (auto package = GetPackage().lock())
             {
-                //package->GenerateItemScoreText(GetX(), GetY(), GetScore());
+                package->GenerateItemScoreText(GetX(), GetY(), GetScore());
             }
         }
         Die();
@@ -154,25 +157,29 @@ void ObjItem::Update()
     }
 }
 
+static float GetItemRenderScale(int itemType)
+{
+    switch (itemType)
+    {
+        case ITEM_1UP_S:
+        case ITEM_SPELL_S:
+        case ITEM_POWER_S:
+        case ITEM_POINT_S:
+        case ITEM_DEFAULT_BONUS:
+            return 0.75;
+    }
+    return 1.0;
+}
+
 void ObjItem::Render(const std::shared_ptr<Renderer>& renderer)
 {
     if (itemData_)
     {
-        float itemScale = 1.0;
-        switch (itemType_)
-        {
-            case ITEM_1UP_S:
-            case ITEM_SPELL_S:
-            case ITEM_POWER_S:
-            case ITEM_POINT_S:
-            case ITEM_DEFAULT_BONUS:
-                itemScale = 0.75;
-                break;
-        }
+        const float itemScale = GetItemRenderScale(itemType_);
 
         bool isOut = GetY() <= 0;
         /* 配置 */
-        D3DXMATRIX world = CreateScaleRotTransMatrix(GetX(), isOut ? ((itemData_->out.bottom - itemData_->out.top) / 2.0f) : GetY(), 0, GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX() * itemScale, GetScaleY() * itemScale, 1.0f);
+        const D3DXMATRIX world = ToD3DXMatrix(renderWorldMatrix_.Get(GetX(), isOut ? ((itemData_->out.bottom - itemData_->out.top) / 2.0f) : GetY(), 0, GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX() * itemScale, GetScaleY() * itemScale, 1.0f));
 
         const auto& rect = isOut ? itemData_->out
             : (animationIdx_ >= 0 && animationIdx_ < itemData_->animationData.size()) ? itemData_->animationData[animationIdx_].rect
@@ -236,13 +243,28 @@ void ObjItem::Render(const std::shared_ptr<Renderer>& renderer)
             }
         }
 
-        auto vertices = GetRectVertices(renderColor, itemData_->texture->GetWidth(), itemData_->texture->GetHeight(), rect);
-        renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), itemData_->texture->GetTexture(), itemBlend, itemFilter, world, GetAppliedShader(), IsPermitCamera(), true);
+        auto vertices = GetRectVertices(renderColor, itemData_->renderTexture->GetWidth(), itemData_->renderTexture->GetHeight(), itemData_->atlasRegion.Remap(rect));
+        renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), itemData_->renderTexture->GetTexture(), itemBlend, itemFilter, world, GetAppliedShader(), IsPermitCamera(), true, itemData_->texture->GetTexture());
     }
 
     ObjCol::RenderIntersection(renderer, IsPermitCamera(), GetPackage());
 }
 
+bool ObjItem::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    if (!itemData_) return false;
+    const bool isOut = GetY() <= 0;
+    const float y = isOut ? ((itemData_->out.bottom - itemData_->out.top) / 2.0f) : GetY();
+    const auto& rect = isOut ? itemData_->out
+        : (animationIdx_ >= 0 && animationIdx_ < itemData_->animationData.size()) ? itemData_->animationData[animationIdx_].rect
+        : itemData_->rect;
+    const float scale = std::max(std::abs(GetScaleX()), std::abs(GetScaleY())) * GetItemRenderScale(itemType_);
+    // 回転しても収まるように対角線の半分を使う
+    const float r = 0.5f * std::hypot((float)(rect.right - rect.left), (float)(rect.bottom - rect.top)) * scale;
+    *bounds = Rect<float>(GetX() - r, y - r, GetX() + r, y + r);
+    return true;
+}
+
 int ObjItem::GetItemType() const { return itemType_; }
 
 PlayerScore ObjItem::GetScore() const { return score_; }
@@ -345,53 +367,59 @@ void ObjItem::UpdateAnimationPosition()
     }
 }
 
-ObjItemScoreText::ObjItemScoreText(PlayerScore score, const std::shared_ptr<Texture>& texture, const std::shared_ptr<Package>& package) :
-    ObjSpriteList2D(package),
-    ObjMove(this),
-    scoreTextDeleteTimer_(32),
-    scoreTextAlpha_(0xff)
+ObjItemScoreText::ObjItemScoreText(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Package>& package) :
+    ObjPrim2D(package),
+    isVertexDirty_(false)
 {
+    SetType(OBJ_PRIMITIVE_2D);
+    SetPrimitiveType(D3DPT_TRIANGLELIST);
     SetBlendType(BLEND_ADD_ARGB);
     SetTexture(texture);
-    SetMoveMode(std::make_shared<MoveModeHoverItemScoreText>(1.0f));
-
-    std::string scoreText = std::to_string(score);
-    int digitWidth = 8;
-    int digitHeight = 14;
-    for (int i = 0; i < scoreText.size(); i++)
-    {
-        int n = scoreText[i] - '0';
-        SetX(i * (digitWidth - 1));
-        SetSourceRect(n * 36, 0, (n + 1) * 36, 32);
-        SetDestRect(0, 0, digitWidth, digitHeight);
-        AddVertex();
-    }
-    CloseVertex();
 }
 
 ObjItemScoreText::~ObjItemScoreText() {}
 
+void ObjItemScoreText::AddScoreText(float x, float y, PlayerScore score)
+{
+    scoreTexts_.Add(x, y, score);
+    isVertexDirty_ = true;
+}
+
 void ObjItemScoreText::Update()
 {
-    scoreTextDeleteTimer_--;
-    if (scoreTextDeleteTimer_ <= 0)
-    {
-        Die();
-    } else
+    if (scoreTexts_.GetCount() == 0) return;
+    scoreTexts_.Update();
+    isVertexDirty_ = true;
+}
+
+void ObjItemScoreText::Render(const std::shared_ptr<Renderer>& renderer)
+{
+    if (isVertexDirty_)
     {
-        Move();
-        scoreTextAlpha_ -= 8;
-        int vertexCnt = GetVertexCount();
-        for (int i = 0; i < vertexCnt; i++)
-        {
-            SetVertexAlpha(i, scoreTextAlpha_);
-        }
+        UpdateVertices();
     }
+    if (vertices_.empty()) return;
+    // 頂点は画面上の座標で作っている
+    const D3DXMATRIX world = ToD3DXMatrix(IdentityMatrix4());
+    renderer->RenderPrim2D(GetD3DPrimitiveType(), vertices_.size(), vertices_.data(), GetD3DTexture(), GetBlendType(), GetFilterType(), world, GetAppliedShader(), IsPermitCamera(), true);
 }
 
-void ObjItemScoreText::Render(const std::shared_ptr<Renderer>& renderer)
+bool ObjItemScoreText::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    return scoreTexts_.GetBounds(bounds);
+}
+
+void ObjItemScoreText::UpdateVertices()
 {
-    ObjSpriteList2D::Render(renderer);
+    int texWidth, texHeight;
+    if (GetD3DTextureSize(&texWidth, &texHeight))
+    {
+        scoreTexts_.WriteVertices(texWidth, texHeight, &vertices_);
+    } else
+    {
+        vertices_.clear();
+    }
+    isVertexDirty_ = false;
 }
 
 AutoItemCollectionManager::AutoItemCollectionManager() :
@@ -539,14 +567,4 @@ void MoveModeItemToPlayer::Move(float & x, float & y)
         y += dy;
     }
 }
-
-MoveModeHoverItemScoreText::MoveModeHoverItemScoreText(float speed) :
-    speed_(speed)
-{
-}
-
-void MoveModeHoverItemScoreText::Move(float & x, float & y)
-{
-    y -= speed_;
-}
 }
\ No newline at end of file
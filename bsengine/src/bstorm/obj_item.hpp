@@ -5,6 +5,7 @@
 #include <bstorm/obj_move.hpp>
 #include <bstorm/obj_col.hpp>
 #include <bstorm/stage_common_player_params.hpp>
+#include <bstorm/item_score_text.hpp>
 
 #include <stdint.h>
 #include <memory>
@@ -24,6 +25,7 @@ public:
     void SetIntersection();
     void Update() override;
     void Render(const std::shared_ptr<Renderer>& renderer) override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
     int GetItemType() const;
     PlayerScore GetScore() const;
     void SetScore(PlayerScore score);
@@ -56,18 +58,24 @@ private:
     int animationFrameCnt_;
     int animationIdx_;
     std::shared_ptr<ItemData> itemData_;
+    ScaleRotTransMatrixCache renderWorldMatrix_;
 };
 
-class ObjItemScoreText : public ObjSpriteList2D, public ObjMove
+// アイテム取得時の点数表示
+// 表示中の点数は全てこのオブジェクトが持ち, まとめて1回で描画する
+class ObjItemScoreText : public ObjPrim2D
 {
 public:
-    ObjItemScoreText(PlayerScore score, const std::shared_ptr<Texture>& texture, const std::shared_ptr<Package>& package);
+    ObjItemScoreText(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Package>& package);
     ~ObjItemScoreText();
+    void AddScoreText(float x, float y, PlayerScore score);
     void Update() override;
     void Render(const std::shared_ptr<Renderer>& renderer) override;
-protected:
-    int scoreTextDeleteTimer_;
-    int scoreTextAlpha_;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
+private:
+    void UpdateVertices();
+    ItemScoreTextList scoreTexts_;
+    bool isVertexDirty_;
 };
 
 class ObjItem;
@@ -131,15 +139,4 @@ private:
     const float speed_;
     std::weak_ptr<ObjPlayer> targetPlayer_;
 };
-
-class MoveModeHoverItemScoreText : public MoveMode
-{
-public:
-    MoveModeHoverItemScoreText(float speed);
-    void Move(float& x, float& y) override;
-    float GetAngle() const override { return 0; }
-    float GetSpeed() const override { return 0; }
-private:
-    float speed_;
-};
 }
\ No newline at end of file
@@ -7,8 +7,11 @@
 #include <bstorm/render_target.hpp>
 #include <bstorm/renderer.hpp>
 #include <bstorm/package.hpp>
+#include <bstorm/particle_vertex.hpp>
 
 #include <d3dx9.h>
+#include <algorithm>
+#include <cmath>
 
 static bool isValidIndex(int i, const std::vector<bstorm::Vertex>& v)
 {
@@ -19,7 +22,13 @@ namespace bstorm
 {
 ObjPrim::ObjPrim(const std::shared_ptr<Package>& state) :
     ObjRender(state),
-    primType_(D3DPT_TRIANGLELIST)
+    primType_(D3DPT_TRIANGLELIST),
+    isVertexBoundsDirty_(false),
+    vertexRadiusSq_(0),
+    vertexLeft_(0),
+    vertexTop_(0),
+    vertexRight_(0),
+    vertexBottom_(0)
 {
 }
 
@@ -45,6 +54,7 @@ void ObjPrim::SetVertexCount(int cnt, bool doClear)
 {
     if (doClear) vertices_.clear();
     vertices_.resize(cnt);
+    InvalidateVertexBounds();
 }
 
 int ObjPrim::GetVertexCount() const
@@ -71,6 +81,7 @@ void ObjPrim::SetVertexPosition(int vIdx, float x, float y, float z)
         vertices_[vIdx].x = x;
         vertices_[vIdx].y = y;
         vertices_[vIdx].z = z;
+        InvalidateVertexBounds();
     }
 }
 
@@ -170,6 +181,59 @@ _D3DPRIMITIVETYPE ObjPrim::GetD3DPrimitiveType() const
     return primType_;
 }
 
+bool ObjPrim::GetD3DTextureSize(int* width, int* height) const
+{
+    auto d3DTex = GetD3DTexture();
+    if (!d3DTex) return false;
+    *width = GetD3DTextureWidth(d3DTex);
+    *height = GetD3DTextureHeight(d3DTex);
+    return true;
+}
+
+float ObjPrim::GetVertexRadius() const
+{
+    if (isVertexBoundsDirty_) UpdateVertexBounds();
+    return std::sqrt(vertexRadiusSq_);
+}
+
+bool ObjPrim::GetVertexRect(Rect<float>* rect) const
+{
+    if (vertices_.empty()) return false;
+    if (isVertexBoundsDirty_) UpdateVertexBounds();
+    *rect = Rect<float>(vertexLeft_, vertexTop_, vertexRight_, vertexBottom_);
+    return true;
+}
+
+void ObjPrim::ExtendVertexBounds(const Vertex& vertex)
+{
+    if (isVertexBoundsDirty_) return;
+    vertexRadiusSq_ = std::max(vertexRadiusSq_, vertex.x * vertex.x + vertex.y * vertex.y + vertex.z * vertex.z);
+    vertexLeft_ = std::min(vertexLeft_, vertex.x);
+    vertexTop_ = std::min(vertexTop_, vertex.y);
+    vertexRight_ = std::max(vertexRight_, vertex.x);
+    vertexBottom_ = std::max(vertexBottom_, vertex.y);
+}
+
+void ObjPrim::UpdateVertexBounds() const
+{
+    vertexRadiusSq_ = 0;
+    vertexLeft_ = vertexTop_ = vertexRight_ = vertexBottom_ = 0;
+    if (!vertices_.empty())
+    {
+        vertexLeft_ = vertexRight_ = vertices_[0].x;
+        vertexTop_ = vertexBottom_ = vertices_[0].y;
+    }
+    for (const auto& vertex : vertices_)
+    {
+        vertexRadiusSq_ = std::max(vertexRadiusSq_, vertex.x * vertex.x + vertex.y * vertex.y + vertex.z * vertex.z);
+        vertexLeft_ = std::min(vertexLeft_, vertex.x);
+        vertexTop_ = std::min(vertexTop_, vertex.y);
+        vertexRight_ = std::max(vertexRight_, vertex.x);
+        vertexBottom_ = std::max(vertexBottom_, vertex.y);
+    }
+    isVertexBoundsDirty_ = false;
+}
+
 ObjPrim2D::ObjPrim2D(const std::shared_ptr<Package>& state) :
     ObjPrim(state)
 {
@@ -178,10 +242,20 @@ ObjPrim2D::ObjPrim2D(const std::shared_ptr<Package>& state) :
 
 void ObjPrim2D::Render(const std::shared_ptr<Renderer>& renderer)
 {
-    D3DXMATRIX world = CreateScaleRotTransMatrix(GetX(), GetY(), GetZ(), GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX(), GetScaleY(), GetScaleZ());
+    const D3DXMATRIX world = ToD3DXMatrix(GetWorldMatrix());
     renderer->RenderPrim2D(GetD3DPrimitiveType(), vertices_.size(), vertices_.data(), GetD3DTexture(), GetBlendType(), GetFilterType(), world, GetAppliedShader(), IsPermitCamera(), true);
 }
 
+bool ObjPrim2D::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    if (vertices_.empty()) return false;
+    // 原点から最も遠い頂点までの距離を半径とする円を内包する矩形
+    const float scale = std::max({ std::abs(GetScaleX()), std::abs(GetScaleY()), std::abs(GetScaleZ()) });
+    const float r = GetVertexRadius() * scale;
+    *bounds = Rect<float>(GetX() - r, GetY() - r, GetX() + r, GetY() + r);
+    return true;
+}
+
 ObjSprite2D::ObjSprite2D(const std::shared_ptr<Package>& state) :
     ObjPrim2D(state)
 {
@@ -241,25 +315,10 @@ void ObjSpriteList2D::Render(const std::shared_ptr<Renderer>& renderer)
         ObjPrim2D::Render(renderer);
     } else
     {
-        // 保存
-        float prevX = GetX();
-        float prevY = GetY();
-        float prevZ = GetZ();
-        float prevAngleX = GetAngleX();
-        float prevAngleY = GetAngleY();
-        float prevAngleZ = GetAngleZ();
-        float prevScaleX = GetScaleX();
-        float prevScaleY = GetScaleY();
-        float prevScaleZ = GetScaleZ();
-        // パラメータをリセットして描画
-        SetPosition(0, 0, 0);
-        SetAngleXYZ(0, 0, 0);
-        SetScaleXYZ(1, 1, 1);
-        ObjPrim2D::Render(renderer);
-        // 復元
-        SetPosition(prevX, prevY, prevZ);
-        SetAngleXYZ(prevAngleX, prevAngleY, prevAngleZ);
-        SetScaleXYZ(prevScaleX, prevScaleY, prevScaleZ);
+        // 頂点は追加時に変換済みなので, 位置などのパラメータを使わずに描画
+        // (パラメータを書き換えるとワールド行列のキャッシュが無効になる)
+        const D3DXMATRIX world = ToD3DXMatrix(IdentityMatrix4());
+        renderer->RenderPrim2D(GetD3DPrimitiveType(), vertices_.size(), vertices_.data(), GetD3DTexture(), GetBlendType(), GetFilterType(), world, GetAppliedShader(), IsPermitCamera(), true);
     }
 }
 
@@ -290,6 +349,13 @@ void ObjSpriteList2D::SetDestCenter()
     }
 }
 
+bool ObjSpriteList2D::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    if (isVertexClosed_) return ObjPrim2D::GetRenderBounds2D(bounds);
+    // 閉じていない頂点は変換済みの座標を持っている
+    return GetVertexRect(bounds);
+}
+
 void ObjSpriteList2D::AddVertex()
 {
     // 頂点を6つ生成する
@@ -299,46 +365,58 @@ void ObjSpriteList2D::AddVertex()
     // 1 4-5
 
     // 座標変換
-    D3DXMATRIX mat = CreateScaleRotTransMatrix(GetX(), GetY(), GetZ(), GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX(), GetScaleY(), GetScaleZ());
-    D3DXMATRIX vecs;
-    // 1行目:左上
-    // 2行目:左下
-    // 3行目:右上
-    // 4行目:右下
-    vecs._11 = vecs._21 = dstRectLeft_;
-    vecs._12 = vecs._32 = dstRectTop_;
-    vecs._31 = vecs._41 = dstRectRight_;
-    vecs._22 = vecs._42 = dstRectBottom_;
-    vecs._13 = vecs._23 = vecs._33 = vecs._43 = 0; // z = 0
-    vecs._14 = vecs._24 = vecs._34 = vecs._44 = 1; // w = 1
-    auto result = vecs * mat;
+    const Matrix4& mat = GetWorldMatrix();
+    auto transform = [&mat](float x, float y, D3DCOLOR color, float u, float v)
+    {
+        return Vertex(x * mat.m[0][0] + y * mat.m[1][0] + mat.m[3][0], x * mat.m[0][1] + y * mat.m[1][1] + mat.m[3][1], 0, color, u, v);
+    };
     float ul = 0;
     float vt = 0;
     float ur = 0;
     float vb = 0;
-    auto texture = GetD3DTexture();
-    if (texture)
+    int texWidth, texHeight;
+    if (GetD3DTextureSize(&texWidth, &texHeight))
     {
-        int texWidth = GetD3DTextureWidth(texture);
-        int texHeight = GetD3DTextureHeight(texture);
         ul = srcRectLeft_ / texWidth;
         vt = srcRectTop_ / texHeight;
         ur = srcRectRight_ / texWidth;
         vb = srcRectBottom_ / texHeight;
     }
-    D3DCOLOR color = GetD3DCOLOR();
-    Vertex v0(result._11, result._12, 0, color, ul, vt);
-    Vertex v1(result._21, result._22, 0, color, ul, vb);
-    Vertex v2(result._31, result._32, 0, color, ur, vt);
-    Vertex& v3 = v2;
-    Vertex& v4 = v1;
-    Vertex v5(result._41, result._42, 0, color, ur, vb);
-    vertices_.push_back(v0);
-    vertices_.push_back(v1);
-    vertices_.push_back(v2);
-    vertices_.push_back(v3);
-    vertices_.push_back(v4);
-    vertices_.push_back(v5);
+    const D3DCOLOR color = GetD3DCOLOR();
+    const Vertex leftTop = transform(dstRectLeft_, dstRectTop_, color, ul, vt);
+    const Vertex leftBottom = transform(dstRectLeft_, dstRectBottom_, color, ul, vb);
+    const Vertex rightTop = transform(dstRectRight_, dstRectTop_, color, ur, vt);
+    const Vertex rightBottom = transform(dstRectRight_, dstRectBottom_, color, ur, vb);
+
+    // push_backを6回呼ばずに, 広げた領域に直接書き込む
+    const size_t offset = vertices_.size();
+    vertices_.resize(offset + 6);
+    Vertex* dst = vertices_.data() + offset;
+    dst[0] = leftTop;
+    dst[1] = leftBottom;
+    dst[2] = rightTop;
+    dst[3] = rightTop;
+    dst[4] = leftBottom;
+    dst[5] = rightBottom;
+    if (offset == 0)
+    {
+        InvalidateVertexBounds();
+    } else
+    {
+        // 四隅だけで範囲が決まる
+        ExtendVertexBounds(leftTop);
+        ExtendVertexBounds(leftBottom);
+        ExtendVertexBounds(rightTop);
+        ExtendVertexBounds(rightBottom);
+    }
+}
+
+void ObjSpriteList2D::Reserve(int spriteCount)
+{
+    if (spriteCount > 0)
+    {
+        vertices_.reserve(6 * (size_t)spriteCount);
+    }
 }
 
 void ObjSpriteList2D::CloseVertex()
@@ -355,6 +433,167 @@ void ObjSpriteList2D::ClearVerexCount()
     isVertexClosed_ = false;
 }
 
+ObjParticleList2D::ObjParticleList2D(const std::shared_ptr<Package>& state) :
+    ObjPrim2D(state),
+    isVertexDirty_(false),
+    vertexBaseColor_(0),
+    vertexTexture_(nullptr),
+    accelX_(0),
+    accelY_(0),
+    srcRectLeft_(0),
+    srcRectTop_(0),
+    srcRectRight_(0),
+    srcRectBottom_(0),
+    dstRectLeft_(0),
+    dstRectTop_(0),
+    dstRectRight_(0),
+    dstRectBottom_(0)
+{
+    SetType(OBJ_PARTICLE_LIST_2D);
+    SetPrimitiveType(D3DPT_TRIANGLELIST);
+}
+
+void ObjParticleList2D::Update()
+{
+    if (particles_.GetCount() == 0) return;
+    particles_.Update();
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::Render(const std::shared_ptr<Renderer>& renderer)
+{
+    if (isVertexDirty_ || vertexBaseColor_ != GetD3DCOLOR() || vertexTexture_ != GetD3DTexture())
+    {
+        UpdateVertices();
+    }
+    if (!vertices_.empty())
+    {
+        ObjPrim2D::Render(renderer);
+    }
+}
+
+bool ObjParticleList2D::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    if (particles_.GetCount() == 0) return false;
+    // 原点から最も遠い粒子までの距離に粒子の大きさを足した半径の円を内包する矩形
+    const float maxDistSq = particles_.GetMaxDistanceSq();
+    const float extent = std::max({ std::abs(dstRectLeft_), std::abs(dstRectTop_), std::abs(dstRectRight_), std::abs(dstRectBottom_) }) * std::sqrt(2.0f) * particles_.GetMaxScale();
+    const float scale = std::max({ std::abs(GetScaleX()), std::abs(GetScaleY()), std::abs(GetScaleZ()) });
+    const float r = (std::sqrt(maxDistSq) + extent) * scale;
+    *bounds = Rect<float>(GetX() - r, GetY() - r, GetX() + r, GetY() + r);
+    return true;
+}
+
+void ObjParticleList2D::SetSourceRect(float left, float top, float right, float bottom)
+{
+    srcRectLeft_ = left;
+    srcRectTop_ = top;
+    srcRectRight_ = right;
+    srcRectBottom_ = bottom;
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::SetDestRect(float left, float top, float right, float bottom)
+{
+    dstRectLeft_ = left;
+    dstRectTop_ = top;
+    dstRectRight_ = right;
+    dstRectBottom_ = bottom;
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::SetDestCenter()
+{
+    float hw = (srcRectRight_ - srcRectLeft_) / 2.0;
+    float hh = (srcRectBottom_ - srcRectTop_) / 2.0;
+    SetDestRect(-hw, -hh, hw, hh);
+}
+
+void ObjParticleList2D::AddParticleA1(float x, float y, float speed, float angle, int life)
+{
+    const float rad = D3DXToRadian(angle);
+    AddParticleB1(x, y, speed * cos(rad), speed * sin(rad), life);
+}
+
+void ObjParticleList2D::AddParticleB1(float x, float y, float vx, float vy, int life)
+{
+    particles_.Add(x, y, vx, vy, accelX_, accelY_, life);
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::SetAcceleration(float ax, float ay)
+{
+    accelX_ = ax;
+    accelY_ = ay;
+}
+
+void ObjParticleList2D::SetColorCurve(int r0, int g0, int b0, int r1, int g1, int b1)
+{
+    particles_.SetColorCurve(r0, g0, b0, r1, g1, b1);
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::SetAlphaCurve(int a0, int a1)
+{
+    particles_.SetAlphaCurve(a0, a1);
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::SetScaleCurve(float s0, float s1)
+{
+    particles_.SetScaleCurve(s0, s1);
+    isVertexDirty_ = true;
+}
+
+void ObjParticleList2D::Reserve(int particleCount)
+{
+    if (particleCount > 0)
+    {
+        particles_.Reserve(particleCount);
+        vertices_.reserve(6 * (size_t)particleCount);
+    }
+}
+
+void ObjParticleList2D::ClearParticles()
+{
+    particles_.Clear();
+    isVertexDirty_ = true;
+}
+
+int ObjParticleList2D::GetParticleCount() const
+{
+    return particles_.GetCount();
+}
+
+void ObjParticleList2D::UpdateVertices()
+{
+    ParticleQuad quad;
+    quad.dstLeft = dstRectLeft_;
+    quad.dstTop = dstRectTop_;
+    quad.dstRight = dstRectRight_;
+    quad.dstBottom = dstRectBottom_;
+    quad.ul = quad.vt = quad.ur = quad.vb = 0;
+    int texWidth, texHeight;
+    if (GetD3DTextureSize(&texWidth, &texHeight))
+    {
+        quad.ul = srcRectLeft_ / texWidth;
+        quad.vt = srcRectTop_ / texHeight;
+        quad.ur = srcRectRight_ / texWidth;
+        quad.vb = srcRectBottom_ / texHeight;
+    }
+    // オブジェクトの色を粒子の色に乗算する
+    const ColorRGB& rgb = GetColor();
+    quad.rMul = rgb.GetR() / 255.0f;
+    quad.gMul = rgb.GetG() / 255.0f;
+    quad.bMul = rgb.GetB() / 255.0f;
+    quad.aMul = GetAlpha() / 255.0f;
+    WriteParticleVertices(particles_, quad, &vertices_);
+    InvalidateVertexBounds();
+    isVertexDirty_ = false;
+    vertexBaseColor_ = GetD3DCOLOR();
+    vertexTexture_ = GetD3DTexture();
+}
+
 ObjPrim3D::ObjPrim3D(const std::shared_ptr<Package>& state) :
     ObjPrim(state),
     billboardEnable_(false)
@@ -364,7 +603,7 @@ ObjPrim3D::ObjPrim3D(const std::shared_ptr<Package>& state) :
 
 void ObjPrim3D::Render(const std::shared_ptr<Renderer>& renderer)
 {
-    D3DXMATRIX world = CreateScaleRotTransMatrix(GetX(), GetY(), GetZ(), GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX(), GetScaleY(), GetScaleZ());
+    const D3DXMATRIX world = ToD3DXMatrix(GetWorldMatrix());
     renderer->RenderPrim3D(GetD3DPrimitiveType(), vertices_.size(), vertices_.data(), GetD3DTexture(), GetBlendType(), world, GetAppliedShader(), IsZWriteEnabled(), IsZTestEnabled(), IsFogEnabled(), IsBillboardEnabled());
 }
 
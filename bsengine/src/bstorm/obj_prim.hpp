@@ -2,7 +2,9 @@
 
 #include <bstorm/vertex.hpp>
 #include <bstorm/obj_render.hpp>
+#include <bstorm/particle_system.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <d3d9.h>
@@ -34,15 +36,95 @@ public:
     void SetVertexUVT(int vIdx, float u, float v);
     void SetVertexColor(int vIdx, int r, int g, int b);
     void SetVertexAlpha(int vIdx, int a);
+    // 一括設定
+    // [begin, begin + count)の頂点を書き換える, 頂点数を超える分は無視する
+    // get(k)はk番目の要素を返す. 1頂点あたり位置,色は3要素, UVは2要素, アルファは1要素を使う
+    template <class Getter>
+    void SetVertexPositions(int begin, int count, Getter&& get)
+    {
+        InvalidateVertexBounds();
+        ForEachVertex(begin, count, [&](int i, Vertex& vertex)
+        {
+            vertex.x = get(3 * i);
+            vertex.y = get(3 * i + 1);
+            vertex.z = get(3 * i + 2);
+        });
+    }
+    template <class Getter>
+    void SetVertexUVs(int begin, int count, Getter&& get)
+    {
+        ForEachVertex(begin, count, [&](int i, Vertex& vertex)
+        {
+            vertex.u = get(2 * i);
+            vertex.v = get(2 * i + 1);
+        });
+    }
+    template <class Getter>
+    void SetVertexUVTs(int begin, int count, Getter&& get)
+    {
+        int texWidth, texHeight;
+        if (!GetD3DTextureSize(&texWidth, &texHeight)) return;
+        ForEachVertex(begin, count, [&](int i, Vertex& vertex)
+        {
+            vertex.u = get(2 * i) / texWidth;
+            vertex.v = get(2 * i + 1) / texHeight;
+        });
+    }
+    template <class Getter>
+    void SetVertexColors(int begin, int count, Getter&& get)
+    {
+        ForEachVertex(begin, count, [&](int i, Vertex& vertex)
+        {
+            ColorRGB rgb((int)get(3 * i), (int)get(3 * i + 1), (int)get(3 * i + 2));
+            vertex.color = rgb.ToD3DCOLOR(vertex.color >> 24);
+        });
+    }
+    template <class Getter>
+    void SetVertexAlphas(int begin, int count, Getter&& get)
+    {
+        ForEachVertex(begin, count, [&](int i, Vertex& vertex)
+        {
+            const int a = std::min(std::max((int)get(i), 0), 0xff);
+            vertex.color = (vertex.color & D3DCOLOR_RGBA(0xff, 0xff, 0xff, 0)) | D3DCOLOR_RGBA(0, 0, 0, a);
+        });
+    }
     const std::vector<Vertex>& GetVertices() const;
 protected:
     IDirect3DTexture9 * GetD3DTexture() const;
     _D3DPRIMITIVETYPE GetD3DPrimitiveType() const;
+    // テクスチャが設定されていなければfalse
+    bool GetD3DTextureSize(int* width, int* height) const;
+    // vertices_の位置を直接書き換えたら呼ぶ
+    void InvalidateVertexBounds() { isVertexBoundsDirty_ = true; }
+    // 原点から最も遠い頂点までの距離, 頂点が変わった後に1度だけ計算する
+    float GetVertexRadius() const;
+    // 頂点を囲むxy平面上の矩形, 頂点が無ければfalse
+    bool GetVertexRect(Rect<float>* rect) const;
+    // 計算済みの範囲に頂点を加える, 空の状態から計算した範囲には使えない
+    // 計算し直す必要がある時は何もしない
+    void ExtendVertexBounds(const Vertex& vertex);
     std::vector<Vertex> vertices_;
 private:
+    void UpdateVertexBounds() const;
+    // fn(i, vertex)のiはbeginからの位置
+    template <class Fn>
+    void ForEachVertex(int begin, int count, Fn&& fn)
+    {
+        const int end = std::min(begin + count, (int)vertices_.size());
+        for (int vIdx = std::max(begin, 0); vIdx < end; vIdx++)
+        {
+            fn(vIdx - begin, vertices_[vIdx]);
+        }
+    }
     _D3DPRIMITIVETYPE primType_;
     std::shared_ptr<Texture> texture_;
     std::shared_ptr<RenderTarget> renderTarget_;
+    mutable bool isVertexBoundsDirty_;
+    mutable float vertexRadiusSq_;
+    mutable float vertexLeft_;
+    mutable float vertexTop_;
+    mutable float vertexRight_;
+    mutable float vertexBottom_;
 };
 
 class ObjPrim2D : public ObjPrim
@@ -50,6 +132,7 @@ class ObjPrim2D : public ObjPrim
 public:
     ObjPrim2D(const std::shared_ptr<Package>& state);
     void Render(const std::shared_ptr<Renderer>& renderer) override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
 };
 
 class ObjSprite2D : public ObjPrim2D
@@ -66,10 +149,13 @@ class ObjSpriteList2D : public ObjPrim2D
 public:
     ObjSpriteList2D(const std::shared_ptr<Package>& state);
     void Render(const std::shared_ptr<Renderer>& renderer) override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
     void SetSourceRect(float left, float top, float right, float bottom);
     void SetDestRect(float left, float top, float right, float bottom);
     void SetDestCenter();
     void AddVertex();
+    // 合計spriteCount個のスプライト分の頂点配列を確保しておく
+    void Reserve(int spriteCount);
     void CloseVertex();
     void ClearVerexCount();
 private:
@@ -84,6 +170,47 @@ private:
     float dstRectBottom_;
 };
 
+// 粒子をまとめて1回で描画するオブジェクト
+// 粒子の座標はオブジェクトのローカル座標
+class ObjParticleList2D : public ObjPrim2D
+{
+public:
+    ObjParticleList2D(const std::shared_ptr<Package>& state);
+    void Update() override;
+    void Render(const std::shared_ptr<Renderer>& renderer) override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
+    void SetSourceRect(float left, float top, float right, float bottom);
+    void SetDestRect(float left, float top, float right, float bottom);
+    void SetDestCenter();
+    // angleは度
+    void AddParticleA1(float x, float y, float speed, float angle, int life);
+    void AddParticleB1(float x, float y, float vx, float vy, int life);
+    void SetAcceleration(float ax, float ay);
+    void SetColorCurve(int r0, int g0, int b0, int r1, int g1, int b1);
+    void SetAlphaCurve(int a0, int a1);
+    void SetScaleCurve(float s0, float s1);
+    void Reserve(int particleCount);
+    void ClearParticles();
+    int GetParticleCount() const;
+private:
+    void UpdateVertices();
+    ParticleSystem particles_;
+    bool isVertexDirty_;
+    // 頂点を作った時のオブジェクトの色とテクスチャ
+    D3DCOLOR vertexBaseColor_;
+    IDirect3DTexture9* vertexTexture_;
+    float accelX_;
+    float accelY_;
+    float srcRectLeft_;
+    float srcRectTop_;
+    float srcRectRight_;
+    float srcRectBottom_;
+    float dstRectLeft_;
+    float dstRectTop_;
+    float dstRectRight_;
+    float dstRectBottom_;
+};
+
 class ObjPrim3D : public ObjPrim
 {
 public:
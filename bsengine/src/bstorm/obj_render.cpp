@@ -1,15 +1,16 @@
-﻿#include <vector>
-
-#include <bstorm/obj_render.hpp>
+﻿#include <bstorm/obj_render.hpp>
 
 #include <bstorm/dnh_const.hpp>
 #include <bstorm/math_util.hpp>
 #include <bstorm/shader.hpp>
 #include <bstorm/texture.hpp>
 #include <bstorm/render_target.hpp>
-#include <bstorm/obj_shot.hpp>
-#include <bstorm/shot_data.hpp>
 #include <bstorm/package.hpp>
+#include <bstorm/renderer.hpp>
+#include <bstorm/thread_util.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace bstorm
 {
@@ -26,18 +27,54 @@ ObjRender::ObjRender(const std::shared_ptr<Package>& package) :
     scaleX_(1),
     scaleY_(1),
     scaleZ_(1),
+    worldMatrix_(IdentityMatrix4()),
+    isWorldMatrixDirty_(false),
     alpha_(0xff),
     blendType_(BLEND_ALPHA),
     filterType_(FILTER_LINEAR), //FP FILTER
     fogEnable_(true),
     zWriteEnable_(true),
     zTestEnable_(true),
-    permitCamera_(true)
+    permitCamera_(true),
+    layerList_(nullptr),
+    renderBucket_(RENDER_BUCKET_HIDDEN),
+    posInBucket_(0),
+    layerSeq_(0)
 {
 }
 
 ObjRender::~ObjRender()
 {
+    if (layerList_)
+    {
+        layerList_->Remove(this);
+    }
+}
+
+void ObjRender::OnDead() noexcept
+{
+    if (layerList_)
+    {
+        layerList_->Remove(this);
+    }
+}
+
+void ObjRender::UpdateRenderBucket()
+{
+    if (layerList_)
+    {
+        layerList_->UpdateRenderBucket(this);
+    }
+}
+
+const Matrix4& ObjRender::GetWorldMatrix() const
+{
+    if (isWorldMatrixDirty_)
+    {
+        worldMatrix_ = ScaleRotTransMatrix4(x_, y_, z_, angleX_, angleY_, angleZ_, scaleX_, scaleY_, scaleZ_);
+        isWorldMatrixDirty_ = false;
+    }
+    return worldMatrix_;
 }
 
 void ObjRender::SetColor(int r, int g, int b)
@@ -191,118 +228,197 @@ ObjectLayerList::ObjectLayerList() :
     stgFrameRenderPriorityMin_(DEFAULT_STG_FRAME_RENDER_PRIORITY_MIN),
     stgFrameRenderPriorityMax_(DEFAULT_STG_FRAME_RENDER_PRIORITY_MAX),
     invalidRenderPriorityMin_(-1),
-    invalidRenderPriorityMax_(-1)
+    invalidRenderPriorityMax_(-1),
+    layerSeqGen_(0)
 {
+    for (auto& layer : layers_)
+    {
+        layer.removedCounts.fill(0);
+    }
 }
 
-ObjectLayerList::~ObjectLayerList() {}
+ObjectLayerList::~ObjectLayerList()
+{
+    // 残っているオブジェクトからの参照を切る
+    for (auto& layer : layers_)
+    {
+        for (auto& bucket : layer.buckets)
+        {
+            for (auto& entry : bucket)
+            {
+                if (entry.obj)
+                {
+                    entry.obj->layerList_ = nullptr;
+                    entry.obj->priority_ = -1;
+                    entry.obj->renderBucket_ = RENDER_BUCKET_HIDDEN;
+                }
+            }
+        }
+    }
+}
 
-void ObjectLayerList::Remove(const std::shared_ptr<ObjRender>& obj)
+void ObjectLayerList::Remove(ObjRender* obj)
 {
-    if (obj->priority_ >= 0)
+    if (obj->layerList_ != this) return;
+    RemoveFromBucket(obj);
+    obj->layerList_ = nullptr;
+    obj->priority_ = -1;
+}
+
+void ObjectLayerList::InsertToBucket(ObjRender* obj, int bucketIdx)
+{
+    auto& bucket = layers_[obj->priority_].buckets[bucketIdx];
+    // 追加順を保つ位置に挿入する, 新規追加なら常に末尾
+    auto it = std::upper_bound(bucket.begin(), bucket.end(), obj->layerSeq_, [](uint64_t seq, const LayerEntry& entry) { return seq < entry.seq; });
+    it = bucket.insert(it, LayerEntry{ obj, obj->layerSeq_ });
+    for (size_t i = it - bucket.begin(); i < bucket.size(); i++)
     {
-        obj->posInLayer_->reset();
-        obj->priority_ = -1;
+        if (auto o = bucket[i].obj)
+        {
+            o->posInBucket_ = i;
+        }
     }
+    obj->renderBucket_ = bucketIdx;
+}
+
+void ObjectLayerList::RemoveFromBucket(ObjRender* obj)
+{
+    auto& layer = layers_[obj->priority_];
+    int bucketIdx = obj->renderBucket_;
+    auto& bucket = layer.buckets[bucketIdx];
+    // 穴を空けておき, 後でまとめて詰める
+    bucket[obj->posInBucket_].obj = nullptr;
+    auto& removedCount = layer.removedCounts[bucketIdx];
+    removedCount++;
+    if (removedCount * 2 > bucket.size())
+    {
+        CompactBucket(layer, bucketIdx);
+    }
+}
+
+void ObjectLayerList::CompactBucket(Layer& layer, int bucketIdx)
+{
+    auto& bucket = layer.buckets[bucketIdx];
+    size_t size = 0;
+    for (size_t i = 0; i < bucket.size(); i++)
+    {
+        if (auto obj = bucket[i].obj)
+        {
+            obj->posInBucket_ = size;
+            bucket[size++] = bucket[i];
+        }
+    }
+    bucket.resize(size);
+    layer.removedCounts[bucketIdx] = 0;
 }
 
 void ObjectLayerList::SetRenderPriority(const std::shared_ptr<ObjRender>& obj, int p)
 {
     if (p < 0 || p > MAX_RENDER_PRIORITY) return;
     // 現在のレイヤーから削除
-    Remove(obj);
-    // 新しいレイヤーに追加
-    auto& layer = layers_.at(p);
-    obj->posInLayer_ = layer.insert(layer.end(), obj);
+    Remove(obj.get());
+    // 新しいレイヤーの末尾に追加
+    obj->layerList_ = this;
     obj->priority_ = p;
+    obj->layerSeq_ = layerSeqGen_++;
+    InsertToBucket(obj.get(), obj->GetRenderBucket());
+}
+
+void ObjectLayerList::UpdateRenderBucket(ObjRender* obj)
+{
+    if (obj->layerList_ != this) return;
+    int bucketIdx = obj->GetRenderBucket();
+    if (bucketIdx == obj->renderBucket_) return;
+    RemoveFromBucket(obj);
+    InsertToBucket(obj, bucketIdx);
 }
 
 void ObjectLayerList::RenderLayer(int priority, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer)
 {
     if (priority < 0 || priority > MAX_RENDER_PRIORITY) return;
+    RenderObjects(layers_[priority], ignoreStgSceneObj, checkVisibleFlag, renderer, nullptr);
+}
 
-    auto& layer = layers_.at(priority);
+void ObjectLayerList::RecordLayers(const std::vector<int>& priorities, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer)
+{
+    // オブジェクトは1つのレイヤーにしか所属しないので, レイヤー単位なら並列に処理できる
+    ParallelTimes((int)priorities.size(), [&](int i)
+    {
+        const int p = priorities[i];
+        if (p < 0 || p > MAX_RENDER_PRIORITY) return;
+        auto& layer = layers_[p];
+        layer.commands.Clear();
+        renderer->BeginRecord(&layer.commands);
+        RenderObjects(layer, ignoreStgSceneObj, checkVisibleFlag, renderer, &layer.commands);
+        renderer->EndRecord();
+    });
+}
 
-    // バケツソートする
-    std::vector<std::shared_ptr<ObjRender>> addShots;
-    std::vector<std::shared_ptr<ObjRender>> mulShots;
-    std::vector<std::shared_ptr<ObjRender>> subShots;
-    std::vector<std::shared_ptr<ObjRender>> invShots;
-    std::vector<std::shared_ptr<ObjRender>> alphaShots;
-    std::vector<std::shared_ptr<ObjRender>> others;
+void ObjectLayerList::SubmitLayer(int priority, const std::shared_ptr<Renderer>& renderer)
+{
+    if (priority < 0 || priority > MAX_RENDER_PRIORITY) return;
 
-    auto it = layer.begin();
-    while (it != layer.end())
+    auto& commands = layers_[priority].commands;
+    for (const auto& cmd : commands.GetCommands())
     {
-        auto& obj = it->lock();
-        if (!obj)
+        switch (cmd.type)
         {
-            //解放済み
-            it = layer.erase(it);
-            continue;
+            case RenderCommand::Type::PRIM_2D:
+                renderer->RenderPrim2D(cmd.primType, cmd.vertexCount, commands.GetVertices(cmd), cmd.texture, cmd.blendType, cmd.filterType, cmd.worldMatrix, cmd.pixelShader, cmd.permitCamera, cmd.insertHalfPixelOffset, cmd.sourceTexture);
+                break;
+            case RenderCommand::Type::PRIM_3D:
+                renderer->RenderPrim3D(cmd.primType, cmd.vertexCount, commands.GetVertices(cmd), cmd.texture, cmd.blendType, cmd.worldMatrix, cmd.pixelShader, cmd.zWriteEnable, cmd.zTestEnable, cmd.useFog, cmd.billboardEnable);
+                break;
+            case RenderCommand::Type::MESH:
+                renderer->RenderMesh(cmd.mesh, cmd.color, cmd.blendType, cmd.worldMatrix, cmd.pixelShader, cmd.zWriteEnable, cmd.zTestEnable, cmd.useFog);
+                break;
+            case RenderCommand::Type::OBJECT:
+                cmd.obj->Render(renderer);
+                break;
         }
-        ++it;
-
-        // 終了状態 or 非表示状態
-        if (obj->IsDead() || (checkVisibleFlag && !obj->IsVisible())) { continue; }
-
-        // StgSceneのオブジェクトを描画するかどうか
-        if (ignoreStgSceneObj && obj->IsStgSceneObject()) { continue; }
+    }
+    // シェーダやメッシュへの参照を残さないように消しておく
+    commands.Clear();
+}
 
-        auto shot = std::dynamic_pointer_cast<ObjShot>(obj);
+void ObjectLayerList::RenderObjects(Layer& layer, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer, RenderCommandList* recordTarget)
+{
+    // ADD, MULTIPLY, SUBTRACT, INV_DESTRGB, ALPHA, その他の順に描画
+    for (int bucketIdx = 0; bucketIdx < RENDER_BUCKET_HIDDEN; bucketIdx++)
+    {
+        auto& bucket = layer.buckets[bucketIdx];
+        if (bucket.empty()) continue;
 
-        // 非Shot
-        if (!shot)
+        if (layer.removedCounts[bucketIdx] != 0)
         {
-            others.push_back(obj);
-            continue;
+            CompactBucket(layer, bucketIdx);
         }
 
-        if (const auto& shotData = shot->GetShotData())
+        // 描画中にバケツが変更されても良いように添字でアクセスする
+        for (size_t i = 0; i < bucket.size(); i++)
         {
-            int blendType;
-            if (!shot->IsDelay())
+            ObjRender* obj = bucket[i].obj;
+            if (!obj) continue;
+
+            // 終了状態 or 非表示状態
+            if (obj->IsDead() || (checkVisibleFlag && !obj->IsVisible())) { continue; }
+
+            // StgSceneのオブジェクトを描画するかどうか
+            if (ignoreStgSceneObj && obj->IsStgSceneObject()) { continue; }
+
+            // 画面外
+            Rect<float> bounds(0, 0, 0, 0);
+            if (renderer->IsCullingEnabled() && obj->GetRenderBounds2D(&bounds) && renderer->IsCulled2D(bounds, obj->IsPermitCamera())) { continue; }
+
+            if (recordTarget && !obj->IsParallelRenderable())
             {
-                blendType = shot->GetBlendType();
-                if (blendType == BLEND_NONE)
-                {
-                    blendType = shotData->render;
-                }
+                recordTarget->AddObject(obj);
             } else
             {
-                blendType = shot->GetSourceBlendType();
-                if (blendType == BLEND_NONE)
-                {
-                    blendType = shotData->delayRender;
-                }
-            }
-            switch (blendType)
-            {
-                case BLEND_ALPHA:
-                    alphaShots.push_back(shot);
-                    break;
-                case BLEND_ADD_RGB:
-                case BLEND_ADD_ARGB:
-                    addShots.push_back(shot);
-                    break;
-                case BLEND_MULTIPLY:
-                    mulShots.push_back(shot);
-                    break;
-                case BLEND_SUBTRACT:
-                    subShots.push_back(shot);
-                    break;
-                case BLEND_INV_DESTRGB:
-                    invShots.push_back(shot);
-                    break;
+                obj->Render(renderer);
             }
         }
     }
-    for (auto shot : addShots) { shot->Render(renderer); }
-    for (auto shot : mulShots) { shot->Render(renderer); }
-    for (auto shot : subShots) { shot->Render(renderer); }
-    for (auto shot : invShots) { shot->Render(renderer); }
-    for (auto shot : alphaShots) { shot->Render(renderer); }
-    for (auto obj : others) { obj->Render(renderer); }
 }
 
 void ObjectLayerList::SetLayerShader(int beginPriority, int endPriority, const std::shared_ptr<Shader>& shader)
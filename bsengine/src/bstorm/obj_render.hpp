@@ -2,12 +2,15 @@
 
 #include <bstorm/color_rgb.hpp>
 #include <bstorm/obj.hpp>
+#include <bstorm/matrix.hpp>
+#include <bstorm/rect.hpp>
+#include <bstorm/render_command.hpp>
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
-#include <list>
 #include <d3d9.h>
 
 namespace bstorm
@@ -17,6 +20,17 @@ class Shader;
 class Texture;
 class RenderTarget;
 class ObjectLayerList;
+
+// 同一レイヤー内での描画順 (ブレンド種別ごとのバケツ)
+constexpr int RENDER_BUCKET_ADD = 0;
+constexpr int RENDER_BUCKET_MULTIPLY = 1;
+constexpr int RENDER_BUCKET_SUBTRACT = 2;
+constexpr int RENDER_BUCKET_INV_DESTRGB = 3;
+constexpr int RENDER_BUCKET_ALPHA = 4;
+constexpr int RENDER_BUCKET_OTHERS = 5;
+constexpr int RENDER_BUCKET_HIDDEN = 6; // レイヤーには所属するが描画しない
+constexpr int RENDER_BUCKET_COUNT = 7;
+
 class ObjRender : public Obj
 {
 public:
@@ -26,43 +40,53 @@ public:
     bool IsVisible() const { return visibleFlag_; }
     void SetVisible(bool visible) { visibleFlag_ = visible; }
     int getRenderPriority() const { return priority_; }
+    // 所属する描画バケツ, 変化した時はUpdateRenderBucketを呼ぶこと
+    virtual int GetRenderBucket() const { return RENDER_BUCKET_OTHERS; }
+    // 描画範囲を内包する2D座標上の矩形, 求められない場合はfalse(カリングしない)
+    virtual bool GetRenderBounds2D(Rect<float>* bounds) const { return false; }
+    // 描画スレッド以外でRenderを呼んでもよいならtrue
+    // falseの場合は描画命令を記録する時に呼び出しそのものを記録し, 描画スレッドで呼ぶ
+    virtual bool IsParallelRenderable() const { return true; }
     float GetX() const { return x_; }
     float GetY() const { return y_; }
     float GetZ() const { return z_; }
-    void SetX(float x) { OnTrans(x - this->x_, 0); this->x_ = x; }
-    void SetY(float y) { OnTrans(0, y - this->y_); this->y_ = y; }
-    void SetZ(float z) { this->z_ = z; }
+    void SetX(float x) { OnTrans(x - this->x_, 0); SetTransform(this->x_, x); }
+    void SetY(float y) { OnTrans(0, y - this->y_); SetTransform(this->y_, y); }
+    void SetZ(float z) { SetTransform(this->z_, z); }
     void SetPosition(float x, float y, float z)
     {
         OnTrans(x - this->x_, y - this->y_);
-        this->x_ = x;
-        this->y_ = y;
-        this->z_ = z;
+        SetTransform(this->x_, x);
+        SetTransform(this->y_, y);
+        SetTransform(this->z_, z);
     }
     float GetAngleX() const { return angleX_; }
     float GetAngleY() const { return angleY_; }
     float GetAngleZ() const { return angleZ_; }
-    void SetAngleX(float angleX) { this->angleX_ = angleX; }
-    void SetAngleY(float angleY) { this->angleY_ = angleY; }
-    void SetAngleZ(float angleZ) { this->angleZ_ = angleZ; }
+    void SetAngleX(float angleX) { SetTransform(this->angleX_, angleX); }
+    void SetAngleY(float angleY) { SetTransform(this->angleY_, angleY); }
+    void SetAngleZ(float angleZ) { SetTransform(this->angleZ_, angleZ); }
     void SetAngleXYZ(float angleX, float angleY, float angleZ)
     {
-        this->angleX_ = angleX;
-        this->angleY_ = angleY;
-        this->angleZ_ = angleZ;
+        SetTransform(this->angleX_, angleX);
+        SetTransform(this->angleY_, angleY);
+        SetTransform(this->angleZ_, angleZ);
     }
     float GetScaleX() const { return scaleX_; }
     float GetScaleY() const { return scaleY_; }
     float GetScaleZ() const { return scaleZ_; }
-    void SetScaleX(float scaleX) { this->scaleX_ = scaleX; }
-    void SetScaleY(float scaleY) { this->scaleY_ = scaleY; }
-    void SetScaleZ(float scaleZ) { this->scaleZ_ = scaleZ; }
+    void SetScaleX(float scaleX) { SetTransform(this->scaleX_, scaleX); }
+    void SetScaleY(float scaleY) { SetTransform(this->scaleY_, scaleY); }
+    void SetScaleZ(float scaleZ) { SetTransform(this->scaleZ_, scaleZ); }
     void SetScaleXYZ(float scaleX, float scaleY, float scaleZ)
     {
-        this->scaleX_ = scaleX;
-        this->scaleY_ = scaleY;
-        this->scaleZ_ = scaleZ;
+        SetTransform(this->scaleX_, scaleX);
+        SetTransform(this->scaleY_, scaleY);
+        SetTransform(this->scaleZ_, scaleZ);
     }
+    // 位置、回転、拡大から求めたワールド行列
+    // 値が変わった時だけ再計算する
+    const Matrix4& GetWorldMatrix() const;
     const ColorRGB& GetColor() const { return rgb_; }
     int GetAlpha() const { return alpha_; }
     D3DCOLOR GetD3DCOLOR() const;
@@ -71,7 +95,7 @@ public:
     void SetColorHSV(int h, int s, int v);
     int GetBlendType() const { return blendType_; }
 	int GetFilterType() const { return filterType_; } //FP FILTER
-    void SetBlendType(int t) { blendType_ = t; }
+    void SetBlendType(int t) { blendType_ = t; UpdateRenderBucket(); }
 	void SetFilterType(int t) { filterType_ = t; } //FP FILTER
     bool IsFogEnabled() const { return fogEnable_; }
     void SetFogEnable(bool enable) { fogEnable_ = enable; }
@@ -93,9 +117,20 @@ public:
     void SetShaderTexture(const std::string& name, const std::shared_ptr<RenderTarget>& renderTarget);
 protected:
     NullableSharedPtr<Shader> GetAppliedShader() const;
+    void OnDead() noexcept override;
+    // GetRenderBucketの結果が変わった時に呼ぶ
+    void UpdateRenderBucket();
     // 移動時コールバック
     virtual void OnTrans(float dx, float dy) {}
 private:
+    void SetTransform(float& param, float value)
+    {
+        if (param != value)
+        {
+            param = value;
+            isWorldMatrixDirty_ = true;
+        }
+    }
     bool visibleFlag_;
     int priority_;
     float x_;
@@ -107,6 +142,8 @@ private:
     float scaleX_;
     float scaleY_;
     float scaleZ_;
+    mutable Matrix4 worldMatrix_;
+    mutable bool isWorldMatrixDirty_;
     ColorRGB rgb_;
     int alpha_;
     int blendType_;
@@ -115,7 +152,10 @@ private:
     bool zWriteEnable_;
     bool zTestEnable_;
     bool permitCamera_;
-    std::list<std::weak_ptr<ObjRender>>::iterator posInLayer_;
+    ObjectLayerList* layerList_;
+    int renderBucket_;
+    size_t posInBucket_;
+    uint64_t layerSeq_;
     NullableSharedPtr<Shader> shader_;
     friend class ObjectLayerList;
 };
@@ -144,7 +184,13 @@ public:
     ObjectLayerList();
     ~ObjectLayerList();
     void SetRenderPriority(const std::shared_ptr<ObjRender>& obj, int p);
+    void UpdateRenderBucket(ObjRender* obj);
     void RenderLayer(int priority, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer);
+    // レイヤーごとに並列に描画命令を記録する
+    // 記録中はRendererの行列やシザー矩形を変更しないこと
+    void RecordLayers(const std::vector<int>& priorities, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer);
+    // RecordLayersで記録した描画命令を描画する, 結果はRenderLayerと同じになる
+    void SubmitLayer(int priority, const std::shared_ptr<Renderer>& renderer);
     void SetLayerShader(int beginPriority, int endPriority, const std::shared_ptr<Shader>& shader);
     void ResetLayerShader(int beginPriority, int endPriority);
     NullableSharedPtr<Shader> GetLayerShader(int p) const;
@@ -161,8 +207,25 @@ public:
     void SetInvalidRenderPriority(int min, int max);
     void ClearInvalidRenderPriority();
 private:
-    void Remove(const std::shared_ptr<ObjRender>& obj);
-    std::array<std::list<std::weak_ptr<ObjRender>>, MAX_RENDER_PRIORITY + 1> layers_;
+    struct LayerEntry
+    {
+        ObjRender* obj; // 削除済みならnullptr
+        uint64_t seq; // レイヤーへの追加順
+    };
+    struct Layer
+    {
+        std::array<std::vector<LayerEntry>, RENDER_BUCKET_COUNT> buckets;
+        std::array<size_t, RENDER_BUCKET_COUNT> removedCounts;
+        RenderCommandList commands;
+    };
+    void Remove(ObjRender* obj);
+    void InsertToBucket(ObjRender* obj, int bucketIdx);
+    void RemoveFromBucket(ObjRender* obj);
+    void CompactBucket(Layer& layer, int bucketIdx);
+    // recordTargetを指定した場合, 記録できないオブジェクトは呼び出しを記録する
+    void RenderObjects(Layer& layer, bool ignoreStgSceneObj, bool checkVisibleFlag, const std::shared_ptr<Renderer>& renderer, RenderCommandList* recordTarget);
+    std::array<Layer, MAX_RENDER_PRIORITY + 1> layers_;
+    uint64_t layerSeqGen_;
     std::array<std::shared_ptr<Shader>, MAX_RENDER_PRIORITY + 1> layerShaders_;
     int shotRenderPriority_;
     int itemRenderPriority_;
@@ -171,5 +234,6 @@ private:
     int stgFrameRenderPriorityMax_;
     int invalidRenderPriorityMin_;
     int invalidRenderPriorityMax_;
+    friend class ObjRender;
 };
 }
\ No newline at end of file
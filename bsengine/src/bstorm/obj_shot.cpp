@@ -17,6 +17,7 @@
 #include <bstorm/package.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <d3dx9.h>
 
 namespace bstorm
@@ -136,6 +137,7 @@ void ObjShot::Update()
 
 void ObjShot::OnDead() noexcept
 {
+    ObjRender::OnDead();
     if (auto package = GetPackage().lock())
     {
         for (auto& addedShot : addedShots_)
@@ -205,9 +207,9 @@ void ObjShot::Render(const std::shared_ptr<Renderer>& renderer)
 				}
 
 				color = GetColor().ToD3DCOLOR((int)(fadeAlpha * std::min(shotData_->alpha, GetAlpha())));
-				D3DXMATRIX world = CreateScaleRotTransMatrix(GetX(), GetY(), 0.0f, GetAngleX(), GetAngleY(), GetAngleZ() + ((IsFadeDeleteStarted() && !shotData_->fixedAngle) ? fadeRandB_ : shotData_->fixedAngle ? 0.0f : GetAngle() + 90.0f), IsFadeDeleteStarted() ? fadeScale : GetScaleX(), IsFadeDeleteStarted() ? fadeScale : GetScaleY(), 1.0f);
-				auto vertices = GetRectVertices(color, shotData_->texture->GetWidth(), shotData_->texture->GetHeight(), IsDelay() ? shotData_->delayRect : (animationIdx_ >= 0 && animationIdx_ < shotData_->animationData.size()) ? shotData_->animationData[animationIdx_].rect : (IsFadeDeleteStarted() && !shotData_->useSelfFadeRect) ? shotData_->fadeRect : shotData_->rect );
-				renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData_->texture->GetTexture(), shotBlend, shotFilter, world, GetAppliedShader(), IsPermitCamera(), true);
+				const D3DXMATRIX world = ToD3DXMatrix(renderWorldMatrix_.Get(GetX(), GetY(), 0.0f, GetAngleX(), GetAngleY(), GetAngleZ() + ((IsFadeDeleteStarted() && !shotData_->fixedAngle) ? fadeRandB_ : shotData_->fixedAngle ? 0.0f : GetAngle() + 90.0f), IsFadeDeleteStarted() ? fadeScale : GetScaleX(), IsFadeDeleteStarted() ? fadeScale : GetScaleY(), 1.0f));
+				auto vertices = GetRectVertices(color, shotData_->renderTexture->GetWidth(), shotData_->renderTexture->GetHeight(), shotData_->atlasRegion.Remap(IsDelay() ? shotData_->delayRect : (animationIdx_ >= 0 && animationIdx_ < shotData_->animationData.size()) ? shotData_->animationData[animationIdx_].rect : (IsFadeDeleteStarted() && !shotData_->useSelfFadeRect) ? shotData_->fadeRect : shotData_->rect));
+				renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData_->renderTexture->GetTexture(), shotBlend, shotFilter, world, GetAppliedShader(), IsPermitCamera(), true, shotData_->texture->GetTexture());
 			}
 			else
 			{
@@ -237,9 +239,9 @@ void ObjShot::Render(const std::shared_ptr<Renderer>& renderer)
 
 				color = GetColor().ToD3DCOLOR((int)(delayAlpha));
 
-				D3DXMATRIX world = CreateScaleRotTransMatrix(GetX(), GetY(), 0.0f,
+				const D3DXMATRIX world = ToD3DXMatrix(renderWorldMatrix_.Get(GetX(), GetY(), 0.0f,
 					GetAngleX(), GetAngleY(), (shotData_->useSelfDelayRect && !shotData_->fixedAngle) ? GetAngle() + 90.0f : GetAngle(),
-					IsDelay() ? delayScale : GetScaleX(), IsDelay() ? delayScale : GetScaleY(), 1.0f);
+					IsDelay() ? delayScale : GetScaleX(), IsDelay() ? delayScale : GetScaleY(), 1.0f));
 
 				// NOTE: Interpret ADD_RGB as ADD_ARGB
 				if (GetBlendType() == BLEND_NONE && shotBlend == BLEND_ADD_RGB)
@@ -247,15 +249,74 @@ void ObjShot::Render(const std::shared_ptr<Renderer>& renderer)
 					shotBlend = BLEND_ADD_ARGB;
 				}
 
-				auto vertices = GetRectVertices(color, shotData_->texture->GetWidth(), shotData_->texture->GetHeight(), shotData_->useSelfDelayRect ? shotData_->rect : shotData_->delayRect);
+				auto vertices = GetRectVertices(color, shotData_->renderTexture->GetWidth(), shotData_->renderTexture->GetHeight(), shotData_->atlasRegion.Remap(shotData_->useSelfDelayRect ? shotData_->rect : shotData_->delayRect));
 
-				renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData_->texture->GetTexture(), shotBlend, shotFilter, world, GetAppliedShader(), IsPermitCamera(), true);
+				renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData_->renderTexture->GetTexture(), shotBlend, shotFilter, world, GetAppliedShader(), IsPermitCamera(), true, shotData_->texture->GetTexture());
 			}
         }
         RenderIntersection(renderer);
     }
 }
 
+int ObjShot::GetRenderBucket() const
+{
+    if (!shotData_) return RENDER_BUCKET_HIDDEN;
+    int blendType;
+    if (!IsDelay())
+    {
+        blendType = GetBlendType();
+        if (blendType == BLEND_NONE)
+        {
+            blendType = shotData_->render;
+        }
+    } else
+    {
+        blendType = GetSourceBlendType();
+        if (blendType == BLEND_NONE)
+        {
+            blendType = shotData_->delayRender;
+        }
+    }
+    switch (blendType)
+    {
+        case BLEND_ALPHA:
+            return RENDER_BUCKET_ALPHA;
+        case BLEND_ADD_RGB:
+        case BLEND_ADD_ARGB:
+            return RENDER_BUCKET_ADD;
+        case BLEND_MULTIPLY:
+            return RENDER_BUCKET_MULTIPLY;
+        case BLEND_SUBTRACT:
+            return RENDER_BUCKET_SUBTRACT;
+        case BLEND_INV_DESTRGB:
+            return RENDER_BUCKET_INV_DESTRGB;
+    }
+    return RENDER_BUCKET_HIDDEN;
+}
+
+bool ObjShot::GetRenderBounds2D(Rect<float>* bounds) const
+{
+    if (!shotData_) return false;
+    // 消去エフェクトは弾の位置以外にも描画するので対象外
+    if (IsFadeDeleteStarted()) return false;
+
+    const Rect<int>* rect;
+    float scale;
+    if (IsDelay())
+    {
+        rect = shotData_->useSelfDelayRect ? &shotData_->rect : &shotData_->delayRect;
+        scale = std::max(std::abs(shotData_->delayData.vA), std::abs(shotData_->delayData.vB));
+    } else
+    {
+        rect = (animationIdx_ >= 0 && animationIdx_ < shotData_->animationData.size()) ? &shotData_->animationData[animationIdx_].rect : &shotData_->rect;
+        scale = std::max(std::abs(GetScaleX()), std::abs(GetScaleY()));
+    }
+    // 回転しても収まるように対角線の半分を使う
+    const float r = 0.5f * std::hypot((float)(rect->right - rect->left), (float)(rect->bottom - rect->top)) * scale;
+    *bounds = Rect<float>(GetX() - r, GetY() - r, GetX() + r, GetY() + r);
+    return true;
+}
+
 void ObjShot::FadeExDraw(const std::shared_ptr<Renderer>& renderer)
 {
 	// ----- Fade Delete Extra Sprite -----
@@ -279,8 +340,8 @@ void ObjShot::FadeExDraw(const std::shared_ptr<Renderer>& renderer)
 
 	D3DCOLOR colorFade = GetColor().ToD3DCOLOR((int)(fadeAlphaSub));
 	D3DXMATRIX worldF = CreateScaleRotTransMatrix(fadeX_ + fadeXOff, fadeY_ - fadeYOff, 0.0f, GetAngleX(), GetAngleY(), fadeRandA_, fadeScaleSub, fadeScaleSub, 1.0f);
-	auto verticesF = GetRectVertices(colorFade, shotData_->texture->GetWidth(), shotData_->texture->GetHeight(), shotData_->fadeRect);
-	renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, verticesF.data(), shotData_->texture->GetTexture(), BLEND_ADD_ARGB, FILTER_LINEAR, worldF, GetAppliedShader(), IsPermitCamera(), true);
+	auto verticesF = GetRectVertices(colorFade, shotData_->renderTexture->GetWidth(), shotData_->renderTexture->GetHeight(), shotData_->atlasRegion.Remap(shotData_->fadeRect));
+	renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, verticesF.data(), shotData_->renderTexture->GetTexture(), BLEND_ADD_ARGB, FILTER_LINEAR, worldF, GetAppliedShader(), IsPermitCamera(), true, shotData_->texture->GetTexture());
 }
 
 double ObjShot::GetDamage() const
@@ -302,7 +363,12 @@ int ObjShot::GetDelay() const
     return delayTimer_;
 }
 
-void ObjShot::SetDelay(int delay) { delayTimer_ = std::max(delay, 0); delayCounter_ = 0; }
+void ObjShot::SetDelay(int delay)
+{
+    delayTimer_ = std::max(delay, 0);
+    delayCounter_ = 0;
+    UpdateRenderBucket();
+}
 
 bool ObjShot::IsDelay() const
 {
@@ -317,6 +383,7 @@ int ObjShot::GetSourceBlendType() const
 void ObjShot::SetSourceBlendType(int blendType)
 {
     sourceBlendType_ = blendType;
+    UpdateRenderBucket();
 }
 
 float ObjShot::GetInitX() const
@@ -509,6 +576,7 @@ void ObjShot::SetShotData(const std::shared_ptr<ShotData>& data)
                 }
             }
         }
+        UpdateRenderBucket();
     }
 }
 
@@ -747,10 +815,15 @@ void ObjShot::UpdateAnimationPosition()
 
 void ObjShot::TickDelayTimer()
 {
+    bool wasDelay = IsDelay();
     delayTimer_ = std::max(0, delayTimer_ - 1);
 	if(IsDelay())
 	{
 		delayCounter_++;
+	} else if (wasDelay)
+	{
+		// 遅延終了で描画バケツが変わる
+		UpdateRenderBucket();
 	}
 }
 
@@ -912,6 +985,7 @@ ObjLaser::ObjLaser(bool isPlayerShot, bool isECLShot, const std::shared_ptr<Coll
 void ObjLaser::SetShotData(const std::shared_ptr<ShotData>& shotData)
 {
     this->shotData_ = shotData;
+    UpdateRenderBucket();
 }
 
 bool ObjLaser::IsGrazeEnabled() const
@@ -1171,14 +1245,14 @@ void ObjLooseLaser::RenderLaser(float width, float length, float angle, const st
 
         // 色と透明度を設定
         D3DCOLOR color = GetColor().ToD3DCOLOR((int)(GetFadeScale() * std::min(shotData->alpha, GetAlpha())));
-        auto vertices = GetRectVertices(color, shotData->texture->GetWidth(), shotData->texture->GetHeight(), (GetAnimationIndex() >= 0 && GetAnimationIndex() < shotData->animationData.size()) ? shotData->animationData[GetAnimationIndex()].rect : shotData->rect);
+        auto vertices = GetRectVertices(color, shotData->renderTexture->GetWidth(), shotData->renderTexture->GetHeight(), shotData->atlasRegion.Remap((GetAnimationIndex() >= 0 && GetAnimationIndex() < shotData->animationData.size()) ? shotData->animationData[GetAnimationIndex()].rect : shotData->rect));
 
         /* 配置 */
         float rectWidth = abs(vertices[0].x - vertices[1].x);
         float rectHeight = abs(vertices[0].y - vertices[2].y);
-        D3DXMATRIX world = CreateScaleRotTransMatrix(centerX, centerY, 0.0f, 0.0f, 0.0f, angle + 90.0f, width / rectWidth, length / rectHeight, 1.0f);
+        const D3DXMATRIX world = ToD3DXMatrix(renderWorldMatrix_.Get(centerX, centerY, 0.0f, 0.0f, 0.0f, angle + 90.0f, width / rectWidth, length / rectHeight, 1.0f));
 
-        renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData->texture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false);
+        renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData->renderTexture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false, shotData->texture->GetTexture());
     }
 }
 
@@ -1233,22 +1307,22 @@ void ObjStLaser::Render(const std::shared_ptr<Renderer>& renderer)
             if (laserSourceEnable_ && !IsFadeDeleteStarted())
             {
                 // レーザー源の描画
-                auto vertices = GetRectVertices(shotData->delayColor.ToD3DCOLOR(0xff), shotData->texture->GetWidth(), shotData->texture->GetHeight(), shotData->delayRect);
+                auto vertices = GetRectVertices(shotData->delayColor.ToD3DCOLOR(0xff), shotData->renderTexture->GetWidth(), shotData->renderTexture->GetHeight(), shotData->atlasRegion.Remap(shotData->delayRect));
 
                 /* 配置 */
                 const Point2D head = GetHead();
                 float rectWidth = abs(vertices[0].x - vertices[1].x);
                 float rectHeight = abs(vertices[0].y - vertices[2].y);
                 float renderWidth = GetRenderWidth() * 1.3125f; // レーザーの幅よりちょっと大きい
-                auto world = CreateScaleRotTransMatrix(head.x, head.y, 0.0f,
-                                                       0.0f, 0.0f, GetLaserAngle() - 90.0f,
-                                                       renderWidth / rectWidth, renderWidth / rectHeight, 1.0f);
+                const auto world = ToD3DXMatrix(sourceWorldMatrix_.Get(head.x, head.y, 0.0f,
+                                                                       0.0f, 0.0f, GetLaserAngle() - 90.0f,
+                                                                       renderWidth / rectWidth, renderWidth / rectHeight, 1.0f));
 
                 /* ブレンド方法の選択 */
                 // NOTE :  delay_renderは使用しない
                 int laserBlend = GetSourceBlendType() == BLEND_NONE ? BLEND_ADD_ARGB : GetSourceBlendType();
                 int laserFilter = GetFilterType(); //FP FILTER
-                renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData->texture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false);
+                renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), shotData->renderTexture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false, shotData->texture->GetTexture());
             }
             // 遅延時間時は予告線
             float renderWidth = IsDelay() ? GetRenderWidth() / 20.0f : GetRenderWidth() * laserWidthScale_;
@@ -1351,7 +1425,7 @@ void ObjCrLaser::Render(const std::shared_ptr<Renderer>& renderer)
             } else
             {
                 // uv算出用
-                auto laserRect = GetRectVertices(0, shotData->texture->GetWidth(), shotData->texture->GetHeight(), (GetAnimationIndex() >= 0 && GetAnimationIndex() < shotData->animationData.size()) ? shotData->animationData[GetAnimationIndex()].rect : shotData->rect);
+                auto laserRect = GetRectVertices(0, shotData->renderTexture->GetWidth(), shotData->renderTexture->GetHeight(), shotData->atlasRegion.Remap((GetAnimationIndex() >= 0 && GetAnimationIndex() < shotData->animationData.size()) ? shotData->animationData[GetAnimationIndex()].rect : shotData->rect));
 
                 // trailに色、UV値をセットする
                 // レーザー中心の透明度
@@ -1384,7 +1458,7 @@ void ObjCrLaser::Render(const std::shared_ptr<Renderer>& renderer)
                 // ShotDataのrender値は使わない
                 int laserBlend = GetBlendType() == BLEND_NONE ? BLEND_ADD_ARGB : GetBlendType();
                 int laserFilter = GetFilterType(); //FP FILTER
-                renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, trail_.size() - tailPos_, &trail_[tailPos_], shotData->texture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false);
+                renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, trail_.size() - tailPos_, &trail_[tailPos_], shotData->renderTexture->GetTexture(), laserBlend, laserFilter, world, GetAppliedShader(), IsPermitCamera(), false, shotData->texture->GetTexture());
             }
         }
     }
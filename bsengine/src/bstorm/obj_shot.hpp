@@ -30,6 +30,8 @@ public:
     void Update() override;
     void OnDead() noexcept override;
     void Render(const std::shared_ptr<Renderer>& renderer) override;
+    int GetRenderBucket() const override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override;
 
     bool IsRegistered() const;
     void Regist();
@@ -137,6 +139,8 @@ protected:
     NullableSharedPtr<ShotData> shotData_;
     bool isGrazeInvalid_;
     bool isTempIntersectionMode_;
+    // 弾本体の描画に使うワールド行列, 向きや消滅時の拡大率が変わった時だけ計算し直す
+    ScaleRotTransMatrixCache renderWorldMatrix_;
 private:
     void AddIntersection(const std::shared_ptr<ShotIntersection>& isect);
     void AddTempIntersection(const std::shared_ptr<ShotIntersection>& isect);
@@ -188,6 +192,7 @@ class ObjLaser : public ObjShot
 public:
     ObjLaser(bool isPlayerShot, bool isECLShot, const std::shared_ptr<CollisionDetector>& colDetector, const std::shared_ptr<Package>& package);
     void SetShotData(const std::shared_ptr<ShotData>& shotData) override;
+    bool GetRenderBounds2D(Rect<float>* bounds) const override { return false; }
     void Graze() override;
     bool IsGrazeEnabled() const override;
     float GetLength() const;
@@ -256,6 +261,7 @@ private:
     float laserAngle_;
     bool laserSourceEnable_;
     float laserWidthScale_;
+    ScaleRotTransMatrixCache sourceWorldMatrix_;
 };
 
 class ObjCrLaser : public ObjLaser
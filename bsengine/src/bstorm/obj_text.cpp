@@ -34,7 +34,8 @@ ObjText::ObjText(const std::shared_ptr<Package>& state) :
     autoTransCenterEnable_(true),
     horizontalAlignment_(ALIGNMENT_LEFT),
     syntacticAnalysisEnable_(true),
-    isFontParamModified_(true)
+    isFontParamModified_(true),
+    isLayoutModified_(true)
 {
     SetType(OBJ_TEXT);
 }
@@ -74,6 +75,7 @@ void ObjText::GenerateFonts()
             }
         }
         isFontParamModified_ = false;
+        isLayoutModified_ = true;
     }
 }
 
@@ -90,20 +92,129 @@ int ObjText::GetNextLineOffsetY() const
     return font->GetNextLineOffsetY() + linePitch_;
 }
 
-void ObjText::RenderFont(const std::shared_ptr<Font>& font, const D3DXMATRIX& world, const std::shared_ptr<Renderer>& renderer)
+const ObjText::TextLayout& ObjText::GetLayout() const
 {
-    std::array<Vertex, 4> vertices;
-    D3DCOLOR color = GetD3DCOLOR();
-    for (auto& vertex : vertices) { vertex.color = color; }
-    vertices[1].u = vertices[3].u = 1.0f * font->GetWidth() / font->GetTextureWidth();
-    vertices[2].v = vertices[3].v = 1.0f * font->GetHeight() / font->GetTextureHeight();
+    if (isLayoutModified_)
+    {
+        UpdateLayout();
+        isLayoutModified_ = false;
+    }
+    return layout_;
+}
+
+void ObjText::UpdateLayout() const
+{
+    layout_.lineLengths = CalcLineLengths();
+    layout_.totalWidth = 0;
+    layout_.totalHeight = 0;
+    layout_.color = GetD3DCOLOR();
+    layout_.batches.clear();
+
+    int idx = 0;
+    float lineY = 0; // 現在の行のy座標
+    const int nextLineOffsetY = GetNextLineOffsetY();
+    auto ruby = rubyFonts_.begin();
+    for (auto cnt : layout_.lineLengths)
+    { // 行ごとの文字数を取得
+        float colX = 0; // 現在の列のx座標
+        if (cnt != 0)
+        {
+            if (!bodyFonts_[idx]) idx++;
+            int lineBodyWidth = 0;
+            for (int k = 0; k < cnt; k++)
+            {
+                lineBodyWidth += bodyFonts_[idx + k]->GetRightCharOffsetX() + sidePitch_;
+            }
+            if (borderType_ != BORDER_NONE)
+            {
+                lineBodyWidth += borderWidth_;
+            }
+            layout_.totalWidth = std::max(layout_.totalWidth, lineBodyWidth);
+            // alignment
+            if (horizontalAlignment_ == ALIGNMENT_RIGHT)
+            {
+                colX += maxWidth_ - lineBodyWidth;
+            } else if (horizontalAlignment_ == ALIGNMENT_CENTER)
+            {
+                colX += (maxWidth_ - lineBodyWidth) / 2;
+            }
+            for (int k = 0; k < cnt; k++)
+            {
+                const auto& bodyFont = bodyFonts_[idx];
+                AddGlyph(bodyFont, colX + bodyFont->GetPrintOffsetX(), lineY + bodyFont->GetPrintOffsetY(), layout_.color);
+                if (ruby != rubyFonts_.end())
+                {
+                    if (ruby->begin == idx)
+                    {
+                        if (!ruby->text.empty())
+                        {
+                            int bodyWidth = 0;
+                            for (int i = ruby->begin; i < ruby->end && i < bodyFonts_.size(); i++)
+                            {
+                                if (bodyFonts_[i])
+                                {
+                                    bodyWidth += bodyFonts_[i]->GetRightCharOffsetX() + sidePitch_;
+                                }
+                            }
+                            int rubyOffsetSum = 0;
+                            for (auto& font : ruby->text)
+                            {
+                                rubyOffsetSum += font->GetRightCharOffsetX();
+                            }
+                            const int rubySidePitch = std::max(0, (bodyWidth - rubyOffsetSum)) / (ruby->text.size());
+                            const int rubyY = lineY - ruby->text[0]->GetNextLineOffsetY();
+                            float rubyX = colX;
+                            for (const auto& rubyFont : ruby->text)
+                            {
+                                AddGlyph(rubyFont, rubyX + rubyFont->GetPrintOffsetX(), rubyY + rubyFont->GetPrintOffsetY(), layout_.color);
+                                rubyX += rubyFont->GetRightCharOffsetX() + rubySidePitch;
+                            }
+                        }
+                        ruby++;
+                    }
+                }
+                colX += bodyFont->GetRightCharOffsetX() + sidePitch_; // 文字の間隔空け
+                idx++;
+            }
+        } else idx++;
+        lineY += nextLineOffsetY; // 行の間隔空け
+    }
 
-    vertices[0].x = vertices[2].x = 0;
-    vertices[0].y = vertices[1].y = 0;
-    vertices[1].x = vertices[3].x = font->GetWidth();
-    vertices[2].y = vertices[3].y = font->GetHeight();
+    if (!bodyFonts_.empty())
+    {
+        const int lineCnt = layout_.lineLengths.size();
+        layout_.totalHeight = lineCnt * nextLineOffsetY - linePitch_;
+        if (borderType_ != BORDER_NONE) layout_.totalHeight += borderWidth_;
+    }
+}
 
-    renderer->RenderPrim2D(D3DPT_TRIANGLESTRIP, 4, vertices.data(), font->GetTexture(), GetBlendType(), GetFilterType(), world, GetAppliedShader(), IsPermitCamera(), true);
+void ObjText::AddGlyph(const std::shared_ptr<Font>& font, float x, float y, D3DCOLOR color) const
+{
+    // ページが変わったら新しいバッチにする
+    if (layout_.batches.empty() || layout_.batches.back().texture != font->GetTexture())
+    {
+        layout_.batches.push_back(GlyphBatch{ font->GetTexture(), std::vector<Vertex>() });
+    }
+    auto& vertices = layout_.batches.back().vertices;
+
+    const AtlasRegion& region = font->GetRegion();
+    const float texWidth = font->GetTextureWidth();
+    const float texHeight = font->GetTextureHeight();
+    const float ul = region.x / texWidth;
+    const float vt = region.y / texHeight;
+    const float ur = (region.x + font->GetWidth()) / texWidth;
+    const float vb = (region.y + font->GetHeight()) / texHeight;
+    const float l = x;
+    const float t = y;
+    const float r = x + font->GetWidth();
+    const float b = y + font->GetHeight();
+
+    vertices.emplace_back(l, t, 0.0f, color, ul, vt);
+    vertices.emplace_back(r, t, 0.0f, color, ur, vt);
+    vertices.emplace_back(l, b, 0.0f, color, ul, vb);
+    vertices.emplace_back(r, t, 0.0f, color, ur, vt);
+    vertices.emplace_back(r, b, 0.0f, color, ur, vb);
+    vertices.emplace_back(l, b, 0.0f, color, ul, vb);
 }
 
 void ObjText::SetText(const std::wstring& t)
@@ -225,11 +336,25 @@ int ObjText::GetLinePitch() const
     return linePitch_;
 }
 
+void ObjText::SetLinePitch(int pitch)
+{
+    if (linePitch_ == pitch) return;
+    linePitch_ = pitch;
+    isLayoutModified_ = true;
+}
+
 int ObjText::GetSidePitch() const
 {
     return sidePitch_;
 }
 
+void ObjText::SetSidePitch(int pitch)
+{
+    if (sidePitch_ == pitch) return;
+    sidePitch_ = pitch;
+    isLayoutModified_ = true;
+}
+
 bool ObjText::IsAutoTransCenterEnabled() const
 {
     return autoTransCenterEnable_;
@@ -256,7 +381,9 @@ int ObjText::GetHorizontalAlignment() const
 
 void ObjText::SetHorizontalAlignment(int alignmentType)
 {
+    if (horizontalAlignment_ == alignmentType) return;
     horizontalAlignment_ = alignmentType;
+    isLayoutModified_ = true;
 }
 
 float ObjText::GetTransCenterX() const
@@ -274,6 +401,13 @@ int ObjText::GetMaxWidth() const
     return maxWidth_;
 }
 
+void ObjText::SetMaxWidth(int w)
+{
+    if (maxWidth_ == w) return;
+    maxWidth_ = w;
+    isLayoutModified_ = true;
+}
+
 int ObjText::GetMaxHeight() const
 {
     return maxHeight_;
@@ -284,84 +418,27 @@ void ObjText::Render(const std::shared_ptr<Renderer>& renderer)
     if (auto package = GetPackage().lock())
     {
         GenerateFonts();
-        int idx = 0;
-        float lineY = GetY(); // 現在の行のy座標
-        const int centerX = GetX() + (autoTransCenterEnable_ ? std::max(0, (GetTotalWidth() - sidePitch_) / 2) : transCenterX_);
-        const int centerY = GetY() + (autoTransCenterEnable_ ? GetTotalHeight() / 2 + (borderType_ != BORDER_NONE ? borderWidth_ / 2 : 0) : transCenterY_);
-        const int nextLineOffsetY = GetNextLineOffsetY();
-        auto ruby = rubyFonts_.begin();
-        for (auto cnt : GetTextLengthCUL())
-        { // 行ごとの文字数を取得
-            float colX = GetX(); // 現在の列のx座標
-            if (cnt != 0)
+        const TextLayout& layout = GetLayout();
+        if (layout.batches.empty()) return;
+
+        const D3DCOLOR color = GetD3DCOLOR();
+        if (layout_.color != color)
+        {
+            for (auto& batch : layout_.batches)
             {
-                if (!bodyFonts_[idx]) idx++;
-                if (horizontalAlignment_ != ALIGNMENT_LEFT)
-                {
-                    // alignment
-                    int lineBodyWidth = 0;
-                    for (int k = 0; k < cnt; k++)
-                    {
-                        lineBodyWidth += bodyFonts_[idx + k]->GetRightCharOffsetX() + sidePitch_;
-                    }
-                    if (borderType_ != BORDER_NONE)
-                    {
-                        lineBodyWidth += borderWidth_;
-                    }
-                    if (horizontalAlignment_ == ALIGNMENT_RIGHT)
-                    {
-                        colX += maxWidth_ - lineBodyWidth;
-                    } else if (horizontalAlignment_ == ALIGNMENT_CENTER)
-                    {
-                        colX += (maxWidth_ - lineBodyWidth) / 2;
-                    }
-                }
-                for (int k = 0; k < cnt; k++)
-                {
-                    auto bodyFont = bodyFonts_[idx];
-                    // 初めに中心座標を原点に持ってきてから拡大・回転したのち元の位置に戻す
-                    D3DXMATRIX trans = CreateScaleRotTransMatrix(colX + bodyFont->GetPrintOffsetX() - centerX, lineY + bodyFont->GetPrintOffsetY() - centerY, GetZ(), 0, 0, 0, 1, 1, 1);
-                    D3DXMATRIX scaleRot = CreateScaleRotTransMatrix(centerX, centerY, 0, GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX(), GetScaleY(), GetScaleZ());
-                    D3DXMATRIX world = trans * scaleRot;
-                    RenderFont(bodyFont, world, renderer);
-                    if (ruby != rubyFonts_.end())
-                    {
-                        if (ruby->begin == idx)
-                        {
-                            if (!ruby->text.empty())
-                            {
-                                int bodyWidth = 0;
-                                for (int i = ruby->begin; i < ruby->end && i < bodyFonts_.size(); i++)
-                                {
-                                    if (bodyFonts_[i])
-                                    {
-                                        bodyWidth += bodyFonts_[i]->GetRightCharOffsetX() + sidePitch_;
-                                    }
-                                }
-                                int rubyOffsetSum = 0;
-                                for (auto& font : ruby->text)
-                                {
-                                    rubyOffsetSum += font->GetRightCharOffsetX();
-                                }
-                                const int rubySidePitch = std::max(0, (bodyWidth - rubyOffsetSum)) / (ruby->text.size());
-                                const int rubyY = lineY - ruby->text[0]->GetNextLineOffsetY();
-                                float rubyX = colX;
-                                for (auto rubyFont : ruby->text)
-                                {
-                                    D3DXMATRIX trans = CreateScaleRotTransMatrix(rubyX + rubyFont->GetPrintOffsetX() - centerX, rubyY + rubyFont->GetPrintOffsetY() - centerY, GetZ(), 0, 0, 0, 1, 1, 1);
-                                    D3DXMATRIX world = trans * scaleRot;
-                                    RenderFont(rubyFont, world, renderer);
-                                    rubyX += rubyFont->GetRightCharOffsetX() + rubySidePitch;
-                                }
-                            }
-                            ruby++;
-                        }
-                    }
-                    colX += bodyFont->GetRightCharOffsetX() + sidePitch_; // 文字の間隔空け
-                    idx++;
-                }
-            } else idx++;
-            lineY += nextLineOffsetY; // 行の間隔空け
+                for (auto& vertex : batch.vertices) { vertex.color = color; }
+            }
+            layout_.color = color;
+        }
+
+        const int centerX = GetX() + (autoTransCenterEnable_ ? std::max(0, (layout.totalWidth - sidePitch_) / 2) : transCenterX_);
+        const int centerY = GetY() + (autoTransCenterEnable_ ? layout.totalHeight / 2 + (borderType_ != BORDER_NONE ? borderWidth_ / 2 : 0) : transCenterY_);
+        // 初めに中心座標を原点に持ってきてから拡大・回転したのち元の位置に戻す
+        const Matrix4& scaleRot = scaleRotMatrix_.Get(centerX, centerY, 0, GetAngleX(), GetAngleY(), GetAngleZ(), GetScaleX(), GetScaleY(), GetScaleZ());
+        const D3DXMATRIX world = ToD3DXMatrix(TransMatrix4(GetX() - centerX, GetY() - centerY, GetZ()) * scaleRot);
+        for (const auto& batch : layout.batches)
+        {
+            renderer->RenderPrim2D(D3DPT_TRIANGLELIST, batch.vertices.size(), batch.vertices.data(), batch.texture, GetBlendType(), GetFilterType(), world, GetAppliedShader(), IsPermitCamera(), true);
         }
     }
 }
@@ -373,42 +450,12 @@ const std::wstring & ObjText::GetText() const
 
 int ObjText::GetTotalWidth() const
 {
-    int idx = 0;
-    int maxTotalWidth = 0;
-    for (auto cnt : GetTextLengthCUL())
-    {
-        int totalWidth = 0;
-        if (cnt != 0)
-        {
-            if (!bodyFonts_[idx]) idx++;
-            for (int k = 0; k < cnt; k++)
-            {
-                totalWidth += bodyFonts_[idx]->GetRightCharOffsetX() + sidePitch_;
-                idx++;
-            }
-            if (borderType_ != BORDER_NONE)
-            {
-                totalWidth += borderWidth_;
-            }
-            maxTotalWidth = std::max(maxTotalWidth, totalWidth);
-        } else idx++;
-    }
-    return maxTotalWidth;
+    return GetLayout().totalWidth;
 }
 
 int ObjText::GetTotalHeight() const
 {
-    if (bodyFonts_.empty())
-    {
-        return 0;
-    } else
-    {
-        int lineCnt = GetTextLengthCUL().size(); // 行数
-        // NULLでないフォントを探す
-        int h = lineCnt * GetNextLineOffsetY() - linePitch_;
-        if (borderType_ != BORDER_NONE) h += borderWidth_;
-        return h;
-    }
+    return GetLayout().totalHeight;
 }
 
 int ObjText::GetTextLength() const
@@ -441,6 +488,11 @@ int ObjText::GetTextLengthCU() const
 }
 
 std::vector<int> ObjText::GetTextLengthCUL() const
+{
+    return GetLayout().lineLengths;
+}
+
+std::vector<int> ObjText::CalcLineLengths() const
 {
     std::vector<int> cnts;
     int idx = 0;
@@ -2,6 +2,7 @@
 
 #include <bstorm/color_rgb.hpp>
 #include <bstorm/obj_render.hpp>
+#include <bstorm/vertex.hpp>
 
 #include <d3dx9.h>
 
@@ -16,6 +17,8 @@ public:
     ~ObjText();
     void Update() override;
     void Render(const std::shared_ptr<Renderer>& renderer) override;
+    // フォントの生成(GDI)を伴うので描画スレッドでのみ描画する
+    bool IsParallelRenderable() const override { return false; }
     const std::wstring& GetText() const;
     void SetText(const std::wstring& t);
     const std::wstring& GetFontName() const;
@@ -35,9 +38,9 @@ public:
     const ColorRGB& GetFontBorderColor() const;
     void SetFontBorderColor(int r, int g, int b);
     int GetLinePitch() const;
-    void SetLinePitch(int pitch) { linePitch_ = pitch; }
+    void SetLinePitch(int pitch);
     int GetSidePitch() const;
-    void SetSidePitch(int pitch) { sidePitch_ = pitch; }
+    void SetSidePitch(int pitch);
     bool IsAutoTransCenterEnabled() const;
     void SetAutoTransCenter(bool enable) { autoTransCenterEnable_ = enable; }
     bool IsSyntacticAnalysisEnabled() const;
@@ -48,7 +51,7 @@ public:
     float GetTransCenterY() const;
     void SetTransCenter(float x, float y) { transCenterX_ = x; transCenterY_ = y; }
     int GetMaxWidth() const;
-    void SetMaxWidth(int w) { maxWidth_ = w; }
+    void SetMaxWidth(int w);
     int GetMaxHeight() const;
     void SetMaxHeight(int h) { maxHeight_ = h; }
     int GetTotalWidth() const;
@@ -75,8 +78,27 @@ public:
     const std::vector<Ruby<std::vector<std::shared_ptr<Font>>>>& GetRubyFonts() const;
     static void ParseRubiedString(const std::wstring& src, std::wstring& bodyText, std::vector<Ruby<std::wstring>>& rubies);
 private:
+    // 同じページの文字をまとめた頂点列
+    struct GlyphBatch
+    {
+        IDirect3DTexture9* texture;
+        std::vector<Vertex> vertices; // TRIANGLELIST, オブジェクトの位置が原点
+    };
+    // 文字の配置結果
+    // テキスト, フォント, 改行と字間の設定が変わるまで使い回す
+    struct TextLayout
+    {
+        std::vector<int> lineLengths; // 行ごとの文字数
+        int totalWidth;
+        int totalHeight;
+        D3DCOLOR color; // 頂点色
+        std::vector<GlyphBatch> batches;
+    };
     int GetNextLineOffsetY() const;
-    void RenderFont(const std::shared_ptr<Font>& font, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Renderer>& renderer);
+    const TextLayout& GetLayout() const;
+    void UpdateLayout() const;
+    std::vector<int> CalcLineLengths() const;
+    void AddGlyph(const std::shared_ptr<Font>& font, float x, float y, D3DCOLOR color) const;
     std::wstring text_;
     std::wstring bodyText_;
     std::vector<Ruby<std::wstring>> rubies_;
@@ -100,5 +122,9 @@ private:
     bool isFontParamModified_;
     std::vector<NullableSharedPtr<Font>> bodyFonts_;
     std::vector<Ruby<std::vector<std::shared_ptr<Font>>>> rubyFonts_;
+    mutable TextLayout layout_;
+    mutable bool isLayoutModified_;
+    // 中心座標を原点として拡大・回転する行列
+    ScaleRotTransMatrixCache scaleRotMatrix_;
 };
 }
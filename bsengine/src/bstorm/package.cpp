@@ -3,6 +3,7 @@
 #include <bstorm/interpolation.hpp>
 #include <bstorm/file_util.hpp>
 #include <bstorm/math_util.hpp>
+#include <bstorm/dx_util.hpp>
 #include <bstorm/string_util.hpp>
 #include <bstorm/path_const.hpp>
 #include <bstorm/dnh_const.hpp>
@@ -17,6 +18,7 @@
 #include <bstorm/renderer.hpp>
 #include <bstorm/lostable_graphic_resource.hpp>
 #include <bstorm/render_target.hpp>
+#include <bstorm/image_save_queue.hpp>
 #include <bstorm/shader.hpp>
 #include <bstorm/texture.hpp>
 #include <bstorm/font.hpp>
@@ -49,6 +51,7 @@
 #include <bstorm/script.hpp>
 #include <bstorm/replay_data.hpp>
 #include <bstorm/config.hpp>
+#include <bstorm/engine_develop_options.hpp>
 
 #include <exception>
 #include <ctime>
@@ -65,6 +68,9 @@
 
 namespace bstorm
 {
+// 保存待ちの画像の最大数
+constexpr size_t IMAGE_SAVE_QUEUE_CAPACITY = 4;
+
 Package::Package(HWND hWnd,
                  int screenWidth,
                  int screenHeight,
@@ -83,6 +89,7 @@ Package::Package(HWND hWnd,
     fpsCounter_(fpsCounter),
     lostableGraphicResourceManager_(lostableGraphicResourceManager),
     engineDevelopOptions_(engineDevelopOptions),
+    imageSaveQueue_(std::make_shared<ImageSaveQueue>(IMAGE_SAVE_QUEUE_CAPACITY)),
     fileLoader_(std::make_shared<FileLoader>()),
     soundDevice(std::make_shared<SoundDevice>(hWnd)),
     renderer_(std::make_shared<Renderer>(graphicDevice_->GetDevice())),
@@ -155,6 +162,9 @@ void Package::TickFrame()
         return;
     }
 
+    // 前フレームの描画統計を確定
+    renderer_->FlushFrameStats();
+
     if (auto stageMain = stageMainScript_.lock())
     {
         if (stageMain->IsClosed())
@@ -552,7 +562,22 @@ void Package::SaveRenderedTextureA2(const std::wstring & name, const std::wstrin
         auto viewport = renderTarget->GetViewport();
         RECT rect = { left, top, right, bottom };
         MakeDirectoryP(GetParentPath(path));
-        if (SUCCEEDED(D3DXSaveSurfaceToFile(path.c_str(), getProperFileFormat(path), renderTarget->GetSurface(), NULL, &rect)))
+        const auto format = getProperFileFormat(path);
+        if (format == D3DXIFF_PNG || format == D3DXIFF_BMP)
+        {
+            // 読み出しだけ済ませて, エンコードと書き込みは別スレッドで行う
+            try
+            {
+                ImageBGRA image;
+                renderTarget->ReadPixels(left, top, right, bottom, &image);
+                imageSaveQueue_->Push(path, format == D3DXIFF_BMP ? ImageFileFormat::BMP : ImageFileFormat::PNG, std::move(image));
+                return;
+            } catch (Log& log)
+            {
+                log.AddSourcePos(srcPos);
+                Logger::Write(log);
+            }
+        } else if (SUCCEEDED(D3DXSaveSurfaceToFile(path.c_str(), format, renderTarget->GetSurface(), NULL, &rect)))
         {
             return;
         }
@@ -590,6 +615,11 @@ void Package::SaveSnapShotA2(const std::wstring & path, int left, int top, int r
     RemoveRenderTarget(SNAP_SHOT_RENDER_TARGET_NAME, srcPos);
 }
 
+bool Package::IsSaveImageCompleted(const std::wstring & path) const
+{
+    return imageSaveQueue_->IsCompleted(path);
+}
+
 std::shared_ptr<Shader> Package::CreateShader(const std::wstring & path, bool precompiled)
 {
     auto shader = std::make_shared<Shader>(path, precompiled, graphicDevice_->GetDevice());
@@ -1368,10 +1398,19 @@ void Package::GenerateBonusItem(float x, float y)
 
 void Package::GenerateItemScoreText(float x, float y, PlayerScore score)
 {
-    auto& texture = textureStore_->Load(SYSTEM_STG_DIGIT_IMG_PATH);
-    auto scoreText = objTable_->Create<ObjItemScoreText>(score, texture, shared_from_this());
-    objLayerList_->SetRenderPriority(scoreText, objLayerList_->GetItemRenderPriority());
-    scoreText->SetMovePosition(x, y);
+    // 点数表示は1つのオブジェクトにまとめる
+    auto scoreTextObj = itemScoreTextObj_.lock();
+    if (!scoreTextObj || scoreTextObj->IsDead())
+    {
+        auto& texture = textureStore_->Load(SYSTEM_STG_DIGIT_IMG_PATH);
+        scoreTextObj = objTable_->Create<ObjItemScoreText>(texture, shared_from_this());
+        itemScoreTextObj_ = scoreTextObj;
+    }
+    if (scoreTextObj->getRenderPriority() != objLayerList_->GetItemRenderPriority())
+    {
+        objLayerList_->SetRenderPriority(scoreTextObj, objLayerList_->GetItemRenderPriority());
+    }
+    scoreTextObj->AddScoreText(x, y, score);
 }
 
 std::shared_ptr<ObjItem> Package::CreateItemA1(int itemType, float x, float y, PlayerScore score)
@@ -1514,9 +1553,9 @@ std::shared_ptr<Script> Package::LoadScript(const std::wstring & path, ScriptTyp
     return script;
 }
 
-std::shared_ptr<Script> Package::LoadScriptInThread(const std::wstring & path, ScriptType type, const std::wstring & version, const std::shared_ptr<SourcePos>& srcPos)
+std::shared_ptr<Script> Package::LoadScriptInThread(const std::wstring & path, ScriptType type, const std::wstring & version, int compilePriority, const std::shared_ptr<SourcePos>& srcPos)
 {
-    auto script = scriptManager_->CompileInThread(path, type, version, shared_from_this(), srcPos);
+    auto script = scriptManager_->CompileInThread(path, type, version, compilePriority, shared_from_this(), srcPos);
     return script;
 }
 
@@ -1622,6 +1661,13 @@ std::shared_ptr<ObjSpriteList2D> Package::CreateObjSpriteList2D()
     return obj;
 }
 
+std::shared_ptr<ObjParticleList2D> Package::CreateObjParticleList2D()
+{
+    auto obj = objTable_->Create<ObjParticleList2D>(shared_from_this());
+    objLayerList_->SetRenderPriority(obj, 50);
+    return obj;
+}
+
 std::shared_ptr<ObjPrim3D> Package::CreateObjPrim3D()
 {
     auto obj = objTable_->Create<ObjPrim3D>(shared_from_this());
@@ -2200,11 +2246,13 @@ Point2D Package::Get2DPosition(float x, float y, float z, bool isStgScene)
     D3DXVec3TransformCoord(&pos, &pos, &(view * proj * viewport));
     if (isStgScene)
     {
-        camera2D_->GenerateViewMatrix(&view);
-        camera2D_->GenerateProjMatrix(&proj, GetScreenWidth(), GetScreenHeight(), GetStgFrameCenterScreenX(), GetStgFrameCenterScreenY());
-        D3DXMATRIX viewProjViewport = view * proj * viewport;
-        D3DXMatrixInverse(&viewProjViewport, NULL, &viewProjViewport);
-        D3DXVec3TransformCoord(&pos, &pos, &viewProjViewport);
+        const Matrix4 viewProjViewport = camera2D_->GetViewMatrix() * camera2D_->GetProjMatrix(GetScreenWidth(), GetScreenHeight(), GetStgFrameCenterScreenX(), GetStgFrameCenterScreenY()) * FromD3DXMatrix(viewport);
+        Matrix4 inv;
+        if (InverseMatrix4(viewProjViewport, &inv))
+        {
+            const D3DXMATRIX invMat = ToD3DXMatrix(inv);
+            D3DXVec3TransformCoord(&pos, &pos, &invMat);
+        }
     }
     return Point2D(pos.x, pos.y);
 }
@@ -2411,6 +2459,9 @@ void Package::RenderToTexture(const std::wstring& name, int begin, int end, int
         renderTarget->SetRenderTarget();
     }
 
+    // 当たり判定の表示中は判定が描画範囲からはみ出すことがあるのでカリングしない
+    renderer_->SetCullingEnable(!engineDevelopOptions_->renderIntersectionEnable);
+
     D3DXMATRIX viewMatrix2D, projMatrix2D, viewMatrix3D, projMatrix3D, billboardMatrix;
     Camera2D outsideStgFrameCamera2D; outsideStgFrameCamera2D.Reset(0, 0);
     renderer_->InitRenderState();
@@ -2428,32 +2479,59 @@ void Package::RenderToTexture(const std::wstring& name, int begin, int end, int
 
     camera3D_->GenerateViewMatrix(&viewMatrix3D, &billboardMatrix);
 
-    // [0, stgFrameMin]
+    // 当たり判定の描画は描画スレッド以外から呼べないので, 表示中は記録しない
+    const bool recordEnable = objId == ID_INVALID && engineDevelopOptions_->parallelRenderRecordEnable && !engineDevelopOptions_->renderIntersectionEnable;
+    auto isTargetLayer = [&](int p)
     {
-        renderer_->DisableScissorTest();
-
-        // set 2D matrix
-        outsideStgFrameCamera2D.GenerateViewMatrix(&viewMatrix2D);
-        outsideStgFrameCamera2D.GenerateProjMatrix(&projMatrix2D, GetScreenWidth(), GetScreenHeight(), 0, 0);
-        renderer_->SetViewProjMatrix2D(viewMatrix2D, projMatrix2D);
-
-        // set 3D matrix
-        camera3D_->GenerateProjMatrix(&projMatrix3D, GetScreenWidth(), GetScreenHeight(), GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f);
-        renderer_->SetViewProjMatrix3D(viewMatrix3D, projMatrix3D, billboardMatrix);
-        for (int p = 0; p < GetStgFrameRenderPriorityMin(); p++)
+        if (objId != ID_INVALID || p < begin || p > end) return false;
+        return !(checkInvalidRenderPriority && objLayerList_->IsInvalidRenderPriority(p));
+    };
+    // [first, last]の優先度を描画する
+    // 記録が有効なら, 先に範囲内のレイヤーの描画命令を並列に記録してから優先度順に描画する
+    // 記録中は行列を変更しないので, 行列が変わる場所で範囲を区切ること
+    auto renderLayers = [&](int first, int last)
+    {
+        if (recordEnable)
+        {
+            std::vector<int> targetLayers;
+            for (int p = first; p <= last; p++)
+            {
+                if (isTargetLayer(p)) targetLayers.push_back(p);
+            }
+            objLayerList_->RecordLayers(targetLayers, IsStagePaused(), checkVisibleFlag, renderer_);
+        }
+        for (int p = first; p <= last; p++)
         {
             if (obj && obj->getRenderPriority() == p)
             {
                 obj->Render(renderer_);
             }
-            if (objId == ID_INVALID && p >= begin && p <= end)
+            if (isTargetLayer(p))
             {
-                if (!(checkInvalidRenderPriority && objLayerList_->IsInvalidRenderPriority(p)))
+                if (recordEnable)
+                {
+                    objLayerList_->SubmitLayer(p, renderer_);
+                } else
                 {
                     objLayerList_->RenderLayer(p, IsStagePaused(), checkVisibleFlag, renderer_);
                 }
             }
         }
+    };
+
+    // [0, stgFrameMin]
+    {
+        renderer_->DisableScissorTest();
+
+        // set 2D matrix
+        outsideStgFrameCamera2D.GenerateViewMatrix(&viewMatrix2D);
+        outsideStgFrameCamera2D.GenerateProjMatrix(&projMatrix2D, GetScreenWidth(), GetScreenHeight(), 0, 0);
+        renderer_->SetViewProjMatrix2D(viewMatrix2D, projMatrix2D);
+
+        // set 3D matrix
+        camera3D_->GenerateProjMatrix(&projMatrix3D, GetScreenWidth(), GetScreenHeight(), GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f);
+        renderer_->SetViewProjMatrix3D(viewMatrix3D, projMatrix3D, billboardMatrix);
+        renderLayers(0, GetStgFrameRenderPriorityMin() - 1);
     }
     // [stgFrameMin, stgFrameMax]
     {
@@ -2482,30 +2560,24 @@ void Package::RenderToTexture(const std::wstring& name, int begin, int end, int
         camera3D_->GenerateProjMatrix(&projMatrix3D, GetScreenWidth(), GetScreenHeight(), GetStgFrameCenterScreenX(), GetStgFrameCenterScreenY());
         renderer_->SetViewProjMatrix3D(viewMatrix3D, projMatrix3D, billboardMatrix);
 
-        for (int p = GetStgFrameRenderPriorityMin(); p <= GetStgFrameRenderPriorityMax(); p++)
+        const int stgFrameMin = GetStgFrameRenderPriorityMin();
+        const int stgFrameMax = GetStgFrameRenderPriorityMax();
+        const int focusPermitPriority = objLayerList_->GetCameraFocusPermitRenderPriority();
+        if (focusPermitPriority >= stgFrameMin && focusPermitPriority <= stgFrameMax)
         {
-            if (obj && obj->getRenderPriority() == p)
+            renderLayers(stgFrameMin, focusPermitPriority);
+            // cameraFocusPermitRenderPriorityより大きい優先度では別のビュー変換行列を使う
+            if (!IsStageFinished())
             {
-                obj->Render(renderer_);
-            }
-            if (objId == ID_INVALID && p >= begin && p <= end)
-            {
-                if (!(checkInvalidRenderPriority && objLayerList_->IsInvalidRenderPriority(p)))
-                {
-                    objLayerList_->RenderLayer(p, IsStagePaused(), checkVisibleFlag, renderer_);
-                }
-            }
-            if (p == objLayerList_->GetCameraFocusPermitRenderPriority())
-            {
-                // cameraFocusPermitRenderPriorityより大きい優先度では別のビュー変換行列を使う
-                if (!IsStageFinished())
-                {
-                    Camera2D focusForbidCamera;
-                    focusForbidCamera.Reset(GetStgFrameCenterWorldX(), GetStgFrameCenterWorldY());
-                    focusForbidCamera.GenerateViewMatrix(&viewMatrix2D);
-                    renderer_->SetViewProjMatrix2D(viewMatrix2D, projMatrix2D);
-                }
+                Camera2D focusForbidCamera;
+                focusForbidCamera.Reset(GetStgFrameCenterWorldX(), GetStgFrameCenterWorldY());
+                focusForbidCamera.GenerateViewMatrix(&viewMatrix2D);
+                renderer_->SetViewProjMatrix2D(viewMatrix2D, projMatrix2D);
             }
+            renderLayers(focusPermitPriority + 1, stgFrameMax);
+        } else
+        {
+            renderLayers(stgFrameMin, stgFrameMax);
         }
     }
     {
@@ -2520,20 +2592,7 @@ void Package::RenderToTexture(const std::wstring& name, int begin, int end, int
         // set 3D matrix
         camera3D_->GenerateProjMatrix(&projMatrix3D, GetScreenWidth(), GetScreenHeight(), GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f);
         renderer_->SetViewProjMatrix3D(viewMatrix3D, projMatrix3D, billboardMatrix);
-        for (int p = GetStgFrameRenderPriorityMax() + 1; p <= MAX_RENDER_PRIORITY; p++)
-        {
-            if (obj && obj->getRenderPriority() == p)
-            {
-                obj->Render(renderer_);
-            }
-            if (objId == ID_INVALID && p >= begin && p <= end)
-            {
-                if (!(checkInvalidRenderPriority && objLayerList_->IsInvalidRenderPriority(p)))
-                {
-                    objLayerList_->RenderLayer(p, IsStagePaused(), checkVisibleFlag, renderer_);
-                }
-            }
-        }
+        renderLayers(GetStgFrameRenderPriorityMax() + 1, MAX_RENDER_PRIORITY);
     }
     graphicDevice_->SwitchRenderTargetToBackBuffer();
 }
@@ -36,12 +36,12 @@ class FileLoader;
 class Font;
 class FontStore;
 class FpsCounter;
+class ImageSaveQueue;
 class GraphicDevice;
 class InputDevice;
 class Intersection;
 class ItemData;
 class ItemDataTable;
-class ItemScoreTextSpawner;
 class VirtualKeyAssign;
 class LostableGraphicResource;
 class LostableGraphicResourceManager;
@@ -54,8 +54,10 @@ class ObjEnemyBossScene;
 class ObjFileB;
 class ObjFileT;
 class ObjItem;
+class ObjItemScoreText;
 class ObjLooseLaser;
 class ObjMesh;
+class ObjParticleList2D;
 class ObjPlayer;
 class ObjPrim2D;
 class ObjPrim3D;
@@ -175,6 +177,7 @@ public:
     void SaveRenderedTextureA2(const std::wstring& name, const std::wstring& path, int left, int top, int right, int bottom, const std::shared_ptr<SourcePos>& srcPos);
     void SaveSnapShotA1(const std::wstring& path, const std::shared_ptr<SourcePos>& srcPos);
     void SaveSnapShotA2(const std::wstring& path, int left, int top, int right, int bottom, const std::shared_ptr<SourcePos>& srcPos);
+    bool IsSaveImageCompleted(const std::wstring& path) const;
 
     /* shader */
     std::shared_ptr<Shader> CreateShader(const std::wstring& path, bool precompiled);
@@ -330,6 +333,7 @@ public:
     std::shared_ptr<ObjPrim2D> CreateObjPrim2D();
     std::shared_ptr<ObjSprite2D> CreateObjSprite2D();
     std::shared_ptr<ObjSpriteList2D> CreateObjSpriteList2D();
+    std::shared_ptr<ObjParticleList2D> CreateObjParticleList2D();
     std::shared_ptr<ObjPrim3D> CreateObjPrim3D();
     std::shared_ptr<ObjSprite3D> CreateObjSprite3D();
     std::shared_ptr<ObjMesh> CreateObjMesh();
@@ -372,7 +376,7 @@ public:
     /* script */
     NullableSharedPtr<Script> GetScript(int scriptId) const;
     std::shared_ptr<Script> LoadScript(const std::wstring& path, ScriptType type, const std::wstring& version, const std::shared_ptr<SourcePos>& srcPos);
-    std::shared_ptr<Script> LoadScriptInThread(const std::wstring& path, ScriptType type, const std::wstring& version, const std::shared_ptr<SourcePos>& srcPos);
+    std::shared_ptr<Script> LoadScriptInThread(const std::wstring& path, ScriptType type, const std::wstring& version, int compilePriority, const std::shared_ptr<SourcePos>& srcPos);
     void CloseStgScene();
     void NotifyEventAll(int eventType);
     void NotifyEventAll(int eventType, const std::unique_ptr<DnhArray>& args);
@@ -511,6 +515,7 @@ private:
     const std::shared_ptr<EngineDevelopOptions> engineDevelopOptions_;
 
     std::unordered_map<std::wstring, std::shared_ptr<RenderTarget>> renderTargets_;
+    std::shared_ptr<ImageSaveQueue> imageSaveQueue_;
     std::unordered_map<VirtualKey, std::pair<Key, PadButton>> virtualKeyAssign_; // AddVirtualKeyの追加先
     std::unordered_set<VirtualKey> replayTargetVirtualKeys_;
     std::shared_ptr<FileLoader> fileLoader_;
@@ -537,6 +542,7 @@ private:
     std::weak_ptr<ObjPlayer> playerObj_;
     std::weak_ptr<ObjEnemyBossScene> enemyBossSceneObj_;
     std::weak_ptr<ObjSpellManage> spellManageObj_;
+    std::weak_ptr<ObjItemScoreText> itemScoreTextObj_;
 
     std::shared_ptr<ShotCounter> shotCounter_;
     std::shared_ptr<RandGenerator> randGenerator_;
@@ -4,17 +4,23 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace bstorm
 {
 class ScriptInfo;
 class FileLoader;
+class DnhTokenCache;
 class UserShotData;
 class UserItemData;
 class Env;
 struct NodeBlock;
 struct Mqo;
-std::shared_ptr<NodeBlock> ParseDnhScript(const std::wstring& filePath, const std::shared_ptr<Env>& globalEnv, bool expandInclude, ScriptInfo* scriptInfo, const std::shared_ptr<FileLoader>& loader);
+class NodeArena;
+// tokenCache : インクルードファイルのトークン列のキャッシュ, nullptrなら使わない
+// arena : ノードの確保先, 返したASTとglobalEnvより後に破棄すること
+// sourcePaths : 指定した場合, 読み込んだ全てのファイル(インクルードされたものを含む)のパスを格納する
+std::shared_ptr<NodeBlock> ParseDnhScript(const std::wstring& filePath, const std::shared_ptr<Env>& globalEnv, bool expandInclude, ScriptInfo* scriptInfo, const std::shared_ptr<FileLoader>& loader, const std::shared_ptr<DnhTokenCache>& tokenCache, NodeArena* arena, std::vector<std::wstring>* sourcePaths = nullptr);
 ScriptInfo ScanDnhScriptInfo(const std::wstring& filePath, const std::shared_ptr<FileLoader>& loader);
 std::shared_ptr<UserShotData> ParseUserShotData(const std::wstring& filePath, const std::shared_ptr<FileLoader>& loader);
 std::shared_ptr<UserItemData> ParseUserItemData(const std::wstring& filePath, const std::shared_ptr<FileLoader>& loader);
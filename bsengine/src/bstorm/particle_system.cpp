@@ -0,0 +1,114 @@
+﻿#include <bstorm/particle_system.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace bstorm
+{
+ParticleSystem::ParticleSystem() :
+    red_(255, 255),
+    green_(255, 255),
+    blue_(255, 255),
+    alpha_(255, 255),
+    scale_(1, 1),
+    maxDistSq_(0)
+{
+}
+
+void ParticleSystem::Add(float x, float y, float vx, float vy, float ax, float ay, int life)
+{
+    if (life <= 0) return;
+    x_.push_back(x);
+    y_.push_back(y);
+    vx_.push_back(vx);
+    vy_.push_back(vy);
+    ax_.push_back(ax);
+    ay_.push_back(ay);
+    age_.push_back(0);
+    life_.push_back(life);
+    maxDistSq_ = std::max(maxDistSq_, x * x + y * y);
+}
+
+void ParticleSystem::Reserve(size_t particleCount)
+{
+    x_.reserve(particleCount);
+    y_.reserve(particleCount);
+    vx_.reserve(particleCount);
+    vy_.reserve(particleCount);
+    ax_.reserve(particleCount);
+    ay_.reserve(particleCount);
+    age_.reserve(particleCount);
+    life_.reserve(particleCount);
+}
+
+void ParticleSystem::Clear()
+{
+    x_.clear();
+    y_.clear();
+    vx_.clear();
+    vy_.clear();
+    ax_.clear();
+    ay_.clear();
+    age_.clear();
+    life_.clear();
+    maxDistSq_ = 0;
+}
+
+void ParticleSystem::Update()
+{
+    // 移動と同時に生き残った粒子を前に詰める
+    const size_t n = GetCount();
+    size_t alive = 0;
+    maxDistSq_ = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const int age = age_[i] + 1;
+        if (age >= life_[i]) continue;
+        const float vx = vx_[i] + ax_[i];
+        const float vy = vy_[i] + ay_[i];
+        const float x = x_[i] + vx;
+        const float y = y_[i] + vy;
+        x_[alive] = x;
+        y_[alive] = y;
+        vx_[alive] = vx;
+        vy_[alive] = vy;
+        ax_[alive] = ax_[i];
+        ay_[alive] = ay_[i];
+        age_[alive] = age;
+        life_[alive] = life_[i];
+        maxDistSq_ = std::max(maxDistSq_, x * x + y * y);
+        alive++;
+    }
+    x_.resize(alive);
+    y_.resize(alive);
+    vx_.resize(alive);
+    vy_.resize(alive);
+    ax_.resize(alive);
+    ay_.resize(alive);
+    age_.resize(alive);
+    life_.resize(alive);
+}
+
+void ParticleSystem::SetColorCurve(float r0, float g0, float b0, float r1, float g1, float b1)
+{
+    red_ = ParticleCurve(r0, r1);
+    green_ = ParticleCurve(g0, g1);
+    blue_ = ParticleCurve(b0, b1);
+}
+
+void ParticleSystem::SetAlphaCurve(float a0, float a1)
+{
+    alpha_ = ParticleCurve(a0, a1);
+}
+
+void ParticleSystem::SetScaleCurve(float s0, float s1)
+{
+    scale_ = ParticleCurve(s0, s1);
+}
+
+float ParticleSystem::GetMaxScale() const
+{
+    // 線形なので両端のどちらかが最大
+    return std::max(std::abs(scale_.start), std::abs(scale_.end));
+}
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace bstorm
+{
+// 粒子の寿命に対して始点から終点へ線形に変化する値
+struct ParticleCurve
+{
+    ParticleCurve(float start, float end) : start(start), end(end) {}
+    // t : 経過した寿命の割合 [0, 1]
+    float Get(float t) const { return start + (end - start) * t; }
+    float start;
+    float end;
+};
+
+// 粒子の集合
+// 粒子毎の値は要素毎の配列に持つ(SoA). 描画APIに依存しない
+class ParticleSystem
+{
+public:
+    ParticleSystem();
+    // life <= 0の粒子は追加しない
+    void Add(float x, float y, float vx, float vy, float ax, float ay, int life);
+    void Reserve(size_t particleCount);
+    void Clear();
+    // 1フレーム進める, 寿命の尽きた粒子は取り除く(残った粒子の順序は保つ)
+    void Update();
+    size_t GetCount() const { return x_.size(); }
+    float GetX(size_t i) const { return x_[i]; }
+    float GetY(size_t i) const { return y_[i]; }
+    float GetVelocityX(size_t i) const { return vx_[i]; }
+    float GetVelocityY(size_t i) const { return vy_[i]; }
+    int GetAge(size_t i) const { return age_[i]; }
+    int GetLife(size_t i) const { return life_[i]; }
+    float GetLifeRate(size_t i) const { return (float)age_[i] / life_[i]; }
+    void SetColorCurve(float r0, float g0, float b0, float r1, float g1, float b1);
+    void SetAlphaCurve(float a0, float a1);
+    void SetScaleCurve(float s0, float s1);
+    float GetRed(size_t i) const { return red_.Get(GetLifeRate(i)); }
+    float GetGreen(size_t i) const { return green_.Get(GetLifeRate(i)); }
+    float GetBlue(size_t i) const { return blue_.Get(GetLifeRate(i)); }
+    float GetAlpha(size_t i) const { return alpha_.Get(GetLifeRate(i)); }
+    float GetScale(size_t i) const { return scale_.Get(GetLifeRate(i)); }
+    // 全粒子のスケールの最大値
+    float GetMaxScale() const;
+    // 原点から最も遠い粒子までの距離の2乗, AddとUpdateの中で求めておく
+    float GetMaxDistanceSq() const { return maxDistSq_; }
+private:
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> ax_;
+    std::vector<float> ay_;
+    std::vector<int> age_;
+    std::vector<int> life_;
+    ParticleCurve red_;
+    ParticleCurve green_;
+    ParticleCurve blue_;
+    ParticleCurve alpha_;
+    ParticleCurve scale_;
+    float maxDistSq_;
+};
+}
@@ -0,0 +1,37 @@
+﻿#include <bstorm/particle_vertex.hpp>
+
+#include <bstorm/particle_system.hpp>
+
+#include <algorithm>
+
+namespace bstorm
+{
+void WriteParticleVertices(const ParticleSystem& particles, const ParticleQuad& quad, std::vector<Vertex>* vertices)
+{
+    auto toByte = [](float v) { return (int)std::min(std::max(v, 0.0f), 255.0f); };
+    const size_t n = particles.GetCount();
+    vertices->resize(6 * n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const float x = particles.GetX(i);
+        const float y = particles.GetY(i);
+        const float s = particles.GetScale(i);
+        const D3DCOLOR color = D3DCOLOR_ARGB(
+            toByte(particles.GetAlpha(i) * quad.aMul),
+            toByte(particles.GetRed(i) * quad.rMul),
+            toByte(particles.GetGreen(i) * quad.gMul),
+            toByte(particles.GetBlue(i) * quad.bMul));
+        const float l = x + quad.dstLeft * s;
+        const float t = y + quad.dstTop * s;
+        const float r = x + quad.dstRight * s;
+        const float b = y + quad.dstBottom * s;
+        Vertex* dst = vertices->data() + 6 * i;
+        dst[0] = Vertex(l, t, 0, color, quad.ul, quad.vt);
+        dst[1] = Vertex(l, b, 0, color, quad.ul, quad.vb);
+        dst[2] = Vertex(r, t, 0, color, quad.ur, quad.vt);
+        dst[3] = dst[2];
+        dst[4] = dst[1];
+        dst[5] = Vertex(r, b, 0, color, quad.ur, quad.vb);
+    }
+}
+}
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <bstorm/vertex.hpp>
+
+#include <vector>
+
+namespace bstorm
+{
+class ParticleSystem;
+
+// 粒子1つ分の四角形の描画設定
+struct ParticleQuad
+{
+    // 粒子の位置からの描画先の矩形(拡大率1の時)
+    float dstLeft, dstTop, dstRight, dstBottom;
+    // テクスチャ座標
+    float ul, vt, ur, vb;
+    // 粒子の色に乗算する値
+    float rMul, gMul, bMul, aMul;
+};
+
+// 全粒子の四角形を三角形リスト(粒子毎に6頂点)で書き込む
+// 並びはObjSpriteList2Dと同じ
+void WriteParticleVertices(const ParticleSystem& particles, const ParticleQuad& quad, std::vector<Vertex>* vertices);
+}
@@ -2,14 +2,17 @@
 
 namespace bstorm
 {
-constexpr wchar_t* FREE_PLAYER_DIR = L"script/player";
+constexpr const wchar_t* FREE_PLAYER_DIR = L"script/player";
 
-constexpr wchar_t* DEFAULT_SYSTEM_PATH = L"script/default_system/Default_System.txt";
-constexpr wchar_t* DEFAULT_ITEM_DATA_PATH = L"resource/script/Default_ItemData.txt";
-constexpr wchar_t* DEFAULT_PACKAGE_PATH = L"resource/script/Default_Package.txt";
-constexpr wchar_t* DEFAULT_PACKAGE_ARGS_COMMON_DATA_AREA_NAME = L"__DEFAULT_PACKAGE_ARGS__";
+constexpr const wchar_t* DEFAULT_SYSTEM_PATH = L"script/default_system/Default_System.txt";
+constexpr const wchar_t* DEFAULT_ITEM_DATA_PATH = L"resource/script/Default_ItemData.txt";
+constexpr const wchar_t* DEFAULT_PACKAGE_PATH = L"resource/script/Default_Package.txt";
+constexpr const wchar_t* DEFAULT_PACKAGE_ARGS_COMMON_DATA_AREA_NAME = L"__DEFAULT_PACKAGE_ARGS__";
 
-constexpr wchar_t* SYSTEM_STG_DIGIT_IMG_PATH = L"resource/img/System_Stg_Digit.png";
-constexpr wchar_t* SYSTEM_SINGLE_STAGE_PATH = L"resource/script/System_SingleStage.txt";
-constexpr wchar_t* SYSTEM_PLURAL_STAGE_PATH = L"resource/script/System_PluralStage.txt";
+constexpr const wchar_t* SYSTEM_STG_DIGIT_IMG_PATH = L"resource/img/System_Stg_Digit.png";
+constexpr const wchar_t* SYSTEM_SINGLE_STAGE_PATH = L"resource/script/System_SingleStage.txt";
+constexpr const wchar_t* SYSTEM_PLURAL_STAGE_PATH = L"resource/script/System_PluralStage.txt";
+
+constexpr const wchar_t* MESH_CACHE_DIR = L"cache/mesh";
+constexpr const wchar_t* SCRIPT_CACHE_DIR = L"cache/script";
 }
\ No newline at end of file
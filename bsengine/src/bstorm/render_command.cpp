@@ -0,0 +1,95 @@
+﻿#include <bstorm/render_command.hpp>
+
+namespace bstorm
+{
+void RenderCommandList::Clear()
+{
+    commands_.clear();
+    vertices_.clear();
+}
+
+void RenderCommandList::AddPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset, IDirect3DTexture9* sourceTexture)
+{
+    const size_t vertexOffset = AddVertices(vertexCount, vertices);
+    auto& cmd = AddCommand(RenderCommand::Type::PRIM_2D);
+    cmd.primType = primType;
+    cmd.vertexOffset = vertexOffset;
+    cmd.vertexCount = vertexCount;
+    cmd.texture = texture;
+    cmd.sourceTexture = sourceTexture;
+    cmd.blendType = blendType;
+    cmd.filterType = filterType;
+    cmd.worldMatrix = worldMatrix;
+    cmd.pixelShader = pixelShader;
+    cmd.permitCamera = permitCamera;
+    cmd.insertHalfPixelOffset = insertHalfPixelOffset;
+}
+
+void RenderCommandList::AddPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog, bool billboardEnable)
+{
+    const size_t vertexOffset = AddVertices(vertexCount, vertices);
+    auto& cmd = AddCommand(RenderCommand::Type::PRIM_3D);
+    cmd.primType = primType;
+    cmd.vertexOffset = vertexOffset;
+    cmd.vertexCount = vertexCount;
+    cmd.texture = texture;
+    cmd.blendType = blendType;
+    cmd.worldMatrix = worldMatrix;
+    cmd.pixelShader = pixelShader;
+    cmd.zWriteEnable = zWriteEnable;
+    cmd.zTestEnable = zTestEnable;
+    cmd.useFog = useFog;
+    cmd.billboardEnable = billboardEnable;
+}
+
+void RenderCommandList::AddMesh(const std::shared_ptr<Mesh>& mesh, const D3DCOLORVALUE& col, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog)
+{
+    auto& cmd = AddCommand(RenderCommand::Type::MESH);
+    cmd.mesh = mesh;
+    cmd.color = col;
+    cmd.blendType = blendType;
+    cmd.worldMatrix = worldMatrix;
+    cmd.pixelShader = pixelShader;
+    cmd.zWriteEnable = zWriteEnable;
+    cmd.zTestEnable = zTestEnable;
+    cmd.useFog = useFog;
+}
+
+void RenderCommandList::AddObject(ObjRender* obj)
+{
+    AddCommand(RenderCommand::Type::OBJECT).obj = obj;
+}
+
+RenderCommand& RenderCommandList::AddCommand(RenderCommand::Type type)
+{
+    commands_.emplace_back();
+    auto& cmd = commands_.back();
+    cmd.type = type;
+    cmd.primType = D3DPT_TRIANGLELIST;
+    cmd.vertexOffset = 0;
+    cmd.vertexCount = 0;
+    cmd.texture = nullptr;
+    cmd.sourceTexture = nullptr;
+    cmd.blendType = 0;
+    cmd.filterType = 0;
+    cmd.color = D3DCOLORVALUE{ 1.0f, 1.0f, 1.0f, 1.0f };
+    cmd.permitCamera = false;
+    cmd.insertHalfPixelOffset = false;
+    cmd.zWriteEnable = false;
+    cmd.zTestEnable = false;
+    cmd.useFog = false;
+    cmd.billboardEnable = false;
+    cmd.obj = nullptr;
+    return cmd;
+}
+
+size_t RenderCommandList::AddVertices(int vertexCount, const Vertex* vertices)
+{
+    const size_t vertexOffset = vertices_.size();
+    if (vertexCount > 0)
+    {
+        vertices_.insert(vertices_.end(), vertices, vertices + vertexCount);
+    }
+    return vertexOffset;
+}
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <bstorm/vertex.hpp>
+
+#include <d3dx9.h>
+#include <memory>
+#include <vector>
+
+namespace bstorm
+{
+class Shader;
+class Mesh;
+class ObjRender;
+
+// Rendererへの描画呼び出し1回分
+// 行列などの描画時の状態は含まないので, 再生時のRendererの状態で描画される
+struct RenderCommand
+{
+    enum class Type
+    {
+        PRIM_2D,
+        PRIM_3D,
+        MESH,
+        OBJECT // 記録できないオブジェクト, 再生時にRenderを呼ぶ
+    };
+    Type type;
+    D3DPRIMITIVETYPE primType;
+    size_t vertexOffset;
+    int vertexCount;
+    IDirect3DTexture9* texture;
+    IDirect3DTexture9* sourceTexture;
+    int blendType;
+    int filterType;
+    D3DXMATRIX worldMatrix;
+    std::shared_ptr<Shader> pixelShader;
+    std::shared_ptr<Mesh> mesh;
+    D3DCOLORVALUE color;
+    bool permitCamera;
+    bool insertHalfPixelOffset;
+    bool zWriteEnable;
+    bool zTestEnable;
+    bool useFog;
+    bool billboardEnable;
+    ObjRender* obj;
+};
+
+// 1レイヤー分の描画命令列
+// 頂点は命令ごとではなく1つの配列にまとめて持つ
+class RenderCommandList
+{
+public:
+    // 確保済みの領域は次のフレームで再利用する
+    void Clear();
+    bool IsEmpty() const { return commands_.empty(); }
+    void AddPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset, IDirect3DTexture9* sourceTexture);
+    void AddPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog, bool billboardEnable);
+    void AddMesh(const std::shared_ptr<Mesh>& mesh, const D3DCOLORVALUE& col, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog);
+    void AddObject(ObjRender* obj);
+    const std::vector<RenderCommand>& GetCommands() const { return commands_; }
+    const Vertex* GetVertices(const RenderCommand& cmd) const { return vertices_.data() + cmd.vertexOffset; }
+private:
+    RenderCommand& AddCommand(RenderCommand::Type type);
+    size_t AddVertices(int vertexCount, const Vertex* vertices);
+    std::vector<RenderCommand> commands_;
+    std::vector<Vertex> vertices_;
+};
+}
@@ -3,6 +3,8 @@
 #include <bstorm/ptr_util.hpp>
 #include <bstorm/logger.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <exception>
 
 namespace bstorm
@@ -71,6 +73,50 @@ void RenderTarget::SetViewport(int left, int top, int width, int height)
     viewport_ = { (DWORD)left, (DWORD)top, (DWORD)width, (DWORD)height, 0.0f, 1.0f };
 }
 
+void RenderTarget::ReadPixels(int left, int top, int right, int bottom, ImageBGRA* image) const noexcept(false)
+{
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, width_);
+    bottom = std::min(bottom, height_);
+
+    Log err = Log(LogLevel::LV_WARN)
+        .Msg("Failed to read render target.")
+        .Param(LogParam(LogParam::Tag::RENDER_TARGET, name_));
+
+    if (textureSurface_ == nullptr || left >= right || top >= bottom)
+    {
+        throw err;
+    }
+
+    // GPUからの転送はサーフェス全体単位
+    IDirect3DSurface9* stagingSurface = nullptr;
+    if (FAILED(d3DDevice_->CreateOffscreenPlainSurface(width_, height_, D3DFMT_A8R8G8B8, D3DPOOL_SYSTEMMEM, &stagingSurface, nullptr)))
+    {
+        throw err;
+    }
+
+    D3DLOCKED_RECT lockedRect;
+    RECT rect = { left, top, right, bottom };
+    if (FAILED(d3DDevice_->GetRenderTargetData(textureSurface_, stagingSurface)) ||
+        FAILED(stagingSurface->LockRect(&lockedRect, &rect, D3DLOCK_READONLY)))
+    {
+        safe_release(stagingSurface);
+        throw err;
+    }
+
+    image->width = right - left;
+    image->height = bottom - top;
+    image->pixels.resize(4 * image->width * image->height);
+    const size_t rowSize = 4 * image->width;
+    for (int y = 0; y < image->height; y++)
+    {
+        memcpy(image->pixels.data() + rowSize * y, (const uint8_t*)lockedRect.pBits + lockedRect.Pitch * y, rowSize);
+    }
+    stagingSurface->UnlockRect();
+    safe_release(stagingSurface);
+}
+
 void RenderTarget::OnResetDevice()
 {
     if (textureSurface_ != nullptr || textureDepthStencilSurface_ != nullptr) return;
@@ -2,6 +2,7 @@
 
 #include <bstorm/non_copyable.hpp>
 #include <bstorm/lostable_graphic_resource.hpp>
+#include <bstorm/image_encoder.hpp>
 
 #include <string>
 #include <d3d9.h>
@@ -21,6 +22,8 @@ public:
     int GetHeight() const;
     const D3DVIEWPORT9& GetViewport() const;
     void SetViewport(int left, int top, int width, int height);
+    // 指定範囲の画素をシステムメモリに読み出す
+    void ReadPixels(int left, int top, int right, int bottom, ImageBGRA* image) const noexcept(false);
     void OnLostDevice() override;
     void OnResetDevice() override;
 private:
@@ -8,9 +8,11 @@
 #include <bstorm/shader.hpp>
 #include <bstorm/texture.hpp>
 #include <bstorm/mesh.hpp>
+#include <bstorm/render_command.hpp>
 #include <bstorm/logger.hpp>
 
 #include <algorithm>
+#include <cfloat>
 
 static const char prim2DVertexShaderSrc[] =
 "float4x4 worldMatrix : register(c0);"
@@ -99,7 +101,13 @@ Renderer::Renderer(IDirect3DDevice9* dev) :
     currentFilterType_(FILTER_LINEAR), //FP FILTER
     fogEnable_(false),
     fogStart_(0),
-    fogEnd_(0)
+    fogEnd_(0),
+    cullingEnable_(true),
+    clipRect_(-1.0f, -1.0f, 1.0f, 1.0f),
+    cullTestCount_(0),
+    culledCount_(0),
+    lastFrameCullTestCount_(0),
+    lastFrameCulledCount_(0)
 {
     ID3DXBuffer* code = nullptr;
     ID3DXBuffer* error = nullptr;
@@ -183,6 +191,9 @@ void Renderer::InitRenderState()
     d3DDevice_->SetRenderState(D3DRS_LIGHTING, FALSE);
 }
 
+// 記録先, スレッドごとに持つ
+static thread_local RenderCommandList* recordingCommandList = nullptr;
+
 static int calcPolygonNum(D3DPRIMITIVETYPE primType, int vertexCount)
 {
     if (primType == D3DPT_TRIANGLELIST)
@@ -194,8 +205,13 @@ static int calcPolygonNum(D3DPRIMITIVETYPE primType, int vertexCount)
     }
 }
 
-void Renderer::RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX & worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset)
+void Renderer::RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX & worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset, IDirect3DTexture9* sourceTexture)
 {
+    if (recordingCommandList)
+    {
+        recordingCommandList->AddPrim2D(primType, vertexCount, vertices, texture, blendType, filterType, worldMatrix, pixelShader, permitCamera, insertHalfPixelOffset, sourceTexture);
+        return;
+    }
     // disable z-buffer-write, z-test, fog
     d3DDevice_->SetRenderState(D3DRS_ZENABLE, FALSE);
     d3DDevice_->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
@@ -213,6 +229,7 @@ void Renderer::RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Ve
     d3DDevice_->SetFVF(Vertex::Format);
     // set texture
     d3DDevice_->SetTexture(0, texture);
+    textureSwitchCounter_.Count(texture, sourceTexture ? sourceTexture : texture);
     // set pixel shader
     if (pixelShader)
     {
@@ -237,6 +254,11 @@ void Renderer::RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Ve
 
 void Renderer::RenderPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, const D3DXMATRIX & worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog, bool billboardEnable_)
 {
+    if (recordingCommandList)
+    {
+        recordingCommandList->AddPrim3D(primType, vertexCount, vertices, texture, blendType, worldMatrix, pixelShader, zWriteEnable, zTestEnable, useFog, billboardEnable_);
+        return;
+    }
     // set z-buffer-write, z-test, fog
     d3DDevice_->SetRenderState(D3DRS_ZENABLE, zTestEnable ? TRUE : FALSE);
     d3DDevice_->SetRenderState(D3DRS_ZWRITEENABLE, zWriteEnable ? TRUE : FALSE);
@@ -256,6 +278,7 @@ void Renderer::RenderPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Ve
     d3DDevice_->SetFVF(Vertex::Format);
     // set texture
     d3DDevice_->SetTexture(0, texture);
+    textureSwitchCounter_.Count(texture, texture);
     // set pixel shader
     if (pixelShader)
     {
@@ -280,6 +303,11 @@ void Renderer::RenderPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Ve
 
 void Renderer::RenderMesh(const std::shared_ptr<Mesh>& mesh, const D3DCOLORVALUE& col, int blendType, const D3DXMATRIX & worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog)
 {
+    if (recordingCommandList)
+    {
+        recordingCommandList->AddMesh(mesh, col, blendType, worldMatrix, pixelShader, zWriteEnable, zTestEnable, useFog);
+        return;
+    }
     // set z-buffer-write, z-test, fog
     d3DDevice_->SetRenderState(D3DRS_ZENABLE, zTestEnable ? TRUE : FALSE);
     d3DDevice_->SetRenderState(D3DRS_ZWRITEENABLE, zWriteEnable ? TRUE : FALSE);
@@ -324,7 +352,9 @@ void Renderer::RenderMesh(const std::shared_ptr<Mesh>& mesh, const D3DCOLORVALUE
         D3DXVec4Normalize(&lightDir, &lightDir);
         d3DDevice_->SetVertexShaderConstantF(10, (const float*)&lightDir, 1);
         // set texture
-        d3DDevice_->SetTexture(0, mat.texture ? mat.texture->GetTexture() : nullptr);
+        IDirect3DTexture9* texture = mat.texture ? mat.texture->GetTexture() : nullptr;
+        d3DDevice_->SetTexture(0, texture);
+        textureSwitchCounter_.Count(texture, texture);
         // set pixel shader
         if (pixelShader)
         {
@@ -437,11 +467,82 @@ void Renderer::EnableScissorTest(const RECT& rect)
 {
     d3DDevice_->SetRenderState(D3DRS_SCISSORTESTENABLE, TRUE);
     d3DDevice_->SetScissorRect(&rect);
+    UpdateClipRect(&rect);
 }
 
 void Renderer::DisableScissorTest()
 {
     d3DDevice_->SetRenderState(D3DRS_SCISSORTESTENABLE, FALSE);
+    UpdateClipRect(nullptr);
+}
+
+void Renderer::UpdateClipRect(const RECT* scissorRect)
+{
+    D3DVIEWPORT9 viewport;
+    if (FAILED(d3DDevice_->GetViewport(&viewport)) || viewport.Width == 0 || viewport.Height == 0)
+    {
+        clipRect_ = Rect<float>(-1.0f, -1.0f, 1.0f, 1.0f);
+        return;
+    }
+    float left = viewport.X;
+    float top = viewport.Y;
+    float right = viewport.X + viewport.Width;
+    float bottom = viewport.Y + viewport.Height;
+    if (scissorRect)
+    {
+        left = std::max(left, (float)scissorRect->left);
+        top = std::max(top, (float)scissorRect->top);
+        right = std::min(right, (float)scissorRect->right);
+        bottom = std::min(bottom, (float)scissorRect->bottom);
+    }
+    // フィルタリングで滲む分として2px広げる
+    constexpr float margin = 2.0f;
+    left -= margin; top -= margin; right += margin; bottom += margin;
+    // スクリーン座標 -> クリップ座標
+    clipRect_.left = (left - viewport.X) / viewport.Width * 2.0f - 1.0f;
+    clipRect_.right = (right - viewport.X) / viewport.Width * 2.0f - 1.0f;
+    clipRect_.top = 1.0f - (bottom - viewport.Y) / viewport.Height * 2.0f;
+    clipRect_.bottom = 1.0f - (top - viewport.Y) / viewport.Height * 2.0f;
+}
+
+void Renderer::BeginRecord(RenderCommandList* list)
+{
+    recordingCommandList = list;
+}
+
+void Renderer::EndRecord()
+{
+    recordingCommandList = nullptr;
+}
+
+bool Renderer::IsCulled2D(const Rect<float>& bounds, bool permitCamera)
+{
+    cullTestCount_++;
+    // 2Dのビュー射影行列は平行投影なので4隅を変換した範囲に収まる
+    const D3DXMATRIX& viewProj = permitCamera ? viewProjMatrix2D_ : forbidCameraViewProjMatrix2D_;
+    const float xs[2] = { bounds.left, bounds.right };
+    const float ys[2] = { bounds.top, bounds.bottom };
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (float x : xs)
+    {
+        for (float y : ys)
+        {
+            const float w = x * viewProj._14 + y * viewProj._24 + viewProj._44;
+            if (w <= 0.0f) return false;
+            const float cx = (x * viewProj._11 + y * viewProj._21 + viewProj._41) / w;
+            const float cy = (x * viewProj._12 + y * viewProj._22 + viewProj._42) / w;
+            minX = std::min(minX, cx);
+            maxX = std::max(maxX, cx);
+            minY = std::min(minY, cy);
+            maxY = std::max(maxY, cy);
+        }
+    }
+    if (maxX < clipRect_.left || minX > clipRect_.right || maxY < clipRect_.top || minY > clipRect_.bottom)
+    {
+        culledCount_++;
+        return true;
+    }
+    return false;
 }
 
 void Renderer::SetFogEnable(bool enable)
@@ -457,4 +558,17 @@ void Renderer::SetFogParam(float start, float end, int r, int g, int b)
     fogEnd_ = end;
     fogColor_ = ColorRGB(r, g, b).ToD3DCOLOR(0xff);
 }
+
+void Renderer::FlushFrameStats()
+{
+    lastFrameTextureSwitchCounter_ = textureSwitchCounter_;
+    textureSwitchCounter_.Reset();
+    lastFrameCullTestCount_ = cullTestCount_.exchange(0);
+    lastFrameCulledCount_ = culledCount_.exchange(0);
+}
+
+const TextureSwitchCounter& Renderer::GetLastFrameTextureSwitchCounter() const
+{
+    return lastFrameTextureSwitchCounter_;
+}
 }
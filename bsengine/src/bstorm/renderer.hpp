@@ -1,9 +1,12 @@
 ﻿#pragma once
 
 #include <bstorm/non_copyable.hpp>
+#include <bstorm/atlas_packer.hpp>
+#include <bstorm/rect.hpp>
 
 #include <d3dx9.h>
 #include <array>
+#include <atomic>
 #include <memory>
 
 namespace bstorm
@@ -11,6 +14,7 @@ namespace bstorm
 struct Vertex;
 class Shader;
 class Mesh;
+class RenderCommandList;
 class Renderer : private NonCopyable
 {
 public:
@@ -20,9 +24,13 @@ public:
     // デバイスロストやライブラリによってデバイスの状態が書き換えられた場合も呼ぶ必要がある
     // 一連の描画の前に1回呼べばよい
     void InitRenderState();
-    void RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset); //FP FILTER
+    void RenderPrim2D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, int filterType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool permitCamera, bool insertHalfPixelOffset, IDirect3DTexture9* sourceTexture = nullptr); //FP FILTER
     void RenderPrim3D(D3DPRIMITIVETYPE primType, int vertexCount, const Vertex* vertices, IDirect3DTexture9* texture, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog, bool billboardEnable_);
     void RenderMesh(const std::shared_ptr<Mesh>& mesh, const D3DCOLORVALUE& col, int blendType, const D3DXMATRIX& worldMatrix, const std::shared_ptr<Shader>& pixelShader, bool zWriteEnable, bool zTestEnable, bool useFog);
+    // NOTE : BeginRecord : 呼び出したスレッドでのRenderPrim2D, RenderPrim3D, RenderMeshを描画せずにlistに記録する
+    // 記録中はデバイスに触れないので描画スレッド以外から呼んでもよい
+    void BeginRecord(RenderCommandList* list);
+    void EndRecord();
     void SetViewProjMatrix2D(const D3DXMATRIX& view, const D3DXMATRIX& proj);
     void SetForbidCameraViewProjMatrix2D(int screenWidth, int screenHeight);
     void SetViewProjMatrix3D(const D3DXMATRIX& view, const D3DXMATRIX& proj);
@@ -32,9 +40,22 @@ public:
     // NOTE : enable/disableScissorTest : デバイスロストすると設定値は消える
     void EnableScissorTest(const RECT& rect);
     void DisableScissorTest();
+    // 2D座標上の矩形が描画範囲(シザー矩形を含む)の外にあるならtrue
+    // 判定は保守的で, 見える物をtrueにすることはない
+    // 描画命令の記録中に複数スレッドから呼んでもよい
+    bool IsCulled2D(const Rect<float>& bounds, bool permitCamera);
+    void SetCullingEnable(bool enable) { cullingEnable_ = enable; }
+    bool IsCullingEnabled() const { return cullingEnable_; }
     void SetFogEnable(bool enable);
     void SetFogParam(float fogStart, float fogEnd, int r, int g, int b);
+    // 1フレーム分の統計を確定して, 次のフレームの集計を始める
+    void FlushFrameStats();
+    const TextureSwitchCounter& GetLastFrameTextureSwitchCounter() const;
+    int GetLastFrameCullTestCount() const { return lastFrameCullTestCount_; }
+    int GetLastFrameCulledCount() const { return lastFrameCulledCount_; }
 private:
+    // 現在のビューポートとシザー矩形から描画範囲(クリップ座標)を求める
+    void UpdateClipRect(const RECT* scissorRect);
     IDirect3DDevice9 * d3DDevice_;
     IDirect3DVertexShader9* prim2DVertexShader_;
     IDirect3DVertexShader9* prim3DVertexShader_;
@@ -52,5 +73,13 @@ private:
     float fogStart_;
     float fogEnd_;
     D3DCOLOR fogColor_;
+    TextureSwitchCounter textureSwitchCounter_;
+    TextureSwitchCounter lastFrameTextureSwitchCounter_;
+    bool cullingEnable_;
+    Rect<float> clipRect_; // x, yともに[-1, 1], topが下端
+    std::atomic<int> cullTestCount_;
+    std::atomic<int> culledCount_;
+    int lastFrameCullTestCount_;
+    int lastFrameCulledCount_;
 };
 }
\ No newline at end of file
@@ -77,6 +77,11 @@ bool Script::IsClosed() const
     return state_.isClosed;
 }
 
+bool Script::IsLoaded() const
+{
+    return state_.isLoaded;
+}
+
 void Script::RunBuiltInSub(const std::string &name)
 {
     if (state_.isFailed) { return; }
@@ -150,7 +155,7 @@ void Script::Load()
     serializedScript_ = serializedScriptStore_->Load(path_, type_, version_);
 
     // 実行環境作成
-    CreateInitRootEnv(type_, version_, L_.get());
+    InitScriptRuntime(type_, L_.get());
 
     // スクリプトをバインド
     SetScript(L_.get(), this);
@@ -316,15 +321,15 @@ ScriptManager::~ScriptManager() {}
 
 std::shared_ptr<Script> ScriptManager::Compile(const std::wstring& path, ScriptType type, const std::wstring& version, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos)
 {
-    serializedScriptStore_->LoadAsync(path, type, version);
-    auto script = std::make_shared<Script>(path, type, version, idGen_++, serializedScriptStore_, package, srcPos);
-    scriptMap_.emplace_hint(scriptMap_.end(), script->GetID(), script);
-    return script;
+    return CompileInThread(path, type, version, SCRIPT_COMPILE_PRIORITY_IMMEDIATE, package, srcPos);
 }
 
-std::shared_ptr<Script> ScriptManager::CompileInThread(const std::wstring & path, ScriptType type, const std::wstring & version, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos)
+std::shared_ptr<Script> ScriptManager::CompileInThread(const std::wstring & path, ScriptType type, const std::wstring & version, int compilePriority, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos)
 {
-    return Compile(path, type, version, package, srcPos);
+    serializedScriptStore_->LoadAsync(path, type, version, compilePriority);
+    auto script = std::make_shared<Script>(path, type, version, idGen_++, serializedScriptStore_, package, srcPos);
+    scriptMap_.emplace_hint(scriptMap_.end(), script->GetID(), script);
+    return script;
 }
 
 void ScriptManager::RunMainLoopAllNonStgScript()
@@ -397,6 +402,11 @@ void ScriptManager::FinalizeAllClosedScript()
         auto& script = it->second;
         if (script->IsClosed())
         {
+            if (!script->IsLoaded())
+            {
+                // 使われないまま閉じられた, 同じスクリプトを待つものが他に無ければ先読みを取り消す
+                serializedScriptStore_->CancelLoad(script->GetPath(), script->GetType(), script->GetVersion());
+            }
             script->RunFinalize();
             it = scriptMap_.erase(it);
         } else ++it;
@@ -18,6 +18,10 @@ namespace bstorm
 {
 extern const std::unordered_set<std::wstring> ignoreScriptExts;
 
+// コンパイルの優先度, 小さいほど先に実行される
+constexpr int SCRIPT_COMPILE_PRIORITY_IMMEDIATE = 0; // すぐに使うスクリプト
+constexpr int SCRIPT_COMPILE_PRIORITY_PREFETCH = 1; // 先読み, 後で使うものほど大きい値を足す
+
 class Package;
 class FileLoader;
 class DnhValue;
@@ -32,6 +36,7 @@ public:
     ~Script();
     void Close();
     bool IsClosed() const;
+    bool IsLoaded() const;
     int GetID() const;
     const std::wstring& GetPath() const;
     ScriptType GetType() const;
@@ -89,7 +94,7 @@ public:
     ScriptManager(const std::shared_ptr<FileLoader>& fileLoader, const std::shared_ptr<SerializedScriptStore>& serializedScriptStore);
     ~ScriptManager();
     std::shared_ptr<Script> Compile(const std::wstring& path, ScriptType type, const std::wstring& version, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos);
-    std::shared_ptr<Script> CompileInThread(const std::wstring& path, ScriptType type, const std::wstring& version, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos);
+    std::shared_ptr<Script> CompileInThread(const std::wstring& path, ScriptType type, const std::wstring& version, int compilePriority, const std::shared_ptr<Package>& package, const std::shared_ptr<SourcePos>& srcPos);
     void RunMainLoopAllNonStgScript();
     void RunMainLoopAllStgScript();
     NullableSharedPtr<Script> Get(int id) const;
@@ -0,0 +1,214 @@
+﻿#include <bstorm/script_cache.hpp>
+
+#include <bstorm/cache_file.hpp>
+#include <bstorm/file_loader.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/string_util.hpp>
+#include <bstorm/path_const.hpp>
+#include <bstorm/logger.hpp>
+#include <bstorm/version.hpp>
+
+#include <luajit/luajit.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <tuple>
+
+namespace bstorm
+{
+static constexpr char SCRIPT_CACHE_MAGIC[8] = { 'B', 'S', 'S', 'C', 'R', 'I', 'P', 'T' };
+
+// エンジンやLuaJITが変わるとバイトコードの互換性が無くなる
+static std::string GetScriptCacheBuildId()
+{
+    return std::string(BSTORM_VERSION) + "/" + LUAJIT_VERSION;
+}
+
+static uint64_t HashScriptCacheKey(const ScriptCacheKey& key)
+{
+    const std::string path = ToUTF8(key.path);
+    const std::string version = ToUTF8(key.version);
+    const std::string buildId = GetScriptCacheBuildId();
+    const uint8_t type = (uint8_t)key.type.value;
+    uint64_t hash = HashFNV1a64(path.data(), path.size());
+    hash = HashFNV1a64(&type, sizeof(type), hash);
+    hash = HashFNV1a64(version.data(), version.size(), hash);
+    hash = HashFNV1a64(key.compileOption.data(), key.compileOption.size(), hash);
+    return HashFNV1a64(buildId.data(), buildId.size(), hash);
+}
+
+bool GetScriptSourceFile(const std::wstring& path, const std::shared_ptr<FileLoader>& fileLoader, ScriptSourceFile* file)
+{
+    FILE* fp = fileLoader->OpenFile(path);
+    if (!fp) return false;
+    uint64_t size = 0;
+    uint64_t hash = FNV1A_64_OFFSET_BASIS;
+    char buf[4096];
+    size_t readSize;
+    while ((readSize = fread(buf, 1, sizeof(buf), fp)) > 0)
+    {
+        hash = HashFNV1a64(buf, readSize, hash);
+        size += readSize;
+    }
+    const bool isError = ferror(fp) != 0;
+    fileLoader->CloseFile(path, fp);
+    if (isError) return false;
+    file->path = path;
+    file->size = size;
+    file->contentHash = hash;
+    return true;
+}
+
+std::wstring GetScriptCachePath(const ScriptCacheKey& key)
+{
+    return ConcatPath(SCRIPT_CACHE_DIR, GetHashFileName(HashScriptCacheKey(key)) + L".bsscript");
+}
+
+bool LoadScriptCache(const std::wstring& cachePath, const ScriptCacheKey& key, const std::shared_ptr<FileLoader>& fileLoader, ScriptCacheData* data)
+{
+    std::vector<char> buf;
+    if (!ReadCacheFile(cachePath, &buf)) return false;
+
+    CacheFileReader reader(buf);
+    char magic[sizeof(SCRIPT_CACHE_MAGIC)];
+    uint32_t version = 0;
+    std::string buildId;
+    std::string path;
+    uint8_t type = 0;
+    std::string scriptVersion;
+    std::string compileOption;
+    if (!reader.Read(magic, sizeof(magic)) || std::memcmp(magic, SCRIPT_CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (!reader.Read(&version) || version != SCRIPT_CACHE_VERSION) return false;
+    if (!reader.ReadString(&buildId) || buildId != GetScriptCacheBuildId()) return false;
+    // ハッシュの衝突に備えてキーも比べる
+    if (!reader.ReadString(&path) || path != ToUTF8(key.path)) return false;
+    if (!reader.Read(&type) || type != (uint8_t)key.type.value) return false;
+    if (!reader.ReadString(&scriptVersion) || scriptVersion != ToUTF8(key.version)) return false;
+    if (!reader.ReadString(&compileOption) || compileOption != key.compileOption) return false;
+
+    // インクルードされたファイルを含めて, 全ての元ファイルの中身が保存時と同じであること
+    uint32_t sourceCount = 0;
+    if (!reader.Read(&sourceCount)) return false;
+    for (uint32_t i = 0; i < sourceCount; i++)
+    {
+        std::string sourcePath;
+        uint64_t size = 0;
+        uint64_t contentHash = 0;
+        if (!reader.ReadString(&sourcePath) || !reader.Read(&size) || !reader.Read(&contentHash)) return false;
+        ScriptSourceFile source;
+        if (!GetScriptSourceFile(ToUnicode(sourcePath), fileLoader, &source)) return false;
+        if (source.size != size || source.contentHash != contentHash) return false;
+    }
+
+    ScriptCacheData result;
+    uint32_t builtInSubNameCount = 0;
+    if (!reader.ReadString(&result.scriptInfo)) return false;
+    if (!reader.ReadString(&result.srcMap)) return false;
+    if (!reader.ReadString(&result.byteCode)) return false;
+    if (!reader.ReadString(&result.srcCode)) return false;
+    if (!reader.Read(&builtInSubNameCount)) return false;
+    for (uint32_t i = 0; i < builtInSubNameCount; i++)
+    {
+        std::string name;
+        std::string convertedName;
+        if (!reader.ReadString(&name) || !reader.ReadString(&convertedName)) return false;
+        result.builtInSubNames.emplace_back(std::move(name), std::move(convertedName));
+    }
+    if (!reader.IsEnd()) return false;
+    *data = std::move(result);
+    return true;
+}
+
+void SaveScriptCache(const std::wstring& cachePath, const ScriptCacheKey& key, const std::vector<ScriptSourceFile>& sources, const ScriptCacheData& data) noexcept(false)
+{
+    Log err = Log(LogLevel::LV_WARN)
+        .Msg("Failed to save script cache.")
+        .Param(LogParam(LogParam::Tag::SCRIPT, key.path));
+
+    // 同じパスのキャッシュを複数のスレッドが同時に書くことはない
+    const std::wstring tmpPath = cachePath + L".tmp";
+    MakeDirectoryP(GetParentPath(cachePath));
+    {
+        std::ofstream out;
+#ifdef _WIN32
+        out.open(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+#else
+        out.open(ToUTF8(tmpPath), std::ios::out | std::ios::binary | std::ios::trunc);
+#endif
+        if (!out.good())
+        {
+            throw err;
+        }
+        out.write(SCRIPT_CACHE_MAGIC, sizeof(SCRIPT_CACHE_MAGIC));
+        WriteCacheValue(out, SCRIPT_CACHE_VERSION);
+        WriteCacheString(out, GetScriptCacheBuildId());
+        WriteCacheString(out, ToUTF8(key.path));
+        WriteCacheValue(out, (uint8_t)key.type.value);
+        WriteCacheString(out, ToUTF8(key.version));
+        WriteCacheString(out, key.compileOption);
+        WriteCacheValue(out, (uint32_t)sources.size());
+        for (const auto& source : sources)
+        {
+            WriteCacheString(out, ToUTF8(source.path));
+            WriteCacheValue(out, source.size);
+            WriteCacheValue(out, source.contentHash);
+        }
+        WriteCacheString(out, data.scriptInfo);
+        WriteCacheString(out, data.srcMap);
+        WriteCacheString(out, data.byteCode);
+        WriteCacheString(out, data.srcCode);
+        WriteCacheValue(out, (uint32_t)data.builtInSubNames.size());
+        for (const auto& names : data.builtInSubNames)
+        {
+            WriteCacheString(out, names.first);
+            WriteCacheString(out, names.second);
+        }
+        if (!out.good())
+        {
+            out.close();
+            RemoveFile(tmpPath);
+            throw err;
+        }
+    }
+    if (!ReplaceCacheFile(tmpPath, cachePath))
+    {
+        throw err;
+    }
+}
+
+void TrimScriptCache(uint64_t maxTotalSize)
+{
+    // 複数のスレッドから同時に消さないようにする
+    static std::mutex trimMutex;
+    std::lock_guard<std::mutex> lock(trimMutex);
+
+    std::vector<std::wstring> cachePaths;
+    GetFilePaths(SCRIPT_CACHE_DIR, cachePaths, {}, false);
+
+    // (更新時刻, サイズ, パス)
+    std::vector<std::tuple<uint64_t, uint64_t, std::wstring>> entries;
+    uint64_t totalSize = 0;
+    for (auto& path : cachePaths)
+    {
+        if (GetLowerExt(path) != L".bsscript") continue;
+        uint64_t lastUpdateTime = 0;
+        uint64_t size = 0;
+        if (!GetFileStatus(path, &lastUpdateTime, &size)) continue;
+        totalSize += size;
+        entries.emplace_back(lastUpdateTime, size, std::move(path));
+    }
+    if (totalSize <= maxTotalSize) return;
+
+    std::sort(entries.begin(), entries.end());
+    for (const auto& entry : entries)
+    {
+        if (totalSize <= maxTotalSize) break;
+        if (RemoveFile(std::get<2>(entry)))
+        {
+            totalSize -= std::get<1>(entry);
+        }
+    }
+}
+}
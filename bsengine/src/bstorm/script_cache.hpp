@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <bstorm/script_info.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bstorm
+{
+class FileLoader;
+
+// コンパイル済みスクリプトを保存するバイナリ形式
+// 形式やコード生成を変えたらバージョンを上げること
+constexpr uint32_t SCRIPT_CACHE_VERSION = 11;
+// キャッシュディレクトリの合計サイズの上限, 超えたら古いものから消す
+constexpr uint64_t SCRIPT_CACHE_MAX_TOTAL_SIZE = 256ull * 1024 * 1024;
+
+// 同じキーなら同じ生成物になる条件
+struct ScriptCacheKey
+{
+    std::wstring path;
+    ScriptType type;
+    std::wstring version;
+    std::string compileOption;
+};
+
+// スクリプト本体とインクルードされたファイル
+struct ScriptSourceFile
+{
+    std::wstring path;
+    uint64_t size;
+    uint64_t contentHash;
+};
+
+// 中身を読んでハッシュを取る, 読めなければfalse
+bool GetScriptSourceFile(const std::wstring& path, const std::shared_ptr<FileLoader>& fileLoader, ScriptSourceFile* file);
+
+struct ScriptCacheData
+{
+    std::string scriptInfo; // シリアライズ済み
+    std::string srcMap; // シリアライズ済み
+    std::string byteCode;
+    std::string srcCode;
+    std::vector<std::pair<std::string, std::string>> builtInSubNames; // 組み込みサブルーチン名と変換後の名前
+};
+
+std::wstring GetScriptCachePath(const ScriptCacheKey& key);
+// キャッシュが無い, 壊れている, バージョンやキーが一致しない, 元ファイルのどれかが変わっている場合はfalse
+bool LoadScriptCache(const std::wstring& cachePath, const ScriptCacheKey& key, const std::shared_ptr<FileLoader>& fileLoader, ScriptCacheData* data);
+void SaveScriptCache(const std::wstring& cachePath, const ScriptCacheKey& key, const std::vector<ScriptSourceFile>& sources, const ScriptCacheData& data) noexcept(false);
+// 合計サイズがmaxTotalSizeを超えていたら更新の古いものから消す
+void TrimScriptCache(uint64_t maxTotalSize);
+}
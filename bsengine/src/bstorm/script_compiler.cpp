@@ -0,0 +1,130 @@
+﻿#include <bstorm/script_compiler.hpp>
+
+#include <bstorm/builtin_registry.hpp>
+#include <bstorm/logger.hpp>
+#include <bstorm/node.hpp>
+#include <bstorm/node_arena.hpp>
+#include <bstorm/parser.hpp>
+#include <bstorm/semantics_checker.hpp>
+#include <bstorm/code_analyzer.hpp>
+#include <bstorm/function_inliner.hpp>
+#include <bstorm/constant_folder.hpp>
+#include <bstorm/escape_analyzer.hpp>
+#include <bstorm/script_entry_routine_names.hpp>
+
+#include <chrono>
+
+namespace bstorm
+{
+// 前回の計測からの時間をtimeに記録する, statsがnullptrなら何もしない
+static void LapTime(DnhCompileStats* stats, double DnhCompileStats::* time, std::chrono::steady_clock::time_point* start)
+{
+    if (!stats) return;
+    auto now = std::chrono::steady_clock::now();
+    stats->*time = std::chrono::duration<double>(now - *start).count();
+    *start = now;
+}
+
+CodeGenerator::Option GetDefaultCodeGeneratorOption()
+{
+    CodeGenerator::Option codeGenOption;
+    codeGenOption.enableNilCheck = false;
+    codeGenOption.deleteUnreachableDefinition = true;
+    codeGenOption.deleteUnneededAssign = true;
+    codeGenOption.promoteGlobalToLocal = true;
+    return codeGenOption;
+}
+
+std::string GetCompileOptionName(const CodeGenerator::Option& option)
+{
+    std::string name;
+    name += option.enableNilCheck ? "nil-check;" : "";
+    name += option.deleteUnreachableDefinition ? "delete-unreachable-def;" : "";
+    name += option.deleteUnneededAssign ? "delete-unneeded-assign;" : "";
+    name += option.promoteGlobalToLocal ? "promote-global-to-local;" : "";
+    name += option.foldConstants ? "" : "no-fold;";
+#ifdef _DEBUG
+    name += "debug;";
+#endif
+    return name;
+}
+
+void CompileDnhScript(const std::wstring& path, ScriptType type, const CodeGenerator::Option& option, const std::shared_ptr<FileLoader>& loader, const std::shared_ptr<DnhTokenCache>& tokenCache, DnhCompileResult* result, DnhCompileStats* stats)
+{
+    // ASTの確保先, ASTを参照するものより先に宣言しておく
+    NodeArena arena;
+
+    // 環境作成
+    auto globalEnv = CreateInitRootEnv(type);
+
+    // 組み込みの定義の作成(初回のみ)は計測しない
+    auto lapStart = std::chrono::steady_clock::now();
+
+    // パース
+    std::shared_ptr<NodeBlock> program = ParseDnhScript(path, globalEnv, true, &result->scriptInfo, loader, tokenCache, &arena, &result->sourcePaths);
+    LapTime(stats, &DnhCompileStats::parseTime, &lapStart);
+    if (stats)
+    {
+        stats->nodeCount = arena.GetObjectCount();
+        stats->arenaSize = arena.GetAllocatedSize();
+    }
+
+    // 静的エラー検査
+    {
+        SemanticsChecker checker;
+        auto errors_ = checker.Check(*program);
+        for (auto& err : errors_)
+        {
+            Logger::Write(err);
+        }
+        if (!errors_.empty())
+        {
+            throw Log(LogLevel::LV_ERROR)
+                .Msg("Found " + std::to_string(errors_.size()) + " script error" + (errors_.size() > 1 ? "s." : "."))
+                .Param(LogParam(LogParam::Tag::SCRIPT, path));
+        }
+    }
+    LapTime(stats, &DnhCompileStats::checkTime, &lapStart);
+
+    // 静的解析
+    CodeAnalyzer analyzer;
+    analyzer.Analyze(*program);
+    LapTime(stats, &DnhCompileStats::analyzeTime, &lapStart);
+
+    // 小さな関数のインライン展開
+    FunctionInliner inliner;
+    inliner.Inline(*program);
+    LapTime(stats, &DnhCompileStats::inlineTime, &lapStart);
+
+    // 定数畳み込み
+    if (option.foldConstants)
+    {
+        ConstantFolder folder;
+        folder.Fold(*program, analyzer.GetProcEntryAssignedDefs());
+    }
+    LapTime(stats, &DnhCompileStats::foldTime, &lapStart);
+
+    // 不要な配列のコピーの除去
+    EscapeAnalyzer escapeAnalyzer;
+    escapeAnalyzer.Analyze(*program);
+    LapTime(stats, &DnhCompileStats::escapeTime, &lapStart);
+
+    // コード生成
+    CodeGenerator codeGen(option);
+    codeGen.Generate(*program);
+    LapTime(stats, &DnhCompileStats::codeGenTime, &lapStart);
+
+    result->code = codeGen.GetCode();
+    result->srcMap = codeGen.GetSourceMap();
+    for (auto&& name : SCRIPT_ENTRY_ROUTINE_NAMES)
+    {
+        if (auto def = globalEnv->FindDef(Ident(name)))
+        {
+            result->builtInSubNameConversionMap[name] = def->convertedName;
+        } else
+        {
+            result->builtInSubNameConversionMap[name] = name;
+        }
+    }
+}
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <bstorm/script_info.hpp>
+#include <bstorm/source_map.hpp>
+#include <bstorm/code_generator.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bstorm
+{
+class FileLoader;
+class DnhTokenCache;
+
+// コンパイルの各段階にかかった時間(秒)とASTの規模
+struct DnhCompileStats
+{
+    double parseTime = 0.0;
+    double checkTime = 0.0;
+    double analyzeTime = 0.0;
+    double inlineTime = 0.0;
+    double foldTime = 0.0;
+    double escapeTime = 0.0;
+    double codeGenTime = 0.0;
+    size_t nodeCount = 0; // パーサが作ったノードの数
+    size_t arenaSize = 0; // パーサが確保したバイト数
+};
+
+struct DnhCompileResult
+{
+    ScriptInfo scriptInfo;
+    std::vector<std::wstring> sourcePaths; // インクルードされたものを含む
+    std::string code; // Luaのコード
+    SourceMap srcMap;
+    std::unordered_map<std::string, std::string> builtInSubNameConversionMap;
+};
+
+// エンジンで使うコード生成の設定
+CodeGenerator::Option GetDefaultCodeGeneratorOption();
+// キャッシュのキーに使う, オプションが変わったらキャッシュを使わない
+std::string GetCompileOptionName(const CodeGenerator::Option& option);
+
+// スクリプトをLuaのコードに変換する, エラーはLogを投げる
+// tokenCache : nullptrなら使わない
+// stats : 指定した場合, 各段階の時間とASTの規模を格納する
+void CompileDnhScript(const std::wstring& path, ScriptType type, const CodeGenerator::Option& option, const std::shared_ptr<FileLoader>& loader, const std::shared_ptr<DnhTokenCache>& tokenCache, DnhCompileResult* result, DnhCompileStats* stats = nullptr);
+}
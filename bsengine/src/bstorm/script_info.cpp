@@ -21,6 +21,7 @@ const char * ScriptType::GetName() const
         case ScriptType::Value::PACKAGE: return "Package";
         case ScriptType::Value::SHOT_CUSTOM: return "ShotCustom";
         case ScriptType::Value::ITEM_CUSTOM: return "ItemCustom";
+        case ScriptType::Value::UNKNOWN: break;
     }
     return "Unknown";
 }
@@ -34,6 +35,10 @@ int ScriptType::GetScriptConst() const
         case ScriptType::Value::STAGE:
         case ScriptType::Value::PACKAGE:
             return static_cast<int>(value);
+        case ScriptType::Value::SHOT_CUSTOM:
+        case ScriptType::Value::ITEM_CUSTOM:
+        case ScriptType::Value::UNKNOWN:
+            break;
     }
     return 0;
 }
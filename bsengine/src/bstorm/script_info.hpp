@@ -31,7 +31,7 @@ public:
     static ScriptType FromName(const std::string& name);
 };
 
-constexpr wchar_t* SCRIPT_VERSION_PH3 = L"3";
+constexpr const wchar_t* SCRIPT_VERSION_PH3 = L"3";
 
 class ScriptInfo
 {
@@ -3,12 +3,12 @@
 namespace bstorm
 {
 // prefix
-constexpr char* DNH_RUNTIME_PREFIX = "r_"; // ^C֐
-constexpr char* DNH_RUNTIME_BUILTIN_PREFIX = "rb_"; // ^CCuɏĂgݍ݊֐
+constexpr const char* DNH_RUNTIME_PREFIX = "r_"; // ^C֐
+constexpr const char* DNH_RUNTIME_BUILTIN_PREFIX = "rb_"; // ^CCuɏĂgݍ݊֐
 #ifdef _DEBUG
-constexpr char* DNH_BUILTIN_FUNC_PREFIX = "b_"; // gݍ݊֐
+constexpr const char* DNH_BUILTIN_FUNC_PREFIX = "b_"; // gݍ݊֐
 #else
-constexpr char* DNH_BUILTIN_FUNC_PREFIX = "d_"; // gݍ݊֐
+constexpr const char* DNH_BUILTIN_FUNC_PREFIX = "d_"; // gݍ݊֐
 #endif
-constexpr char* DNH_VAR_PREFIX = "d_"; // ϐ
+constexpr const char* DNH_VAR_PREFIX = "d_"; // ϐ
 }
\ No newline at end of file
@@ -129,6 +129,9 @@ function r_neg(x)
   return -rl_tonum(x);
 end
 
+-- mathの関数に直接渡す値をrb_*と同じく数値にする(nilは0)
+r_tonum = rl_tonum;
+
 -- throws
 local function r_cmp(x, y)
   if type(x) ~= type(y) then
@@ -207,6 +210,19 @@ function r_cat(a, b)
   return r_mcat(r_cp(a), b);
 end
 
+-- 文字列として読むだけの箇所には文字の配列ではなくLuaの文字列を渡す
+function r_tostr(s)
+  return table.concat(s);
+end
+
+function r_itostr(n)
+  return string.format("%d", rl_toint(n));
+end
+
+function r_rtostr(n)
+  return string.format("%f", rl_tonum(n));
+end
+
 -- throws
 function r_slice(a, s, e)
   if type(a) ~= "table" then
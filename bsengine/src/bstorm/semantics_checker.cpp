@@ -4,28 +4,28 @@
 
 namespace bstorm
 {
-static Log invalid_return(const std::shared_ptr<SourcePos>& srcPos)
+static Log invalid_return(const NodePos* srcPos)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid return: 'return' with a value is available only to 'function' function type.")
         .AddSourcePos(srcPos);
 }
 
-static Log variable_call(const std::shared_ptr<SourcePos>& srcPos, const std::string& name)
+static Log variable_call(const NodePos* srcPos, const std::string& name)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid variable call: Variable '" + name + "' can not be called as if it were a function.")
         .AddSourcePos(srcPos);
 }
 
-static Log undefined_name(const std::shared_ptr<SourcePos>& srcPos, const std::string& name)
+static Log undefined_name(const NodePos* srcPos, const std::string& name)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Undefined name: '" + name + "' is not defined.")
         .AddSourcePos(srcPos);
 }
 
-static Log wrong_number_args(const std::shared_ptr<SourcePos>& srcPos, const std::string& name, int passed, int expected)
+static Log wrong_number_args(const NodePos* srcPos, const std::string& name, int passed, int expected)
 {
     auto msg = "Argument count mismatch: Wrong number of arguments passed to '" + name + "' (passed : " + std::to_string(passed) + ", expected : " + std::to_string(expected) + ").";
     return Log(LogLevel::LV_ERROR)
@@ -33,28 +33,28 @@ static Log wrong_number_args(const std::shared_ptr<SourcePos>& srcPos, const std
         .AddSourcePos(srcPos);
 }
 
-static Log invalid_left_value(const std::shared_ptr<SourcePos>& srcPos, const std::string& name)
+static Log invalid_left_value(const NodePos* srcPos, const std::string& name)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid assignment: '" + name + "' is not a variable.")
         .AddSourcePos(srcPos);
 }
 
-static Log invalid_sub_call(const std::shared_ptr<SourcePos>& srcPos, const std::string& name)
+static Log invalid_sub_call(const NodePos* srcPos, const std::string& name)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid subroutine call: Sub '" + name + "' can not be called as an expression.")
         .AddSourcePos(srcPos);
 }
 
-static Log invalid_task_call(const std::shared_ptr<SourcePos>& srcPos, const std::string& name)
+static Log invalid_task_call(const NodePos* srcPos, const std::string& name)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid micro thread call: Task '" + name + "' can not be called as an expression.")
         .AddSourcePos(srcPos);
 }
 
-static Log invalid_break(const std::shared_ptr<SourcePos>& srcPos)
+static Log invalid_break(const NodePos* srcPos)
 {
     return Log(LogLevel::LV_ERROR)
         .Msg("Invalid break: 'break' found outside a loop.")
@@ -142,7 +142,7 @@ void SemanticsChecker::Traverse(NodeCallExp& call)
     {
         // 変数を呼び出している
         errors_.push_back(variable_call(call.srcPos, call.name));
-    } else if (GetParamCnt(def) != call.args.size())
+    } else if (GetParamCnt(def) != (int)call.args.size())
     {
         // 引数の数が定義と一致しない
         errors_.push_back(wrong_number_args(call.srcPos, call.name, (int)call.args.size(), GetParamCnt(def)));
@@ -198,7 +198,7 @@ void SemanticsChecker::Traverse(NodeCallStmt& call)
     {
         // 変数を呼び出している
         errors_.push_back(variable_call(call.srcPos, call.name));
-    } else if (GetParamCnt(def) != call.args.size())
+    } else if (GetParamCnt(def) != (int)call.args.size())
     {
         // 引数の数が定義と一致しない
         errors_.push_back(wrong_number_args(call.srcPos, call.name, (int)call.args.size(), GetParamCnt(def)));
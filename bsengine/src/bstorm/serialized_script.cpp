@@ -7,14 +7,14 @@
 #include <bstorm/logger.hpp>
 #include <bstorm/api.hpp>
 #include <bstorm/source_map.hpp>
-#include <bstorm/parser.hpp>
-#include <bstorm/semantics_checker.hpp>
-#include <bstorm/code_analyzer.hpp>
-#include <bstorm/code_generator.hpp>
-#include <bstorm/script_entry_routine_names.hpp>
+#include <bstorm/script_compiler.hpp>
+#include <bstorm/script_cache.hpp>
+#include <bstorm/dnh_token_cache.hpp>
 
 #include <luajit/lua.hpp>
 
+#include <algorithm>
+
 namespace bstorm
 {
 SerializedScriptSignature::SerializedScriptSignature(const std::wstring & path, ScriptType type, std::wstring version, TimeStamp lastUpdateTime) :
@@ -45,48 +45,34 @@ size_t SerializedScriptSignature::hashValue() const
     return h;
 }
 
-SerializedScript::SerializedScript(const SerializedScriptSignature& signature, const std::shared_ptr<FileLoader>& fileLoader) :
+SerializedScript::SerializedScript(const SerializedScriptSignature& signature, const std::shared_ptr<FileLoader>& fileLoader, const std::shared_ptr<DnhTokenCache>& tokenCache) :
     signature_(signature)
 {
-    std::unique_ptr<lua_State, decltype(&lua_close)> L(luaL_newstate(), lua_close);
-    // 쐬
-    auto globalEnv = CreateInitRootEnv(signature.type, signature.version, nullptr);
-
-    // p[X
-    ScriptInfo scriptInfo;
-    std::shared_ptr<NodeBlock> program = ParseDnhScript(signature.path, globalEnv, true, &scriptInfo, fileLoader);
-
-    // ÓIG[
+    const CodeGenerator::Option codeGenOption = GetDefaultCodeGeneratorOption();
+    const ScriptCacheKey cacheKey{ signature.path, signature.type, signature.version, GetCompileOptionName(codeGenOption) };
+    const std::wstring cachePath = GetScriptCachePath(cacheKey);
     {
-        SemanticsChecker checker;
-        auto errors_ = checker.Check(*program);
-        for (auto& err : errors_)
-        {
-            Logger::Write(err);
-        }
-        if (!errors_.empty())
+        ScriptCacheData cache;
+        if (LoadScriptCache(cachePath, cacheKey, fileLoader, &cache))
         {
-            throw Log(LogLevel::LV_ERROR)
-                .Msg("Found " + std::to_string(errors_.size()) + " script error" + (errors_.size() > 1 ? "s." : "."))
-                .Param(LogParam(LogParam::Tag::SCRIPT, signature.path));
+            scriptInfo_ = std::move(cache.scriptInfo);
+            srcMap_ = std::move(cache.srcMap);
+            byteCode_ = std::move(cache.byteCode);
+            srcCode_ = std::move(cache.srcCode);
+            builtInSubNameConversionMap_.insert(cache.builtInSubNames.begin(), cache.builtInSubNames.end());
+            return;
         }
     }
 
-    // ÓI
-    CodeAnalyzer analyzer;
-    analyzer.Analyze(*program);
-
-    // R[h
-    CodeGenerator::Option codeGenOption;
-    codeGenOption.enableNilCheck = false;
-    codeGenOption.deleteUnreachableDefinition = true;
-    codeGenOption.deleteUnneededAssign = true;
-    CodeGenerator codeGen(codeGenOption);
-    codeGen.Generate(*program);
+    std::unique_ptr<lua_State, decltype(&lua_close)> L(luaL_newstate(), lua_close);
+    // LuãR[hɕϊ
+    DnhCompileResult result;
+    CompileDnhScript(signature.path, signature.type, codeGenOption, fileLoader, tokenCache, &result);
 
     // RpC
     {
-        int hasCompileError = luaL_loadstring(L.get(), codeGen.GetCode().c_str());
+        // 񃊃eNUL肤̂Œn, `NluaL_loadstringƓ
+        int hasCompileError = luaL_loadbuffer(L.get(), result.code.data(), result.code.size(), result.code.c_str());
         if (hasCompileError)
         {
             std::string msg = lua_tostring(L.get(), -1); lua_pop(L.get(), 1);
@@ -98,7 +84,7 @@ SerializedScript::SerializedScript(const SerializedScriptSignature& signature, c
                 if (ss.size() >= 2)
                 {
                     int line = _wtoi(ss[1].c_str());
-                    err.AddSourcePos(codeGen.GetSourceMap().GetSourcePos(line));
+                    err.AddSourcePos(result.srcMap.GetSourcePos(line));
                 } else
                 {
                     err.Param(LogParam(LogParam::Tag::SCRIPT, signature.path));
@@ -112,21 +98,33 @@ SerializedScript::SerializedScript(const SerializedScriptSignature& signature, c
             }
         }
     }
-    scriptInfo.Serialize(scriptInfo_);
-    codeGen.GetSourceMap().Serialize(srcMap_);
+    result.scriptInfo.Serialize(scriptInfo_);
+    result.srcMap.Serialize(srcMap_);
     SerializeChunk(L.get(), byteCode_);
 #ifdef _DEBUG
-    srcCode_ = codeGen.GetCode();
+    srcCode_ = std::move(result.code);
 #endif
-    for (auto&& name : SCRIPT_ENTRY_ROUTINE_NAMES)
+    builtInSubNameConversionMap_ = std::move(result.builtInSubNameConversionMap);
+
+    // ȍ~̓RpCɓǂݍ
+    try
     {
-        if (auto def = globalEnv->FindDef(name))
+        std::vector<ScriptSourceFile> sources(result.sourcePaths.size());
+        for (size_t i = 0; i < result.sourcePaths.size(); i++)
         {
-            builtInSubNameConversionMap_[name] = def->convertedName;
-        } else
-        {
-            builtInSubNameConversionMap_[name] = name;
+            if (!GetScriptSourceFile(result.sourcePaths[i], fileLoader, &sources[i])) return;
         }
+        ScriptCacheData cache;
+        cache.scriptInfo = scriptInfo_;
+        cache.srcMap = srcMap_;
+        cache.byteCode = byteCode_;
+        cache.srcCode = srcCode_;
+        cache.builtInSubNames.assign(builtInSubNameConversionMap_.begin(), builtInSubNameConversionMap_.end());
+        SaveScriptCache(cachePath, cacheKey, sources, cache);
+        TrimScriptCache(SCRIPT_CACHE_MAX_TOTAL_SIZE);
+    } catch (Log& log)
+    {
+        Logger::Write(log);
     }
 }
 std::string SerializedScript::GetConvertedBuiltInSubName(const std::string & name) const
@@ -139,24 +137,39 @@ std::string SerializedScript::GetConvertedBuiltInSubName(const std::string & nam
     return "";
 }
 
+// `Xbh̕c
+static int GetCompileWorkerCount()
+{
+    constexpr int maxWorkerCnt = 4;
+    return std::min(std::max((int)std::thread::hardware_concurrency() - 1, 1), maxWorkerCnt);
+}
+
 SerializedScriptStore::SerializedScriptStore(const std::shared_ptr<FileLoader>& fileLoader) :
-    fileLoader_(fileLoader)
+    fileLoader_(fileLoader),
+    tokenCache_(std::make_shared<DnhTokenCache>(DNH_TOKEN_CACHE_MAX_TOKEN_COUNT)),
+    compilePool_(GetCompileWorkerCount())
 {
 }
 
 const std::shared_ptr<SerializedScript>& SerializedScriptStore::Load(const std::wstring & path, ScriptType type, const std::wstring & version)
 {
     SerializedScriptSignature signature(path, type, version, GetFileLastUpdateTime(path));
-    return cacheStore_.Load(signature, signature, fileLoader_);
+    return cacheStore_.Load(signature, signature, fileLoader_, tokenCache_);
 }
 
-SerializedScriptSignature SerializedScriptStore::LoadAsync(const std::wstring & path, ScriptType type, const std::wstring & version)
+SerializedScriptSignature SerializedScriptStore::LoadAsync(const std::wstring & path, ScriptType type, const std::wstring & version, int priority)
 {
     SerializedScriptSignature signature(path, type, version, GetFileLastUpdateTime(path));
-    cacheStore_.LoadAsync(signature, signature, fileLoader_);
+    cacheStore_.LoadAsync(compilePool_, priority, signature, signature, fileLoader_, tokenCache_);
     return signature;
 }
 
+void SerializedScriptStore::CancelLoad(const std::wstring & path, ScriptType type, const std::wstring & version)
+{
+    SerializedScriptSignature signature(path, type, version, GetFileLastUpdateTime(path));
+    cacheStore_.CancelLoad(signature);
+}
+
 NullableSharedPtr<SerializedScript> SerializedScriptStore::Get(const SerializedScriptSignature & signature) const
 {
     try
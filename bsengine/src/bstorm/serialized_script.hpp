@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bstorm/cache_store.hpp>
+#include <bstorm/task_pool.hpp>
 #include <bstorm/script_info.hpp>
 #include <bstorm/time_stamp.hpp>
 #include <bstorm/nullable_shared_ptr.hpp>
@@ -41,10 +42,11 @@ struct hash<bstorm::SerializedScriptSignature>
 namespace bstorm
 {
 class FileLoader;
+class DnhTokenCache;
 class SerializedScript
 {
 public:
-    SerializedScript(const SerializedScriptSignature& signature, const std::shared_ptr<FileLoader>& fileLoader);
+    SerializedScript(const SerializedScriptSignature& signature, const std::shared_ptr<FileLoader>& fileLoader, const std::shared_ptr<DnhTokenCache>& tokenCache);
     const std::string& GetScriptInfo() const { return scriptInfo_; }
     const std::string& GetSourceMap() const { return srcMap_; }
     const char* GetByteCode() { return byteCode_.data(); }
@@ -66,7 +68,10 @@ class SerializedScriptStore
 public:
     SerializedScriptStore(const std::shared_ptr<FileLoader>& fileLoader);
     const std::shared_ptr<SerializedScript>& Load(const std::wstring& path, ScriptType type, const std::wstring& version);
-    SerializedScriptSignature LoadAsync(const std::wstring& path, ScriptType type, const std::wstring& version);
+    // priority : lower value compiles first
+    SerializedScriptSignature LoadAsync(const std::wstring& path, ScriptType type, const std::wstring& version, int priority);
+    // withdraw one LoadAsync request; the compile is cancelled only when no other request is waiting and it has not started
+    void CancelLoad(const std::wstring& path, ScriptType type, const std::wstring& version);
     NullableSharedPtr<SerializedScript> Get(const SerializedScriptSignature& signature) const;
     void RemoveCache(const SerializedScriptSignature& signature);
     bool IsLoadCompleted(const SerializedScriptSignature& signature) const;
@@ -74,6 +79,8 @@ public:
     void ForEach(Fn func) { cacheStore_.ForEach(func); }
 private:
     std::shared_ptr<FileLoader> fileLoader_;
+    std::shared_ptr<DnhTokenCache> tokenCache_;
+    TaskPool compilePool_;
     CacheStore<SerializedScriptSignature, SerializedScript> cacheStore_;
 };
 }
@@ -54,6 +54,11 @@ void ShotDataTable::Add(const std::shared_ptr<ShotData>& data)
 {
     if (data->texture)
     {
+        if (!data->renderTexture)
+        {
+            data->renderTexture = data->texture;
+            data->atlasRegion = AtlasRegion();
+        }
         table_.emplace(data->id, data);
     }
 }
@@ -92,6 +97,8 @@ void ShotDataTable::Reload(const std::wstring & path, const std::shared_ptr<Sour
     std::wstring uniqPath = GetCanonicalPath(path);
     auto userShotData = ParseUserShotData(uniqPath, fileLoader_);
     auto& texture = textureStore_->Load(userShotData->imagePath);
+    AtlasRegion atlasRegion;
+    auto renderTexture = textureStore_->RegisterToAtlas(texture, &atlasRegion);
     for (auto& entry : userShotData->dataMap)
     {
         auto& data = entry.second;
@@ -141,6 +148,8 @@ void ShotDataTable::Reload(const std::wstring & path, const std::shared_ptr<Sour
             data.collisions.push_back({ r, 0.0f, 0.0f });
         }
         data.texture = texture;
+        data.renderTexture = renderTexture;
+        data.atlasRegion = atlasRegion;
         table_.emplace(data.id, std::make_shared<ShotData>(data));
 
 		/*
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <bstorm/rect.hpp>
+#include <bstorm/atlas_packer.hpp>
 #include <bstorm/animation.hpp>
 #include <bstorm/color_rgb.hpp>
 #include <bstorm/nullable_shared_ptr.hpp>
@@ -78,6 +79,10 @@ public:
 	FadeMetadata fadeData;
     AnimationData animationData;
     std::shared_ptr<Texture> texture;
+    // 描画に使うテクスチャ, アトラスに登録されていればそのページ
+    std::shared_ptr<Texture> renderTexture;
+    // renderTexture上の位置, 矩形はRemapしてから使う
+    AtlasRegion atlasRegion;
 	bool useSelfDelayRect;
 	bool useSelfFadeRect;
 	bool useExFade;
@@ -9,6 +9,8 @@
 #include <yas/buffers.hpp>
 
 #include <deque>
+#include <mutex>
+#include <unordered_set>
 
 namespace bstorm
 {
@@ -17,6 +19,27 @@ std::string SourcePos::ToString() const
     return ToUTF8(*filename) + ":" + std::to_string(line) + ((column >= 0) ? (":" + std::to_string(column)) : "");
 }
 
+const std::wstring* InternSourcePath(const std::wstring& path)
+{
+    // o^pX͉Ȃ
+    static std::mutex mutex;
+    static std::unordered_set<std::wstring> paths;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*paths.insert(path).first;
+}
+
+std::shared_ptr<std::wstring> NodePos::GetFilename() const
+{
+    if (!filename) return nullptr;
+    // LȂshared_ptr
+    return std::shared_ptr<std::wstring>(std::shared_ptr<std::wstring>(), const_cast<std::wstring*>(filename));
+}
+
+std::shared_ptr<SourcePos> NodePos::ToSourcePos() const
+{
+    return std::make_shared<SourcePos>(line, column, GetFilename());
+}
+
 // VACYp̒ԕ\
 // <srcPath, <outputLine, srcLine>>
 using CompactSourceMap = std::map<std::wstring, std::deque<std::pair<uint16_t, uint16_t>>>;
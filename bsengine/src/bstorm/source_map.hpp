@@ -25,6 +25,30 @@ struct SourceLoc
     SourcePos end;
 };
 
+// Returns the single copy of the path kept for the lifetime of the process.
+const std::wstring* InternSourcePath(const std::wstring& path);
+
+// Position held by AST nodes.
+// filename comes from InternSourcePath, so copying needs no reference counting.
+struct NodePos
+{
+    NodePos() : line(-1), column(-1), filename(nullptr) { }
+    NodePos(int line, int column, const std::wstring* path) :
+        line(line), column(column), filename(path) {}
+    int line;
+    int column;
+    const std::wstring* filename;
+    // the returned pointers do not own the interned path
+    std::shared_ptr<std::wstring> GetFilename() const;
+    std::shared_ptr<SourcePos> ToSourcePos() const;
+};
+
+struct NodeLoc
+{
+    NodePos begin;
+    NodePos end;
+};
+
 class SourceMap
 {
 public:
@@ -2,9 +2,27 @@
 
 #include <sstream>
 #include <regex>
+#ifndef _WIN32
+#include <codecvt>
+#include <locale>
+#endif
 
 namespace bstorm
 {
+#ifndef _WIN32
+std::string ToUTF8(const std::wstring& ws)
+{
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> conv("", L"");
+    return conv.to_bytes(ws);
+}
+
+std::wstring ToUnicode(const std::string& s)
+{
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> conv("", L"");
+    return conv.from_bytes(s);
+}
+#endif
+
 std::vector<std::wstring> Split(const std::wstring& s, wchar_t delimiter)
 {
     std::vector<std::wstring> r;
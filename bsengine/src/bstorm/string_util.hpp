@@ -2,10 +2,13 @@
 
 #include <string>
 #include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace bstorm
 {
+#ifdef _WIN32
 template <UINT cp>
 std::string ToMultiByte(const std::wstring& ws)
 {
@@ -35,6 +38,11 @@ inline std::wstring ToUnicode(const std::string& s)
 {
     return FromMultiByte<CP_UTF8>(s);
 }
+#else
+// non-Windows (headless compiler)
+std::string ToUTF8(const std::wstring& ws);
+std::wstring ToUnicode(const std::string& s);
+#endif
 
 std::vector<std::wstring> Split(const std::wstring& s, wchar_t delimiter);
 std::vector<std::wstring> Split(const std::wstring& s, const std::wstring& delimiter);
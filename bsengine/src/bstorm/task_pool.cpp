@@ -0,0 +1,106 @@
+﻿#include <bstorm/task_pool.hpp>
+
+#include <algorithm>
+
+namespace bstorm
+{
+TaskPool::TaskPool(int workerCnt) :
+    nextId_(1),
+    isStopped_(false)
+{
+    workerCnt = std::max(workerCnt, 1);
+    workers_.reserve(workerCnt);
+    for (int i = 0; i < workerCnt; i++)
+    {
+        workers_.emplace_back([this]() { WorkerMain(); });
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopped_ = true;
+        queue_.clear();
+        priorities_.clear();
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+TaskPool::TaskId TaskPool::Push(int priority, std::function<void()>&& task)
+{
+    TaskId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        queue_.emplace(QueueKey(priority, id), std::move(task));
+        priorities_[id] = priority;
+    }
+    cv_.notify_one();
+    return id;
+}
+
+bool TaskPool::Cancel(TaskId id)
+{
+    std::function<void()> task;
+    // タスクの破棄はロックの外で行う
+    return PopTask(id, &task);
+}
+
+bool TaskPool::RunNow(TaskId id)
+{
+    std::function<void()> task;
+    if (!PopTask(id, &task)) return false;
+    task();
+    return true;
+}
+
+void TaskPool::RaisePriority(TaskId id, int priority)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = priorities_.find(id);
+    if (it == priorities_.end() || it->second <= priority) return;
+    auto queueIt = queue_.find(QueueKey(it->second, id));
+    auto task = std::move(queueIt->second);
+    queue_.erase(queueIt);
+    queue_.emplace(QueueKey(priority, id), std::move(task));
+    it->second = priority;
+}
+
+void TaskPool::WorkerMain()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return isStopped_ || !queue_.empty(); });
+            if (isStopped_) return;
+            auto it = queue_.begin();
+            priorities_.erase(it->first.second);
+            task = std::move(it->second);
+            queue_.erase(it);
+        }
+        try
+        {
+            task();
+        } catch (...) {}
+    }
+}
+
+bool TaskPool::PopTask(TaskId id, std::function<void()>* task)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = priorities_.find(id);
+    if (it == priorities_.end()) return false;
+    auto queueIt = queue_.find(QueueKey(it->second, id));
+    *task = std::move(queueIt->second);
+    queue_.erase(queueIt);
+    priorities_.erase(it);
+    return true;
+}
+}
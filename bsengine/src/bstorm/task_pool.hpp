@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <bstorm/non_copyable.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bstorm
+{
+// 固定数のワーカースレッドで優先度付きのタスクを実行する
+// priorityが小さいほど先に実行される, 同じ優先度なら追加順
+// thread-safe
+class TaskPool : private NonCopyable
+{
+public:
+    using TaskId = uint64_t;
+    TaskPool(int workerCnt);
+    // 未実行のタスクは破棄し, 実行中のタスクは完了を待つ
+    ~TaskPool();
+    TaskId Push(int priority, std::function<void()>&& task);
+    // 未実行なら取り消してtrueを返す
+    bool Cancel(TaskId id);
+    // 未実行なら呼び出し元のスレッドで直ちに実行してtrueを返す
+    bool RunNow(TaskId id);
+    // 未実行で現在より高い優先度なら優先度を上げる
+    void RaisePriority(TaskId id, int priority);
+    int GetWorkerCount() const { return (int)workers_.size(); }
+private:
+    void WorkerMain();
+    bool PopTask(TaskId id, std::function<void()>* task);
+    using QueueKey = std::pair<int, TaskId>; // (priority, id)
+    std::map<QueueKey, std::function<void()>> queue_;
+    std::unordered_map<TaskId, int> priorities_; // 未実行のタスクの優先度
+    TaskId nextId_;
+    bool isStopped_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::thread> workers_;
+};
+}
@@ -5,6 +5,7 @@
 #include <bstorm/logger.hpp>
 #include <bstorm/graphic_device.hpp>
 
+#include <cstring>
 #include <d3dx9.h>
 
 namespace bstorm
@@ -35,12 +36,38 @@ static IDirect3DTexture9 * LoadTextureFromFile(const std::wstring & path, Graphi
 
 Texture::Texture(const std::wstring & path, const std::shared_ptr<GraphicDevice> & graphicDevice) :
     path_(path),
+    isLoadedFromFile_(true),
     d3DTexture_(nullptr),
     graphicDevice_(graphicDevice)
 {
     Reload();
 }
 
+Texture::Texture(const std::wstring & name, int width, int height, const std::shared_ptr<GraphicDevice>& graphicDevice) :
+    path_(name),
+    isLoadedFromFile_(false),
+    width_(width),
+    height_(height),
+    d3DTexture_(nullptr),
+    graphicDevice_(graphicDevice)
+{
+    if (FAILED(graphicDevice_->GetDevice()->CreateTexture(width, height, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &d3DTexture_, NULL)))
+    {
+        throw Log(LogLevel::LV_ERROR)
+            .Msg("Failed to create texture.")
+            .Param(LogParam(LogParam::Tag::TEXTURE, path_));
+    }
+    D3DLOCKED_RECT lockedRect;
+    if (SUCCEEDED(d3DTexture_->LockRect(0, &lockedRect, NULL, 0)))
+    {
+        for (int y = 0; y < height; y++)
+        {
+            memset((uint8_t*)lockedRect.pBits + y * lockedRect.Pitch, 0, width * sizeof(D3DCOLOR));
+        }
+        d3DTexture_->UnlockRect(0);
+    }
+}
+
 Texture::~Texture()
 {
     safe_release(d3DTexture_);
@@ -72,6 +99,7 @@ IDirect3DTexture9* Texture::GetTexture() const
 
 void Texture::Reload()
 {
+    if (!isLoadedFromFile_) return;
     auto texture = LoadTextureFromFile(path_, *graphicDevice_);
     if (texture == nullptr)
     {
@@ -83,6 +111,11 @@ void Texture::Reload()
     GetD3DTextureSize(d3DTexture_, &width_, &height_);
 }
 
+bool Texture::IsLoadedFromFile() const
+{
+    return isLoadedFromFile_;
+}
+
 void GetD3DTextureSize(IDirect3DTexture9 * texture, int * width, int * height)
 {
     D3DSURFACE_DESC desc;
@@ -110,7 +143,118 @@ int GetD3DTextureHeight(IDirect3DTexture9 * texture)
     return h;
 }
 
+// ページの大きさ, 2048はD3D9世代のGPUなら大抵扱える
+constexpr int ATLAS_PAGE_SIZE = 2048;
+// フィルタリング時に隣の画像が滲まないように空ける
+constexpr int ATLAS_PADDING = 2;
+
+TextureAtlas::TextureAtlas(int pageWidth, int pageHeight, int padding, const std::shared_ptr<GraphicDevice>& graphicDevice) :
+    packer_(pageWidth, pageHeight, padding),
+    graphicDevice_(graphicDevice)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+bool TextureAtlas::IsRegistrable(const std::shared_ptr<Texture>& texture) const
+{
+    if (!texture || !texture->GetTexture()) return false;
+    // 大きい画像を入れるとページがすぐに埋まるので, ページの1/4以下のものだけ
+    return texture->GetWidth() <= packer_.GetPageWidth() / 2 && texture->GetHeight() <= packer_.GetPageHeight() / 2;
+}
+
+NullableSharedPtr<Texture> TextureAtlas::Register(const std::shared_ptr<Texture>& texture, AtlasRegion* region)
+{
+    if (!IsRegistrable(texture)) return nullptr;
+
+    // 登録済み
+    auto it = regions_.find(texture->GetPath());
+    if (it != regions_.end())
+    {
+        *region = it->second;
+        return pages_[region->page];
+    }
+
+    AtlasRegion newRegion;
+    if (!packer_.Insert(texture->GetWidth(), texture->GetHeight(), &newRegion)) return nullptr;
+
+    if (newRegion.page >= pages_.size())
+    {
+        pages_.resize(newRegion.page + 1);
+    }
+    auto& page = pages_[newRegion.page];
+    if (!page)
+    {
+        page = std::make_shared<Texture>(L"atlas-page-" + std::to_wstring(newRegion.page), packer_.GetPageWidth(), packer_.GetPageHeight(), graphicDevice_);
+    }
+
+    // ページに複製
+    IDirect3DSurface9* srcSurface = nullptr;
+    IDirect3DSurface9* dstSurface = nullptr;
+    bool copied = false;
+    if (SUCCEEDED(texture->GetTexture()->GetSurfaceLevel(0, &srcSurface)) && SUCCEEDED(page->GetTexture()->GetSurfaceLevel(0, &dstSurface)))
+    {
+        RECT dstRect = { newRegion.x, newRegion.y, newRegion.x + newRegion.width, newRegion.y + newRegion.height };
+        copied = SUCCEEDED(D3DXLoadSurfaceFromSurface(dstSurface, NULL, &dstRect, srcSurface, NULL, NULL, D3DX_FILTER_NONE, 0));
+    }
+    safe_release(srcSurface);
+    safe_release(dstSurface);
+
+    // NOTE: 複製に失敗した領域は使われないまま残る
+    if (!copied) return nullptr;
+
+    regions_[texture->GetPath()] = newRegion;
+    *region = newRegion;
+    return page;
+}
+
+void TextureAtlas::RemoveUnusedPage()
+{
+    for (int i = 0; i < pages_.size(); i++)
+    {
+        auto& page = pages_[i];
+        if (page && page.use_count() <= 1)
+        {
+            Logger::Write(std::move(
+                Log(LogLevel::LV_INFO)
+                .Msg("Released atlas page.")
+                .Param(LogParam(LogParam::Tag::TEXTURE, page->GetPath()))));
+            page.reset();
+            packer_.ClearPage(i);
+            auto it = regions_.begin();
+            while (it != regions_.end())
+            {
+                if (it->second.page == i)
+                {
+                    regions_.erase(it++);
+                } else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+}
+
+int TextureAtlas::GetPageCount() const
+{
+    return pages_.size();
+}
+
+const std::shared_ptr<Texture>& TextureAtlas::GetPage(int page) const
+{
+    return pages_.at(page);
+}
+
+AtlasPageStats TextureAtlas::GetPageStats(int page) const
+{
+    return packer_.GetPageStats(page);
+}
+
 TextureStore::TextureStore(const std::shared_ptr<GraphicDevice>& graphicDevice) :
+    atlas_(std::make_shared<TextureAtlas>(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, ATLAS_PADDING, graphicDevice)),
     graphicDevice_(graphicDevice)
 {
 }
@@ -157,10 +301,26 @@ bool TextureStore::IsReserved(const std::wstring & path) const
 void TextureStore::RemoveUnusedTexture()
 {
     cacheStore_.RemoveUnused();
+    atlas_->RemoveUnusedPage();
 }
 bool TextureStore::IsLoadCompleted(const std::wstring& path) const
 {
     auto uniqPath = GetCanonicalPath(path);
     return cacheStore_.IsLoadCompleted(uniqPath);
 }
+
+std::shared_ptr<Texture> TextureStore::RegisterToAtlas(const std::shared_ptr<Texture>& texture, AtlasRegion * region)
+{
+    if (auto page = atlas_->Register(texture, region))
+    {
+        return page;
+    }
+    *region = AtlasRegion();
+    return texture;
+}
+
+const std::shared_ptr<TextureAtlas>& TextureStore::GetAtlas() const
+{
+    return atlas_;
+}
 }
\ No newline at end of file
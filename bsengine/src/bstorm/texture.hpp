@@ -1,10 +1,14 @@
 ﻿#pragma once
 
 #include <bstorm/non_copyable.hpp>
+#include <bstorm/nullable_shared_ptr.hpp>
 #include <bstorm/cache_store.hpp> 
+#include <bstorm/atlas_packer.hpp>
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 #include <d3d9.h>
 
 namespace bstorm
@@ -15,20 +19,56 @@ class Texture : private NonCopyable
 {
 public:
     Texture(const std::wstring& path, const std::shared_ptr<GraphicDevice>& graphicDevice);
+    // 透明で初期化された空のテクスチャを作る
+    Texture(const std::wstring& name, int width, int height, const std::shared_ptr<GraphicDevice>& graphicDevice);
     ~Texture();
     const std::wstring& GetPath() const;
     int GetWidth() const;
     int GetHeight() const;
     IDirect3DTexture9* GetTexture() const;
     void Reload();
+    bool IsLoadedFromFile() const;
 private:
     const std::wstring path_;
+    const bool isLoadedFromFile_;
     int width_;
     int height_;
     IDirect3DTexture9* d3DTexture_;
     const std::shared_ptr<GraphicDevice> graphicDevice_;
 };
 
+// 小さいテクスチャを共有のページにまとめて, テクスチャの切り替えを減らす
+// ページはD3DPOOL_MANAGEDなのでデバイスロストの対応は不要
+class TextureAtlas : private NonCopyable
+{
+public:
+    TextureAtlas(int pageWidth, int pageHeight, int padding, const std::shared_ptr<GraphicDevice>& graphicDevice);
+    ~TextureAtlas();
+    // ページに複製して, 配置先のページを返す
+    // 登録できなければnullptr
+    NullableSharedPtr<Texture> Register(const std::shared_ptr<Texture>& texture, AtlasRegion* region);
+    bool IsRegistrable(const std::shared_ptr<Texture>& texture) const;
+    // どこからも参照されていないページを解放する
+    void RemoveUnusedPage();
+    int GetPageCount() const;
+    // 解放済みならnullptr
+    const std::shared_ptr<Texture>& GetPage(int page) const;
+    AtlasPageStats GetPageStats(int page) const;
+    template <class Fn>
+    void ForEachRegion(Fn func) const
+    {
+        for (const auto& entry : regions_)
+        {
+            func(entry.first, entry.second);
+        }
+    }
+private:
+    AtlasPacker packer_;
+    std::vector<std::shared_ptr<Texture>> pages_;
+    std::unordered_map<std::wstring, AtlasRegion> regions_;
+    const std::shared_ptr<GraphicDevice> graphicDevice_;
+};
+
 class TextureStore
 {
 public:
@@ -40,10 +80,15 @@ public:
     bool IsReserved(const std::wstring& path) const;
     void RemoveUnusedTexture();
     bool IsLoadCompleted(const std::wstring & path) const;
+    // アトラスに登録して描画用のテクスチャを返す
+    // 登録できなければtextureをそのまま返し, regionは恒等変換になる
+    std::shared_ptr<Texture> RegisterToAtlas(const std::shared_ptr<Texture>& texture, AtlasRegion* region);
+    const std::shared_ptr<TextureAtlas>& GetAtlas() const;
     template <class Fn>
     void ForEach(Fn func) { cacheStore_.ForEach(func); }
 private:
     CacheStore<std::wstring, Texture> cacheStore_;
+    std::shared_ptr<TextureAtlas> atlas_;
     const std::shared_ptr<GraphicDevice> graphicDevice_;
 };
 
@@ -1,11 +1,17 @@
 #include <bstorm/time_stamp.hpp>
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <bstorm/string_util.hpp>
+#include <sys/stat.h>
+#endif
 
 namespace bstorm
 {
 TimeStamp GetFileLastUpdateTime(const std::wstring & file) noexcept(false)
 {
+#ifdef _WIN32
     HANDLE fileHandle = CreateFile(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
     if (fileHandle == INVALID_HANDLE_VALUE)
     {
@@ -20,5 +26,13 @@ TimeStamp GetFileLastUpdateTime(const std::wstring & file) noexcept(false)
         return (high << 32u) | low;
     }
     return TIME_STAMP_NONE;
+#else
+    struct stat st;
+    if (stat(ToUTF8(file).c_str(), &st) != 0)
+    {
+        return TIME_STAMP_NONE;
+    }
+    return static_cast<uint64_t>(st.st_mtime);
+#endif
 }
 }
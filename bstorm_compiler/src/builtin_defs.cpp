@@ -0,0 +1,15 @@
+﻿#include <bstorm/builtin_registry.hpp>
+#include <bstorm/dnh_const.hpp>
+#include <bstorm/node.hpp>
+
+namespace bstorm
+{
+// コンパイルに必要な定義だけを登録する
+// 関数の実装は登録しないので, エンジン(api.cpp)とはリンクしない
+#define BUILTIN_FUNC(name) (nullptr)
+void DefineBuiltIns(const std::shared_ptr<Env>& env, BuiltInRegistry& reg, ScriptTypeSet type)
+{
+#include <bstorm/builtin_def_list.hpp>
+}
+#undef BUILTIN_FUNC
+}
@@ -0,0 +1,453 @@
+﻿#include <bstorm/script_compiler.hpp>
+#include <bstorm/parser.hpp>
+#include <bstorm/file_loader.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/string_util.hpp>
+#include <bstorm/lua_util.hpp>
+#include <bstorm/dnh_token_cache.hpp>
+#include <bstorm/script_cache.hpp>
+#include <bstorm/logger.hpp>
+
+#include "script_runner.hpp"
+
+#include <luajit/lua.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace bstorm;
+
+#ifndef BSTORM_RUNTIME_PATH
+#define BSTORM_RUNTIME_PATH "../bsengine/src/bstorm/script_runtime.lua"
+#endif
+
+// D3DやWin32を使わずにスクリプトをコンパイルし, 各段階の時間と出力の大きさを表示する
+// 使い方は PrintUsage を参照
+
+struct Options
+{
+    std::vector<std::wstring> inputPaths;
+    std::wstring outputDir; // 空なら出力しない
+    bool outputByteCode = false;
+    int repeatCount = 1;
+    ScriptType defaultType = ScriptType::Value::UNKNOWN; // ヘッダの無いファイルの種類, UNKNOWNなら飛ばす
+    bool useTokenCache = false;
+    std::wstring cacheDir; // 空ならスクリプトキャッシュを使わない
+    std::string expectCache; // "hit"か"miss", 空なら確かめない
+    bool compareTokenCache = false;
+    bool promoteGlobalToLocal = true;
+    bool foldConstants = true;
+    int runFrameCount = 0; // 0なら実行しない
+    std::wstring runtimePath = ToUnicode(BSTORM_RUNTIME_PATH);
+};
+
+// 1ファイル分の計測結果, 時間は繰り返しの合計
+struct FileResult
+{
+    DnhCompileStats stats;
+    double loadTime = 0.0;
+    double runTime = 0.0; // @MainLoopの合計, 繰り返しても1回分
+    size_t codeSize = 0;
+    size_t byteCodeSize = 0;
+    // 1回目のコンパイル結果, --compare-token-cache で比べる
+    std::string code;
+    std::vector<std::wstring> sourcePaths;
+};
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: bstorm_compiler [options] <file or directory>...\n"
+            "  -o <dir>       write compiled scripts to <dir>\n"
+            "  -b             write LuaJIT bytecode instead of Lua source\n"
+            "  -n <count>     compile each script <count> times and report the average\n"
+            "  -t <type>      compile scripts without a header as <type> (Player, Single, Plural, Stage, Package, ShotCustom, ItemCustom)\n"
+            "  --token-cache  cache tokens of included files across compilations, as the engine does\n"
+            "  --cache <dir>  save scripts to the script cache in <dir>, or load them from it and compare with a fresh compile\n"
+            "  --expect-cache <hit|miss>\n"
+            "                 fail unless every script is (hit) or is not (miss) loaded from the cache\n"
+            "  --compare-token-cache\n"
+            "                 also compile each script without the token cache, fail if the generated code differs,\n"
+            "                 and report how much parse time the token cache saves\n"
+            "  --no-promote-globals\n"
+            "                 keep top-level definitions as Lua globals (codegen before promoteGlobalToLocal)\n"
+            "  --no-fold      compile without constant folding\n"
+            "  --run <frames> run each script's @Initialize and then <frames> @MainLoop frames and report the time\n"
+            "                 (only built-in functions of the runtime library are available)\n"
+            "  --runtime <file>\n"
+            "                 runtime library for --run (default: " BSTORM_RUNTIME_PATH ")\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], Options* opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            opts->outputDir = ToUnicode(argv[++i]);
+        } else if (arg == "-b")
+        {
+            opts->outputByteCode = true;
+        } else if (arg == "-n" && i + 1 < argc)
+        {
+            opts->repeatCount = std::atoi(argv[++i]);
+            if (opts->repeatCount < 1) return false;
+        } else if (arg == "-t" && i + 1 < argc)
+        {
+            opts->defaultType = ScriptType::FromName(argv[++i]);
+            if (opts->defaultType.value == ScriptType::Value::UNKNOWN) return false;
+        } else if (arg == "--token-cache")
+        {
+            opts->useTokenCache = true;
+        } else if (arg == "--compare-token-cache")
+        {
+            opts->compareTokenCache = true;
+        } else if (arg == "--no-promote-globals")
+        {
+            opts->promoteGlobalToLocal = false;
+        } else if (arg == "--no-fold")
+        {
+            opts->foldConstants = false;
+        } else if (arg == "--run" && i + 1 < argc)
+        {
+            opts->runFrameCount = std::atoi(argv[++i]);
+            if (opts->runFrameCount < 1) return false;
+        } else if (arg == "--runtime" && i + 1 < argc)
+        {
+            opts->runtimePath = ToUnicode(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc)
+        {
+            opts->cacheDir = ToUnicode(argv[++i]);
+        } else if (arg == "--expect-cache" && i + 1 < argc)
+        {
+            opts->expectCache = argv[++i];
+            if (opts->expectCache != "hit" && opts->expectCache != "miss") return false;
+        } else if (!arg.empty() && arg[0] == '-')
+        {
+            return false;
+        } else
+        {
+            opts->inputPaths.push_back(ToUnicode(arg));
+        }
+    }
+    if (!opts->expectCache.empty() && opts->cacheDir.empty()) return false;
+    return !opts->inputPaths.empty();
+}
+
+static bool WriteFile(const std::wstring& path, const std::string& data)
+{
+    MakeDirectoryP(GetParentPath(path));
+#ifdef _WIN32
+    std::ofstream ofs(path, std::ios::binary);
+#else
+    std::ofstream ofs(ToUTF8(path), std::ios::binary);
+#endif
+    if (!ofs) return false;
+    ofs.write(data.data(), data.size());
+    return (bool)ofs;
+}
+
+static double Elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void AddStats(DnhCompileStats* total, const DnhCompileStats& stats)
+{
+    total->parseTime += stats.parseTime;
+    total->checkTime += stats.checkTime;
+    total->analyzeTime += stats.analyzeTime;
+    total->inlineTime += stats.inlineTime;
+    total->foldTime += stats.foldTime;
+    total->escapeTime += stats.escapeTime;
+    total->codeGenTime += stats.codeGenTime;
+    total->nodeCount += stats.nodeCount;
+    total->arenaSize += stats.arenaSize;
+}
+
+// Luaのコードからバイトコードを作る, 失敗したらLogを投げる
+static double LoadChunk(const std::string& code, const std::wstring& path, std::string* byteCode)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<lua_State, decltype(&lua_close)> L(luaL_newstate(), lua_close);
+    // エンジンと同じく, NULを含むコードも最後まで読む
+    if (luaL_loadbuffer(L.get(), code.data(), code.size(), code.c_str()))
+    {
+        std::string msg = lua_tostring(L.get(), -1);
+        throw Log(LogLevel::LV_ERROR)
+            .Msg("Failed to load compiled code. (" + msg + ")")
+            .Param(LogParam(LogParam::Tag::SCRIPT, path));
+    }
+    double loadTime = Elapsed(start);
+    byteCode->clear();
+    SerializeChunk(L.get(), *byteCode);
+    return loadTime;
+}
+
+static void SortBuiltInSubNames(ScriptCacheData* data)
+{
+    std::sort(data->builtInSubNames.begin(), data->builtInSubNames.end());
+}
+
+// エンジンと同じキーと形式でスクリプトキャッシュを読み書きする
+// キャッシュから読めたら今コンパイルした結果と一致することを確かめ, 読めなければ保存する
+// キャッシュから読めたらtrue
+static bool UpdateScriptCache(const std::wstring& path, ScriptType type, const std::wstring& version, const std::string& compileOption, const std::wstring& cacheDir, const std::shared_ptr<FileLoader>& loader, const DnhCompileResult& result, const std::string& byteCode)
+{
+    const ScriptCacheKey key{ GetCanonicalPath(path), type, version, compileOption };
+    const std::wstring cachePath = ConcatPath(cacheDir, GetFileName(GetScriptCachePath(key)));
+
+    ScriptCacheData compiled;
+    result.scriptInfo.Serialize(compiled.scriptInfo);
+    result.srcMap.Serialize(compiled.srcMap);
+    compiled.byteCode = byteCode;
+    compiled.srcCode = result.code;
+    compiled.builtInSubNames.assign(result.builtInSubNameConversionMap.begin(), result.builtInSubNameConversionMap.end());
+    SortBuiltInSubNames(&compiled);
+
+    ScriptCacheData cached;
+    if (LoadScriptCache(cachePath, key, loader, &cached))
+    {
+        SortBuiltInSubNames(&cached);
+        const char* diff = nullptr;
+        if (cached.scriptInfo != compiled.scriptInfo) diff = "script info";
+        else if (cached.srcMap != compiled.srcMap) diff = "source map";
+        else if (cached.byteCode != compiled.byteCode) diff = "bytecode";
+        else if (cached.srcCode != compiled.srcCode) diff = "Lua source";
+        else if (cached.builtInSubNames != compiled.builtInSubNames) diff = "built-in sub names";
+        if (diff)
+        {
+            throw Log(LogLevel::LV_ERROR)
+                .Msg(std::string("Cached ") + diff + " differs from a fresh compile.")
+                .Param(LogParam(LogParam::Tag::SCRIPT, path));
+        }
+        return true;
+    }
+
+    std::vector<ScriptSourceFile> sources(result.sourcePaths.size());
+    for (size_t i = 0; i < result.sourcePaths.size(); i++)
+    {
+        if (!GetScriptSourceFile(result.sourcePaths[i], loader, &sources[i]))
+        {
+            throw Log(LogLevel::LV_ERROR)
+                .Msg("Failed to read script source.")
+                .Param(LogParam(LogParam::Tag::SCRIPT, result.sourcePaths[i]));
+        }
+    }
+    SaveScriptCache(cachePath, key, sources, compiled);
+    return false;
+}
+
+// エンジンと同じ順で組み込みサブルーチンを呼び, @MainLoopにかかった時間を返す
+static double RunScript(const std::wstring& path, ScriptType type, const Options& opts, const DnhCompileResult& result, const std::string& byteCode)
+{
+    ScriptRunner runner(type, opts.runtimePath);
+    runner.Load(byteCode, result.builtInSubNameConversionMap, path);
+    runner.RunBuiltInSub("Loading");
+    runner.RunBuiltInSub("Initialize");
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < opts.runFrameCount; i++)
+    {
+        runner.RunBuiltInSub("MainLoop");
+    }
+    double runTime = Elapsed(start);
+    runner.RunBuiltInSub("Finalize");
+    return runTime;
+}
+
+static void CompileFile(const std::wstring& path, ScriptType type, const std::wstring& version, const Options& opts, const std::shared_ptr<FileLoader>& loader, const std::shared_ptr<DnhTokenCache>& tokenCache, const std::wstring& outputPath, FileResult* fileResult)
+{
+    auto codeGenOption = GetDefaultCodeGeneratorOption();
+    codeGenOption.promoteGlobalToLocal = opts.promoteGlobalToLocal;
+    codeGenOption.foldConstants = opts.foldConstants;
+    for (int i = 0; i < opts.repeatCount; i++)
+    {
+        DnhCompileResult result;
+        DnhCompileStats stats;
+        CompileDnhScript(path, type, codeGenOption, loader, tokenCache, &result, &stats);
+        std::string byteCode;
+        fileResult->loadTime += LoadChunk(result.code, path, &byteCode);
+        AddStats(&fileResult->stats, stats);
+        fileResult->codeSize = result.code.size();
+        fileResult->byteCodeSize = byteCode.size();
+        if (i == 0)
+        {
+            fileResult->code = result.code;
+            fileResult->sourcePaths = result.sourcePaths;
+        }
+        if (i == 0 && !outputPath.empty())
+        {
+            if (!WriteFile(outputPath, opts.outputByteCode ? byteCode : result.code))
+            {
+                throw Log(LogLevel::LV_ERROR)
+                    .Msg("Failed to write output.")
+                    .Param(LogParam(LogParam::Tag::TEXT, outputPath));
+            }
+        }
+        if (i == 0 && opts.runFrameCount > 0)
+        {
+            fileResult->runTime = RunScript(path, type, opts, result, byteCode);
+        }
+        if (i == 0 && !opts.cacheDir.empty())
+        {
+            const bool isHit = UpdateScriptCache(path, type, version, GetCompileOptionName(codeGenOption), opts.cacheDir, loader, result, byteCode);
+            fprintf(stderr, "%s: cache %s\n", ToUTF8(path).c_str(), isHit ? "hit" : "miss");
+            if (!opts.expectCache.empty() && opts.expectCache != (isHit ? "hit" : "miss"))
+            {
+                throw Log(LogLevel::LV_ERROR)
+                    .Msg("Expected cache " + opts.expectCache + ".")
+                    .Param(LogParam(LogParam::Tag::SCRIPT, path));
+            }
+        }
+    }
+}
+
+static double GetTotalTime(const FileResult& r)
+{
+    const auto& s = r.stats;
+    return s.parseTime + s.checkTime + s.analyzeTime + s.inlineTime + s.foldTime + s.escapeTime + s.codeGenTime + r.loadTime;
+}
+
+static void PrintRow(const std::string& name, const std::string& type, const FileResult& r, int div)
+{
+    const auto& s = r.stats;
+    auto ms = [div](double t) { return t * 1000.0 / div; };
+    double total = GetTotalTime(r);
+    printf("%s\t%s\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%zu\t%zu\t%zu\t%zu\n",
+           name.c_str(), type.c_str(),
+           ms(s.parseTime), ms(s.checkTime), ms(s.analyzeTime), ms(s.inlineTime), ms(s.foldTime), ms(s.escapeTime), ms(s.codeGenTime), ms(r.loadTime), ms(total),
+           s.nodeCount / div, s.arenaSize / div, r.codeSize, r.byteCodeSize);
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+    if (!ParseOptions(argc, argv, &opts))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    auto loader = std::make_shared<FileLoader>();
+    auto tokenCache = (opts.useTokenCache || opts.compareTokenCache) ? std::make_shared<DnhTokenCache>(DNH_TOKEN_CACHE_MAX_TOKEN_COUNT) : nullptr;
+    // 比較用の追加のコンパイルでは出力もキャッシュの確認もしない
+    Options extraOpts = opts;
+    extraOpts.cacheDir.clear();
+    extraOpts.expectCache.clear();
+
+    // (スクリプトのパス, 出力先での相対パス)
+    std::vector<std::pair<std::wstring, std::wstring>> targets;
+    for (const auto& input : opts.inputPaths)
+    {
+        std::vector<std::wstring> paths;
+        GetFilePathsRecursively(input, paths, {});
+        if (paths.empty())
+        {
+            // ディレクトリでなければファイルとして扱う
+            targets.emplace_back(input, GetFileName(input));
+            continue;
+        }
+        for (const auto& path : paths)
+        {
+            if (GetLowerExt(path) != L".dnh") continue;
+            targets.emplace_back(path, path.substr(ConcatPath(input, L"").size()));
+        }
+    }
+
+    printf("path\ttype\tparse\tcheck\tanalyze\tinline\tfold\tescape\tcodegen\tload\ttotal(ms)\tnodes\tarena(B)\tlua(B)\tbytecode(B)\n");
+    FileResult total;
+    FileResult uncachedTotal; // --compare-token-cache でトークンキャッシュを使わなかった分
+    int compiledCount = 0;
+    int skippedCount = 0;
+    int failedCount = 0;
+    for (const auto& target : targets)
+    {
+        const auto& path = target.first;
+        try
+        {
+            ScriptInfo info = ScanDnhScriptInfo(path, loader);
+            ScriptType type = info.type;
+            if (type.value == ScriptType::Value::UNKNOWN)
+            {
+                // インクルードされる側のファイル
+                if (opts.defaultType.value == ScriptType::Value::UNKNOWN)
+                {
+                    skippedCount++;
+                    continue;
+                }
+                type = opts.defaultType;
+            }
+            std::wstring outputPath;
+            if (!opts.outputDir.empty())
+            {
+                const auto& relPath = target.second;
+                outputPath = ConcatPath(opts.outputDir, relPath.substr(0, relPath.size() - GetExt(relPath).size()) + (opts.outputByteCode ? L".luac" : L".lua"));
+            }
+            FileResult uncached;
+            FileResult warmUp;
+            if (opts.compareTokenCache)
+            {
+                CompileFile(path, type, info.version, extraOpts, loader, nullptr, L"", &uncached);
+                AddStats(&uncachedTotal.stats, uncached.stats);
+                uncachedTotal.loadTime += uncached.loadTime;
+                // インクルードファイルのトークンをキャッシュに載せてから計る
+                extraOpts.repeatCount = 1;
+                CompileFile(path, type, info.version, extraOpts, loader, tokenCache, L"", &warmUp);
+                extraOpts.repeatCount = opts.repeatCount;
+            }
+            FileResult r;
+            CompileFile(path, type, info.version, opts, loader, tokenCache, outputPath, &r);
+            if (opts.compareTokenCache)
+            {
+                // キャッシュに登録する時と再生する時のどちらもキャッシュ無しと同じ結果になること
+                for (const FileResult* cached : { &warmUp, &r })
+                {
+                    if (cached->code != uncached.code || cached->sourcePaths != uncached.sourcePaths)
+                    {
+                        throw Log(LogLevel::LV_ERROR)
+                            .Msg("Token cache changed the compile result.")
+                            .Param(LogParam(LogParam::Tag::SCRIPT, path));
+                    }
+                }
+            }
+            PrintRow(ToUTF8(path), type.GetName(), r, opts.repeatCount);
+            if (opts.runFrameCount > 0)
+            {
+                fprintf(stderr, "%s: run %.3f ms/frame\n", ToUTF8(path).c_str(), r.runTime * 1000.0 / opts.runFrameCount);
+            }
+            AddStats(&total.stats, r.stats);
+            total.loadTime += r.loadTime;
+            total.runTime += r.runTime;
+            total.codeSize += r.codeSize;
+            total.byteCodeSize += r.byteCodeSize;
+            compiledCount++;
+        } catch (Log& log)
+        {
+            Logger::Write(log);
+            failedCount++;
+        }
+    }
+    PrintRow("(total)", "-", total, opts.repeatCount);
+    fprintf(stderr, "compiled: %d, skipped: %d, failed: %d\n", compiledCount, skippedCount, failedCount);
+    if (opts.runFrameCount > 0)
+    {
+        fprintf(stderr, "run: %.3f ms for %d frames (%.3f ms/frame)\n", total.runTime * 1000.0, opts.runFrameCount, total.runTime * 1000.0 / opts.runFrameCount);
+    }
+    if (opts.compareTokenCache)
+    {
+        // トークンキャッシュを使っても残るパースの時間が, ASTをキャッシュしてさらに省ける時間の上限
+        auto ms = [&opts](double t) { return t * 1000.0 / opts.repeatCount; };
+        const double cachedTotalTime = GetTotalTime(total);
+        fprintf(stderr, "parse without token cache: %.3f ms, with token cache: %.3f ms, remaining parse: %.1f%% of %.3f ms total\n",
+                ms(uncachedTotal.stats.parseTime), ms(total.stats.parseTime),
+                cachedTotalTime > 0.0 ? total.stats.parseTime * 100.0 / cachedTotalTime : 0.0, ms(cachedTotalTime));
+    }
+    return failedCount == 0 ? 0 : 1;
+}
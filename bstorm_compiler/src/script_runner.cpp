@@ -0,0 +1,265 @@
+﻿#include "script_runner.hpp"
+
+#include <bstorm/builtin_registry.hpp>
+#include <bstorm/node.hpp>
+#include <bstorm/script_name_prefix.hpp>
+#include <bstorm/string_util.hpp>
+#include <bstorm/logger.hpp>
+
+#include <cstdlib>
+
+namespace bstorm
+{
+// ランタイムライブラリが使う関数, api.cppのものと同じ動作
+
+static std::wstring ToWString(lua_State* L, int idx)
+{
+    size_t len;
+    const char* str = lua_tolstring(L, idx, &len);
+    return str ? ToUnicode(std::string(str, len)) : L"";
+}
+
+static int c_chartonum(lua_State* L)
+{
+    std::wstring wstr = ToWString(L, 1);
+    lua_pushnumber(L, wstr.empty() ? 0 : (int)wstr[0]);
+    return 1;
+}
+
+static void PushShiftedChar(lua_State* L, int d)
+{
+    std::wstring wstr = ToWString(L, 1);
+    if (wstr.empty())
+    {
+        lua_pushstring(L, "");
+    } else
+    {
+        wchar_t c = (wchar_t)(wstr[0] + d);
+        lua_pushstring(L, ToUTF8(std::wstring{ c }).c_str());
+    }
+}
+
+static int c_succchar(lua_State* L)
+{
+    PushShiftedChar(L, 1);
+    return 1;
+}
+
+static int c_predchar(lua_State* L)
+{
+    PushShiftedChar(L, -1);
+    return 1;
+}
+
+// エンジンではLogを投げるが, ここでは例外をLuaに通さずLuaのエラーにする
+static int c_raiseerror(lua_State* L)
+{
+    return luaL_error(L, "%s", lua_tostring(L, 1));
+}
+
+static int ator(lua_State* L)
+{
+    double r = 0;
+    switch (lua_type(L, 1))
+    {
+        case LUA_TNUMBER:
+            r = lua_tonumber(L, 1);
+            break;
+        case LUA_TBOOLEAN:
+            r = lua_toboolean(L, 1);
+            break;
+        case LUA_TSTRING:
+        {
+            std::wstring wstr = ToWString(L, 1);
+            r = wstr.empty() ? 0 : wstr[0];
+            break;
+        }
+        case LUA_TTABLE:
+        {
+            // 文字の配列を文字列として読む
+            std::string str;
+            const size_t size = lua_objlen(L, 1);
+            for (size_t i = 1; i <= size; i++)
+            {
+                lua_rawgeti(L, 1, (int)i);
+                size_t len;
+                const char* c = lua_tolstring(L, -1, &len);
+                if (c) str.append(c, len);
+                lua_pop(L, 1);
+            }
+            r = std::atof(str.c_str());
+            break;
+        }
+    }
+    lua_pushnumber(L, r);
+    return 1;
+}
+
+// 文字の配列かLuaの文字列をUTF-8で取り出す(DnhValue::ToStringU8の文字列の場合だけ)
+static std::string ToMessage(lua_State* L, int idx)
+{
+    if (lua_type(L, idx) != LUA_TTABLE)
+    {
+        size_t len;
+        const char* str = lua_tolstring(L, idx, &len);
+        return str ? std::string(str, len) : "";
+    }
+    std::string msg;
+    const int size = (int)lua_objlen(L, idx);
+    for (int i = 1; i <= size; i++)
+    {
+        lua_rawgeti(L, idx, i);
+        size_t len;
+        const char* str = lua_tolstring(L, -1, &len);
+        if (str) msg.append(str, len);
+        lua_pop(L, 1);
+    }
+    return msg;
+}
+
+// テスト用の組み込み関数, api.cppのものと同じ判定でLuaのエラーにする
+static int RaiseError(lua_State* L)
+{
+    std::string msg = ToMessage(L, 1);
+    return luaL_error(L, "RaiseError. (%s)", msg.c_str());
+}
+
+// コモンデータのキーは文字の配列でもLuaの文字列でも同じ項目になる
+static const char* COMMON_DATA_KEY = "bstorm_common_data";
+
+static int SetCommonData(lua_State* L)
+{
+    std::string key = ToMessage(L, 1);
+    lua_getfield(L, LUA_REGISTRYINDEX, COMMON_DATA_KEY);
+    lua_pushlstring(L, key.data(), key.size());
+    lua_pushvalue(L, 2);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+    return 0;
+}
+
+static int GetCommonData(lua_State* L)
+{
+    std::string key = ToMessage(L, 1);
+    lua_getfield(L, LUA_REGISTRYINDEX, COMMON_DATA_KEY);
+    lua_pushlstring(L, key.data(), key.size());
+    lua_rawget(L, -2);
+    if (lua_isnil(L, -1))
+    {
+        lua_pushvalue(L, 2);
+    }
+    return 1;
+}
+
+static int assert(lua_State* L)
+{
+    // 真偽の判定はランタイムライブラリのr_toboolに任せる
+    lua_getglobal(L, "r_tobool");
+    lua_pushvalue(L, 1);
+    lua_call(L, 1, 1);
+    bool cond = lua_toboolean(L, -1);
+    lua_pop(L, 1);
+    std::string msg = ToMessage(L, 2);
+    if (!cond)
+    {
+        return luaL_error(L, "Assertion failed. (%s)", msg.c_str());
+    }
+    return 0;
+}
+
+ScriptRunner::ScriptRunner(ScriptType type, const std::wstring& runtimePath) :
+    L_(luaL_newstate(), lua_close)
+{
+    lua_State* L = L_.get();
+    luaL_openlibs(L);
+
+#ifdef _WIN32
+    const std::string runtimeFile = ToMultiByte<CP_ACP>(runtimePath);
+#else
+    const std::string runtimeFile = ToUTF8(runtimePath);
+#endif
+    if (luaL_loadfile(L, runtimeFile.c_str()) != 0 || lua_pcall(L, 0, 0, 0) != 0)
+    {
+        std::string msg = lua_tostring(L, -1);
+        lua_pop(L, 1);
+        throw Log(LogLevel::LV_ERROR)
+            .Msg("Runtime library error.")
+            .Param(LogParam(LogParam::Tag::TEXT, msg));
+    }
+
+    for (const auto& runtimeFunc : GetBuiltInRegistry(type)->runtimeFuncs)
+    {
+        lua_getglobal(L, runtimeFunc.first.c_str());
+        lua_setglobal(L, runtimeFunc.second.c_str());
+        lua_pushnil(L);
+        lua_setglobal(L, runtimeFunc.first.c_str());
+    }
+
+    lua_register(L, "c_chartonum", c_chartonum);
+    lua_register(L, "c_succchar", c_succchar);
+    lua_register(L, "c_predchar", c_predchar);
+    lua_register(L, "c_raiseerror", c_raiseerror);
+    lua_register(L, "c_ator", ator);
+
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, COMMON_DATA_KEY);
+
+    // 組み込み関数はエンジンと同じ名前で登録する
+    auto env = CreateInitRootEnv(type);
+    const std::pair<const char*, lua_CFunction> testFuncs[] = {
+        { "assert", assert },
+        { "RaiseError", RaiseError },
+        { "SetCommonData", SetCommonData },
+        { "GetCommonData", GetCommonData }
+    };
+    for (const auto& func : testFuncs)
+    {
+        if (auto def = env->FindDef(Ident(func.first)))
+        {
+            lua_register(L, (std::string(DNH_BUILTIN_FUNC_PREFIX) + def->convertedName).c_str(), func.second);
+        }
+    }
+}
+
+void ScriptRunner::Load(const std::string& byteCode, const std::unordered_map<std::string, std::string>& builtInSubNameConversionMap, const std::wstring& path)
+{
+    builtInSubNameConversionMap_ = builtInSubNameConversionMap;
+    path_ = path;
+    if (luaL_loadbuffer(L_.get(), byteCode.data(), byteCode.size(), "main") != 0)
+    {
+        std::string msg = lua_tostring(L_.get(), -1);
+        lua_pop(L_.get(), 1);
+        throw Log(LogLevel::LV_ERROR)
+            .Msg("Failed to load compiled code. (" + msg + ")")
+            .Param(LogParam(LogParam::Tag::SCRIPT, path_));
+    }
+    Call(0);
+}
+
+void ScriptRunner::RunBuiltInSub(const std::string& name)
+{
+    auto it = builtInSubNameConversionMap_.find(name);
+    if (it == builtInSubNameConversionMap_.end()) return;
+    lua_getglobal(L_.get(), (std::string(DNH_RUNTIME_PREFIX) + "run").c_str());
+    lua_getglobal(L_.get(), (DNH_VAR_PREFIX + it->second).c_str());
+    if (lua_isfunction(L_.get(), -1))
+    {
+        Call(1);
+    } else
+    {
+        lua_pop(L_.get(), 2);
+    }
+}
+
+void ScriptRunner::Call(int argCnt)
+{
+    if (lua_pcall(L_.get(), argCnt, 0, 0) != 0)
+    {
+        std::string msg = lua_tostring(L_.get(), -1);
+        lua_pop(L_.get(), 1);
+        throw Log(LogLevel::LV_ERROR)
+            .Msg("Script runtime error. (" + msg + ")")
+            .Param(LogParam(LogParam::Tag::SCRIPT, path_));
+    }
+}
+}
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <bstorm/script_info.hpp>
+
+#include <luajit/lua.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace bstorm
+{
+// コンパイル済みのスクリプトをエンジンと同じ手順で実行する(Script::Load, RunBuiltInSub相当)
+// 使える組み込み関数はランタイムライブラリ(script_runtime.lua)にあるものと, テスト用のassert, RaiseError, SetCommonData, GetCommonDataだけ
+// エンジンの他の組み込み関数を呼ぶとLuaのエラーになる
+class ScriptRunner
+{
+public:
+    ScriptRunner(ScriptType type, const std::wstring& runtimePath);
+    // トップレベルを実行する, 失敗したらLogを投げる
+    void Load(const std::string& byteCode, const std::unordered_map<std::string, std::string>& builtInSubNameConversionMap, const std::wstring& path);
+    // @Initializeや@MainLoopを1回実行する, 無ければ何もしない
+    void RunBuiltInSub(const std::string& name);
+private:
+    void Call(int argCnt);
+    std::unique_ptr<lua_State, decltype(&lua_close)> L_;
+    std::unordered_map<std::string, std::string> builtInSubNameConversionMap_;
+    std::wstring path_;
+};
+}
@@ -0,0 +1,48 @@
+local d_lv,d_qv,d_mv,d_nv; d_rv = function()
+local d__1;
+d_qv(1,((r_read(d_lv,0)+6)%r_read(d_lv,1)),{[=[r]=],[=[e]=],[=[m]=]});
+d_qv(0.5,(r_read(d_lv,4)%r_read(d_lv,1)),{[=[n]=],[=[e]=],[=[g]=],[=[a]=],[=[t]=],[=[i]=],[=[v]=],[=[e]=],[=[ ]=],[=[r]=],[=[e]=],[=[m]=]});
+d_qv(1.4142135623730951,(r_read(d_lv,1)^r_read(d_lv,2)),{[=[p]=],[=[o]=],[=[w]=]});
+d_qv(7.5,r_abs(r_read(d_lv,4)),{[=[a]=],[=[b]=],[=[s]=]});
+d_qv(true,(r_read(d_lv,0)<r_read(d_lv,1)),{[=[l]=],[=[t]=]});
+d_qv(false,(r_read(d_lv,1)<=r_read(d_lv,2)),{[=[l]=],[=[e]=]});
+d_qv(2,(r_read(d_lv,0)-(-r_read(d_lv,0))),{[=[n]=],[=[e]=],[=[g]=],[=[a]=],[=[t]=],[=[i]=],[=[v]=],[=[e]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_qv(true,(not(r_tobool(r_read(d_lv,3)))),{[=[n]=],[=[o]=],[=[t]=],[=[ ]=],[=[r]=],[=[e]=],[=[a]=],[=[l]=]});
+d_qv(true,(not(r_tobool(r_read(d_nv,1)))),{[=[n]=],[=[o]=],[=[t]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=]});
+d_qv(2,r_or(r_read(d_lv,3), function() return r_read(d_lv,1) end),{[=[o]=],[=[r]=],[=[ ]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[e]=]});
+d_qv(0.5,r_and(r_read(d_lv,0), function() return r_read(d_lv,2) end),{[=[a]=],[=[n]=],[=[d]=],[=[ ]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[e]=]});
+d_qv(0,r_and(r_read(d_lv,3), function() return r_read(d_lv,1) end),{[=[a]=],[=[n]=],[=[d]=],[=[ ]=],[=[s]=],[=[h]=],[=[o]=],[=[r]=],[=[t]=],[=[ ]=],[=[c]=],[=[i]=],[=[r]=],[=[c]=],[=[u]=],[=[i]=],[=[t]=]});
+d_qv(true,r_eq(r_read(d_mv,0),r_read(d_mv,0)),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[e]=],[=[q]=]});
+d_qv(true,r_ne(r_read(d_mv,0),r_read(d_mv,1)),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[n]=],[=[e]=]});
+d_qv(false,(not(r_tobool(r_read(d_mv,2)))),{[=[d]=],[=[i]=],[=[g]=],[=[i]=],[=[t]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[i]=],[=[s]=],[=[ ]=],[=[t]=],[=[r]=],[=[u]=],[=[e]=]});
+d_qv(false,(not(r_tobool(r_read(d_mv,0)))),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[i]=],[=[s]=],[=[ ]=],[=[t]=],[=[r]=],[=[u]=],[=[e]=]});
+d_qv([=[b]=],r_and(r_read(d_mv,0), function() return r_read(d_mv,1) end),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[n]=],[=[d]=]});
+d_qv({[=[a]=],[=[b]=]},r_mcat(({r_read(d_mv,0)}),({r_read(d_mv,1)})),{[=[c]=],[=[a]=],[=[t]=]});
+d_qv(true,r_eq(r_read(d_nv,0),r_read(d_nv,0)),{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[e]=],[=[q]=]});
+d_qv({[=[a]=],[=[b]=]},r_or(r_read(d_nv,1), function() return r_read(d_nv,0) end),{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[o]=],[=[r]=]});
+d_qv(d_rE({[=[a]=],[=[b]=]}),d_rE(r_read(d_nv,0)),{[=[l]=],[=[e]=],[=[n]=],[=[g]=],[=[t]=],[=[h]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[c]=],[=[o]=],[=[n]=],[=[s]=],[=[t]=],[=[ ]=],[=[v]=],[=[a]=],[=[r]=]});
+d_qv(r_read({[=[a]=],[=[b]=]},1),r_read(r_read(d_nv,0),1),{[=[i]=],[=[n]=],[=[d]=],[=[e]=],[=[x]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[c]=],[=[o]=],[=[n]=],[=[s]=],[=[t]=],[=[ ]=],[=[v]=],[=[a]=],[=[r]=]});
+d_qv({[=[-]=],[=[2]=]},d_if((r_read(d_lv,4)/3)),{[=[I]=],[=[n]=],[=[t]=],[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=]});
+d_qv({[=[0]=],[=[.]=],[=[5]=],[=[0]=],[=[0]=],[=[0]=],[=[0]=],[=[0]=]},d_kf(r_read(d_lv,2)),{[=[r]=],[=[t]=],[=[o]=],[=[a]=]});
+d_qv((-7),(math.modf(r_tonum(r_read(d_lv,4)))),{[=[t]=],[=[r]=],[=[u]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=]});
+d_qv((-7),math.floor((r_tonum(r_read(d_lv,4)))+0.5),{[=[r]=],[=[o]=],[=[u]=],[=[n]=],[=[d]=]});
+d_qv(1,math.min(r_tonum(r_read(d_lv,0)),r_tonum(r_read(d_lv,1))),{[=[m]=],[=[i]=],[=[n]=]});
+d_qv((-1.5),math.fmod(r_tonum(r_read(d_lv,4)),r_tonum(r_read(d_lv,1))),{[=[m]=],[=[o]=],[=[d]=],[=[c]=]});
+d_qv(({2,1}),({r_read(d_lv,1),r_read(d_lv,0)}),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_qv(r_arr({{[=[a]=],[=[b]=]},{}}),r_cp(d_nv),{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_qv(1,(r_read(d_lv,2)*r_read(d_lv,1)),{[=[c]=],[=[o]=],[=[n]=],[=[s]=],[=[t]=],[=[ ]=],[=[v]=],[=[a]=],[=[r]=]});
+d__1 = 0;
+do
+d__1 = r_succ(d__1);
+end
+return d_qv(1,d__1,{[=[t]=],[=[a]=],[=[k]=],[=[e]=],[=[n]=],[=[ ]=],[=[b]=],[=[r]=],[=[a]=],[=[n]=],[=[c]=],[=[h]=]});
+end
+d_qv = function(d__1,d_a1,d_A1)
+d_dg(r_eq(d__1,d_a1),d_A1);
+end
+d_sv = function()
+r_yield();
+end
+d_lv = ({1,2,0.5,0,(-7.5)});
+d_mv = ({[=[a]=],[=[b]=],[=[0]=]});
+d_nv = r_arr({{[=[a]=],[=[b]=]},{}});
@@ -0,0 +1,34 @@
+local d_qv,d_rv,d_mv,d_nv,d_ov,d_pv; d_uv = function()
+local d_a1;
+local d__1;
+d_a1 = function()
+do return d__1 end
+end
+d_dg(r_eq(r_add(d_nv,1),1),{[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[b]=],[=[e]=],[=[f]=],[=[o]=],[=[r]=],[=[e]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[i]=],[=[n]=],[=[i]=],[=[t]=],[=[i]=],[=[a]=],[=[l]=],[=[i]=],[=[z]=],[=[a]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(r_eq(d_pv,5),{[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[a]=],[=[f]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[i]=],[=[n]=],[=[i]=],[=[t]=],[=[i]=],[=[a]=],[=[l]=],[=[i]=],[=[z]=],[=[a]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(r_eq(d_rv(2),5),{[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[f]=],[=[r]=],[=[o]=],[=[m]=],[=[ ]=],[=[a]=],[=[ ]=],[=[p]=],[=[r]=],[=[o]=],[=[c]=],[=[e]=],[=[d]=],[=[u]=],[=[r]=],[=[e]=]});
+d_dg(r_eq(r_read(d_mv,0),6),{[=[i]=],[=[n]=],[=[i]=],[=[t]=],[=[i]=],[=[a]=],[=[l]=],[=[i]=],[=[z]=],[=[e]=],[=[d]=],[=[ ]=],[=[b]=],[=[e]=],[=[f]=],[=[o]=],[=[r]=],[=[e]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[f]=],[=[i]=],[=[r]=],[=[s]=],[=[t]=],[=[ ]=],[=[c]=],[=[a]=],[=[l]=],[=[l]=]});
+d_dg(r_eq(d_qv,4),{[=[i]=],[=[n]=],[=[i]=],[=[t]=],[=[i]=],[=[a]=],[=[l]=],[=[i]=],[=[z]=],[=[e]=],[=[d]=],[=[ ]=],[=[a]=],[=[f]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[f]=],[=[i]=],[=[r]=],[=[s]=],[=[t]=],[=[ ]=],[=[c]=],[=[a]=],[=[l]=],[=[l]=]});
+d__1 = 7;
+return d_dg(true,{[=[l]=],[=[o]=],[=[c]=],[=[a]=],[=[l]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[e]=],[=[n]=],[=[c]=],[=[l]=],[=[o]=],[=[s]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[p]=],[=[r]=],[=[o]=],[=[c]=],[=[e]=],[=[d]=],[=[u]=],[=[r]=],[=[e]=]});
+end
+d_sv = function()
+do return 6 end
+end
+d_vv = function()
+r_yield();
+end
+d_tv = function()
+do return d_qv end
+end
+d_rv = function(d__1)
+if (d__1>0) then
+do return d_rv((d__1-1)) end
+end
+do return d_ov end
+end
+d_mv = r_cp(({6,3}));
+d_nv = r_cp(d_rv(0));
+d_ov = 5;
+d_pv = r_cp(d_rv(1));
+d_qv = 4;
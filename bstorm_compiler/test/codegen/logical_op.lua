@@ -0,0 +1,95 @@
+local d_lv,d_tv,d_sv,d_qv,d_rv,d_ov,d_pv; d_uv = function()
+local d_c1;
+local d_B1;
+local d_b1;
+local d_A1;
+local d_a1;
+local d_C1;
+local d__1;
+d_A1 = ({1,2});
+d_dg(true,{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(true,{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(true,{[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(true,{[=[e]=],[=[m]=],[=[p]=],[=[t]=],[=[y]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(true,{[=[e]=],[=[m]=],[=[p]=],[=[t]=],[=[y]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(r_eq(r_or(d_A1, function() return 1 end),({1,2})),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(r_eq(r_and(d_A1, function() return 1 end),1),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(r_eq(r_and(({}), function() return 1 end),({})),{[=[e]=],[=[m]=],[=[p]=],[=[t]=],[=[y]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(true,{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(true,{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(r_eq(r_or(d_c1, function() return 1 end),1),{[=[n]=],[=[i]=],[=[l]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(r_eq(r_add(r_and(d_c1, function() return 1 end),1),1),{[=[n]=],[=[i]=],[=[l]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(true,{[=[0]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_dg(true,{[=[0]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(true,{[=[0]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(true,{[=[0]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=[t]=],[=[h]=],[=[r]=],[=[o]=],[=[u]=],[=[g]=],[=[h]=],[=[ ]=],[=[a]=],[=[ ]=],[=[f]=],[=[u]=],[=[n]=],[=[c]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(r_eq(d_pv(r_cp(d_A1),{[=[x]=]}),{[=[x]=]}),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[t]=],[=[h]=],[=[r]=],[=[o]=],[=[u]=],[=[g]=],[=[h]=],[=[ ]=],[=[a]=],[=[ ]=],[=[f]=],[=[u]=],[=[n]=],[=[c]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_C1 = false;
+d_C1 = true;
+d_C1 = 0;
+d_C1 = {[=[s]=]};
+do
+d_C1 = 2;
+end
+d_dg(r_eq(d_C1,2),{[=[c]=],[=[o]=],[=[n]=],[=[d]=],[=[i]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=],[=[s]=]});
+d_dg((d_qv==0),{[=[r]=],[=[i]=],[=[g]=],[=[h]=],[=[t]=],[=[ ]=],[=[o]=],[=[p]=],[=[e]=],[=[r]=],[=[a]=],[=[n]=],[=[d]=],[=[ ]=],[=[s]=],[=[k]=],[=[i]=],[=[p]=],[=[p]=],[=[e]=],[=[d]=]});
+d_C1 = r_cp(d_rv(false));
+d_C1 = r_cp(d_rv(true));
+d_C1 = r_cp(d_rv(1));
+d_C1 = r_cp(d_rv(1));
+d_dg((d_qv==4),{[=[r]=],[=[i]=],[=[g]=],[=[h]=],[=[t]=],[=[ ]=],[=[o]=],[=[p]=],[=[e]=],[=[r]=],[=[a]=],[=[n]=],[=[d]=],[=[ ]=],[=[e]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[a]=],[=[t]=],[=[e]=],[=[d]=]});
+d_C1 = r_cp(r_or(r_and(d_tv([=[a]=],true), function() return d_tv([=[b]=],false) end), function() return d_tv([=[c]=],true) end));
+d_dg(r_eq(d_sv,{[=[a]=],[=[b]=],[=[c]=]}),{[=[&]=],[=[&]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[n]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_sv = {};
+d_C1 = r_cp(r_or(d_tv([=[a]=],0), function() return r_and(d_tv([=[b]=],0), function() return d_tv([=[c]=],1) end) end));
+d_dg(r_eq(d_sv,{[=[a]=],[=[b]=]}),{[=[|]=],[=[|]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[n]=],[=[ ]=],[=[&]=],[=[&]=]});
+d_dg(r_eq(d_C1,0),{[=[|]=],[=[|]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[n]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[e]=]});
+d_sv = {};
+if (r_tobool(d_tv([=[a]=],false)) or (r_tobool(d_tv([=[b]=],true)) and r_tobool(d_tv([=[c]=],true)))) then
+r_mcat(d_sv,{[=[!]=]});
+end
+d_dg(r_eq(d_sv,{[=[a]=],[=[b]=],[=[c]=],[=[!]=]}),{[=[c]=],[=[o]=],[=[n]=],[=[d]=],[=[i]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(true,{[=[!]=],[=[(]=],[=[t]=],[=[r]=],[=[u]=],[=[e]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[!]=],[=[f]=],[=[a]=],[=[l]=],[=[s]=],[=[e]=],[=[)]=]});
+d_dg(true,{[=[!]=],[=[(]=],[=[f]=],[=[a]=],[=[l]=],[=[s]=],[=[e]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=[!]=],[=[t]=],[=[r]=],[=[u]=],[=[e]=],[=[)]=]});
+d_dg(true,{[=[!]=],[=[f]=],[=[a]=],[=[l]=],[=[s]=],[=[e]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[!]=],[=[(]=],[=[0]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=["]=],[=["]=],[=[)]=]});
+d_dg(true,{[=[!]=],[=[(]=],[=[s]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[0]=],[=[)]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=[_]=]});
+d_dg((not(((not((r_tobool(d_A1) or r_tobool(0)))) and false))),{[=[!]=],[=[(]=],[=[!]=],[=[(]=],[=[a]=],[=[r]=],[=[r]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=[0]=],[=[)]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[!]=],[=[c]=],[=[)]=]});
+d_dg(true,{[=[(]=],[=[s]=],[=[ ]=],[=[&]=],[=[&]=],[=[ ]=],[=[!]=],[=[0]=],[=[)]=],[=[ ]=],[=[|]=],[=[|]=],[=[ ]=],[=[n]=],[=[i]=],[=[l]=]});
+return d_dg((d_qv==4),{[=[n]=],[=[e]=],[=[s]=],[=[t]=],[=[e]=],[=[d]=],[=[ ]=],[=[r]=],[=[i]=],[=[g]=],[=[h]=],[=[t]=],[=[ ]=],[=[o]=],[=[p]=],[=[e]=],[=[r]=],[=[a]=],[=[n]=],[=[d]=],[=[ ]=],[=[s]=],[=[k]=],[=[i]=],[=[p]=],[=[p]=],[=[e]=],[=[d]=]});
+end
+d_tv = function(d__1,d_a1)
+r_mcat(d_sv,({d__1}));
+do return d_a1 end
+end
+d_rv = function(d__1)
+d_qv = r_succ(d_qv);
+do return d__1 end
+end
+d_pv = function(d__1,d_a1)
+do return r_and(d__1, function() return d_a1 end) end
+end
+d_vv = function()
+local d_a1;
+local d__1;
+if (r_tobool(d_lv) and r_tobool(10)) then
+d_lv = r_succ(d_lv);
+end
+if (r_gt(d_lv,1) or false) then
+d_lv = r_succ(d_lv);
+elseif (not((r_tobool(d_lv) or r_tobool(10)))) then
+d_lv = 0;
+end
+while (r_lt(d_lv,10) and (not((r_eq(d_lv,5) or r_eq(d_lv,7))))) do
+d_lv = r_succ(d_lv);
+end
+d__1 = r_cp((r_gt(d_lv,2) and d_ov(r_cp(d_lv),10)));
+d_a1 = r_cp((r_eq(d_lv,3) or 10));
+d_lv = r_add(d_ov(r_cp(d_lv),1),d_pv(r_cp(d__1),r_cp(d_a1)));
+r_yield();
+end
+d_ov = function(d__1,d_a1)
+do return r_or(d__1, function() return d_a1 end) end
+end
+d_lv = 0;
+d_qv = 0;
+d_sv = {};
@@ -0,0 +1,67 @@
+local d_ov,d_lv,d_mv,d_nv; d_pv = function()
+d_dg((d_rE({[=[s]=]})==1),{[=[o]=],[=[p]=],[=[a]=],[=[q]=],[=[u]=],[=[e]=]});
+do
+local i = 0;
+local e = d_rE(d_lv);
+while i < e do
+local d_B2;
+local d_b2;
+local d_A2;
+local d_a2;
+local d__2 = r_cp(i);
+d_a2 = r_read(d_lv,d__2);
+d_A2 = r_read(d_lv,((d_rE(d_lv)-1)-d__2));
+d_b2 = d_a2;
+d_B2 = d_A2;
+d_ov(math.cos((r_tonum(d_a2))*0.017453292519943295),d_wE(d_b2),{[=[c]=],[=[o]=],[=[s]=]});
+d_ov(math.sin((r_tonum(d_a2))*0.017453292519943295),d_xE(d_b2),{[=[s]=],[=[i]=],[=[n]=]});
+d_ov(math.tan((r_tonum(d_a2))*0.017453292519943295),d_yE(d_b2),{[=[t]=],[=[a]=],[=[n]=]});
+d_ov((math.atan(r_tonum(d_a2))*57.29577951308232),d_af(d_b2),{[=[a]=],[=[t]=],[=[a]=],[=[n]=]});
+d_ov((math.atan2(r_tonum(d_a2),r_tonum(d_A2))*57.29577951308232),d_Af(d_b2,d_B2),{[=[a]=],[=[t]=],[=[a]=],[=[n]=],[=[2]=]});
+d_ov(math.abs(r_tonum(d_a2)),d_ef(d_b2),{[=[a]=],[=[b]=],[=[s]=],[=[o]=],[=[l]=],[=[u]=],[=[t]=],[=[e]=]});
+d_ov(math.floor(r_tonum(d_a2)),d_Df(d_b2),{[=[f]=],[=[l]=],[=[o]=],[=[o]=],[=[r]=]});
+d_ov(math.ceil(r_tonum(d_a2)),d_df(d_b2),{[=[c]=],[=[e]=],[=[i]=],[=[l]=]});
+d_ov(math.floor((r_tonum(d_a2))+0.5),d_Bf(d_b2),{[=[r]=],[=[o]=],[=[u]=],[=[n]=],[=[d]=]});
+d_ov((math.modf(r_tonum(d_a2))),d_cf(d_b2),{[=[t]=],[=[r]=],[=[u]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=]});
+d_ov((math.modf(r_tonum(d_a2))),d_Cf(d_b2),{[=[t]=],[=[r]=],[=[u]=],[=[n]=],[=[c]=]});
+d_ov(math.min(r_tonum(d_a2),r_tonum(d_A2)),d_sE(d_b2,d_B2),{[=[m]=],[=[i]=],[=[n]=]});
+d_ov(math.max(r_tonum(d_a2),r_tonum(d_A2)),d_tE(d_b2,d_B2),{[=[m]=],[=[a]=],[=[x]=]});
+if (d_A2~=0) then
+d_ov(math.fmod(r_tonum(d_a2),r_tonum(d_A2)),d_Ef(d_b2,d_B2),{[=[m]=],[=[o]=],[=[d]=],[=[c]=]});
+end
+if (d_a2>0) then
+d_ov(math.log(r_tonum(d_a2)),d_uE(d_b2),{[=[l]=],[=[o]=],[=[g]=]});
+d_ov(math.log10(r_tonum(d_a2)),d_vE(d_b2),{[=[l]=],[=[o]=],[=[g]=],[=[1]=],[=[0]=]});
+d_ov(((r_tonum(d_a2))^(0.5)),d_hE(d_b2,0.5),{[=[p]=],[=[o]=],[=[w]=],[=[e]=],[=[r]=]});
+end
+d_ov(math.cos((((d_a2*2)+1))*0.017453292519943295),d_wE(d_nv(((d_a2*2)+1))),{[=[c]=],[=[o]=],[=[s]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[r]=],[=[i]=],[=[t]=],[=[h]=],[=[m]=],[=[e]=],[=[t]=],[=[i]=],[=[c]=]});
+d_ov(math.floor(math.cos((r_tonum(d_a2))*0.017453292519943295)),d_Df(d_nv(d_wE(d_b2))),{[=[n]=],[=[e]=],[=[s]=],[=[t]=],[=[e]=],[=[d]=]});
+i = i + 1;
+end
+end
+do
+local i = 0;
+local e = d_rE(d_mv);
+while i < e do
+local d_A2;
+local d_a2;
+local d__2 = r_cp(i);
+d_a2 = r_read(d_mv,d__2);
+d_A2 = d_a2;
+d_ov((math.acos(r_tonum(d_a2))*57.29577951308232),d_zE(d_A2),{[=[a]=],[=[c]=],[=[o]=],[=[s]=]});
+d_ov((math.asin(r_tonum(d_a2))*57.29577951308232),d__f(d_A2),{[=[a]=],[=[s]=],[=[i]=],[=[n]=]});
+i = i + 1;
+end
+end
+end
+d_ov = function(d__1,d_a1,d_A1)
+d_dg((d__1==d_a1),d_A1);
+end
+d_nv = function(d__1)
+do return d__1 end
+end
+d_qv = function()
+r_yield();
+end
+d_lv = ({0,1,(-1),0.5,(-0.5),1.5,(-2.5),30,(-45),90,123.456,(-987.654),10000000000});
+d_mv = ({0,1,(-1),0.5,(-0.5),0.25,(-0.999)});
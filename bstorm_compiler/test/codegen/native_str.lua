@@ -0,0 +1,41 @@
+d_mv = function()
+local d_a1;
+local d__1;
+d__1 = ({[=[a]=],[=[b]=],[=[c]=]});
+d_dg(("abc"==r_tostr(({[=[a]=],[=[b]=],[=[c]=]}))),{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg((r_tostr(({[=[a]=],[=[b]=],[=[c]=]}))=="abc"),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg(("abc"==r_tostr(d__1)),{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[v]=],[=[a]=],[=[r]=],[=[i]=],[=[a]=],[=[b]=],[=[l]=],[=[e]=]});
+d_dg((r_tostr(d__1)=="abc"),{[=[v]=],[=[a]=],[=[r]=],[=[i]=],[=[a]=],[=[b]=],[=[l]=],[=[e]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[ ]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[e]=]});
+d_dg(true,{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[!]=],[=[=]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg(("abc"~=r_tostr(({[=[a]=],[=[b]=]}))),{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[!]=],[=[=]=],[=[ ]=],[=[s]=],[=[h]=],[=[o]=],[=[r]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg((r_tostr(({[=[a]=],[=[b]=]}))~="abc"),{[=[s]=],[=[h]=],[=[o]=],[=[r]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[!]=],[=[=]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg((not(("abc"~=r_tostr(d__1)))),{[=[!]=],[=[=]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[e]=],[=[q]=],[=[u]=],[=[a]=],[=[l]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[s]=]});
+d_dg(r_eq({},({})),{[=[e]=],[=[m]=],[=[p]=],[=[t]=],[=[y]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[e]=],[=[m]=],[=[p]=],[=[t]=],[=[y]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg((("ab"..r_tostr(({[=[c]=]})))=="abc"),{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[~]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg(((r_tostr(({[=[a]=]})).."bc")=="abc"),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[~]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg(((("a"..r_tostr(d__1)).."d")=="aabcd"),{[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[~]=],[=[ ]=],[=[v]=],[=[a]=],[=[r]=],[=[i]=],[=[a]=],[=[b]=],[=[l]=],[=[e]=],[=[ ]=],[=[~]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg(((r_tostr(d__1).."abc")==r_tostr(({[=[a]=],[=[b]=],[=[c]=],[=[a]=],[=[b]=],[=[c]=]}))),{[=[v]=],[=[a]=],[=[r]=],[=[i]=],[=[a]=],[=[b]=],[=[l]=],[=[e]=],[=[ ]=],[=[~]=],[=[ ]=],[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[ ]=],[=[v]=],[=[a]=],[=[l]=],[=[u]=],[=[e]=]});
+d_dg((d_rE(r_mcat({[=[a]=],[=[b]=]},({[=[c]=]})))==3),{[=[l]=],[=[e]=],[=[n]=],[=[g]=],[=[t]=],[=[h]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[ ]=],[=[m]=],[=[i]=],[=[x]=],[=[e]=],[=[d]=],[=[ ]=],[=[c]=],[=[o]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=],[=[n]=],[=[a]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(r_eq(r_read(r_mcat({[=[a]=],[=[b]=]},({[=[c]=]})),2),[=[c]=]),{[=[e]=],[=[l]=],[=[e]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[ ]=],[=[m]=],[=[i]=],[=[x]=],[=[e]=],[=[d]=],[=[ ]=],[=[c]=],[=[o]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=],[=[n]=],[=[a]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg(true,{[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[ ]=],[=[n]=],[=[u]=],[=[m]=],[=[b]=],[=[e]=],[=[r]=]});
+d_dg(("abc"==r_tostr(d__1)),{[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[ ]=],[=[s]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=]});
+d_dg((r_tostr(d__1)=="abc"),{[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[a]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg(true,{[=[I]=],[=[n]=],[=[t]=],[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=]});
+d_dg(("-2"==r_tostr(({[=[-]=],[=[2]=]}))),{[=[I]=],[=[n]=],[=[t]=],[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[=]=],[=[=]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg(true,{[=[i]=],[=[t]=],[=[o]=],[=[a]=]});
+d_dg(true,{[=[r]=],[=[t]=],[=[o]=],[=[a]=]});
+d_dg(true,{[=[i]=],[=[t]=],[=[o]=],[=[a]=],[=[ ]=],[=[i]=],[=[n]=],[=[ ]=],[=[a]=],[=[ ]=],[=[c]=],[=[o]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=],[=[n]=],[=[a]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_dg((("0.250000"..r_tostr(({[=[!]=]})))=="0.250000!"),{[=[T]=],[=[o]=],[=[S]=],[=[t]=],[=[r]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[~]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=]});
+d_dg((d_rE({[=[1]=],[=[.]=],[=[0]=],[=[0]=],[=[0]=],[=[0]=],[=[0]=],[=[0]=]})==8),{[=[l]=],[=[e]=],[=[n]=],[=[g]=],[=[t]=],[=[h]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[r]=],[=[t]=],[=[o]=],[=[a]=]});
+d_Dg(r_tostr(({[=[k]=],[=[e]=],[=[y]=]})),1);
+d_dg(r_eq(d_eg("key",0),1),{[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[k]=],[=[e]=],[=[y]=],[=[,]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[l]=],[=[o]=],[=[o]=],[=[k]=],[=[u]=],[=[p]=]});
+d_Dg(("ke"..r_tostr(({[=[y]=],[=[2]=]}))),2);
+d_dg(r_eq(d_eg(r_tostr(({[=[k]=],[=[e]=],[=[y]=],[=[2]=]})),0),2),{[=[c]=],[=[o]=],[=[n]=],[=[c]=],[=[a]=],[=[t]=],[=[e]=],[=[n]=],[=[a]=],[=[t]=],[=[e]=],[=[d]=],[=[ ]=],[=[k]=],[=[e]=],[=[y]=],[=[,]=],[=[ ]=],[=[c]=],[=[h]=],[=[a]=],[=[r]=],[=[ ]=],[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[l]=],[=[o]=],[=[o]=],[=[k]=],[=[u]=],[=[p]=]});
+return d_dg(r_eq(d_eg(r_tostr(d__1),3),3),{[=[m]=],[=[i]=],[=[s]=],[=[s]=],[=[i]=],[=[n]=],[=[g]=],[=[ ]=],[=[k]=],[=[e]=],[=[y]=]});
+end
+d_nv = function()
+r_yield();
+end
+d_lv = function(d__1)
+do return d__1 end
+end
@@ -0,0 +1,29 @@
+local d_lv,d_mv,d_nv; d_ov = function()
+d_dg(r_eq(r_add(d_lv((-1)),1),1),{[=[r]=],[=[a]=],[=[n]=],[=[ ]=],[=[o]=],[=[f]=],[=[f]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[e]=],[=[n]=],[=[d]=]});
+d_dg(r_eq(r_add(d_lv(4),1),3),{[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[e]=],[=[d]=]});
+d_dg(r_eq(r_add(d_mv(20),1),1),{[=[r]=],[=[e]=],[=[s]=],[=[u]=],[=[l]=],[=[t]=],[=[ ]=],[=[n]=],[=[e]=],[=[v]=],[=[e]=],[=[r]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=]});
+d_dg(r_eq(r_add(d_mv(2),1),3),{[=[r]=],[=[e]=],[=[s]=],[=[u]=],[=[l]=],[=[t]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=]});
+return d_dg(((d_nv((-3))+1)==0),{[=[e]=],[=[v]=],[=[e]=],[=[r]=],[=[y]=],[=[ ]=],[=[p]=],[=[a]=],[=[t]=],[=[h]=],[=[ ]=],[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[s]=]});
+end
+d_lv = function(d__1)
+if (d__1>0) then
+do return (d__1/2) end
+end
+end
+d_nv = function(d__1)
+if (d__1>0) then
+do return 1 end
+else
+do return (-1) end
+end
+end
+d_pv = function()
+r_yield();
+end
+d_mv = function(d__1)
+local d_a1;
+if (d__1<10) then
+d_a1 = d__1;
+end
+return d_a1;
+end
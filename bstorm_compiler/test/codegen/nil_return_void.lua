@@ -0,0 +1,32 @@
+local d_lv,d_mv; d_nv = function()
+d_dg(r_eq(r_add(d_lv(({1,2,3}),5),1),1),{[=[b]=],[=[a]=],[=[r]=],[=[e]=],[=[ ]=],[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=]});
+d_dg(r_eq(r_add(d_lv(({1,2,3}),2),1),2),{[=[f]=],[=[o]=],[=[u]=],[=[n]=],[=[d]=]});
+d_dg(((d_mv((-1))+1)==0),{[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[ ]=],[=[a]=],[=[f]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[r]=],[=[e]=],[=[s]=],[=[u]=],[=[l]=],[=[t]=]});
+return d_dg(((d_mv(3)+1)==7),{[=[r]=],[=[a]=],[=[n]=],[=[ ]=],[=[o]=],[=[f]=],[=[f]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[e]=],[=[n]=],[=[d]=],[=[ ]=],[=[a]=],[=[f]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[r]=],[=[e]=],[=[s]=],[=[u]=],[=[l]=],[=[t]=]});
+end
+d_mv = function(d__1)
+local d_a1;
+d_a1 = d__1;
+if (d__1<0) then
+do return d_a1 end
+end
+d_a1 = (d__1*2);
+return d_a1;
+end
+d_ov = function()
+r_yield();
+end
+d_lv = function(d__1,d_a1)
+do
+local i = 0;
+local e = d_rE(d__1);
+while i < e do
+local d__2 = r_cp(i);
+if (r_read(d__1,d__2)==d_a1) then
+do return d__2 end
+end
+i = i + 1;
+end
+end
+do return end
+end
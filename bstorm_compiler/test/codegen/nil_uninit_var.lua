@@ -0,0 +1,38 @@
+local d_lv,d_mv; d_ov = function()
+local d_b1;
+local d_A1;
+local d_a1;
+local d__1;
+d_dg(r_eq(r_add(d_lv,1),1),{[=[g]=],[=[l]=],[=[o]=],[=[b]=],[=[a]=],[=[l]=],[=[ ]=],[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[b]=],[=[e]=],[=[f]=],[=[o]=],[=[r]=],[=[e]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=]});
+d_lv = 5;
+d_dg(r_eq(r_add(d_lv,1),6),{[=[g]=],[=[l]=],[=[o]=],[=[b]=],[=[a]=],[=[l]=],[=[ ]=],[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[a]=],[=[f]=],[=[t]=],[=[e]=],[=[r]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=]});
+d_dg((((d_mv*2)+1)==5),{[=[g]=],[=[l]=],[=[o]=],[=[b]=],[=[a]=],[=[l]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=],[=[ ]=],[=[a]=],[=[t]=],[=[ ]=],[=[t]=],[=[o]=],[=[p]=],[=[ ]=],[=[l]=],[=[e]=],[=[v]=],[=[e]=],[=[l]=]});
+d_dg(r_eq(r_add(d__1,1),1),{[=[l]=],[=[o]=],[=[c]=],[=[a]=],[=[l]=],[=[ ]=],[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[b]=],[=[e]=],[=[f]=],[=[o]=],[=[r]=],[=[e]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=]});
+d__1 = 3;
+if (d_mv>5) then
+d_a1 = 1;
+end
+d_dg(r_eq(r_add(d_a1,1),1),{[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=],[=[ ]=],[=[o]=],[=[n]=],[=[ ]=],[=[o]=],[=[n]=],[=[e]=],[=[ ]=],[=[b]=],[=[r]=],[=[a]=],[=[n]=],[=[c]=],[=[h]=]});
+if (d_mv>5) then
+d_A1 = 1;
+else
+d_A1 = 2;
+end
+d_dg(((d_A1+1)==3),{[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=],[=[ ]=],[=[o]=],[=[n]=],[=[ ]=],[=[e]=],[=[v]=],[=[e]=],[=[r]=],[=[y]=],[=[ ]=],[=[b]=],[=[r]=],[=[a]=],[=[n]=],[=[c]=],[=[h]=]});
+do
+local i = 0;
+local e = (2);
+while i < e do
+d_b1 = 1;
+i = i + 1;
+end
+end
+return d_dg(r_eq(r_add(d_b1,1),2),{[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=],[=[ ]=],[=[i]=],[=[n]=],[=[ ]=],[=[a]=],[=[ ]=],[=[l]=],[=[o]=],[=[o]=],[=[p]=]});
+end
+d_nv = function()
+do return r_add(d_lv,1) end
+end
+d_pv = function()
+r_yield();
+end
+d_mv = 2;
@@ -0,0 +1,60 @@
+local d_lv,d_mv,d_nv,d_ov,d_pv,d_qv,d_rv; d_sv = function()
+local d_c1;
+local d_B1;
+local d_b1;
+local d_a1;
+local d_A1;
+local d__1;
+d__1 = ({1,2});
+d_a1 = r_cp(d_lv(r_cp(d__1)));
+r_write1(d_a1,0,5);
+d_dg((r_read(d__1,0)==1),{[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=]});
+d_A1 = r_cp(d_mv(r_cp(d__1),({3})));
+r_write1(d_A1,0,5);
+d_dg((r_read(d__1,0)==1),{[=[r]=],[=[e]=],[=[t]=],[=[u]=],[=[r]=],[=[n]=],[=[ ]=],[=[t]=],[=[h]=],[=[r]=],[=[o]=],[=[u]=],[=[g]=],[=[h]=],[=[ ]=],[=[|]=],[=[|]=]});
+d_b1 = r_cp(d_nv(r_cp(d__1)));
+r_write1(d_b1,0,5);
+d_dg((r_read(d__1,0)==1),{[=[n]=],[=[e]=],[=[s]=],[=[t]=],[=[e]=],[=[d]=],[=[ ]=],[=[f]=],[=[u]=],[=[n]=],[=[c]=],[=[t]=],[=[i]=],[=[o]=],[=[n]=]});
+d_B1 = r_cp(d_ov(d__1));
+r_write(d_B1, {0,0}, 5);
+d_dg((r_read(d__1,0)==1),{[=[e]=],[=[l]=],[=[e]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=],[=[ ]=],[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=]});
+d_c1 = r_cp(d_pv(r_cp(d__1)));
+r_write(d_c1, {0,0}, 5);
+d_dg((r_read(r_read(d_c1,1),0)==1),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=],[=[ ]=],[=[e]=],[=[l]=],[=[e]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=],[=[s]=]});
+d_dg((r_read(d__1,0)==1),{[=[a]=],[=[r]=],[=[r]=],[=[a]=],[=[y]=],[=[ ]=],[=[l]=],[=[i]=],[=[t]=],[=[e]=],[=[r]=],[=[a]=],[=[l]=]});
+d_dg((d_qv(r_cp(d__1))==9),{[=[a]=],[=[s]=],[=[s]=],[=[i]=],[=[g]=],[=[n]=],[=[e]=],[=[d]=],[=[ ]=],[=[e]=],[=[l]=],[=[e]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=]});
+d_dg((r_read(d__1,0)==1),{[=[e]=],[=[l]=],[=[e]=],[=[m]=],[=[e]=],[=[n]=],[=[t]=],[=[ ]=],[=[o]=],[=[f]=],[=[ ]=],[=[t]=],[=[h]=],[=[e]=],[=[ ]=],[=[p]=],[=[a]=],[=[r]=],[=[a]=],[=[m]=],[=[e]=],[=[t]=],[=[e]=],[=[r]=]});
+return d_dg((d_rv(d__1)==1),{[=[r]=],[=[e]=],[=[a]=],[=[d]=],[=[ ]=],[=[o]=],[=[n]=],[=[l]=],[=[y]=]});
+end
+d_qv = function(d__1)
+r_write1(d__1,0,9);
+do return r_read(d__1,0) end
+end
+d_pv = function(d__1)
+do return ({d__1,d__1}) end
+end
+d_ov = function(d__1)
+local d_A1;
+d_A1 = ({0});
+r_write1(d_A1,0,d__1);
+do return d_A1 end
+end
+d_nv = function(d__1)
+local d_A1;
+d_A1 = function()
+do return d__1 end
+end
+do return d__1 end
+end
+d_mv = function(d__1,d_a1)
+do return r_or(d__1, function() return d_a1 end) end
+end
+d_tv = function()
+r_yield();
+end
+d_lv = function(d__1)
+do return d__1 end
+end
+d_rv = function(d__1)
+do return r_read(d__1,0) end
+end
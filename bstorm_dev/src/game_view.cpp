@@ -149,6 +149,11 @@ void GameView::draw()
                     ImGui::Checkbox("never hit", &playerInvincibleEnable);
                     playController->SetPlayerInvincibleEnable(playerInvincibleEnable);
                 }
+                {
+                    bool parallelRenderRecordEnable = playController->IsParallelRenderRecordEnabled();
+                    ImGui::Checkbox("parallel render", &parallelRenderRecordEnable);
+                    playController->SetParallelRenderRecordEnable(parallelRenderRecordEnable);
+                }
                 ImGui::EndGroup();
             }
             ImGui::SameLine(ImGui::GetContentRegionAvailWidth() - controllerSpace);
@@ -527,15 +527,14 @@ void drawObjEditArea(const std::shared_ptr<Obj>& obj, std::shared_ptr<ObjectLaye
                     {
                         int fontId = 0;
                         // 重複を弾く
-                        std::unordered_set<IDirect3DTexture9*> displayed;
+                        std::unordered_set<const Font*> displayed;
                         const auto& bodyFonts = objText->GetBodyFonts();
                         for (const auto& font : bodyFonts)
                         {
                             if (font)
                             {
-                                auto fontTexture = font->GetTexture();
-                                if (displayed.count(fontTexture) != 0) continue;
-                                displayed.insert(fontTexture);
+                                if (displayed.count(font.get()) != 0) continue;
+                                displayed.insert(font.get());
                                 ImGui::PushID(fontId++);
                                 if (ImGui::TreeNode(ToUTF8(std::wstring{ font->GetParams().c }).c_str()))
                                 {
@@ -552,9 +551,8 @@ void drawObjEditArea(const std::shared_ptr<Obj>& obj, std::shared_ptr<ObjectLaye
                             {
                                 if (font)
                                 {
-                                    auto fontTexture = font->GetTexture();
-                                    if (displayed.count(fontTexture) != 0) continue;
-                                    displayed.insert(fontTexture);
+                                    if (displayed.count(font.get()) != 0) continue;
+                                    displayed.insert(font.get());
                                     ImGui::PushID(fontId++);
                                     if (ImGui::TreeNode(ToUTF8(std::wstring{ font->GetParams().c }).c_str()))
                                     {
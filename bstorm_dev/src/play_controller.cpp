@@ -175,6 +175,16 @@ void PlayController::SetPlayerInvincibleEnable(bool enable)
     engine_->GetDevelopOptions()->forcePlayerInvincibleEnable = enable;
 }
 
+bool PlayController::IsParallelRenderRecordEnabled() const
+{
+    return engine_->GetDevelopOptions()->parallelRenderRecordEnable;
+}
+
+void PlayController::SetParallelRenderRecordEnable(bool enable)
+{
+    engine_->GetDevelopOptions()->parallelRenderRecordEnable = enable;
+}
+
 void PlayController::SetInputEnable(bool enable)
 {
     engine_->SetInputEnable(enable);
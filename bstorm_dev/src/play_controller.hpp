@@ -29,6 +29,8 @@ public:
     void SetRenderIntersectionEnable(bool enable);
     bool IsPlayerInvincibleEnabled() const;
     void SetPlayerInvincibleEnable(bool enable);
+    bool IsParallelRenderRecordEnabled() const;
+    void SetParallelRenderRecordEnable(bool enable);
     void SetInputEnable(bool enable);
     const ScriptInfo& GetMainScriptInfo() const;
     const NullableSharedPtr<Package>& GetCurrentPackage() const { return package_; }
@@ -5,6 +5,7 @@
 #include <bstorm/texture.hpp>
 #include <bstorm/font.hpp>
 #include <bstorm/render_target.hpp>
+#include <bstorm/renderer.hpp>
 #include <bstorm/serialized_script.hpp>
 #include <bstorm/logger.hpp>
 #include <bstorm/package.hpp>
@@ -91,14 +92,16 @@ void DrawFontInfo(const std::shared_ptr<Font>& font)
         int height = font->GetHeight();
         int texWidth = font->GetTextureWidth();
         int texHeight = font->GetTextureHeight();
+        const AtlasRegion& region = font->GetRegion();
         int useCount = font.use_count() - 1;
         ImGui::BulletText("width          : %d", width);
         ImGui::BulletText("height         : %d", height);
         ImGui::BulletText("texture-width  : %d", texWidth);
         ImGui::BulletText("texture-height : %d", texHeight);
+        ImGui::BulletText("glyph-rect     : (%d %d %d %d)", region.x, region.y, region.x + width, region.y + height);
         ImGui::BulletText("use-count      : %d", useCount);
         ImGui::Separator();
-        ImGui::Image(font->GetTexture(), ImVec2(texWidth, texHeight));
+        ImGui::Image(font->GetTexture(), ImVec2(width, height), ImVec2(1.0f * region.x / texWidth, 1.0f * region.y / texHeight), ImVec2(1.0f * (region.x + width) / texWidth, 1.0f * (region.y + height) / texHeight));
         ImGui::EndGroup();
     }
 }
@@ -184,19 +187,56 @@ void DrawTextureInfoTab(const std::shared_ptr<TextureStore>& textureStore)
     ImGui::EndChild();
 }
 
+void DrawTextureAtlasInfoTab(const std::shared_ptr<TextureAtlas>& atlas, const std::shared_ptr<Renderer>& renderer)
+{
+    const auto& counter = renderer->GetLastFrameTextureSwitchCounter();
+    ImGui::BulletText("draw-count              : %d", counter.GetDrawCount());
+    ImGui::BulletText("texture-switch          : %d", counter.GetSwitchCount());
+    ImGui::BulletText("texture-switch (saved)  : %d", counter.GetSavedSwitchCount());
+    ImGui::BulletText("cull-test               : %d", renderer->GetLastFrameCullTestCount());
+    ImGui::BulletText("culled                  : %d", renderer->GetLastFrameCulledCount());
+    ImGui::Separator();
+    for (int i = 0; i < atlas->GetPageCount(); i++)
+    {
+        const auto& page = atlas->GetPage(i);
+        if (!page) continue;
+        const auto stats = atlas->GetPageStats(i);
+        ImGui::PushID(i);
+        if (ImGui::TreeNode("page", "page %d (%d regions, %.1f%%)", i, stats.regionCount, stats.GetOccupancy() * 100.0f))
+        {
+            std::vector<Rect<int>> rects;
+            atlas->ForEachRegion([&](const std::wstring& path, const AtlasRegion& region)
+            {
+                if (region.page == i)
+                {
+                    ImGui::BulletText("%s : (%d %d %d %d)", ToUTF8(path).c_str(), region.x, region.y, region.width, region.height);
+                    rects.emplace_back(region.x, region.y, region.x + region.width, region.y + region.height);
+                }
+            });
+            DrawTextureInfo(page, rects, nullptr);
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
+    }
+}
+
 void DrawFontInfoTab(const std::shared_ptr<FontStore>& fontStore)
 {
     static FontParams selectedFontParams;
     float sideBarWidth = ImGui::GetContentRegionAvailWidth() * 0.2;
     ImGui::BeginChild("ResourceFontTabSideBar", ImVec2(sideBarWidth, -1), true, ImGuiWindowFlags_HorizontalScrollbar);
     {
+        const auto& glyphAtlas = fontStore->GetGlyphAtlas();
+        ImGui::Text("glyph pages : %d / %d (%d glyphs)", glyphAtlas->GetPageCount(), glyphAtlas->GetMaxPageCount(), glyphAtlas->GetGlyphCount());
+        ImGui::Separator();
         int fontId = 0;
         fontStore->ForEach([&](const auto& params, auto& isReserved, auto& font)
         {
             ImGui::PushID(fontId++);
             ImGui::BeginGroup();
             float iconWidth = ImGui::GetTextLineHeight();
-            if (ImGui::ImageButton(font->GetTexture(), ImVec2(iconWidth, iconWidth), ImVec2(0, 0), ImVec2(1.0f*font->GetWidth() / font->GetTextureWidth(), 1.0f*font->GetHeight() / font->GetTextureHeight()), 0, ImVec4(0, 0, 0, 1)))
+            const AtlasRegion& region = font->GetRegion();
+            if (ImGui::ImageButton(font->GetTexture(), ImVec2(iconWidth, iconWidth), ImVec2(1.0f*region.x / font->GetTextureWidth(), 1.0f*region.y / font->GetTextureHeight()), ImVec2(1.0f*(region.x + font->GetWidth()) / font->GetTextureWidth(), 1.0f*(region.y + font->GetHeight()) / font->GetTextureHeight()), 0, ImVec4(0, 0, 0, 1)))
             {
                 selectedFontParams = params;
             }
@@ -300,6 +340,7 @@ void Package::backDoor<RenderTargetMonitor>()
 enum class Tab
 {
     TEXTURE,
+    TEXTURE_ATLAS,
     FONT,
     RENDER_TARGET,
     SCRIPT_CACHE
@@ -308,7 +349,7 @@ enum class Tab
 template <>
 void Package::backDoor<ResourceMonitor>()
 {
-    ImGui::Columns(4, "resource tab");
+    ImGui::Columns(5, "resource tab");
     ImGui::Separator();
     static Tab selectedTab = Tab::TEXTURE;
     if (ImGui::Selectable("Texture##ResourceTextureTab", selectedTab == Tab::TEXTURE))
@@ -316,6 +357,11 @@ void Package::backDoor<ResourceMonitor>()
         selectedTab = Tab::TEXTURE;
     }
     ImGui::NextColumn();
+    if (ImGui::Selectable("Atlas##ResourceTextureAtlasTab", selectedTab == Tab::TEXTURE_ATLAS))
+    {
+        selectedTab = Tab::TEXTURE_ATLAS;
+    }
+    ImGui::NextColumn();
     if (ImGui::Selectable("Font##ResourceFontTab", selectedTab == Tab::FONT))
     {
         selectedTab = Tab::FONT;
@@ -337,6 +383,9 @@ void Package::backDoor<ResourceMonitor>()
         case Tab::TEXTURE:
             DrawTextureInfoTab(textureStore_);
             break;
+        case Tab::TEXTURE_ATLAS:
+            DrawTextureAtlasInfoTab(textureStore_->GetAtlas(), renderer_);
+            break;
         case Tab::FONT:
             DrawFontInfoTab(fontStore_);
             break;
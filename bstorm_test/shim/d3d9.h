@@ -0,0 +1,40 @@
+// Minimal stand-in for the Direct3D 9 header so that engine headers which only
+// use D3D types (not the device) compile on Linux. Values match d3d9types.h.
+#pragma once
+
+#include <cstdint>
+
+typedef uint32_t DWORD;
+typedef uint8_t BYTE;
+typedef DWORD D3DCOLOR;
+
+#define D3DCOLOR_ARGB(a, r, g, b) \
+    ((D3DCOLOR)((((a) & 0xff) << 24) | (((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff)))
+#define D3DCOLOR_XRGB(r, g, b) D3DCOLOR_ARGB(0xff, r, g, b)
+
+#define D3DFVF_XYZ 0x002
+#define D3DFVF_NORMAL 0x010
+#define D3DFVF_DIFFUSE 0x040
+#define D3DFVF_TEX1 0x100
+
+enum D3DPRIMITIVETYPE
+{
+    D3DPT_POINTLIST = 1,
+    D3DPT_LINELIST = 2,
+    D3DPT_LINESTRIP = 3,
+    D3DPT_TRIANGLELIST = 4,
+    D3DPT_TRIANGLESTRIP = 5,
+    D3DPT_TRIANGLEFAN = 6
+};
+
+struct D3DCOLORVALUE
+{
+    float r, g, b, a;
+};
+
+struct D3DMATRIX
+{
+    float m[4][4];
+};
+
+struct IDirect3DTexture9;
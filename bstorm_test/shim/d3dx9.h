@@ -0,0 +1,9 @@
+// Minimal stand-in for the D3DX 9 header, see d3d9.h.
+#pragma once
+
+#include <d3d9.h>
+
+struct D3DXMATRIX : public D3DMATRIX
+{
+    D3DXMATRIX() = default;
+};
@@ -0,0 +1,215 @@
+﻿#include <bstorm/atlas_packer.hpp>
+#include <bstorm/vertex.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace bstorm;
+
+namespace
+{
+// テクスチャアトラスと同じ設定
+constexpr int PAGE_SIZE = 2048;
+
+bool IsOverlapped(const AtlasRegion& a, const AtlasRegion& b, int padding)
+{
+    if (a.page != b.page) return false;
+    return a.x < b.x + b.width + padding && b.x < a.x + a.width + padding &&
+        a.y < b.y + b.height + padding && b.y < a.y + a.height + padding;
+}
+}
+
+TEST(AtlasPackerTest, PlacesAtLowestThenLeftmostPosition)
+{
+    AtlasPacker packer(64, 64, 0);
+    AtlasRegion r1, r2, r3, r4;
+    ASSERT_TRUE(packer.Insert(32, 16, &r1));
+    ASSERT_TRUE(packer.Insert(32, 16, &r2));
+    ASSERT_TRUE(packer.Insert(32, 8, &r3));
+    ASSERT_TRUE(packer.Insert(16, 16, &r4));
+
+    EXPECT_EQ(0, r1.page); EXPECT_EQ(0, r1.x); EXPECT_EQ(0, r1.y);
+    // 1つ目の右隣, 高さ0の段
+    EXPECT_EQ(32, r2.x); EXPECT_EQ(0, r2.y);
+    // 2つの段が同じ高さ16に結合された後なので左端
+    EXPECT_EQ(0, r3.x); EXPECT_EQ(16, r3.y);
+    // 左の段(高さ24)より右の段(高さ16)の方が低い
+    EXPECT_EQ(32, r4.x); EXPECT_EQ(16, r4.y);
+    EXPECT_EQ(16, r4.width); EXPECT_EQ(16, r4.height);
+}
+
+TEST(AtlasPackerTest, RegionsDoNotOverlapIncludingPadding)
+{
+    const int padding = 2;
+    AtlasPacker packer(256, 256, padding);
+    std::mt19937 rand(12345);
+    std::uniform_int_distribution<int> size(1, 48);
+    std::vector<AtlasRegion> regions;
+    for (int i = 0; i < 300; i++)
+    {
+        AtlasRegion r;
+        ASSERT_TRUE(packer.Insert(size(rand), size(rand), &r));
+        EXPECT_GE(r.x, 0);
+        EXPECT_GE(r.y, 0);
+        EXPECT_LE(r.x + r.width + padding, packer.GetPageWidth());
+        EXPECT_LE(r.y + r.height + padding, packer.GetPageHeight());
+        for (const auto& other : regions)
+        {
+            ASSERT_FALSE(IsOverlapped(r, other, padding));
+        }
+        regions.push_back(r);
+    }
+    EXPECT_GT(packer.GetPageCount(), 1);
+}
+
+TEST(AtlasPackerTest, PaddingSeparatesNeighbors)
+{
+    AtlasPacker packer(16, 16, 2);
+    AtlasRegion r1, r2;
+    ASSERT_TRUE(packer.Insert(6, 6, &r1));
+    ASSERT_TRUE(packer.Insert(6, 6, &r2));
+    EXPECT_EQ(0, r1.x);
+    EXPECT_EQ(8, r2.x);
+    EXPECT_EQ(0, r2.y);
+    // 領域自体の大きさにはパディングを含まない
+    EXPECT_EQ(6, r2.width);
+    EXPECT_EQ(6, r2.height);
+    EXPECT_EQ(72, packer.GetPageStats(0).usedArea);
+
+    // パディング込みでちょうどページに収まる大きさは新しいページに置かれる
+    AtlasRegion r3;
+    ASSERT_TRUE(packer.Insert(14, 14, &r3));
+    EXPECT_EQ(1, r3.page);
+    EXPECT_EQ(0, r3.x);
+    EXPECT_EQ(0, r3.y);
+}
+
+TEST(AtlasPackerTest, RollsOverToNextPageWhenFull)
+{
+    AtlasPacker packer(PAGE_SIZE, PAGE_SIZE, 0);
+    const int half = PAGE_SIZE / 2;
+    for (int i = 0; i < 4; i++)
+    {
+        AtlasRegion r;
+        ASSERT_TRUE(packer.Insert(half, half, &r));
+        EXPECT_EQ(0, r.page);
+    }
+    EXPECT_EQ(1, packer.GetPageCount());
+    EXPECT_FLOAT_EQ(1.0f, packer.GetPageStats(0).GetOccupancy());
+
+    AtlasRegion r;
+    ASSERT_TRUE(packer.Insert(half, half, &r));
+    EXPECT_EQ(1, r.page);
+    EXPECT_EQ(0, r.x);
+    EXPECT_EQ(0, r.y);
+    EXPECT_EQ(2, packer.GetPageCount());
+    EXPECT_EQ(4, packer.GetPageStats(0).regionCount);
+    EXPECT_EQ(1, packer.GetPageStats(1).regionCount);
+
+    // 空きのある前のページが優先される
+    packer.ClearPage(0);
+    ASSERT_TRUE(packer.Insert(half, half, &r));
+    EXPECT_EQ(0, r.page);
+    EXPECT_EQ(0, r.x);
+    EXPECT_EQ(0, r.y);
+}
+
+TEST(AtlasPackerTest, RejectsRectLargerThanPage)
+{
+    AtlasPacker packer(PAGE_SIZE, PAGE_SIZE, 2);
+    AtlasRegion r;
+    EXPECT_FALSE(packer.Insert(PAGE_SIZE + 1, 1, &r));
+    EXPECT_FALSE(packer.Insert(1, PAGE_SIZE + 1, &r));
+    // パディングを足すとページを超える
+    EXPECT_FALSE(packer.Insert(PAGE_SIZE, PAGE_SIZE, &r));
+    EXPECT_FALSE(packer.Insert(0, 16, &r));
+    EXPECT_FALSE(r.IsValid());
+    EXPECT_EQ(0, packer.GetPageCount());
+
+    EXPECT_TRUE(packer.Insert(PAGE_SIZE - 2, PAGE_SIZE - 2, &r));
+    EXPECT_EQ(1, packer.GetPageCount());
+}
+
+TEST(AtlasPackerTest, RemapKeepsRectOnRegionEdges)
+{
+    const int pageSize = 256;
+    AtlasPacker packer(pageSize, pageSize, 2);
+    AtlasRegion dummy, region;
+    ASSERT_TRUE(packer.Insert(40, 24, &dummy));
+    ASSERT_TRUE(packer.Insert(64, 32, &region));
+    ASSERT_NE(0, region.x);
+
+    // 元画像全体はちょうど領域全体になる
+    auto whole = region.Remap(Rect<int>(0, 0, 64, 32));
+    EXPECT_EQ(region.x, whole.left);
+    EXPECT_EQ(region.y, whole.top);
+    EXPECT_EQ(region.x + region.width, whole.right);
+    EXPECT_EQ(region.y + region.height, whole.bottom);
+
+    // 右下の端の1テクセル
+    auto corner = region.Remap(Rect<int>(63, 31, 64, 32));
+    EXPECT_EQ(region.x + region.width - 1, corner.left);
+    EXPECT_EQ(region.y + region.height - 1, corner.top);
+    EXPECT_EQ(region.x + region.width, corner.right);
+    EXPECT_EQ(region.y + region.height, corner.bottom);
+
+    // ページ上のUVは元画像上のUVを領域に写したもの
+    auto src = GetRectVertices(0, 64, 32, Rect<int>(0, 0, 64, 32));
+    auto dst = GetRectVertices(0, pageSize, pageSize, whole);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_FLOAT_EQ((region.x + src[i].u * 64) / pageSize, dst[i].u);
+        EXPECT_FLOAT_EQ((region.y + src[i].v * 32) / pageSize, dst[i].v);
+        // 頂点位置は変わらない
+        EXPECT_FLOAT_EQ(src[i].x, dst[i].x);
+        EXPECT_FLOAT_EQ(src[i].y, dst[i].y);
+    }
+    EXPECT_FLOAT_EQ((float)region.x / pageSize, dst[0].u);
+    EXPECT_FLOAT_EQ((float)(region.x + region.width) / pageSize, dst[3].u);
+    EXPECT_FLOAT_EQ((float)(region.y + region.height) / pageSize, dst[3].v);
+}
+
+TEST(AtlasPackerTest, RemapIsIdentityWhenNotPlaced)
+{
+    AtlasRegion region;
+    auto r = region.Remap(Rect<int>(3, 5, 17, 19));
+    EXPECT_EQ(3, r.left);
+    EXPECT_EQ(5, r.top);
+    EXPECT_EQ(17, r.right);
+    EXPECT_EQ(19, r.bottom);
+}
+
+TEST(TextureSwitchCounterTest, CountsSwitchesInDrawSequence)
+{
+    // 2つの元画像が同じアトラスのページに入っている
+    int page, other, src1, src2;
+    const void* seq[][2] = {
+        { &page, &src1 },
+        { &page, &src1 },
+        { &page, &src2 },
+        { &page, &src1 },
+        { &other, &other },
+        { &other, &other },
+        { &page, &src2 },
+    };
+    TextureSwitchCounter counter;
+    for (const auto& draw : seq)
+    {
+        counter.Count(draw[0], draw[1]);
+    }
+    EXPECT_EQ(7, counter.GetDrawCount());
+    // page, other, page
+    EXPECT_EQ(3, counter.GetSwitchCount());
+    // src1, src2, src1, other, src2
+    EXPECT_EQ(5, counter.GetSourceSwitchCount());
+    EXPECT_EQ(2, counter.GetSavedSwitchCount());
+
+    // 最初の描画は切り替えに数える
+    counter.Reset();
+    counter.Count(nullptr, nullptr);
+    EXPECT_EQ(1, counter.GetDrawCount());
+    EXPECT_EQ(1, counter.GetSwitchCount());
+    EXPECT_EQ(1, counter.GetSourceSwitchCount());
+}
@@ -0,0 +1,55 @@
+﻿#include <bstorm/cache_store.hpp>
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+using namespace bstorm;
+
+namespace
+{
+// ワーカーを塞いでおき, 後から積んだロードが未実行のままになるようにする
+class CacheStoreCancelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto blocked = gate.get_future().share();
+        pool.Push(0, [blocked]() { blocked.wait(); });
+    }
+    void TearDown() override
+    {
+        gate.set_value();
+    }
+    std::promise<void> gate;
+    TaskPool pool{ 1 };
+    CacheStore<int, int> store;
+};
+}
+
+TEST_F(CacheStoreCancelTest, CancelsQueuedLoad)
+{
+    store.LoadAsync(pool, 1, 10, 42);
+    EXPECT_TRUE(store.CancelLoad(10));
+    EXPECT_FALSE(store.Contains(10));
+}
+
+TEST_F(CacheStoreCancelTest, KeepsLoadWhileAnotherRequestWaits)
+{
+    store.LoadAsync(pool, 1, 10, 42);
+    store.LoadAsync(pool, 1, 10, 42);
+    // 片方が取り下げても, もう片方が待っているので残す
+    EXPECT_FALSE(store.CancelLoad(10));
+    EXPECT_TRUE(store.Contains(10));
+    EXPECT_TRUE(store.CancelLoad(10));
+    EXPECT_FALSE(store.Contains(10));
+}
+
+TEST_F(CacheStoreCancelTest, KeepsLoadedEntry)
+{
+    store.LoadAsync(pool, 1, 10, 42);
+    // 呼び出し元のスレッドで実行され, 取り消せなくなる
+    EXPECT_EQ(42, *store.Get(10));
+    EXPECT_FALSE(store.CancelLoad(10));
+    EXPECT_EQ(42, *store.Get(10));
+}
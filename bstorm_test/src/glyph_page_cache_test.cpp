@@ -0,0 +1,145 @@
+﻿#include <bstorm/glyph_page_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace bstorm
+{
+// ページの代わり
+class Texture
+{
+public:
+    explicit Texture(int id) : id(id) {}
+    const int id;
+};
+}
+
+using namespace bstorm;
+
+namespace
+{
+constexpr int PAGE_SIZE = 64;
+constexpr int MAX_PAGE_COUNT = 4;
+
+// 1文字で1ページを使い切る大きさ(パディング1)
+Glyph MakeLargeGlyph()
+{
+    Glyph glyph{};
+    glyph.width = PAGE_SIZE - 1;
+    glyph.height = PAGE_SIZE - 1;
+    return glyph;
+}
+
+class GlyphPageCacheTest : public ::testing::Test
+{
+protected:
+    GlyphPageCacheTest() : cache(PAGE_SIZE, MAX_PAGE_COUNT), createdPageCount(0) {}
+    Glyph Insert(const std::wstring& face, wchar_t c)
+    {
+        Glyph glyph = MakeLargeGlyph();
+        EXPECT_TRUE(cache.Insert(face, c, &glyph, [&](int) { return std::make_shared<Texture>(createdPageCount++); }));
+        return glyph;
+    }
+    GlyphPageCache<std::wstring> cache;
+    int createdPageCount;
+};
+}
+
+TEST_F(GlyphPageCacheTest, EvictsPagesBeyondMaxPageCount)
+{
+    for (int i = 0; i < MAX_PAGE_COUNT * 3; i++)
+    {
+        // 戻り値のページは保持しない
+        Insert(L"face", L'a' + i);
+        EXPECT_LE(cache.GetPageCount(), MAX_PAGE_COUNT);
+    }
+    EXPECT_EQ(MAX_PAGE_COUNT * 3, createdPageCount);
+    EXPECT_EQ(MAX_PAGE_COUNT, cache.GetPageCount());
+    EXPECT_EQ(MAX_PAGE_COUNT, cache.GetGlyphCount());
+
+    // 古い文字は追い出されている
+    Glyph glyph;
+    EXPECT_FALSE(cache.Find(L"face", L'a', &glyph));
+    ASSERT_TRUE(cache.Find(L"face", L'a' + MAX_PAGE_COUNT * 3 - 1, &glyph));
+    EXPECT_EQ(MAX_PAGE_COUNT * 3 - 1, glyph.page->id);
+}
+
+TEST_F(GlyphPageCacheTest, CachedGlyphDoesNotPinPage)
+{
+    Insert(L"face", L'a');
+    Glyph glyph;
+    ASSERT_TRUE(cache.Find(L"face", L'a', &glyph));
+    // キャッシュ内のページと返した文字のページのみ
+    EXPECT_EQ(2, glyph.page.use_count());
+}
+
+TEST_F(GlyphPageCacheTest, EvictsLeastRecentlyUsedPage)
+{
+    for (int i = 0; i < MAX_PAGE_COUNT; i++)
+    {
+        Insert(L"face" + std::to_wstring(i), L'a');
+    }
+    // face0を使ったので, 最も古いのはface1
+    Glyph glyph;
+    ASSERT_TRUE(cache.Find(L"face0", L'a', &glyph));
+    glyph.page.reset();
+
+    Insert(L"face4", L'a');
+    EXPECT_EQ(MAX_PAGE_COUNT, cache.GetPageCount());
+    EXPECT_TRUE(cache.Find(L"face0", L'a', &glyph));
+    EXPECT_FALSE(cache.Find(L"face1", L'a', &glyph));
+    EXPECT_TRUE(cache.Find(L"face2", L'a', &glyph));
+}
+
+TEST_F(GlyphPageCacheTest, DoesNotEvictReferencedPage)
+{
+    std::vector<Glyph> used;
+    for (int i = 0; i < MAX_PAGE_COUNT; i++)
+    {
+        used.push_back(Insert(L"face", L'a' + i));
+    }
+    // 全て参照中なら上限を超えてでも作る
+    Glyph extra = Insert(L"face", L'z');
+    EXPECT_EQ(MAX_PAGE_COUNT + 1, cache.GetPageCount());
+    Glyph glyph;
+    for (int i = 0; i < MAX_PAGE_COUNT; i++)
+    {
+        EXPECT_TRUE(cache.Find(L"face", L'a' + i, &glyph));
+    }
+
+    // 参照が切れたら次のページ作成時に上限まで追い出される
+    used.clear();
+    extra.page.reset();
+    glyph.page.reset();
+    Insert(L"face", L'y');
+    EXPECT_EQ(MAX_PAGE_COUNT, cache.GetPageCount());
+    // 最も長く使われていないのは'z'と'a'
+    EXPECT_FALSE(cache.Find(L"face", L'z', &glyph));
+    EXPECT_FALSE(cache.Find(L"face", L'a', &glyph));
+    EXPECT_TRUE(cache.Find(L"face", L'b', &glyph));
+}
+
+TEST_F(GlyphPageCacheTest, SharesPageWithinFace)
+{
+    Glyph small{};
+    small.width = 8;
+    small.height = 8;
+    Glyph a = small, b = small, c = small;
+    auto createPage = [&](int) { return std::make_shared<Texture>(createdPageCount++); };
+    ASSERT_TRUE(cache.Insert(L"face", L'a', &a, createPage));
+    ASSERT_TRUE(cache.Insert(L"face", L'b', &b, createPage));
+    ASSERT_TRUE(cache.Insert(L"other", L'c', &c, createPage));
+    EXPECT_EQ(a.page, b.page);
+    EXPECT_NE(a.page, c.page);
+    EXPECT_NE(a.region.x, b.region.x);
+    EXPECT_EQ(2, cache.GetPageCount());
+
+    // ページに収まらない文字は登録しない
+    Glyph huge{};
+    huge.width = PAGE_SIZE;
+    huge.height = PAGE_SIZE;
+    EXPECT_FALSE(cache.Insert(L"face", L'd', &huge, createPage));
+    EXPECT_EQ(2, cache.GetPageCount());
+}
@@ -0,0 +1,88 @@
+﻿#include <bstorm/ident.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace bstorm;
+
+TEST(IdentTest, SharesEntryForSameSpelling)
+{
+    std::string spelling = "ident_test_shared";
+    Ident a(spelling);
+    Ident b("ident_test_shared");
+    EXPECT_EQ(a.GetEntry(), b.GetEntry());
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a == Ident("ident_test_other"));
+    EXPECT_EQ(a.GetString(), spelling);
+}
+
+TEST(IdentTest, DefaultIsEmptyString)
+{
+    EXPECT_EQ(Ident(), Ident(""));
+    EXPECT_TRUE(Ident().GetString().empty());
+}
+
+// 名前表の走査順が文字列をキーにしていた時と変わらないこと
+TEST(IdentTest, HashesLikeString)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++)
+    {
+        names.push_back("v" + std::to_string(i));
+    }
+    std::unordered_map<std::string, int> byString;
+    std::unordered_map<Ident, int> byIdent;
+    for (int i = 0; i < (int)names.size(); i++)
+    {
+        EXPECT_EQ(std::hash<Ident>()(Ident(names[i])), std::hash<std::string>()(names[i]));
+        byString[names[i]] = i;
+        byIdent[Ident(names[i])] = i;
+    }
+    auto it = byIdent.begin();
+    for (const auto& entry : byString)
+    {
+        ASSERT_NE(it, byIdent.end());
+        EXPECT_EQ(it->first.GetString(), entry.first);
+        ++it;
+    }
+}
+
+TEST(IdentTest, ComparesAndConcatenatesWithStrings)
+{
+    Ident name("ident_test_cat");
+    EXPECT_TRUE(name == "ident_test_cat");
+    EXPECT_TRUE("ident_test_cat" == name);
+    EXPECT_TRUE(name != std::string("ident_test"));
+    EXPECT_EQ("_" + name + "_", "_ident_test_cat_");
+    EXPECT_EQ(std::string("x") + name, "xident_test_cat");
+}
+
+TEST(IdentTest, InternsFromManyThreads)
+{
+    constexpr int threadCount = 4;
+    constexpr int nameCount = 1000;
+    std::vector<std::vector<const Ident::Entry*>> entries(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([t, &entries]()
+        {
+            for (int i = 0; i < nameCount; i++)
+            {
+                entries[t].push_back(Ident("ident_test_thread" + std::to_string(i)).GetEntry());
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (int t = 1; t < threadCount; t++)
+    {
+        EXPECT_EQ(entries[t], entries[0]);
+    }
+}
@@ -0,0 +1,244 @@
+﻿#include <bstorm/image_encoder.hpp>
+#include <bstorm/image_save_queue.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/string_util.hpp>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <random>
+#include <string>
+
+using namespace bstorm;
+
+namespace
+{
+ImageBGRA MakeImage(int width, int height, uint32_t seed)
+{
+    ImageBGRA image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(4 * (size_t)width * height);
+    std::mt19937 rand(seed);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint8_t* p = image.pixels.data() + 4 * ((size_t)width * y + x);
+            // グラデーションと雑音を混ぜて, 一致する部分としない部分を両方作る
+            p[0] = (uint8_t)(x * 3);
+            p[1] = (uint8_t)(y * 5);
+            p[2] = (x / 8 + y / 8) % 2 ? 0xff : (uint8_t)rand();
+            p[3] = (uint8_t)(0xff - x);
+        }
+    }
+    return image;
+}
+
+std::vector<uint8_t> Inflate(const std::vector<uint8_t>& compressed, size_t expectedSize)
+{
+    std::vector<uint8_t> out(expectedSize + 1);
+    uLongf outSize = (uLongf)out.size();
+    EXPECT_EQ(Z_OK, uncompress(out.data(), &outSize, compressed.data(), (uLong)compressed.size()));
+    out.resize(outSize);
+    return out;
+}
+
+uint32_t ReadBE32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint32_t ReadLE32(const uint8_t* p)
+{
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+struct PngChunk
+{
+    std::string type;
+    std::vector<uint8_t> data;
+};
+
+// チャンクに分解してCRCを確かめる
+std::vector<PngChunk> ParsePng(const std::vector<uint8_t>& png)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<PngChunk> chunks;
+    EXPECT_GE(png.size(), sizeof(signature));
+    EXPECT_TRUE(std::equal(signature, signature + 8, png.begin()));
+    size_t pos = 8;
+    while (pos + 12 <= png.size())
+    {
+        const uint32_t len = ReadBE32(&png[pos]);
+        EXPECT_LE(pos + 12 + len, png.size());
+        PngChunk chunk;
+        chunk.type.assign((const char*)&png[pos + 4], 4);
+        chunk.data.assign(png.begin() + pos + 8, png.begin() + pos + 8 + len);
+        const uint32_t crc = ReadBE32(&png[pos + 8 + len]);
+        EXPECT_EQ(crc32(0, &png[pos + 4], 4 + len), crc) << chunk.type;
+        chunks.push_back(std::move(chunk));
+        pos += 12 + len;
+    }
+    EXPECT_EQ(png.size(), pos);
+    return chunks;
+}
+
+// PNGを展開してBGRAに戻す
+ImageBGRA DecodePng(const std::vector<uint8_t>& png)
+{
+    ImageBGRA image;
+    const auto chunks = ParsePng(png);
+    if (chunks.size() != 3) { ADD_FAILURE() << "chunk count " << chunks.size(); return image; }
+    EXPECT_EQ("IHDR", chunks[0].type);
+    EXPECT_EQ("IDAT", chunks[1].type);
+    EXPECT_EQ("IEND", chunks[2].type);
+    const auto& header = chunks[0].data;
+    EXPECT_EQ(13u, header.size());
+    image.width = (int)ReadBE32(&header[0]);
+    image.height = (int)ReadBE32(&header[4]);
+    EXPECT_EQ(8, header[8]);
+    EXPECT_EQ(6, header[9]);
+
+    const size_t rowSize = 1 + 4 * (size_t)image.width;
+    const auto raw = Inflate(chunks[1].data, rowSize * image.height);
+    EXPECT_EQ(rowSize * image.height, raw.size());
+    image.pixels.resize(4 * (size_t)image.width * image.height);
+    for (int y = 0; y < image.height && raw.size() == rowSize * image.height; y++)
+    {
+        const uint8_t* src = raw.data() + rowSize * y;
+        EXPECT_EQ(1, src[0]); // Sub
+        uint8_t left[4] = { 0, 0, 0, 0 };
+        for (int x = 0; x < image.width; x++)
+        {
+            uint8_t rgba[4];
+            for (int c = 0; c < 4; c++)
+            {
+                rgba[c] = (uint8_t)(src[1 + 4 * x + c] + left[c]);
+                left[c] = rgba[c];
+            }
+            uint8_t* dst = image.pixels.data() + 4 * ((size_t)image.width * y + x);
+            dst[0] = rgba[2];
+            dst[1] = rgba[1];
+            dst[2] = rgba[0];
+            dst[3] = rgba[3];
+        }
+    }
+    return image;
+}
+}
+
+TEST(ImageEncoderTest, CompressZlibIsInflatable)
+{
+    std::mt19937 rand(1);
+    std::vector<std::vector<uint8_t>> inputs;
+    inputs.push_back({});
+    inputs.push_back({ 42 });
+    inputs.push_back(std::vector<uint8_t>(100000, 7)); // 最長一致の連続
+    {
+        std::vector<uint8_t> noise(70000);
+        for (auto& b : noise) b = (uint8_t)rand();
+        inputs.push_back(noise);
+    }
+    {
+        // 窓(32K)を超える距離の繰り返し
+        std::vector<uint8_t> block(40000);
+        for (auto& b : block) b = (uint8_t)rand();
+        std::vector<uint8_t> repeated = block;
+        repeated.insert(repeated.end(), block.begin(), block.end());
+        inputs.push_back(repeated);
+    }
+    {
+        std::string text;
+        for (int i = 0; i < 2000; i++) text += "bstorm " + std::to_string(i % 37) + "\n";
+        inputs.push_back(std::vector<uint8_t>(text.begin(), text.end()));
+    }
+    for (const auto& input : inputs)
+    {
+        std::vector<uint8_t> compressed;
+        CompressZlib(input.data(), input.size(), &compressed);
+        EXPECT_EQ(input, Inflate(compressed, input.size())) << "size " << input.size();
+    }
+}
+
+TEST(ImageEncoderTest, EncodePngRoundTrip)
+{
+    for (auto size : { std::make_pair(1, 1), std::make_pair(3, 2), std::make_pair(64, 48), std::make_pair(257, 31) })
+    {
+        const ImageBGRA image = MakeImage(size.first, size.second, size.first);
+        std::vector<uint8_t> png;
+        EncodePng(image, &png);
+        const ImageBGRA decoded = DecodePng(png);
+        EXPECT_EQ(image.width, decoded.width);
+        EXPECT_EQ(image.height, decoded.height);
+        EXPECT_EQ(image.pixels, decoded.pixels) << size.first << "x" << size.second;
+    }
+}
+
+TEST(ImageEncoderTest, EncodeBmpLayout)
+{
+    // 3 * 5 = 15バイトの行は16バイトに揃える
+    const ImageBGRA image = MakeImage(5, 3, 2);
+    std::vector<uint8_t> bmp;
+    EncodeBmp(image, &bmp);
+    const size_t rowSize = 16;
+    ASSERT_EQ(54 + rowSize * 3, bmp.size());
+    EXPECT_EQ('B', bmp[0]);
+    EXPECT_EQ('M', bmp[1]);
+    EXPECT_EQ(bmp.size(), ReadLE32(&bmp[2]));
+    EXPECT_EQ(54u, ReadLE32(&bmp[10]));
+    EXPECT_EQ(5u, ReadLE32(&bmp[18]));
+    EXPECT_EQ(3u, ReadLE32(&bmp[22]));
+    EXPECT_EQ(24, bmp[28]);
+
+    for (int y = 0; y < 3; y++)
+    {
+        // 下の行から並ぶ
+        const uint8_t* row = bmp.data() + 54 + rowSize * (2 - y);
+        for (int x = 0; x < 5; x++)
+        {
+            const uint8_t* src = image.pixels.data() + 4 * (5 * y + x);
+            EXPECT_EQ(src[0], row[3 * x]);
+            EXPECT_EQ(src[1], row[3 * x + 1]);
+            EXPECT_EQ(src[2], row[3 * x + 2]);
+        }
+        EXPECT_EQ(0, row[15]);
+    }
+}
+
+TEST(ImageSaveQueueTest, WritesEncodedFiles)
+{
+    const std::wstring dir = ToUnicode(::testing::TempDir()) + L"bstorm_image_save_queue_test";
+    MakeDirectoryP(dir);
+    const std::wstring pngPath = dir + L"/スナップショット.png";
+    const std::wstring bmpPath = dir + L"/snapshot.bmp";
+    RemoveFile(pngPath);
+    RemoveFile(bmpPath);
+
+    const ImageBGRA image = MakeImage(32, 16, 3);
+    std::vector<uint8_t> expectedPng, expectedBmp;
+    EncodePng(image, &expectedPng);
+    EncodeBmp(image, &expectedBmp);
+    {
+        ImageSaveQueue queue(1);
+        for (int i = 0; i < 3; i++)
+        {
+            queue.Push(pngPath, ImageFileFormat::PNG, ImageBGRA(image));
+        }
+        queue.Push(bmpPath, ImageFileFormat::BMP, ImageBGRA(image));
+        // 破棄時に残りを書き出す
+    }
+    std::vector<char> png, bmp;
+    ASSERT_TRUE(ReadFileBytes(pngPath, &png));
+    ASSERT_TRUE(ReadFileBytes(bmpPath, &bmp));
+    EXPECT_EQ(expectedPng, std::vector<uint8_t>(png.begin(), png.end()));
+    EXPECT_EQ(expectedBmp, std::vector<uint8_t>(bmp.begin(), bmp.end()));
+
+    ImageSaveQueue queue(4);
+    RemoveFile(pngPath);
+    queue.Push(pngPath, ImageFileFormat::PNG, ImageBGRA(image));
+    while (!queue.IsCompleted(pngPath)) std::this_thread::yield();
+    EXPECT_TRUE(queue.IsAllCompleted());
+    ASSERT_TRUE(ReadFileBytes(pngPath, &png));
+    EXPECT_EQ(expectedPng, std::vector<uint8_t>(png.begin(), png.end()));
+}
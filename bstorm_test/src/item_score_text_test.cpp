@@ -0,0 +1,107 @@
+﻿#include <bstorm/item_score_text.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace bstorm;
+
+TEST(ItemScoreTextListTest, HoversAndExpiresInOrder)
+{
+    ItemScoreTextList texts;
+    texts.Add(10, 100, 1);
+    texts.Update();
+    texts.Add(20, 200, 2);
+    ASSERT_EQ(2u, texts.GetCount());
+    EXPECT_EQ(99.0f, texts.GetY(0));
+    EXPECT_EQ(1, texts.GetAge(0));
+    EXPECT_EQ(200.0f, texts.GetY(1));
+    EXPECT_EQ(0, texts.GetAge(1));
+
+    // 先に追加した方が1フレーム早く消える
+    for (int i = 0; i < SCORE_TEXT_LIFE - 2; i++) texts.Update();
+    ASSERT_EQ(2u, texts.GetCount());
+    EXPECT_EQ(10.0f, texts.GetX(0));
+    EXPECT_EQ(100.0f - (SCORE_TEXT_LIFE - 1) * SCORE_TEXT_HOVER_SPEED, texts.GetY(0));
+    texts.Update();
+    ASSERT_EQ(1u, texts.GetCount());
+    EXPECT_EQ(20.0f, texts.GetX(0));
+    EXPECT_EQ(SCORE_TEXT_LIFE - 1, texts.GetAge(0));
+    texts.Update();
+    EXPECT_EQ(0u, texts.GetCount());
+}
+
+TEST(ItemScoreTextListTest, WritesOneQuadPerDigit)
+{
+    // 0から9が横に並んだ画像
+    const int texWidth = 10 * SCORE_TEXT_DIGIT_SRC_WIDTH;
+    const int texHeight = 2 * SCORE_TEXT_DIGIT_SRC_HEIGHT;
+    ItemScoreTextList texts;
+    texts.Add(10, 20, 907);
+    texts.Add(0, 0, 5);
+    std::vector<Vertex> vertices;
+    texts.WriteVertices(texWidth, texHeight, &vertices);
+    ASSERT_EQ(6u * 4, vertices.size());
+
+    const int expectedDigits[] = { 9, 0, 7, 5 };
+    for (int i = 0; i < 4; i++)
+    {
+        const Vertex* quad = vertices.data() + 6 * i;
+        const float l = i < 3 ? 10.0f + i * (SCORE_TEXT_DIGIT_WIDTH - 1) : 0.0f;
+        const float t = i < 3 ? 20.0f : 0.0f;
+        const float u0 = (float)(expectedDigits[i] * SCORE_TEXT_DIGIT_SRC_WIDTH) / texWidth;
+        const float u1 = (float)((expectedDigits[i] + 1) * SCORE_TEXT_DIGIT_SRC_WIDTH) / texWidth;
+        // 左上, 左下, 右上, 右上, 左下, 右下
+        EXPECT_EQ(l, quad[0].x) << "digit " << i;
+        EXPECT_EQ(t, quad[0].y) << "digit " << i;
+        EXPECT_EQ(u0, quad[0].u) << "digit " << i;
+        EXPECT_EQ(0.0f, quad[0].v) << "digit " << i;
+        EXPECT_EQ(l, quad[1].x) << "digit " << i;
+        EXPECT_EQ(t + SCORE_TEXT_DIGIT_HEIGHT, quad[1].y) << "digit " << i;
+        EXPECT_EQ(0.5f, quad[1].v) << "digit " << i;
+        EXPECT_EQ(l + SCORE_TEXT_DIGIT_WIDTH, quad[2].x) << "digit " << i;
+        EXPECT_EQ(u1, quad[2].u) << "digit " << i;
+        EXPECT_EQ(0, std::memcmp(&quad[2], &quad[3], sizeof(Vertex))) << "digit " << i;
+        EXPECT_EQ(0, std::memcmp(&quad[1], &quad[4], sizeof(Vertex))) << "digit " << i;
+        EXPECT_EQ(l + SCORE_TEXT_DIGIT_WIDTH, quad[5].x) << "digit " << i;
+        EXPECT_EQ(t + SCORE_TEXT_DIGIT_HEIGHT, quad[5].y) << "digit " << i;
+        for (int k = 0; k < 6; k++)
+        {
+            EXPECT_EQ(D3DCOLOR_ARGB(0xff, 0xff, 0xff, 0xff), quad[k].color);
+        }
+    }
+
+    // 時間と共に薄くなる
+    for (int i = 0; i < 4; i++) texts.Update();
+    texts.WriteVertices(texWidth, texHeight, &vertices);
+    ASSERT_EQ(6u * 4, vertices.size());
+    EXPECT_EQ(D3DCOLOR_ARGB(0xff - 32, 0xff, 0xff, 0xff), vertices[0].color);
+    EXPECT_EQ(16.0f, vertices[0].y);
+
+    // 書き込み先は毎回作り直す
+    texts = ItemScoreTextList();
+    texts.WriteVertices(texWidth, texHeight, &vertices);
+    EXPECT_TRUE(vertices.empty());
+}
+
+TEST(ItemScoreTextListTest, BoundsContainAllTexts)
+{
+    ItemScoreTextList texts;
+    Rect<float> bounds(0, 0, 0, 0);
+    EXPECT_FALSE(texts.GetBounds(&bounds));
+
+    texts.Add(50, 40, 1234567890);
+    texts.Add(-10, 80, 0);
+    std::vector<Vertex> vertices;
+    texts.WriteVertices(360, 32, &vertices);
+    ASSERT_TRUE(texts.GetBounds(&bounds));
+    EXPECT_EQ(-10.0f, bounds.left);
+    EXPECT_EQ(40.0f, bounds.top);
+    for (const auto& v : vertices)
+    {
+        EXPECT_LE(bounds.left, v.x);
+        EXPECT_LE(bounds.top, v.y);
+        EXPECT_GE(bounds.right, v.x);
+        EXPECT_GE(bounds.bottom, v.y);
+    }
+}
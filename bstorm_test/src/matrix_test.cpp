@@ -0,0 +1,303 @@
+﻿#include <bstorm/matrix.hpp>
+#include <bstorm/camera2D.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace bstorm;
+
+namespace
+{
+// D3DXの各関数のリファレンスに記載された定義をそのまま書いたもの
+namespace d3dx
+{
+constexpr float PI = 3.14159265358979323846f;
+
+float ToRadian(float deg) { return deg * (PI / 180.0f); }
+
+struct Vec3 { float x, y, z; };
+
+Vec3 Sub(const Vec3& a, const Vec3& b) { return Vec3{ a.x - b.x, a.y - b.y, a.z - b.z }; }
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return Vec3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+Vec3 Normalize(const Vec3& v)
+{
+    const float len = std::sqrt(Dot(v, v));
+    return Vec3{ v.x / len, v.y / len, v.z / len };
+}
+
+// D3DXMatrixMultiply
+Matrix4 Multiply(const Matrix4& a, const Matrix4& b)
+{
+    Matrix4 mat = {};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                mat.m[i][j] += a.m[i][k] * b.m[k][j];
+            }
+        }
+    }
+    return mat;
+}
+
+Matrix4 Identity()
+{
+    Matrix4 mat = {};
+    mat.m[0][0] = mat.m[1][1] = mat.m[2][2] = mat.m[3][3] = 1.0f;
+    return mat;
+}
+
+Matrix4 RotationX(float rad)
+{
+    Matrix4 mat = Identity();
+    mat.m[1][1] = std::cos(rad); mat.m[1][2] = std::sin(rad);
+    mat.m[2][1] = -std::sin(rad); mat.m[2][2] = std::cos(rad);
+    return mat;
+}
+
+Matrix4 RotationY(float rad)
+{
+    Matrix4 mat = Identity();
+    mat.m[0][0] = std::cos(rad); mat.m[0][2] = -std::sin(rad);
+    mat.m[2][0] = std::sin(rad); mat.m[2][2] = std::cos(rad);
+    return mat;
+}
+
+Matrix4 RotationZ(float rad)
+{
+    Matrix4 mat = Identity();
+    mat.m[0][0] = std::cos(rad); mat.m[0][1] = std::sin(rad);
+    mat.m[1][0] = -std::sin(rad); mat.m[1][1] = std::cos(rad);
+    return mat;
+}
+
+// D3DXMatrixRotationYawPitchRoll : ロール(Z), ピッチ(X), ヨー(Y)の順
+Matrix4 RotationYawPitchRoll(float yaw, float pitch, float roll)
+{
+    return Multiply(Multiply(RotationZ(roll), RotationX(pitch)), RotationY(yaw));
+}
+
+Matrix4 Scaling(float sx, float sy, float sz)
+{
+    Matrix4 mat = Identity();
+    mat.m[0][0] = sx; mat.m[1][1] = sy; mat.m[2][2] = sz;
+    return mat;
+}
+
+Matrix4 Translation(float x, float y, float z)
+{
+    Matrix4 mat = Identity();
+    mat.m[3][0] = x; mat.m[3][1] = y; mat.m[3][2] = z;
+    return mat;
+}
+
+// D3DXMatrixLookAtLH
+Matrix4 LookAtLH(const Vec3& eye, const Vec3& at, const Vec3& up)
+{
+    const Vec3 zaxis = Normalize(Sub(at, eye));
+    const Vec3 xaxis = Normalize(Cross(up, zaxis));
+    const Vec3 yaxis = Cross(zaxis, xaxis);
+    Matrix4 mat = Identity();
+    mat.m[0][0] = xaxis.x; mat.m[0][1] = yaxis.x; mat.m[0][2] = zaxis.x;
+    mat.m[1][0] = xaxis.y; mat.m[1][1] = yaxis.y; mat.m[1][2] = zaxis.y;
+    mat.m[2][0] = xaxis.z; mat.m[2][1] = yaxis.z; mat.m[2][2] = zaxis.z;
+    mat.m[3][0] = -Dot(xaxis, eye); mat.m[3][1] = -Dot(yaxis, eye); mat.m[3][2] = -Dot(zaxis, eye);
+    return mat;
+}
+}
+
+// 以前のCamera2D::GenerateViewMatrixと同じ手順で求めたビュー行列
+Matrix4 ReferenceCamera2DView(float focusX, float focusY, float angleZ, float ratioX, float ratioY)
+{
+    Matrix4 rot = d3dx::RotationZ(d3dx::ToRadian(-angleZ));
+    for (int j = 0; j < 4; j++)
+    {
+        rot.m[0][j] *= ratioX;
+        rot.m[1][j] *= ratioY;
+    }
+    const Matrix4 lookAt = d3dx::LookAtLH(d3dx::Vec3{ focusX, focusY, 1.0f }, d3dx::Vec3{ focusX, focusY, 0.0f }, d3dx::Vec3{ 0.0f, -1.0f, 0.0f });
+    return d3dx::Multiply(lookAt, rot);
+}
+
+void ExpectMatrixNear(const Matrix4& expected, const Matrix4& actual, float eps = 1e-4f)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            EXPECT_NEAR(expected.m[i][j], actual.m[i][j], eps) << "m[" << i << "][" << j << "]";
+        }
+    }
+}
+
+Matrix4 MakeMatrix(float seed)
+{
+    Matrix4 mat;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            // 対角を大きくして正則にする
+            mat.m[i][j] = std::sin(seed + i * 4 + j) * 3.0f + (i == j ? 8.0f : 0.0f);
+        }
+    }
+    return mat;
+}
+}
+
+TEST(MatrixTest, MultiplyMatchesD3DX)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        const Matrix4 a = MakeMatrix(0.3f * i);
+        const Matrix4 b = MakeMatrix(1.7f * i + 5.0f);
+        ExpectMatrixNear(d3dx::Multiply(a, b), a * b);
+    }
+    const Matrix4 a = MakeMatrix(2.0f);
+    ExpectMatrixNear(a, a * IdentityMatrix4(), 0.0f);
+    ExpectMatrixNear(a, IdentityMatrix4() * a, 0.0f);
+}
+
+TEST(MatrixTest, ScaleRotTransMatchesYawPitchRoll)
+{
+    const float angles[][3] = {
+        { 0.0f, 0.0f, 0.0f },
+        { 90.0f, 0.0f, 0.0f },
+        { 0.0f, 90.0f, 0.0f },
+        { 0.0f, 0.0f, 90.0f },
+        { 30.0f, 45.0f, 60.0f },
+        { -120.0f, 200.0f, 15.5f },
+        { 359.0f, -1.0f, 721.0f },
+    };
+    for (const auto& a : angles)
+    {
+        const float rx = a[0], ry = a[1], rz = a[2];
+        // D3DXMatrixScaling * D3DXMatrixRotationYawPitchRoll(ry, rx, rz) * D3DXMatrixTranslation
+        const Matrix4 expected = d3dx::Multiply(d3dx::Multiply(d3dx::Scaling(2.0f, 0.5f, -3.0f), d3dx::RotationYawPitchRoll(d3dx::ToRadian(ry), d3dx::ToRadian(rx), d3dx::ToRadian(rz))), d3dx::Translation(10.0f, -20.0f, 30.0f));
+        ExpectMatrixNear(expected, ScaleRotTransMatrix4(10.0f, -20.0f, 30.0f, rx, ry, rz, 2.0f, 0.5f, -3.0f));
+    }
+}
+
+TEST(MatrixTest, Camera2DViewMatchesLookAtLHTimesRotZ)
+{
+    const float params[][5] = {
+        { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 320.0f, 240.0f, 0.0f, 1.0f, 1.0f },
+        { 192.0f, 224.0f, 30.0f, 2.0f, 2.0f },
+        { -50.0f, 800.0f, -135.0f, 0.5f, 1.5f },
+        { 10.0f, 20.0f, 400.0f, 3.0f, 0.25f },
+    };
+    for (const auto& p : params)
+    {
+        ExpectMatrixNear(ReferenceCamera2DView(p[0], p[1], p[2], p[3], p[4]), Camera2DViewMatrix4(p[0], p[1], p[2], p[3], p[4]));
+    }
+}
+
+TEST(MatrixTest, InverseMatchesIdentity)
+{
+    const Matrix4 mats[] = {
+        IdentityMatrix4(),
+        ScaleRotTransMatrix4(10.0f, -20.0f, 30.0f, 30.0f, 45.0f, 60.0f, 2.0f, 0.5f, 3.0f),
+        Camera2DViewMatrix4(192.0f, 224.0f, 30.0f, 2.0f, 1.5f) * Camera2DProjMatrix4(640.0f, 480.0f, 224.0f, 240.0f),
+        MakeMatrix(1.0f),
+    };
+    for (const auto& mat : mats)
+    {
+        Matrix4 inv;
+        ASSERT_TRUE(InverseMatrix4(mat, &inv));
+        ExpectMatrixNear(IdentityMatrix4(), mat * inv);
+        ExpectMatrixNear(IdentityMatrix4(), inv * mat);
+    }
+
+    // 移動と拡大の逆行列は解析的に求まる
+    Matrix4 inv;
+    ASSERT_TRUE(InverseMatrix4(d3dx::Multiply(d3dx::Scaling(2.0f, 4.0f, 8.0f), d3dx::Translation(1.0f, 2.0f, 3.0f)), &inv));
+    ExpectMatrixNear(d3dx::Multiply(d3dx::Translation(-1.0f, -2.0f, -3.0f), d3dx::Scaling(0.5f, 0.25f, 0.125f)), inv);
+}
+
+TEST(MatrixTest, InverseOfSingularMatrixFails)
+{
+    Matrix4 singular = d3dx::Scaling(1.0f, 0.0f, 1.0f);
+    Matrix4 inv = MakeMatrix(3.0f);
+    const Matrix4 before = inv;
+    EXPECT_FALSE(InverseMatrix4(singular, &inv));
+    ExpectMatrixNear(before, inv, 0.0f);
+}
+
+TEST(MatrixTest, TransMatchesD3DX)
+{
+    ExpectMatrixNear(d3dx::Translation(10.0f, -20.0f, 30.0f), TransMatrix4(10.0f, -20.0f, 30.0f), 0.0f);
+    // ObjTextの行列: 中心を原点に移してから拡大・回転して戻す
+    const Matrix4 expected = d3dx::Multiply(d3dx::Translation(-8.0f, -4.0f, 1.0f), ScaleRotTransMatrix4(40.0f, 24.0f, 0.0f, 0.0f, 0.0f, 30.0f, 2.0f, 0.5f, 1.0f));
+    ExpectMatrixNear(expected, TransMatrix4(-8.0f, -4.0f, 1.0f) * ScaleRotTransMatrix4(40.0f, 24.0f, 0.0f, 0.0f, 0.0f, 30.0f, 2.0f, 0.5f, 1.0f));
+}
+
+TEST(MatrixTest, ScaleRotTransCacheIsRecomputedOnlyWhenArgumentsChange)
+{
+    ScaleRotTransMatrixCache cache;
+    const Matrix4* mat = &cache.Get(10.0f, -20.0f, 0.0f, 0.0f, 0.0f, 45.0f, 2.0f, 2.0f, 1.0f);
+    ExpectMatrixNear(ScaleRotTransMatrix4(10.0f, -20.0f, 0.0f, 0.0f, 0.0f, 45.0f, 2.0f, 2.0f, 1.0f), *mat, 0.0f);
+
+    // 全ての引数が結果に反映される
+    const float base[9] = { 10.0f, -20.0f, 0.0f, 0.0f, 0.0f, 45.0f, 2.0f, 2.0f, 1.0f };
+    for (int i = 0; i < 9; i++)
+    {
+        float p[9];
+        std::copy(base, base + 9, p);
+        p[i] += 3.0f;
+        const Matrix4 expected = ScaleRotTransMatrix4(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]);
+        EXPECT_EQ(mat, &cache.Get(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]));
+        ExpectMatrixNear(expected, *mat, 0.0f);
+        ExpectMatrixNear(ScaleRotTransMatrix4(base[0], base[1], base[2], base[3], base[4], base[5], base[6], base[7], base[8]), cache.Get(base[0], base[1], base[2], base[3], base[4], base[5], base[6], base[7], base[8]), 0.0f);
+    }
+
+    // 最初の呼び出しは引数が0でも計算する
+    ScaleRotTransMatrixCache zero;
+    ExpectMatrixNear(ScaleRotTransMatrix4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f), zero.Get(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f), 0.0f);
+}
+
+TEST(Camera2DTest, ViewMatrixIsRecomputedOnlyWhenDirty)
+{
+    Camera2D camera;
+    camera.Reset(192.0f, 224.0f);
+    const Matrix4* cache = &camera.GetViewMatrix();
+    ExpectMatrixNear(ReferenceCamera2DView(192.0f, 224.0f, 0.0f, 1.0f, 1.0f), *cache);
+
+    // 同じ値の設定では再計算されない (同じ場所を指したまま中身も変わらない)
+    camera.SetFocusX(192.0f);
+    camera.SetRatio(1.0f);
+    EXPECT_EQ(cache, &camera.GetViewMatrix());
+    ExpectMatrixNear(ReferenceCamera2DView(192.0f, 224.0f, 0.0f, 1.0f, 1.0f), camera.GetViewMatrix(), 0.0f);
+
+    camera.SetFocusX(100.0f);
+    ExpectMatrixNear(ReferenceCamera2DView(100.0f, 224.0f, 0.0f, 1.0f, 1.0f), camera.GetViewMatrix());
+    camera.SetFocusY(50.0f);
+    ExpectMatrixNear(ReferenceCamera2DView(100.0f, 50.0f, 0.0f, 1.0f, 1.0f), camera.GetViewMatrix());
+    camera.SetAngleZ(45.0f);
+    ExpectMatrixNear(ReferenceCamera2DView(100.0f, 50.0f, 45.0f, 1.0f, 1.0f), camera.GetViewMatrix());
+    camera.SetRatioX(2.0f);
+    ExpectMatrixNear(ReferenceCamera2DView(100.0f, 50.0f, 45.0f, 2.0f, 1.0f), camera.GetViewMatrix());
+    camera.SetRatioY(0.5f);
+    ExpectMatrixNear(ReferenceCamera2DView(100.0f, 50.0f, 45.0f, 2.0f, 0.5f), camera.GetViewMatrix());
+
+    camera.Reset(0.0f, 0.0f);
+    ExpectMatrixNear(ReferenceCamera2DView(0.0f, 0.0f, 0.0f, 1.0f, 1.0f), camera.GetViewMatrix());
+}
+
+TEST(Camera2DTest, ProjMatrixIsRecomputedWhenArgumentsChange)
+{
+    Camera2D camera;
+    ExpectMatrixNear(Camera2DProjMatrix4(640.0f, 480.0f, 224.0f, 240.0f), camera.GetProjMatrix(640.0f, 480.0f, 224.0f, 240.0f), 0.0f);
+    ExpectMatrixNear(Camera2DProjMatrix4(640.0f, 480.0f, 320.0f, 240.0f), camera.GetProjMatrix(640.0f, 480.0f, 320.0f, 240.0f), 0.0f);
+    ExpectMatrixNear(Camera2DProjMatrix4(800.0f, 600.0f, 320.0f, 240.0f), camera.GetProjMatrix(800.0f, 600.0f, 320.0f, 240.0f), 0.0f);
+
+    // 射影: スクリーン中心に置いたカメラ中心はNDCの原点に写る
+    const Matrix4 viewProj = camera.GetViewMatrix() * camera.GetProjMatrix(640.0f, 480.0f, 320.0f, 240.0f);
+    EXPECT_NEAR(0.0f, viewProj.m[3][0], 1e-6f);
+    EXPECT_NEAR(0.0f, viewProj.m[3][1], 1e-6f);
+}
@@ -0,0 +1,268 @@
+﻿#include "reflex/mqo_lexer.hpp"
+#include "bison/mqo.tab.hpp"
+
+#include <bstorm/mesh_cache.hpp>
+#include <bstorm/mqo.hpp>
+#include <bstorm/file_loader.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/string_util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+using namespace bstorm;
+
+namespace
+{
+// ParseMqoと同じ手順. parser.cppは弾やアイテム定義のパーサも含むのでここで組み立てる
+std::shared_ptr<Mqo> LoadMqo(const std::wstring& path)
+{
+    MqoLexer lexer;
+    lexer.SetLoader(std::make_shared<FileLoader>());
+    lexer.SetInputSource(path);
+    MqoParseContext ctx(&lexer);
+    MqoParser parser(&ctx);
+    parser.parse();
+    return ctx.mqo;
+}
+
+class MeshCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto info = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir = ToUnicode(::testing::TempDir()) + L"bstorm_mesh_cache_test/" + ToUnicode(info->name());
+        MakeDirectoryP(dir);
+        cachePath = dir + L"/mesh.bsmesh";
+        RemoveFile(cachePath);
+
+        source.path = L"script/mesh/テスト.mqo";
+        source.lastUpdateTime = 132000000000000000ull;
+        source.size = 12345;
+
+        for (int i = 0; i < 3; i++)
+        {
+            MeshMaterialData mat;
+            mat.r = 0.1f * i; mat.g = 0.2f; mat.b = 0.3f; mat.a = 1.0f;
+            mat.dif = 0.8f; mat.amb = 0.6f; mat.emi = 0.0f;
+            mat.texturePath = i == 1 ? L"" : L"tex/材質" + std::to_wstring(i) + L".png";
+            for (int v = 0; v < 3 * (i + 1); v++)
+            {
+                mat.vertices.emplace_back(1.0f * v, 2.0f * i, -1.0f, 0.0f, 1.0f, 0.0f, 0.5f * v, 0.25f);
+            }
+            materials.push_back(mat);
+        }
+    }
+    std::vector<char> ReadCache() const
+    {
+        std::vector<char> buf;
+        EXPECT_TRUE(ReadFileBytes(cachePath, &buf));
+        return buf;
+    }
+    void WriteCache(const std::vector<char>& buf) const
+    {
+        std::ofstream out(ToUTF8(cachePath), std::ios::binary | std::ios::trunc);
+        out.write(buf.data(), buf.size());
+    }
+    bool Load(std::vector<MeshMaterialData>* loaded) const
+    {
+        return LoadMeshCache(cachePath, source, loaded);
+    }
+    // ヘッダの後の材質数の位置
+    size_t GetMaterialCountOffset() const
+    {
+        return 8 + 4 + 4 + 8 + 8 + 4 + ToUTF8(source.path).size();
+    }
+    std::wstring dir;
+    std::wstring cachePath;
+    MeshSourceInfo source;
+    std::vector<MeshMaterialData> materials;
+};
+}
+
+TEST_F(MeshCacheTest, RoundTrip)
+{
+    SaveMeshCache(cachePath, source, materials);
+    std::vector<MeshMaterialData> loaded;
+    ASSERT_TRUE(Load(&loaded));
+    ASSERT_EQ(materials.size(), loaded.size());
+    for (size_t i = 0; i < materials.size(); i++)
+    {
+        const auto& expected = materials[i];
+        const auto& actual = loaded[i];
+        EXPECT_EQ(expected.r, actual.r);
+        EXPECT_EQ(expected.g, actual.g);
+        EXPECT_EQ(expected.b, actual.b);
+        EXPECT_EQ(expected.a, actual.a);
+        EXPECT_EQ(expected.dif, actual.dif);
+        EXPECT_EQ(expected.amb, actual.amb);
+        EXPECT_EQ(expected.emi, actual.emi);
+        EXPECT_EQ(expected.texturePath, actual.texturePath);
+        ASSERT_EQ(expected.vertices.size(), actual.vertices.size());
+        EXPECT_EQ(0, std::memcmp(expected.vertices.data(), actual.vertices.data(), expected.vertices.size() * sizeof(MeshVertex)));
+    }
+
+    // 空のメッシュ
+    SaveMeshCache(cachePath, source, {});
+    ASSERT_TRUE(Load(&loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(MeshCacheTest, RejectsMismatchedSource)
+{
+    SaveMeshCache(cachePath, source, materials);
+    std::vector<MeshMaterialData> loaded;
+    MeshSourceInfo other = source;
+    other.lastUpdateTime++;
+    EXPECT_FALSE(LoadMeshCache(cachePath, other, &loaded));
+    other = source;
+    other.size++;
+    EXPECT_FALSE(LoadMeshCache(cachePath, other, &loaded));
+    other = source;
+    other.path += L"x";
+    EXPECT_FALSE(LoadMeshCache(cachePath, other, &loaded));
+    EXPECT_FALSE(LoadMeshCache(dir + L"/missing.bsmesh", source, &loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(MeshCacheTest, RejectsTruncatedOrExtendedFile)
+{
+    SaveMeshCache(cachePath, source, materials);
+    const auto original = ReadCache();
+    std::vector<MeshMaterialData> loaded;
+    for (size_t size = 0; size < original.size(); size++)
+    {
+        WriteCache(std::vector<char>(original.begin(), original.begin() + size));
+        ASSERT_FALSE(Load(&loaded)) << "size " << size;
+    }
+    auto extended = original;
+    extended.push_back(0);
+    WriteCache(extended);
+    EXPECT_FALSE(Load(&loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(MeshCacheTest, RejectsCorruptedHeader)
+{
+    SaveMeshCache(cachePath, source, materials);
+    const auto original = ReadCache();
+    std::vector<MeshMaterialData> loaded;
+    // マジック, バージョン, 頂点サイズ
+    for (size_t pos : { 0, 8, 12 })
+    {
+        auto corrupted = original;
+        corrupted[pos] ^= 0x5a;
+        WriteCache(corrupted);
+        EXPECT_FALSE(Load(&loaded)) << "pos " << pos;
+    }
+}
+
+TEST_F(MeshCacheTest, RejectsHugeCountsWithoutAllocating)
+{
+    SaveMeshCache(cachePath, source, materials);
+    const auto original = ReadCache();
+    std::vector<MeshMaterialData> loaded;
+
+    const size_t countPos = GetMaterialCountOffset();
+    uint32_t count = 0;
+    std::memcpy(&count, original.data() + countPos, sizeof(count));
+    ASSERT_EQ(materials.size(), count);
+
+    for (uint32_t hugeCount : { 0xffffffffu, 0x10000000u, (uint32_t)materials.size() + 1 })
+    {
+        auto corrupted = original;
+        std::memcpy(corrupted.data() + countPos, &hugeCount, sizeof(hugeCount));
+        WriteCache(corrupted);
+        EXPECT_FALSE(Load(&loaded)) << "materialCount " << hugeCount;
+    }
+
+    // 最初の材質の頂点数
+    const size_t vertexCountPos = countPos + 4 + sizeof(float) * 7 + 4 + ToUTF8(materials[0].texturePath).size();
+    std::memcpy(&count, original.data() + vertexCountPos, sizeof(count));
+    ASSERT_EQ(materials[0].vertices.size(), count);
+    for (uint32_t hugeCount : { 0xffffffffu, 0x08000000u })
+    {
+        auto corrupted = original;
+        std::memcpy(corrupted.data() + vertexCountPos, &hugeCount, sizeof(hugeCount));
+        WriteCache(corrupted);
+        EXPECT_FALSE(Load(&loaded)) << "vertexCount " << hugeCount;
+    }
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(MeshCacheTest, RoundTripRealMqo)
+{
+    const auto mqo = LoadMqo(ToUnicode(BSTORM_TEST_MQO_PATH));
+    ASSERT_EQ(1u, mqo->materials.size());
+    ASSERT_EQ(1u, mqo->objects.size());
+    const auto& obj = mqo->objects[0];
+    ASSERT_EQ(121u, obj.vertices.size());
+    ASSERT_EQ(100u, obj.faces.size());
+
+    std::vector<MeshMaterialData> created;
+    CreateMeshMaterialData(*mqo, created);
+    ASSERT_EQ(1u, created.size());
+    const auto& mqoMat = mqo->materials[0];
+    const auto& mat = created[0];
+    EXPECT_EQ(mqoMat.col.r, mat.r);
+    EXPECT_EQ(mqoMat.col.g, mat.g);
+    EXPECT_EQ(mqoMat.col.b, mat.b);
+    EXPECT_EQ(mqoMat.col.a, mat.a);
+    EXPECT_FLOAT_EQ(1.0f, mat.dif);
+    EXPECT_FLOAT_EQ(0.6f, mat.amb);
+    EXPECT_FLOAT_EQ(0.0f, mat.emi);
+    EXPECT_EQ(L"Default_BackGround_IceMountain.bmp", mat.texturePath);
+
+    // 四角形の面は(0, i+1, i+2)の扇形に2つの三角形に分割され, 頂点は逆順に並ぶ
+    ASSERT_EQ(obj.faces.size() * 2 * 3, mat.vertices.size());
+    size_t k = 0;
+    for (const auto& face : obj.faces)
+    {
+        ASSERT_EQ(4u, face.vertexIndices.size());
+        for (size_t i = 0; i < 2; i++)
+        {
+            for (size_t j : { i + 2, i + 1, (size_t)0 })
+            {
+                const auto& pos = obj.vertices[face.vertexIndices[j]];
+                const auto& v = mat.vertices[k++];
+                EXPECT_EQ(pos.x, v.x);
+                EXPECT_EQ(pos.y, v.y);
+                EXPECT_EQ(-pos.z, v.z);
+                EXPECT_EQ(face.uvs[j].x, v.u);
+                EXPECT_EQ(face.uvs[j].y, v.v);
+                EXPECT_NEAR(1.0f, std::sqrt(v.nx * v.nx + v.ny * v.ny + v.nz * v.nz), 1e-5f);
+            }
+        }
+    }
+
+    SaveMeshCache(cachePath, source, created);
+    std::vector<MeshMaterialData> loaded;
+    ASSERT_TRUE(Load(&loaded));
+    ASSERT_EQ(created.size(), loaded.size());
+    EXPECT_EQ(mat.r, loaded[0].r);
+    EXPECT_EQ(mat.g, loaded[0].g);
+    EXPECT_EQ(mat.b, loaded[0].b);
+    EXPECT_EQ(mat.a, loaded[0].a);
+    EXPECT_EQ(mat.dif, loaded[0].dif);
+    EXPECT_EQ(mat.amb, loaded[0].amb);
+    EXPECT_EQ(mat.emi, loaded[0].emi);
+    EXPECT_EQ(mat.texturePath, loaded[0].texturePath);
+    ASSERT_EQ(mat.vertices.size(), loaded[0].vertices.size());
+    for (size_t i = 0; i < mat.vertices.size(); i++)
+    {
+        const auto& expected = mat.vertices[i];
+        const auto& actual = loaded[0].vertices[i];
+        EXPECT_EQ(expected.x, actual.x) << "vertex " << i;
+        EXPECT_EQ(expected.y, actual.y) << "vertex " << i;
+        EXPECT_EQ(expected.z, actual.z) << "vertex " << i;
+        EXPECT_EQ(expected.nx, actual.nx) << "vertex " << i;
+        EXPECT_EQ(expected.ny, actual.ny) << "vertex " << i;
+        EXPECT_EQ(expected.nz, actual.nz) << "vertex " << i;
+        EXPECT_EQ(expected.u, actual.u) << "vertex " << i;
+        EXPECT_EQ(expected.v, actual.v) << "vertex " << i;
+    }
+}
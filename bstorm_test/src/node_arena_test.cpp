@@ -0,0 +1,194 @@
+﻿#include <bstorm/node_arena.hpp>
+#include <bstorm/node.hpp>
+#include <bstorm/parser.hpp>
+#include <bstorm/file_loader.hpp>
+#include <bstorm/file_util.hpp>
+#include <bstorm/logger.hpp>
+#include <bstorm/source_map.hpp>
+#include <bstorm/string_util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+using namespace bstorm;
+
+namespace
+{
+bool IsAligned(const void* p, size_t align)
+{
+    return reinterpret_cast<uintptr_t>(p) % align == 0;
+}
+
+class NodeArenaParseTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto info = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir = ToUnicode(::testing::TempDir()) + L"bstorm_node_arena_test/" + ToUnicode(info->name());
+        MakeDirectoryP(dir);
+    }
+    std::wstring WriteScript(const std::string& name, const std::string& src) const
+    {
+        const std::wstring path = dir + L"/" + ToUnicode(name);
+        std::ofstream(ToUTF8(path), std::ios::binary) << src;
+        return path;
+    }
+    std::shared_ptr<NodeBlock> Parse(const std::wstring& path, NodeArena* arena) const
+    {
+        ScriptInfo info;
+        return ParseDnhScript(path, nullptr, true, &info, std::make_shared<FileLoader>(), nullptr, arena);
+    }
+    std::wstring dir;
+};
+}
+
+TEST(NodeArenaTest, PadsToAlignment)
+{
+    NodeArena arena;
+    char* c = static_cast<char*>(arena.Allocate(1, 1));
+    char* d = static_cast<char*>(arena.Allocate(sizeof(double), alignof(double)));
+    EXPECT_TRUE(IsAligned(d, alignof(double)));
+    EXPECT_GT(d, c);
+    EXPECT_LT(d, c + 1 + alignof(double));
+    char* v = static_cast<char*>(arena.Allocate(16, 64));
+    EXPECT_TRUE(IsAligned(v, 64));
+    EXPECT_GE(v, d + sizeof(double));
+    EXPECT_LT(v, d + sizeof(double) + 64);
+    // パディングは確保したバイト数に含めない
+    EXPECT_EQ(1 + sizeof(double) + 16, arena.GetAllocatedSize());
+    EXPECT_EQ(NodeArena::blockSize, arena.GetReservedSize());
+}
+
+TEST(NodeArenaTest, StartsNewBlockWhenPaddingDoesNotFit)
+{
+    NodeArena arena;
+    char* first = static_cast<char*>(arena.Allocate(NodeArena::blockSize - 2, 1));
+    // 残り2バイトにちょうど入る
+    char* last = static_cast<char*>(arena.Allocate(2, 1));
+    EXPECT_EQ(first + NodeArena::blockSize - 2, last);
+    EXPECT_EQ(NodeArena::blockSize, arena.GetReservedSize());
+
+    NodeArena padded;
+    first = static_cast<char*>(padded.Allocate(NodeArena::blockSize - 1, 1));
+    // 残りは1バイトだが, 奇数番地なので2バイト境界に揃えると入らない
+    char* next = static_cast<char*>(padded.Allocate(1, 2));
+    EXPECT_TRUE(IsAligned(next, 2));
+    EXPECT_TRUE(next < first || next >= first + NodeArena::blockSize);
+    EXPECT_EQ(2 * NodeArena::blockSize, padded.GetReservedSize());
+}
+
+TEST(NodeArenaTest, GivesOversizedAllocationItsOwnBlock)
+{
+    NodeArena arena;
+    char* small = static_cast<char*>(arena.Allocate(8, 8));
+    const size_t size = NodeArena::blockSize;
+    char* big = static_cast<char*>(arena.Allocate(size, 64));
+    EXPECT_TRUE(IsAligned(big, 64));
+    // 全体に書き込める(ASanで範囲外を検出する)
+    std::memset(big, 0xab, size);
+    EXPECT_EQ(NodeArena::blockSize + size + 64, arena.GetReservedSize());
+    EXPECT_EQ(8 + size, arena.GetAllocatedSize());
+    // 小さいものは元のブロックの続きに置く
+    char* next = static_cast<char*>(arena.Allocate(8, 8));
+    EXPECT_EQ(small + 8, next);
+
+    // ブロックを1つも持たない状態でも同じ
+    NodeArena empty;
+    big = static_cast<char*>(empty.Allocate(size, 16));
+    EXPECT_TRUE(IsAligned(big, 16));
+    EXPECT_EQ(size + 16, empty.GetReservedSize());
+    empty.Allocate(1, 1);
+    EXPECT_EQ(size + 16 + NodeArena::blockSize, empty.GetReservedSize());
+}
+
+TEST(NodeArenaTest, CountsLiveObjects)
+{
+    NodeArena arena;
+    auto num = arena.New<NodeNum>(std::string("1"));
+    auto str = arena.New<NodeStr>(std::wstring(L"long enough to leave the small string buffer"));
+    EXPECT_EQ(2u, arena.GetLiveObjectCount());
+    arena.Destroy(num);
+    EXPECT_EQ(1u, arena.GetLiveObjectCount());
+    {
+        std::shared_ptr<NodeExp> owned = arena.Own(str);
+        std::shared_ptr<NodeExp> copy = owned;
+        owned.reset();
+        EXPECT_EQ(1u, arena.GetLiveObjectCount());
+    }
+    EXPECT_EQ(0u, arena.GetLiveObjectCount());
+    EXPECT_EQ(2u, arena.GetObjectCount());
+}
+
+TEST_F(NodeArenaParseTest, DestroysNodesAfterParse)
+{
+    const auto path = WriteScript("ok.dnh",
+        "let x = [1, 2];\n"
+        "function F(a, b) { return a + b * x[0]; }\n"
+        "@MainLoop { ascent(i in 0..3) { F(i, 1); } yield; }\n");
+    NodeArena arena;
+    auto program = Parse(path, &arena);
+    ASSERT_TRUE(program);
+    EXPECT_GT(arena.GetLiveObjectCount(), 0u);
+    program.reset();
+    EXPECT_EQ(0u, arena.GetLiveObjectCount());
+}
+
+// 位置はアリーナに置き, ファイルパスは登録した1つを共有する
+TEST_F(NodeArenaParseTest, SharesInternedSourcePaths)
+{
+    const auto incPath = WriteScript("inc.dnh", "let y = 2;\n");
+    const auto path = WriteScript("main.dnh", "let x = 1;\n#include \"./inc.dnh\"\nlet z = 3;\n");
+    std::unique_ptr<Log> log;
+    {
+        NodeArena arena;
+        auto program = Parse(path, &arena);
+        ASSERT_TRUE(program);
+        ASSERT_EQ(3u, program->stmts.size());
+        const NodePos* x = program->stmts[0]->srcPos;
+        const NodePos* y = program->stmts[1]->srcPos;
+        const NodePos* z = program->stmts[2]->srcPos;
+        EXPECT_EQ(InternSourcePath(GetCanonicalPath(path)), x->filename);
+        EXPECT_EQ(InternSourcePath(GetCanonicalPath(incPath)), y->filename);
+        EXPECT_EQ(x->filename, z->filename);
+        EXPECT_EQ(1, x->line);
+        EXPECT_EQ(1, y->line);
+        EXPECT_EQ(3, z->line);
+        log.reset(new Log(Log(LogLevel::LV_ERROR).AddSourcePos(z)));
+        program.reset();
+    }
+    // アリーナを破棄してもログに残した位置は使える
+    ASSERT_EQ(1u, log->GetSourcePosStack().size());
+    EXPECT_EQ(ToUTF8(GetCanonicalPath(path)) + ":3:1", log->GetSourcePosStack()[0].ToString());
+}
+
+// 構文エラーで止まったら, 途中まで作ったノードは全て破棄される
+TEST_F(NodeArenaParseTest, DestroysNodesWhenParserStopsOnSyntaxError)
+{
+    const char* sources[] = {
+        // 式の途中
+        "let x = [1, 2;\n",
+        // 関数, ブロック, 引数リストの途中
+        "let y = 1;\nfunction F(a) { let b = F(a + 1, [a, \"str\"]) * ; }\n",
+        // 入れ子の文の途中でファイルが終わる
+        "@MainLoop { if (x) { F(1, [2, 3]); } else { loop { alternative (y) case (1) { yield; }\n",
+        // 不正なトークン
+        "@Initialize { let s = \"abc\"; s[0] = $; }\n",
+        // 重複した定義
+        "let z = 1;\nlet z = 2;\n",
+    };
+    int i = 0;
+    for (const char* src : sources)
+    {
+        SCOPED_TRACE(src);
+        const auto path = WriteScript("error" + std::to_string(i++) + ".dnh", src);
+        NodeArena arena;
+        EXPECT_THROW(Parse(path, &arena), Log);
+        EXPECT_GT(arena.GetObjectCount(), 0u);
+        EXPECT_EQ(0u, arena.GetLiveObjectCount());
+    }
+}
@@ -0,0 +1,193 @@
+﻿#include <bstorm/particle_system.hpp>
+#include <bstorm/particle_vertex.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace bstorm;
+
+namespace
+{
+ParticleQuad MakeQuad()
+{
+    ParticleQuad quad;
+    quad.dstLeft = -4; quad.dstTop = -2; quad.dstRight = 4; quad.dstBottom = 2;
+    quad.ul = 0.25f; quad.vt = 0.5f; quad.ur = 0.75f; quad.vb = 1.0f;
+    quad.rMul = quad.gMul = quad.bMul = quad.aMul = 1.0f;
+    return quad;
+}
+}
+
+TEST(ParticleSystemTest, EmitsOnlyParticlesWithLife)
+{
+    ParticleSystem particles;
+    particles.Add(1, 2, 3, 4, 0.5f, -0.5f, 10);
+    particles.Add(0, 0, 0, 0, 0, 0, 0);
+    particles.Add(0, 0, 0, 0, 0, 0, -1);
+    ASSERT_EQ(1u, particles.GetCount());
+    EXPECT_EQ(1, particles.GetX(0));
+    EXPECT_EQ(2, particles.GetY(0));
+    EXPECT_EQ(0, particles.GetAge(0));
+    EXPECT_EQ(10, particles.GetLife(0));
+    EXPECT_EQ(0.0f, particles.GetLifeRate(0));
+
+    particles.Clear();
+    EXPECT_EQ(0u, particles.GetCount());
+}
+
+TEST(ParticleSystemTest, UpdateAcceleratesThenMoves)
+{
+    ParticleSystem particles;
+    particles.Add(10, 20, 1, 2, 0.5f, -1, 100);
+    particles.Update();
+    // 速度に加速度を足してから移動する
+    EXPECT_FLOAT_EQ(1.5f, particles.GetVelocityX(0));
+    EXPECT_FLOAT_EQ(1.0f, particles.GetVelocityY(0));
+    EXPECT_FLOAT_EQ(11.5f, particles.GetX(0));
+    EXPECT_FLOAT_EQ(21.0f, particles.GetY(0));
+    particles.Update();
+    EXPECT_FLOAT_EQ(2.0f, particles.GetVelocityX(0));
+    EXPECT_FLOAT_EQ(0.0f, particles.GetVelocityY(0));
+    EXPECT_FLOAT_EQ(13.5f, particles.GetX(0));
+    EXPECT_FLOAT_EQ(21.0f, particles.GetY(0));
+    EXPECT_EQ(2, particles.GetAge(0));
+}
+
+TEST(ParticleSystemTest, ExpiredParticlesAreRemovedInOrder)
+{
+    ParticleSystem particles;
+    // x座標で識別する
+    const int lives[] = { 3, 1, 5, 2, 3 };
+    for (int i = 0; i < 5; i++)
+    {
+        particles.Add((float)i, 0, 0, 0, 0, 0, lives[i]);
+    }
+    particles.Update(); // 寿命1が消える
+    ASSERT_EQ(4u, particles.GetCount());
+    EXPECT_EQ(0, particles.GetX(0));
+    EXPECT_EQ(2, particles.GetX(1));
+    EXPECT_EQ(3, particles.GetX(2));
+    EXPECT_EQ(4, particles.GetX(3));
+    particles.Update(); // 寿命2が消える
+    ASSERT_EQ(3u, particles.GetCount());
+    EXPECT_EQ(0, particles.GetX(0));
+    EXPECT_EQ(2, particles.GetX(1));
+    EXPECT_EQ(4, particles.GetX(2));
+    EXPECT_EQ(2, particles.GetAge(2));
+    particles.Update(); // 寿命3が消える
+    ASSERT_EQ(1u, particles.GetCount());
+    EXPECT_EQ(2, particles.GetX(0));
+    particles.Update();
+    particles.Update();
+    EXPECT_EQ(0u, particles.GetCount());
+    // 空でも問題ない
+    particles.Update();
+    EXPECT_EQ(0u, particles.GetCount());
+}
+
+TEST(ParticleSystemTest, MaxDistanceFollowsAddUpdateAndExpiry)
+{
+    ParticleSystem particles;
+    EXPECT_EQ(0.0f, particles.GetMaxDistanceSq());
+    // 遠い粒子ほど先に消える
+    particles.Add(3, 4, 0, 0, 0, 0, 100);
+    particles.Add(-30, 40, 0, 0, 0, 0, 2);
+    particles.Add(0, 1, 0, -1, 0, 0, 100);
+    EXPECT_EQ(2500.0f, particles.GetMaxDistanceSq());
+
+    auto bruteForce = [&]()
+    {
+        float maxDistSq = 0;
+        for (size_t i = 0; i < particles.GetCount(); i++)
+        {
+            const float x = particles.GetX(i);
+            const float y = particles.GetY(i);
+            maxDistSq = std::max(maxDistSq, x * x + y * y);
+        }
+        return maxDistSq;
+    };
+    for (int frame = 0; frame < 10; frame++)
+    {
+        particles.Update();
+        EXPECT_EQ(bruteForce(), particles.GetMaxDistanceSq()) << "frame " << frame;
+    }
+    // 3番目の粒子が(0, -9)まで動いて最も遠くなる
+    EXPECT_EQ(81.0f, particles.GetMaxDistanceSq());
+
+    particles.Clear();
+    EXPECT_EQ(0.0f, particles.GetMaxDistanceSq());
+}
+
+TEST(ParticleSystemTest, CurvesFollowLifeRate)
+{
+    ParticleSystem particles;
+    particles.SetColorCurve(255, 0, 100, 0, 255, 100);
+    particles.SetAlphaCurve(200, 0);
+    particles.SetScaleCurve(1, -3);
+    particles.Add(0, 0, 0, 0, 0, 0, 4);
+    particles.Update();
+    ASSERT_FLOAT_EQ(0.25f, particles.GetLifeRate(0));
+    EXPECT_FLOAT_EQ(191.25f, particles.GetRed(0));
+    EXPECT_FLOAT_EQ(63.75f, particles.GetGreen(0));
+    EXPECT_FLOAT_EQ(100.0f, particles.GetBlue(0));
+    EXPECT_FLOAT_EQ(150.0f, particles.GetAlpha(0));
+    EXPECT_FLOAT_EQ(0.0f, particles.GetScale(0));
+    EXPECT_FLOAT_EQ(3.0f, particles.GetMaxScale());
+}
+
+TEST(ParticleSystemTest, VertexBufferContents)
+{
+    ParticleSystem particles;
+    particles.SetColorCurve(255, 255, 255, 0, 128, 255);
+    particles.SetAlphaCurve(255, 0);
+    particles.SetScaleCurve(1, 3);
+    particles.Add(100, 50, 0, 0, 0, 0, 2);
+    particles.Add(-10, 0, 1, 0, 0, 0, 4);
+    particles.Update();
+
+    std::vector<Vertex> vertices;
+    ParticleQuad quad = MakeQuad();
+    quad.rMul = 2.0f; // 255を超えたら切り詰める
+    quad.aMul = 0.5f;
+    WriteParticleVertices(particles, quad, &vertices);
+    ASSERT_EQ(12u, vertices.size());
+
+    // 1つ目 : 寿命の半分, 拡大率2
+    {
+        const D3DCOLOR color = D3DCOLOR_ARGB(63, 255, 191, 255);
+        const Vertex* v = vertices.data();
+        EXPECT_FLOAT_EQ(92, v[0].x); EXPECT_FLOAT_EQ(46, v[0].y);
+        EXPECT_FLOAT_EQ(92, v[1].x); EXPECT_FLOAT_EQ(54, v[1].y);
+        EXPECT_FLOAT_EQ(108, v[2].x); EXPECT_FLOAT_EQ(46, v[2].y);
+        EXPECT_FLOAT_EQ(108, v[5].x); EXPECT_FLOAT_EQ(54, v[5].y);
+        EXPECT_EQ(0.25f, v[0].u); EXPECT_EQ(0.5f, v[0].v);
+        EXPECT_EQ(0.25f, v[1].u); EXPECT_EQ(1.0f, v[1].v);
+        EXPECT_EQ(0.75f, v[2].u); EXPECT_EQ(0.5f, v[2].v);
+        EXPECT_EQ(0.75f, v[5].u); EXPECT_EQ(1.0f, v[5].v);
+        for (int i = 0; i < 6; i++)
+        {
+            EXPECT_EQ(color, v[i].color) << i;
+            EXPECT_EQ(0.0f, v[i].z);
+        }
+        // 2つの三角形で頂点を共有する
+        EXPECT_EQ(0, std::memcmp(&v[2], &v[3], sizeof(Vertex)));
+        EXPECT_EQ(0, std::memcmp(&v[1], &v[4], sizeof(Vertex)));
+    }
+    // 2つ目 : 寿命の1/4, 拡大率1.5, x = -9
+    {
+        const Vertex* v = vertices.data() + 6;
+        EXPECT_FLOAT_EQ(-15, v[0].x); EXPECT_FLOAT_EQ(-3, v[0].y);
+        EXPECT_FLOAT_EQ(-3, v[5].x); EXPECT_FLOAT_EQ(3, v[5].y);
+        EXPECT_EQ(D3DCOLOR_ARGB(95, 255, 223, 255), v[0].color);
+    }
+
+    // 粒子が減ったら頂点も減る
+    particles.Update();
+    WriteParticleVertices(particles, quad, &vertices);
+    EXPECT_EQ(6u, vertices.size());
+    particles.Clear();
+    WriteParticleVertices(particles, quad, &vertices);
+    EXPECT_TRUE(vertices.empty());
+}
@@ -0,0 +1,179 @@
+﻿#include <bstorm/render_command.hpp>
+#include <bstorm/thread_util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace bstorm;
+
+namespace
+{
+constexpr int LAYER_COUNT = 32;
+
+IDirect3DTexture9* FakeTexture(int id)
+{
+    return reinterpret_cast<IDirect3DTexture9*>(static_cast<uintptr_t>(0x1000 + id * 0x10));
+}
+
+ObjRender* FakeObject(int id)
+{
+    return reinterpret_cast<ObjRender*>(static_cast<uintptr_t>(0x100000 + id * 0x10));
+}
+
+D3DXMATRIX MakeMatrix(int seed)
+{
+    D3DXMATRIX mat;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            mat.m[i][j] = 0.25f * seed + i - 0.5f * j;
+        }
+    }
+    return mat;
+}
+
+// レイヤーの描画の代わり, レイヤーごとに決まった命令列を記録する
+void RecordLayer(int layer, RenderCommandList& list)
+{
+    list.Clear();
+    const int objCount = 5 + layer % 7;
+    for (int i = 0; i < objCount; i++)
+    {
+        const int id = layer * 100 + i;
+        std::vector<Vertex> vertices;
+        for (int v = 0; v < 4 + i % 3; v++)
+        {
+            vertices.emplace_back(1.0f * id, 0.5f * v, 0.0f, D3DCOLOR_ARGB(0xff, id & 0xff, v, 0x80), 0.125f * v, 0.25f * i);
+        }
+        switch (id % 4)
+        {
+            case 0:
+                list.AddPrim2D(D3DPT_TRIANGLESTRIP, (int)vertices.size(), vertices.data(), FakeTexture(id), id % 8, id % 3, MakeMatrix(id), nullptr, i % 2 == 0, i % 3 == 0, i % 5 == 0 ? FakeTexture(id + 1) : nullptr);
+                break;
+            case 1:
+                list.AddPrim3D(D3DPT_TRIANGLELIST, (int)vertices.size(), vertices.data(), FakeTexture(id), id % 8, MakeMatrix(id), nullptr, i % 2 == 0, i % 3 == 0, i % 4 == 0, i % 5 == 0);
+                break;
+            case 2:
+                list.AddMesh(nullptr, D3DCOLORVALUE{ 0.1f * i, 0.2f, 0.3f, 1.0f }, id % 8, MakeMatrix(id), nullptr, true, false, i % 2 == 0);
+                break;
+            default:
+                list.AddObject(FakeObject(id));
+                break;
+        }
+    }
+}
+
+template <class T>
+void Write(std::vector<uint8_t>& out, const T& value)
+{
+    const auto p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+// SubmitLayerと同じ順に命令を辿って, Rendererに渡る引数をバイト列にする
+void Submit(const RenderCommandList& list, std::vector<uint8_t>& out)
+{
+    for (const auto& cmd : list.GetCommands())
+    {
+        Write(out, cmd.type);
+        switch (cmd.type)
+        {
+            case RenderCommand::Type::PRIM_2D:
+            case RenderCommand::Type::PRIM_3D:
+            {
+                Write(out, cmd.primType);
+                Write(out, cmd.vertexCount);
+                const Vertex* vertices = list.GetVertices(cmd);
+                for (int i = 0; i < cmd.vertexCount; i++)
+                {
+                    Write(out, vertices[i]);
+                }
+                Write(out, cmd.texture);
+                Write(out, cmd.blendType);
+                Write(out, cmd.worldMatrix.m);
+                if (cmd.type == RenderCommand::Type::PRIM_2D)
+                {
+                    Write(out, cmd.filterType);
+                    Write(out, cmd.permitCamera);
+                    Write(out, cmd.insertHalfPixelOffset);
+                    Write(out, cmd.sourceTexture);
+                } else
+                {
+                    Write(out, cmd.zWriteEnable);
+                    Write(out, cmd.zTestEnable);
+                    Write(out, cmd.useFog);
+                    Write(out, cmd.billboardEnable);
+                }
+                break;
+            }
+            case RenderCommand::Type::MESH:
+                Write(out, cmd.color);
+                Write(out, cmd.blendType);
+                Write(out, cmd.worldMatrix.m);
+                Write(out, cmd.zWriteEnable);
+                Write(out, cmd.zTestEnable);
+                Write(out, cmd.useFog);
+                break;
+            case RenderCommand::Type::OBJECT:
+                Write(out, cmd.obj);
+                break;
+        }
+    }
+}
+
+std::vector<uint8_t> SubmitAll(const std::vector<RenderCommandList>& layers)
+{
+    std::vector<uint8_t> out;
+    for (const auto& list : layers)
+    {
+        Submit(list, out);
+    }
+    return out;
+}
+}
+
+TEST(RenderCommandTest, ParallelRecordingMatchesSerialRecording)
+{
+    std::vector<RenderCommandList> serial(LAYER_COUNT);
+    for (int i = 0; i < LAYER_COUNT; i++)
+    {
+        RecordLayer(i, serial[i]);
+    }
+    const auto expected = SubmitAll(serial);
+    ASSERT_FALSE(expected.empty());
+
+    // ObjectLayerList::RecordLayersと同じくレイヤー単位で並列に記録する
+    // 前フレームの領域を再利用するので複数回繰り返す
+    std::vector<RenderCommandList> parallel(LAYER_COUNT);
+    for (int frame = 0; frame < 3; frame++)
+    {
+        ParallelTimes(LAYER_COUNT, [&](int i) { RecordLayer(i, parallel[i]); });
+        const auto actual = SubmitAll(parallel);
+        ASSERT_EQ(expected.size(), actual.size());
+        EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), expected.size())) << "frame " << frame;
+    }
+}
+
+TEST(RenderCommandTest, VerticesArePackedInRecordingOrder)
+{
+    RenderCommandList list;
+    Vertex a[3], b[4];
+    for (int i = 0; i < 3; i++) a[i].x = (float)i;
+    for (int i = 0; i < 4; i++) b[i].x = 10.0f + i;
+    list.AddPrim2D(D3DPT_TRIANGLELIST, 3, a, nullptr, 0, 0, MakeMatrix(0), nullptr, true, false, nullptr);
+    list.AddObject(FakeObject(0));
+    list.AddPrim3D(D3DPT_TRIANGLESTRIP, 4, b, nullptr, 0, MakeMatrix(1), nullptr, true, true, false, false);
+
+    const auto& cmds = list.GetCommands();
+    ASSERT_EQ(3u, cmds.size());
+    EXPECT_EQ(0u, cmds[0].vertexOffset);
+    EXPECT_EQ(3u, cmds[2].vertexOffset);
+    EXPECT_FLOAT_EQ(2.0f, list.GetVertices(cmds[0])[2].x);
+    EXPECT_FLOAT_EQ(13.0f, list.GetVertices(cmds[2])[3].x);
+
+    list.Clear();
+    EXPECT_TRUE(list.IsEmpty());
+}